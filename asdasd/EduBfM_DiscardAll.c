@@ -0,0 +1,162 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_DiscardAll.c
+ *
+ * Description:
+ *  Drop trains from the buffer without writing them out.
+ *
+ * Exports:
+ *  Four BfM_DiscardAll(void)
+ *  Four BfM_DiscardAllTrainsInVolume(Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM.h"
+
+
+
+/*@================================
+ * BfM_DiscardAll()
+ *================================*/
+/*
+ * Function: Four BfM_DiscardAll(void)
+ *
+ * Description:
+ *  Drop all the trains of all buffer types, fixed or not, without writing
+ *  them out, the mapped pages included.
+ *
+ * Returns:
+ *  error code
+ */
+Four BfM_DiscardAll(void)
+{
+    Four type;			/* buffer type */
+    Four p;			/* partition index */
+    BufferPartition *part;	/* a partition */
+
+
+    /* no train is being written out meanwhile */
+    pthread_mutex_lock(&edubfm_writeMutex);
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+	for (p = 0; p < BI_NPARTITIONS(type); p++) {
+	    part = BI_PARTITION(type, p);
+	    pthread_mutex_lock(&part->mutex);
+	    edubfm_ResetPartition(type, part);
+	    pthread_mutex_unlock(&part->mutex);
+	}
+    }
+
+    (void) edubfm_DiscardMapped(NIL);
+
+    pthread_mutex_unlock(&edubfm_writeMutex);
+
+    return(eNOERROR);
+
+} /* BfM_DiscardAll() */
+
+
+
+/*@================================
+ * BfM_DiscardAllTrainsInVolume()
+ *================================*/
+/*
+ * Function: Four BfM_DiscardAllTrainsInVolume(Four)
+ *
+ * Description:
+ *  Drop all the trains of the volume 'volNo' without writing them out.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four BfM_DiscardAllTrainsInVolume(
+    Four volNo)			/* IN volume whose trains are dropped */
+{
+    Four e;			/* error */
+    Four type;			/* buffer type */
+    Four p;			/* partition index */
+    Four i;			/* frame index */
+    BufferPartition *part;	/* a partition */
+    BufferTable *entry;		/* a buffer table entry */
+
+
+    /* no train is being written out meanwhile */
+    pthread_mutex_lock(&edubfm_writeMutex);
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+	for (p = 0; p < BI_NPARTITIONS(type); p++) {
+	    part = BI_PARTITION(type, p);
+	    pthread_mutex_lock(&part->mutex);
+
+	    for (i = part->firstFrame; i < part->firstFrame + part->nFrames; i++) {
+		entry = BI_BUFTABLE_ENTRY(type, i);
+		if (entry->key.pageNo != NIL && entry->key.volNo == volNo) {
+		    e = edubfm_ReleaseTrain(type, part, i);
+		    if (e < eNOERROR) {
+			pthread_mutex_unlock(&part->mutex);
+			pthread_mutex_unlock(&edubfm_writeMutex);
+			ERR(e);
+		    }
+		}
+	    }
+
+	    pthread_mutex_unlock(&part->mutex);
+	}
+    }
+
+    (void) edubfm_DiscardMapped(volNo);
+
+    pthread_mutex_unlock(&edubfm_writeMutex);
+
+    return(eNOERROR);
+
+} /* BfM_DiscardAllTrainsInVolume() */
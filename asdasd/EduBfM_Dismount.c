@@ -0,0 +1,151 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_Dismount.c
+ *
+ * Description:
+ *  Write out and drop the trains of a volume being dismounted.
+ *
+ * Exports:
+ *  Four BfM_Dismount(Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM.h"
+
+
+
+/*@================================
+ * BfM_Dismount()
+ *================================*/
+/*
+ * Function: Four BfM_Dismount(Four)
+ *
+ * Description:
+ *  Write out the dirty trains of the volume 'volNo' and drop all its
+ *  trains from the buffer. Nothing is done if a train of the volume is
+ *  fixed. A mapped volume is written back and unmapped, and the compressed
+ *  page store of the volume, if any, is closed.
+ *
+ * Returns:
+ *  error code
+ *    eFLUSHFIXEDBUF_BFM
+ *    some errors caused by function calls
+ */
+Four BfM_Dismount(
+    Four volNo)			/* IN volume being dismounted */
+{
+    Four e;			/* error */
+    Four type;			/* buffer type */
+    Four p;			/* partition index */
+    Four i;			/* frame index */
+    BufferPartition *part;	/* a partition */
+    BufferTable *entry;		/* a buffer table entry */
+
+
+    /* no train is being written out meanwhile */
+    pthread_mutex_lock(&edubfm_writeMutex);
+
+    /*@ check that no train of the volume is fixed */
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+	for (i = 0; i < BI_NBUFS(type); i++) {
+	    entry = BI_BUFTABLE_ENTRY(type, i);
+	    if (entry->key.pageNo != NIL && entry->key.volNo == volNo && BFM_LOAD(&entry->fixed) > 0) {
+		pthread_mutex_unlock(&edubfm_writeMutex);
+		ERR(eFLUSHFIXEDBUF_BFM);
+	    }
+	}
+    }
+
+    /*@ write back and unmap the mapped pages */
+    e = edubfm_UnmapVolumes(volNo);
+    if (e < eNOERROR) {
+	pthread_mutex_unlock(&edubfm_writeMutex);
+	ERR(e);
+    }
+
+    /* the descriptors of the volume are closed by RDsM */
+    edubfm_ForgetLocations(volNo);
+
+    /*@ write out and drop the trains */
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+	for (p = 0; p < BI_NPARTITIONS(type); p++) {
+	    part = BI_PARTITION(type, p);
+	    pthread_mutex_lock(&part->mutex);
+
+	    for (i = part->firstFrame; i < part->firstFrame + part->nFrames; i++) {
+		entry = BI_BUFTABLE_ENTRY(type, i);
+		if (entry->key.pageNo == NIL || entry->key.volNo != volNo) continue;
+
+		e = (entry->bits & BFM_DIRTY) ? edubfm_FlushTrain(type, i) : eNOERROR;
+		if (e >= eNOERROR) e = edubfm_ReleaseTrain(type, part, i);
+		if (e < eNOERROR) {
+		    pthread_mutex_unlock(&part->mutex);
+		    pthread_mutex_unlock(&edubfm_writeMutex);
+		    ERR(e);
+		}
+	    }
+
+	    pthread_mutex_unlock(&part->mutex);
+	}
+    }
+
+    /*@ close the compressed page store */
+    pthread_mutex_lock(&edubfm_ioMutex);
+    e = edubfm_DetachStore(volNo, FALSE);
+    pthread_mutex_unlock(&edubfm_ioMutex);
+
+    pthread_mutex_unlock(&edubfm_writeMutex);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* BfM_Dismount() */
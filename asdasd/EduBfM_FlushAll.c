@@ -0,0 +1,98 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_FlushAll.c
+ *
+ * Description:
+ *  Write out all the dirty trains.
+ *
+ * Exports:
+ *  Four BfM_FlushAll(void)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM.h"
+
+
+
+/*@================================
+ * BfM_FlushAll()
+ *================================*/
+/*
+ * Function: Four BfM_FlushAll(void)
+ *
+ * Description:
+ *  Write out the dirty trains of all buffer types, adjacent trains with
+ *  one call (see edubfm_WriteDirtyTrains()). The trains stay in the
+ *  buffer. The dirty pages of the mapped volumes are written back too.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four BfM_FlushAll(void)
+{
+    Four e;			/* error */
+    Four type;			/* buffer type */
+
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+	e = edubfm_WriteDirtyTrains(type, BI_NBUFS(type), FALSE);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    pthread_mutex_lock(&edubfm_writeMutex);
+    e = edubfm_FlushMapped(NIL);
+    pthread_mutex_unlock(&edubfm_writeMutex);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* BfM_FlushAll() */
@@ -0,0 +1,152 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetNewTrain.c
+ *
+ * Description:
+ *  Fix a newly allocated train in the buffer.
+ *
+ * Exports:
+ *  Four BfM_GetNewTrain(TrainID*, char**, Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM.h"
+
+
+
+/*@================================
+ * BfM_GetNewTrain()
+ *================================*/
+/*
+ * Function: Four BfM_GetNewTrain(TrainID*, char**, Four)
+ *
+ * Description:
+ *  Fix the train 'trainId', which has just been allocated on the disk, in
+ *  the buffer of the buffer type 'type' without reading it, and return the
+ *  frame holding it. If the train may have to be restored by a rollback,
+ *  it is read as by BfM_GetTrain().
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM
+ *    eBADBUFFERTYPE_BFM
+ *    some errors caused by function calls
+ */
+Four BfM_GetNewTrain(
+    TrainID *trainId,		/* IN train to fix */
+    char **retBuf,		/* OUT frame holding the train */
+    Four type)			/* IN buffer type */
+{
+    Four e;			/* error */
+    Four index;			/* frame index */
+    Four logIndex;		/* position in the log table, not used */
+    BufferPartition *part;	/* partition of the train */
+    BufferTable *entry;		/* buffer table entry of the frame */
+
+
+    /*@ parameter checking */
+    if (retBuf == NULL) ERR(eBADBUFFER_BFM);
+
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    if (RM_RollbackRequiredFlag && rm_LookUpInLogTable(trainId, &logIndex))
+	return(BfM_GetTrain(trainId, retBuf, type));
+
+    if (edubfm_params.mmapReads && type == PAGE_BUF) {
+	e = edubfm_FixMapped(trainId, retBuf, TRUE);
+	if (e < eNOERROR) ERR(e);
+	if (e != BFM_NOT_MAPPED) return(eNOERROR);
+    }
+
+    part = BI_PARTITION_OF(type, trainId);
+    pthread_mutex_lock(&part->mutex);
+
+    BFM_COUNT(part, nFixes);
+
+    index = edubfm_LookUp(trainId, type);
+    if (index != NIL) {
+	/*@ the train is in the buffer; frames in the hash table are not claimed */
+	BFM_COUNT(part, nHits);
+	entry = BI_BUFTABLE_ENTRY(type, index);
+	(void) edubfm_TryFix(entry);
+	BFM_SET_BITS(entry, BFM_REFER);
+	edubfm_Touch(type, part, index);
+    }
+    else {
+	index = edubfm_AllocTrain(type, part);
+	if (index < eNOERROR) {
+	    pthread_mutex_unlock(&part->mutex);
+	    ERR(index);
+	}
+
+	entry = BI_BUFTABLE_ENTRY(type, index);
+	entry->key = *trainId;
+	entry->bits = BFM_VALID | BFM_REFER | BFM_NEW;
+	BFM_STORE(&entry->fixed, 1);
+
+	e = edubfm_Insert(trainId, index, type);
+	if (e < eNOERROR) {
+	    entry->key.pageNo = NIL;
+	    (void) edubfm_ReleaseTrain(type, part, index);
+	    pthread_mutex_unlock(&part->mutex);
+	    ERR(e);
+	}
+
+	edubfm_Admit(type, part, index);
+    }
+
+    *retBuf = BI_BUFFER(type, index);
+
+    pthread_mutex_unlock(&part->mutex);
+
+    return(eNOERROR);
+
+} /* BfM_GetNewTrain() */
@@ -0,0 +1,193 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetTrain.c
+ *
+ * Description:
+ *  Fix a train in the buffer.
+ *
+ * Exports:
+ *  Four BfM_GetTrain(TrainID*, char**, Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM.h"
+
+
+
+/*@================================
+ * BfM_GetTrain()
+ *================================*/
+/*
+ * Function: Four BfM_GetTrain(TrainID*, char**, Four)
+ *
+ * Description:
+ *  Fix the train 'trainId' in the buffer of the buffer type 'type' and
+ *  return the frame holding it. The train is read from the disk if it is
+ *  not in the buffer.
+ *
+ *  A train in the buffer is fixed without the mutex of its partition; the
+ *  replacement state of 2Q and LRU-K is updated only if the mutex is free
+ *  at that moment, which loses some references under contention but never
+ *  makes a hit wait. Under BFM_HINT_SEQUENTIAL, a hit records nothing and
+ *  a train read from the disk is cold (see EduBfM_SetAccessHint()).
+ *  With the parameter 'mmapReads', a page of PAGE_BUF is returned in the
+ *  mapping of its volume if the volume can be mapped (see edubfm_Mmap.c).
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM
+ *    eBADBUFFERTYPE_BFM
+ *    some errors caused by function calls
+ */
+Four BfM_GetTrain(
+    TrainID *trainId,		/* IN train to fix */
+    char **retBuf,		/* OUT frame holding the train */
+    Four type)			/* IN buffer type */
+{
+    Four e;			/* error */
+    Four index;			/* frame index */
+    BufferPartition *part;	/* partition of the train */
+    BufferTable *entry;		/* buffer table entry of the frame */
+
+
+    /*@ parameter checking */
+    if (retBuf == NULL) ERR(eBADBUFFER_BFM);
+
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    /*@ serve a page of a mapped volume from the mapping */
+    if (edubfm_params.mmapReads && type == PAGE_BUF) {
+	e = edubfm_FixMapped(trainId, retBuf, FALSE);
+	if (e < eNOERROR) ERR(e);
+	if (e != BFM_NOT_MAPPED) return(eNOERROR);
+    }
+
+    part = BI_PARTITION_OF(type, trainId);
+
+    BFM_COUNT(part, nFixes);
+
+    /*@ fix the train without the mutex if it is in the buffer */
+    index = edubfm_LockFreeLookUp(trainId, type);
+    if (index != NIL) {
+	entry = BI_BUFTABLE_ENTRY(type, index);
+	if (edubfm_TryFix(entry)) {
+	    if (EQUAL_PAGEID(entry->key, *trainId)) {
+		BFM_COUNT(part, nHits);
+		if (edubfm_accessHint == BFM_HINT_SEQUENTIAL) {
+		    *retBuf = BI_BUFFER(type, index);
+		    return(eNOERROR);
+		}
+		if (entry->bits & BFM_COLD) BFM_CLEAR_BITS(entry, BFM_COLD);
+		BFM_SET_BITS(entry, BFM_REFER);
+		if (edubfm_params.policy != BFM_CLOCK && pthread_mutex_trylock(&part->mutex) == 0) {
+		    if (EQUAL_PAGEID(entry->key, *trainId)) edubfm_Touch(type, part, index);
+		    pthread_mutex_unlock(&part->mutex);
+		}
+		*retBuf = BI_BUFFER(type, index);
+
+		return(eNOERROR);
+	    }
+	    (void) edubfm_Unfix(entry);
+	}
+    }
+
+    pthread_mutex_lock(&part->mutex);
+
+    index = edubfm_LookUp(trainId, type);
+    if (index != NIL) {
+	/*@ the train is in the buffer; frames in the hash table are not claimed */
+	BFM_COUNT(part, nHits);
+	entry = BI_BUFTABLE_ENTRY(type, index);
+	(void) edubfm_TryFix(entry);
+	if (edubfm_accessHint != BFM_HINT_SEQUENTIAL) {
+	    if (entry->bits & BFM_COLD) BFM_CLEAR_BITS(entry, BFM_COLD);
+	    BFM_SET_BITS(entry, BFM_REFER);
+	    edubfm_Touch(type, part, index);
+	}
+    }
+    else {
+	/*@ read the train into a new frame */
+	index = edubfm_AllocTrain(type, part);
+	if (index < eNOERROR) {
+	    pthread_mutex_unlock(&part->mutex);
+	    ERR(index);
+	}
+
+	e = edubfm_ReadTrain(trainId, BI_BUFFER(type, index), type);
+	if (e < eNOERROR) {
+	    (void) edubfm_ReleaseTrain(type, part, index);
+	    pthread_mutex_unlock(&part->mutex);
+	    ERR(e);
+	}
+
+	entry = BI_BUFTABLE_ENTRY(type, index);
+	entry->key = *trainId;
+	entry->bits = (edubfm_accessHint == BFM_HINT_SEQUENTIAL) ? BFM_VALID | BFM_COLD : BFM_VALID | BFM_REFER;
+	BFM_STORE(&entry->fixed, 1);
+
+	e = edubfm_Insert(trainId, index, type);
+	if (e < eNOERROR) {
+	    entry->key.pageNo = NIL;
+	    (void) edubfm_ReleaseTrain(type, part, index);
+	    pthread_mutex_unlock(&part->mutex);
+	    ERR(e);
+	}
+
+	edubfm_Admit(type, part, index);
+    }
+
+    *retBuf = BI_BUFFER(type, index);
+
+    pthread_mutex_unlock(&part->mutex);
+
+    return(eNOERROR);
+
+} /* BfM_GetTrain() */
@@ -0,0 +1,455 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_Init.c
+ *
+ * Description:
+ *  Initialization and finalization of the in-tree buffer manager, and its
+ *  parameters and statistics.
+ *  The in-tree buffer manager exports the same BfM_* interface as the one
+ *  in the COSMOS object and replaces it when the Makefile is run with
+ *  BFM=intree. Each buffer pool is split into partitions which have their
+ *  own frames, hash table, replacement state and mutex; the replacement
+ *  policy (CLOCK, 2Q or LRU-K), the number of frames, the number of
+ *  partitions, the use of huge pages, the direct I/O of the volumes, the
+ *  background writer, the mmap read path and the asynchronous writes are
+ *  set with EduBfM_SetParameters(); a thread running a scan declares it
+ *  with EduBfM_SetAccessHint().
+ *
+ * Exports:
+ *  Four BfM_Init(void)
+ *  Four BfM_Final(void)
+ *  Four EduBfM_SetParameters(BfM_Parameters*)
+ *  Four EduBfM_GetParameters(BfM_Parameters*)
+ *  Four EduBfM_GetStatistics(BfM_Statistics*)
+ *  Four EduBfM_SetAccessHint(Four)
+ *  Four EduBfM_SetCompression(Four, char*)
+ *  Four EduBfM_GetCompressionStatistics(Four, BfM_CompressionStatistics*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "EduBfM.h"
+
+
+BufferInfo      edubfm_bufInfo[NUM_BUF_TYPES];
+BfM_Parameters  edubfm_params = { { BFM_NUM_PAGE_BUFS, BFM_NUM_LOT_LEAF_BUFS }, BFM_NUM_PARTITIONS, BFM_POLICY, BFM_HUGE_PAGES, BFM_DIRECT_IO,
+				  BFM_CLEAN_TARGET, BFM_WRITE_RATE, BFM_MMAP_READS, BFM_ASYNC_WRITES };
+pthread_mutex_t edubfm_ioMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t edubfm_writeMutex = PTHREAD_MUTEX_INITIALIZER;
+__thread Four   edubfm_accessHint = BFM_HINT_NORMAL;
+
+static Four bfmTrainSize[NUM_BUF_TYPES] = { PAGE_BUF_TRAIN_SIZE, LOT_LEAF_BUF_TRAIN_SIZE };
+
+
+
+/*@================================
+ * BfM_Init()
+ *================================*/
+/*
+ * Function: Four BfM_Init(void)
+ *
+ * Description:
+ *  Allocate the buffer pools with the current parameters and start the
+ *  background writer if it is requested.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four BfM_Init(void)
+{
+    Four e;			/* error */
+    Four type;			/* buffer type */
+
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+	e = edubfm_InitBufferInfo(type, bfmTrainSize[type], edubfm_params.nBufs[type], edubfm_params.nPartitions);
+	if (e < eNOERROR) {
+	    while (--type >= 0) (void) edubfm_FinalBufferInfo(type);
+	    ERR(e);
+	}
+    }
+
+    edubfm_StartWriter();
+
+    return(eNOERROR);
+
+} /* BfM_Init() */
+
+
+
+/*@================================
+ * BfM_Final()
+ *================================*/
+/*
+ * Function: Four BfM_Final(void)
+ *
+ * Description:
+ *  Stop the background writer, write out the dirty trains and free the
+ *  buffer pools, and unmap the mapped volumes.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four BfM_Final(void)
+{
+    Four e;			/* error */
+    Four type;			/* buffer type */
+    Four firstError;		/* first error met */
+
+
+    edubfm_StopWriter();
+
+    pthread_mutex_lock(&edubfm_writeMutex);
+    firstError = edubfm_UnmapVolumes(NIL);
+    pthread_mutex_unlock(&edubfm_writeMutex);
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+	e = edubfm_FinalBufferInfo(type);
+	if (e < eNOERROR && firstError == eNOERROR) firstError = e;
+    }
+
+    if (firstError < eNOERROR) ERR(firstError);
+
+    return(eNOERROR);
+
+} /* BfM_Final() */
+
+
+
+/*@================================
+ * EduBfM_SetParameters()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetParameters(BfM_Parameters*)
+ *
+ * Description:
+ *  Set the number of frames of each buffer type, the number of partitions,
+ *  the replacement policy, the backing of the frames (base pages or
+ *  huge pages, falling back to base pages) and the use of O_DIRECT for the
+ *  volumes, which applies at once to the volumes already mounted (see
+ *  edubfm_DirectIO.c), and the clean frames kept by the background writer
+ *  and its write rate (see edubfm_Writer.c), and the mmap read path, which
+ *  excludes O_DIRECT (see edubfm_Mmap.c), and the asynchronous writes of
+ *  the dirty trains (see edubfm_Writer.c). Called before the buffer manager is
+ *  initialized (i.e. before LRDS_Init()), the parameters are used by
+ *  BfM_Init(); called later, the dirty trains are written out and the
+ *  buffer pools are rebuilt, which requires that no train is fixed. The
+ *  statistics are reset in the latter case.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eFLUSHFIXEDBUF_BFM
+ *    some errors caused by function calls
+ */
+Four EduBfM_SetParameters(
+    BfM_Parameters *params)	/* IN new parameters */
+{
+    Four e;			/* error */
+    Four type;			/* buffer type */
+    Four i;			/* index */
+
+
+    /*@ parameter checking */
+    if (params == NULL) ERR(eBADPARAMETER);
+
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+	if (params->nBufs[type] < BFM_MIN_PARTITION_BUFS) ERR(eBADPARAMETER);
+
+    if (params->nPartitions < 1 || params->nPartitions > BFM_MAX_PARTITIONS) ERR(eBADPARAMETER);
+
+    if (params->policy != BFM_CLOCK && params->policy != BFM_2Q && params->policy != BFM_LRUK) ERR(eBADPARAMETER);
+
+    if (params->hugePages < BFM_HUGEPAGE_NONE || params->hugePages > BFM_HUGEPAGE_EXPLICIT) ERR(eBADPARAMETER);
+
+    if (params->directIO != TRUE && params->directIO != FALSE) ERR(eBADPARAMETER);
+
+    if (params->cleanTarget < 0 || params->writeRate < 0) ERR(eBADPARAMETER);
+
+    if (params->mmapReads != TRUE && params->mmapReads != FALSE) ERR(eBADPARAMETER);
+
+    if (params->mmapReads && params->directIO) ERR(eBADPARAMETER);
+
+    if (params->asyncWrites != TRUE && params->asyncWrites != FALSE) ERR(eBADPARAMETER);
+
+    /*@ not initialized yet */
+    if (edubfm_bufInfo[PAGE_BUF].bufTable == NULL) {
+	edubfm_params = *params;
+	edubfm_SetDirectIO(params->directIO);
+	return(eNOERROR);
+    }
+
+    /*@ rebuild the buffer pools */
+    edubfm_StopWriter();
+
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+	for (i = 0; i < BI_NBUFS(type); i++)
+	    if (BI_BUFTABLE_ENTRY(type, i)->fixed > 0) {
+		edubfm_StartWriter();
+		ERR(eFLUSHFIXEDBUF_BFM);
+	    }
+
+    pthread_mutex_lock(&edubfm_writeMutex);
+    e = edubfm_UnmapVolumes(NIL);
+    pthread_mutex_unlock(&edubfm_writeMutex);
+    if (e < eNOERROR) {
+	edubfm_StartWriter();
+	ERR(e);
+    }
+
+    e = BfM_Final();
+    if (e < eNOERROR) ERR(e);
+
+    edubfm_params = *params;
+    edubfm_SetDirectIO(params->directIO);
+
+    e = BfM_Init();
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduBfM_SetParameters() */
+
+
+
+/*@================================
+ * EduBfM_GetParameters()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetParameters(BfM_Parameters*)
+ *
+ * Description:
+ *  Return the current parameters of the buffer manager.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four EduBfM_GetParameters(
+    BfM_Parameters *params)	/* OUT current parameters */
+{
+    if (params == NULL) ERR(eBADPARAMETER);
+
+    *params = edubfm_params;
+
+    return(eNOERROR);
+
+} /* EduBfM_GetParameters() */
+
+
+
+/*@================================
+ * EduBfM_GetStatistics()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetStatistics(BfM_Statistics*)
+ *
+ * Description:
+ *  Return the statistics of all buffer types since the buffer pools were
+ *  built.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four EduBfM_GetStatistics(
+    BfM_Statistics *stats)	/* OUT statistics */
+{
+    Four type;			/* buffer type */
+    Four p;			/* partition index */
+    BufferPartition *part;	/* a partition */
+
+
+    if (stats == NULL) ERR(eBADPARAMETER);
+
+    memset(stats, 0, sizeof(BfM_Statistics));
+    stats->hugePages = edubfm_bufInfo[PAGE_BUF].hugePages;
+    edubfm_GetDirectIOStatistics(&stats->nDirectIOs, &stats->nBufferedIOs);
+    edubfm_GetWriterStatistics(&stats->nBgWrites, &stats->nRuns, &stats->nAsyncWrites);
+    edubfm_GetMapStatistics(&stats->nMappedFixes, &stats->nMappedWrites);
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+	for (p = 0; p < BI_NPARTITIONS(type); p++) {
+	    part = BI_PARTITION(type, p);
+	    pthread_mutex_lock(&part->mutex);
+	    stats->nFixes += part->stats.nFixes;
+	    stats->nHits += part->stats.nHits;
+	    stats->nReads += part->stats.nReads;
+	    stats->nWrites += part->stats.nWrites;
+	    stats->nEvictions += part->stats.nEvictions;
+	    pthread_mutex_unlock(&part->mutex);
+	}
+    }
+
+    return(eNOERROR);
+
+} /* EduBfM_GetStatistics() */
+
+
+
+/*@================================
+ * EduBfM_SetAccessHint()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetAccessHint(Four)
+ *
+ * Description:
+ *  Set the access hint of the calling thread. Under BFM_HINT_SEQUENTIAL,
+ *  the trains loaded are cold: they are not referenced for the
+ *  replacement policy, not remembered as ghosts when evicted, and once the
+ *  scan ring of their partition holds BFM_SCAN_RING frames, the next cold
+ *  train of the partition takes the frame of the oldest one. Fixes of
+ *  trains already in the buffer are not recorded either. A cold train
+ *  fixed later under BFM_HINT_NORMAL becomes an ordinary one. So a scan
+ *  larger than the buffer pool does not flush the trains of the other
+ *  accesses.
+ *
+ * Returns:
+ *  the previous hint, or an error code
+ *    eBADPARAMETER
+ */
+Four EduBfM_SetAccessHint(
+    Four hint)			/* IN BFM_HINT_NORMAL or BFM_HINT_SEQUENTIAL */
+{
+    Four prevHint;		/* hint replaced */
+
+
+    if (hint != BFM_HINT_NORMAL && hint != BFM_HINT_SEQUENTIAL) ERR(eBADPARAMETER);
+
+    prevHint = edubfm_accessHint;
+    edubfm_accessHint = hint;
+
+    return(prevHint);
+
+} /* EduBfM_SetAccessHint() */
+
+
+
+/*@================================
+ * EduBfM_SetCompression()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetCompression(Four, char*)
+ *
+ * Description:
+ *  Give the mounted volume 'volNo' the compressed page store 'storeName',
+ *  created if it does not exist, so that its data pages are kept
+ *  compressed from then on (see edubfm_Compress.c); the volume is
+ *  unmapped if the mmap read path mapped it. The store of a volume is not
+ *  remembered by the volume: it is given again after each mount of the
+ *  volume, before its pages are used, and closed by BfM_Dismount(). With
+ *  'storeName' NULL, the pages of the store of the volume are written back
+ *  to their home and the store is removed.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    some errors caused by function calls
+ */
+Four EduBfM_SetCompression(
+    Four volNo,			/* IN mounted volume */
+    char *storeName)		/* IN file name of the store, NULL for none */
+{
+    Four e;			/* error */
+
+
+    /* no train is being written out meanwhile */
+    pthread_mutex_lock(&edubfm_writeMutex);
+
+    pthread_mutex_lock(&edubfm_ioMutex);
+    e = (storeName != NULL) ? edubfm_AttachStore(volNo, storeName) : edubfm_DetachStore(volNo, TRUE);
+    pthread_mutex_unlock(&edubfm_ioMutex);
+
+    /* a volume with a store is never mapped again */
+    if (e >= eNOERROR && storeName != NULL) e = edubfm_UnmapVolumes(volNo);
+
+    pthread_mutex_unlock(&edubfm_writeMutex);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduBfM_SetCompression() */
+
+
+
+/*@================================
+ * EduBfM_GetCompressionStatistics()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetCompressionStatistics(Four, BfM_CompressionStatistics*)
+ *
+ * Description:
+ *  Return the statistics of the compressed page store of the volume
+ *  'volNo' since it was given its store.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four EduBfM_GetCompressionStatistics(
+    Four volNo,			/* IN volume with a store */
+    BfM_CompressionStatistics *stats) /* OUT statistics of the store */
+{
+    Four e;			/* error */
+
+
+    pthread_mutex_lock(&edubfm_ioMutex);
+    e = edubfm_GetStoreStatistics(volNo, stats);
+    pthread_mutex_unlock(&edubfm_ioMutex);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduBfM_GetCompressionStatistics() */
@@ -0,0 +1,125 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_RemoveTrain.c
+ *
+ * Description:
+ *  Drop a train from the buffer.
+ *
+ * Exports:
+ *  Four BfM_RemoveTrain(TrainID*, Four, Boolean)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM.h"
+
+
+
+/*@================================
+ * BfM_RemoveTrain()
+ *================================*/
+/*
+ * Function: Four BfM_RemoveTrain(TrainID*, Four, Boolean)
+ *
+ * Description:
+ *  Drop the train 'trainId' from the buffer, fixed or not. If 'flushFlag'
+ *  is TRUE and the train is dirty, it is written out first. Nothing is
+ *  done if the train is not in the buffer.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM
+ *    some errors caused by function calls
+ */
+Four BfM_RemoveTrain(
+    TrainID *trainId,		/* IN train to drop */
+    Four type,			/* IN buffer type */
+    Boolean flushFlag)		/* IN TRUE to write out the train if it is dirty */
+{
+    Four e;			/* error */
+    Four index;			/* frame index */
+    BufferPartition *part;	/* partition of the train */
+
+
+    /*@ parameter checking */
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    part = BI_PARTITION_OF(type, trainId);
+    pthread_mutex_lock(&edubfm_writeMutex);
+
+    if (edubfm_params.mmapReads && type == PAGE_BUF) {
+	e = edubfm_DropMapped(trainId, NULL, flushFlag);
+	if (e != BFM_NOT_MAPPED) {
+	    pthread_mutex_unlock(&edubfm_writeMutex);
+	    if (e < eNOERROR) ERR(e);
+	    return(eNOERROR);
+	}
+    }
+
+    pthread_mutex_lock(&part->mutex);
+
+    index = edubfm_LookUp(trainId, type);
+    if (index == NIL) {
+	pthread_mutex_unlock(&part->mutex);
+	pthread_mutex_unlock(&edubfm_writeMutex);
+	return(eNOERROR);
+    }
+
+    e = (flushFlag && (BI_BUFTABLE_ENTRY(type, index)->bits & BFM_DIRTY)) ? edubfm_FlushTrain(type, index) : eNOERROR;
+    if (e >= eNOERROR) e = edubfm_ReleaseTrain(type, part, index);
+
+    pthread_mutex_unlock(&part->mutex);
+    pthread_mutex_unlock(&edubfm_writeMutex);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* BfM_RemoveTrain() */
@@ -0,0 +1,108 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_SetDirty.c
+ *
+ * Description:
+ *  Mark a train as modified.
+ *
+ * Exports:
+ *  Four BfM_SetDirty(TrainID*, Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM.h"
+
+
+
+/*@================================
+ * BfM_SetDirty()
+ *================================*/
+/*
+ * Function: Four BfM_SetDirty(TrainID*, Four)
+ *
+ * Description:
+ *  Set the dirty bit of the train 'trainId', so that it is written out
+ *  before its frame is reused. The train is fixed by the caller, so it is
+ *  looked up without the mutex of its partition as in BfM_FreeTrain().
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM
+ *    eNOTFOUND_BFM
+ */
+Four BfM_SetDirty(
+    TrainID *trainId,		/* IN modified train */
+    Four type)			/* IN buffer type */
+{
+    Four index;			/* frame index */
+    BufferPartition *part;	/* partition of the train */
+
+
+    /*@ parameter checking */
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    if (edubfm_params.mmapReads && type == PAGE_BUF && edubfm_SetDirtyMapped(trainId) != BFM_NOT_MAPPED) return(eNOERROR);
+
+    part = BI_PARTITION_OF(type, trainId);
+
+    index = edubfm_LockFreeLookUp(trainId, type);
+    if (index == NIL) {
+	pthread_mutex_lock(&part->mutex);
+	index = edubfm_LookUp(trainId, type);
+	pthread_mutex_unlock(&part->mutex);
+	if (index == NIL) ERR(eNOTFOUND_BFM);
+    }
+
+    BFM_SET_BITS(BI_BUFTABLE_ENTRY(type, index), BFM_DIRTY);
+
+    return(eNOERROR);
+
+} /* BfM_SetDirty() */
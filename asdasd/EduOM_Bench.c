@@ -0,0 +1,2862 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Bench.c
+ *
+ * Description :
+ *  Benchmark driver of EduOM.
+ *  A volume is formatted and filled with a file of small objects, and the
+ *  benchmarks given on the command line (all if none is given) are run on
+ *  the file. Each benchmark reports the elapsed time of its variants.
+ *
+ *  usage: EduOM_Bench [benchmark ...]
+ */
+
+
+#define _FILE_OFFSET_BITS 64
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "EduOM_common.h"
+#include "EduOM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_TestModule.h"
+#include "EduBfM.h"
+#include "RDsM.h"
+
+
+#define BENCH_VOLUME        "bench.vol"
+#define BENCH_NUM_PAGES     20000       /* # of pages of the benchmark volume */
+#define BENCH_NUM_OBJECTS   100000      /* # of objects in the benchmark file */
+#define BENCH_OBJECT_SIZE   200         /* size of an object */
+#define BENCH_NUM_TAGS      16          /* objects are tagged round-robin */
+#define BENCH_RA_THREADS    4           /* # of read-ahead worker threads */
+#define BENCH_NUM_LOOKUPS   20000       /* # of random objects read by multiget */
+#define BENCH_LOOKUP_BATCH  500         /* # of objects read at once by multiget */
+#define BENCH_HOT_OBJECTS   1000        /* # of hot objects read by objcache */
+#define BENCH_CACHE_BUDGET  (1024*1024) /* memory budget of the object cache */
+#define BENCH_LOAD_OBJECTS  20000       /* # of objects created by bfmload */
+#define BENCH_ZIPF_READS    200000      /* # of objects read by bfmzipf */
+#define BENCH_ZIPF_SKEW     0.99        /* skew of the Zipf distribution of bfmzipf */
+#define BENCH_HOT_READS     20000       /* # of hot objects read between the scans of bfmscan */
+#define BENCH_HOT_PERCENT   5           /* share of the file read by the hot reads of bfmscan */
+#define BENCH_SCAN_ROUNDS   4           /* # of scans of bfmscan */
+#define BENCH_HIT_PAGES     1000        /* # of buffered pages fixed by bfmhit */
+#define BENCH_HIT_FIXES     1000000     /* # of fixes per thread of bfmhit */
+#define BENCH_MAX_THREADS   8           /* maximum # of threads of bfmhit */
+#define BENCH_HUGE_BUFS     8192        /* # of page frames of hugepages, enough for the file */
+#define BENCH_HUGE_SCANS    4           /* # of warm scans of hugepages */
+#define BENCH_HUGE_ROUNDS   7           /* # of rounds of hugepages, each timing every backing */
+#define BENCH_DIRECT_READS  20000       /* # of random objects read by directio */
+#define BENCH_WRITER_BUFS   500         /* # of page frames of bgwriter */
+#define BENCH_WRITER_UPDATES 50000      /* # of random objects updated by bgwriter */
+#define BENCH_CLEAN_TARGET  250         /* clean frames kept by the background writer in bgwriter */
+#define BENCH_WRITE_RATE    5000        /* trains per second of the rate-limited background writer */
+#define BENCH_SCANMIX_BUFS  1000        /* # of page frames of scanmix, less than the file */
+#define BENCH_MMAP_READS    200000      /* # of random objects read by mmapread */
+#define BENCH_MMAP_UPDATES  10000       /* # of random objects updated by mmapread */
+#define BENCH_MAP_BITS      ((PAGESIZE - RDSM_PAGEMAP_HDR_SIZE) * 8) /* # of pages of a page map page */
+#define BENCH_MAP_SEARCHES  20000       /* # of searches of a whole page map page by pagemap */
+#define BENCH_MAP_EXT_OPS   2000000     /* # of operations on an extent by pagemap */
+#define BENCH_MAP_EXT_SIZE  16          /* # of pages of an extent of pagemap */
+#define BENCH_MAP_FREE      10          /* percentage of free pages of pagemap */
+#define BENCH_IO_UPDATES    5000        /* # of objects updated and flushed by iouring */
+#define BENCH_MAX_DEVICES   4           /* maximum # of devices of a volume of devices */
+#define BENCH_DEV_PAGES     12000       /* # of pages of a volume of devices, over all its devices */
+#define BENCH_DEV_OBJECTS   50000       /* # of objects in the file of a volume of devices */
+#define BENCH_DEV_VOLUME    2000        /* volume number of the volumes of devices, plus their # of devices */
+#define BENCH_LZ_PAGES      12000       /* # of pages of the volumes of compress */
+#define BENCH_LZ_OBJECTS    50000       /* # of objects in the file of a volume of compress */
+#define BENCH_LZ_VOLUME     3000        /* volume number of the plain volume of compress, plus 1 for the compressed one */
+#define BENCH_FMT_MIN_PAGES 4096        /* # of pages of the smallest volume of format */
+#define BENCH_FMT_MAX_PAGES (256*1024)  /* # of pages of the largest volume of format */
+#define BENCH_FMT_VOLUME    4000        /* volume number of the volumes of format */
+
+Four sm_GetCatalogEntryFromDataFileId(Four, FileID*, ObjectID*);
+Four SM_CreateFile(Four, FileID*, Boolean, void*);
+
+static char *benchDevNames[1] = { BENCH_VOLUME };
+static char **benchDropNames = benchDevNames;	/* devices whose pages bench_DropCaches() drops */
+static Four benchDropNumDevices = 1;	/* # of devices of 'benchDropNames' */
+static XactID benchXactId;		/* transaction of the benchmarks */
+static Four benchNumFixes = 0;		/* # of BfM_GetTrain() calls made by EduOM */
+
+Four __real_BfM_GetTrain(TrainID*, char**, Four);
+
+/* I/O counters of the disk manager */
+extern Four io_num_of_reads;
+extern Four io_num_of_writes;
+
+/* defined only when the bench is linked with the in-tree buffer manager */
+#pragma weak EduBfM_SetParameters
+#pragma weak EduBfM_GetParameters
+#pragma weak EduBfM_GetStatistics
+#pragma weak EduBfM_SetCompression
+#pragma weak EduBfM_GetCompressionStatistics
+
+/* defined only when the bench is linked with the in-tree extent allocation */
+#pragma weak cosmos_RDsM_alloc_ext
+Four cosmos_RDsM_alloc_ext(RDsM_VolTableEntry*, Four, Four*);
+#pragma weak EduRDsM_SetInitExt
+
+/*
+ * Typedef for a file of the benchmarks
+ */
+typedef struct {
+    Four volId;				/* volume of the file */
+    ObjectID catalogEntry;		/* catalog object of the file */
+    ObjectID *oids;			/* objects of the file, in the order of the file */
+    Four nObjects;			/* # of objects of the file */
+} bench_File;
+
+/*
+ * Typedef for the argument of a thread of bfmhit
+ */
+typedef struct {
+    PageID *pids;			/* buffered pages */
+    Four nPids;				/* # of buffered pages */
+    unsigned int seed;			/* seed of the random page choice */
+    Four error;				/* first error met */
+} bench_HitArg;
+
+static double bench_Now(void);
+static Four bench_DropCaches(void);
+static Four bench_CreateFile(Four, Four, char, Boolean, bench_File*);
+static Four bench_ScanAll(ObjectID*, Four, Four*, double*);
+static Four bench_RandomReads(bench_File*, Four, double*);
+static Four bench_RandomUpdates(bench_File*, Four);
+static Four bench_UseEduBfM(char*, BfM_Parameters*);
+static Four bench_OnVolume(Four, Four, char**, Four*, Four (*)(Four, Four, char**), Four);
+static Four bench_ColdScan(bench_File*);
+static Four bench_ChecksumObject(ObjectID*, Object*, void*);
+static Four bench_ParallelScan(bench_File*);
+static Four bench_FilterScan(bench_File*);
+static Four bench_ZoneMap(bench_File*);
+static Four bench_ScanRead(bench_File*);
+static Four bench_MultiGet(bench_File*);
+static Four bench_PinRead(bench_File*);
+static Four bench_Fields(bench_File*);
+static Four bench_ObjectCache(bench_File*);
+static Four bench_CompareBfM(bench_File*, Four (*)(bench_File*, Four*));
+static Four bench_BfMLoadWork(bench_File*, Four*);
+static Four bench_BfMZipfWork(bench_File*, Four*);
+static Four bench_BfMScanWork(bench_File*, Four*);
+static Four bench_BfMLoad(bench_File*);
+static Four bench_BfMZipf(bench_File*);
+static Four bench_BfMScan(bench_File*);
+static void *bench_HitWorker(void*);
+static Four bench_BfMHit(bench_File*);
+static int bench_OpenTLBCounter(void);
+static int bench_CompareTimes(const void*, const void*);
+static Four bench_HugePages(bench_File*);
+static Four bench_CachedPages(void);
+static Four bench_DirectIO(bench_File*);
+static Four bench_BgWriter(bench_File*);
+static Four bench_ScanMix(bench_File*);
+static Four bench_MmapRead(bench_File*);
+static Four bench_PageMap(bench_File*);
+static Four bench_IOUring(bench_File*);
+static Four bench_FlushUpdates(bench_File*, Four, Four, Four);
+static Four bench_Devices(bench_File*);
+static Four bench_DevicesWork(Four, Four, char**);
+static Four bench_Compress(bench_File*);
+static Four bench_CompressWork(Four, Four, char**);
+static Four bench_Format(bench_File*);
+
+/*
+ * Table of benchmarks
+ */
+static struct {
+    char *name;				/* name given on the command line */
+    Four (*run)(bench_File*);		/* benchmark on the file of the volume */
+} benchmarks[] = {
+    { "coldscan", bench_ColdScan },
+    { "parallelscan", bench_ParallelScan },
+    { "filterscan", bench_FilterScan },
+    { "zonemap", bench_ZoneMap },
+    { "scanread", bench_ScanRead },
+    { "multiget", bench_MultiGet },
+    { "pinread", bench_PinRead },
+    { "fields", bench_Fields },
+    { "objcache", bench_ObjectCache },
+    { "bfmload", bench_BfMLoad },
+    { "bfmzipf", bench_BfMZipf },
+    { "bfmscan", bench_BfMScan },
+    { "bfmhit", bench_BfMHit },
+    { "hugepages", bench_HugePages },
+    { "directio", bench_DirectIO },
+    { "bgwriter", bench_BgWriter },
+    { "scanmix", bench_ScanMix },
+    { "mmapread", bench_MmapRead },
+    { "pagemap", bench_PageMap },
+    { "iouring", bench_IOUring },
+    { "devices", bench_Devices },
+    { "compress", bench_Compress },
+    { "format", bench_Format },
+};
+
+#define NUM_BENCHMARKS ((Four)(sizeof(benchmarks) / sizeof(benchmarks[0])))
+
+
+
+Four main(int argc, char **argv)
+{
+    Four	e;				/* for errors */
+    Four	i, j;				/* loop index */
+    Four	handle;				/* system handle */
+    Four	volId;				/* volume identifier */
+    Four	numPagesInDevices[1];		/* # of pages in the device */
+    bench_File	file;				/* file of the benchmarks */
+
+
+    e = LRDS_Init();
+    if (e < eNOERROR) {
+	printf("LRDS_Init failed!!!\n");
+	exit(1);
+    }
+
+    e = LRDS_AllocHandle(&handle);
+    if (e < eNOERROR) {
+	printf("LRDS_AllocHandle failed!!!\n");
+	LRDS_Final();
+	exit(1);
+    }
+
+    volId = 1000;
+    numPagesInDevices[0] = BENCH_NUM_PAGES;
+    e = LRDS_FormatDataVolume(1, benchDevNames, "bench", volId, 16, numPagesInDevices, 16);
+    if (e < eNOERROR) {
+	printf("LRDS_FormatDataVolume failed!!!\n");
+	LRDS_FreeHandle(handle);
+	LRDS_Final();
+	exit(1);
+    }
+
+    e = LRDS_Mount(1, benchDevNames, &volId);
+    if (e < eNOERROR) {
+	printf("LRDS_Mount failed!!!\n");
+	LRDS_FreeHandle(handle);
+	LRDS_Final();
+	exit(1);
+    }
+
+    e = LRDS_BeginTransaction(&benchXactId, X_RR_RR);
+    if (e < eNOERROR) goto fail;
+
+    /* build the file */
+    e = bench_CreateFile(volId, BENCH_NUM_OBJECTS, 'x', FALSE, &file);
+    if (e < eNOERROR) goto fail;
+    printf("%d objects of %d bytes are created\n", BENCH_NUM_OBJECTS, BENCH_OBJECT_SIZE);
+
+    /* run the benchmarks */
+    for (i = 0; i < NUM_BENCHMARKS; i++) {
+	if (argc > 1) {
+	    for (j = 1; j < argc; j++)
+		if (strcmp(argv[j], benchmarks[i].name) == 0) break;
+	    if (j == argc) continue;
+	}
+	printf("\n[%s]\n", benchmarks[i].name);
+	e = benchmarks[i].run(&file);
+	if (e < eNOERROR) { free(file.oids); goto fail; }
+    }
+    free(file.oids);
+
+    e = LRDS_CommitTransaction(&benchXactId);
+    if (e < eNOERROR) goto fail;
+
+    LRDS_Dismount(volId);
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+    unlink(BENCH_VOLUME);
+
+    return 0;
+
+fail:
+    printf("EduOM_Bench failed!!! (error = %ld)\n", (long)e);
+    EduOM_FinalReadAhead();
+    LRDS_Dismount(volId);
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+    unlink(BENCH_VOLUME);
+    exit(1);
+}
+
+
+
+/*
+ * Function: Four __wrap_BfM_GetTrain(TrainID*, char**, Four)
+ *
+ * Description:
+ *  Count the page fixes of EduOM; the bench is linked with
+ *  --wrap=BfM_GetTrain.
+ */
+Four __wrap_BfM_GetTrain(
+    TrainID *trainId,		/* IN train to fix */
+    char **retBuf,		/* OUT buffer holding the train */
+    Four type)			/* IN buffer type */
+{
+    benchNumFixes++;
+
+    return(__real_BfM_GetTrain(trainId, retBuf, type));
+
+} /* __wrap_BfM_GetTrain() */
+
+
+
+/*
+ * Function: double bench_Now(void)
+ *
+ * Description:
+ *  Return the current time in milliseconds.
+ */
+static double bench_Now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return(tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0);
+
+} /* bench_Now() */
+
+
+
+/*
+ * Function: Four bench_DropCaches(void)
+ *
+ * Description:
+ *  Write out and discard all buffered pages, and drop the pages of the
+ *  volume from the OS page cache, so that the next access reads the disk.
+ *  The volume is the benchmark volume, or the volume being measured by
+ *  bench_OnVolume().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_DropCaches(void)
+{
+    Four e;			/* error */
+    Four i;			/* index of the devices */
+    int fd;			/* descriptor of the device */
+
+
+    e = BfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; i < benchDropNumDevices; i++) {
+	fd = open(benchDropNames[i], O_RDONLY);
+	if (fd >= 0) {
+	    fdatasync(fd);
+	    (void) posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+	    close(fd);
+	}
+    }
+
+    return(eNOERROR);
+
+} /* bench_DropCaches() */
+
+
+
+/*
+ * Function: Four bench_CreateFile(Four, Four, char, Boolean, bench_File*)
+ *
+ * Description:
+ *  Create a file of 'nObjects' objects in the mounted volume 'volId'. The
+ *  objects hold BENCH_OBJECT_SIZE bytes of 'fill', or the strings of
+ *  EduOM_Test if 'fill' is 0, and are tagged round-robin or, if
+ *  'clustered', by runs of nObjects / BENCH_NUM_TAGS objects. The objects
+ *  are returned in file->oids, allocated with malloc().
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four bench_CreateFile(
+    Four volId,			/* IN mounted volume */
+    Four nObjects,		/* IN # of objects to create */
+    char fill,			/* IN byte of the objects, 0 for the strings of EduOM_Test */
+    Boolean clustered,		/* IN TRUE to cluster the tags */
+    bench_File *file)		/* OUT the file */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four length;		/* length of an object */
+    FileID fid;			/* file identifier */
+    ObjectHdr objHdr;		/* header of the object to insert */
+    char data[BENCH_OBJECT_SIZE]; /* object to insert */
+
+
+    file->volId = volId;
+    file->nObjects = 0;
+    file->oids = (ObjectID *)malloc(nObjects * sizeof(ObjectID));
+    if (file->oids == NULL) ERR(eMEMORYALLOCERR);
+
+    e = SM_CreateFile(volId, &fid, FALSE, NULL);
+    if (e < eNOERROR) { free(file->oids); ERR(e); }
+    for (i = 0; smMountTable[i].volId != volId; i++) ;
+    e = sm_GetCatalogEntryFromDataFileId(i, &fid, &file->catalogEntry);
+    if (e < eNOERROR) { free(file->oids); ERR(e); }
+
+    memset(data, fill, BENCH_OBJECT_SIZE);
+    length = BENCH_OBJECT_SIZE;
+    objHdr.properties = 0;
+    for (i = 0; i < nObjects; i++) {
+	objHdr.tag = clustered ? i / (nObjects / BENCH_NUM_TAGS) : i % BENCH_NUM_TAGS;
+	if (fill == 0) length = sprintf(data, "EduOM_TestModule_OBJECT_NUM_%ld", (long)i);
+	e = EduOM_CreateObject(&file->catalogEntry, (i == 0) ? NULL : &file->oids[i-1], &objHdr,
+			       length, data, &file->oids[i]);
+	if (e < eNOERROR) { free(file->oids); ERR(e); }
+    }
+    file->nObjects = nObjects;
+
+    return(eNOERROR);
+
+} /* bench_CreateFile() */
+
+
+
+/*
+ * Function: Four bench_ScanAll(ObjectID*, Four, Four*, double*)
+ *
+ * Description:
+ *  Scan the whole file with EduOM_NextObject() (useCursor == FALSE) or the
+ *  scan cursor (useCursor == TRUE), and return the number of objects and,
+ *  if 'elapsed' is not NULL, the time of the scan.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_ScanAll(
+    ObjectID *catalogEntry,	/* IN catalog object of the file */
+    Four useCursor,		/* IN TRUE to use the scan cursor */
+    Four *nObjects,		/* OUT # of objects scanned */
+    double *elapsed)		/* OUT time of the scan in milliseconds, or NULL */
+{
+    Four e;			/* error */
+    ObjectID oid;		/* current object */
+    OM_ScanCursor cursor;	/* scan cursor */
+    double start;		/* start time */
+
+
+    *nObjects = 0;
+    start = bench_Now();
+
+    if (useCursor) {
+	e = EduOM_OpenScan(catalogEntry, FORWARD, &cursor);
+	if (e < eNOERROR) ERR(e);
+	while ((e = EduOM_ScanNext(&cursor, &oid, NULL)) != EOS) {
+	    if (e < eNOERROR) ERR(e);
+	    (*nObjects)++;
+	}
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+    }
+    else {
+	e = EduOM_NextObject(catalogEntry, NULL, &oid, NULL);
+	while (e != EOS) {
+	    if (e < eNOERROR) ERR(e);
+	    (*nObjects)++;
+	    e = EduOM_NextObject(catalogEntry, &oid, &oid, NULL);
+	}
+    }
+
+    if (elapsed != NULL) *elapsed = bench_Now() - start;
+
+    return(eNOERROR);
+
+} /* bench_ScanAll() */
+
+
+
+/*
+ * Function: Four bench_RandomReads(bench_File*, Four, double*)
+ *
+ * Description:
+ *  Read 'nReads' objects of the file drawn at random, the same ones at
+ *  each call, and return the time of the reads if 'elapsed' is not NULL.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_RandomReads(
+    bench_File *file,		/* IN the file */
+    Four nReads,		/* IN # of objects to read */
+    double *elapsed)		/* OUT time of the reads in milliseconds, or NULL */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    char data[BENCH_OBJECT_SIZE]; /* data of an object */
+    double start;		/* start time */
+
+
+    srand(1);
+    start = bench_Now();
+
+    for (i = 0; i < nReads; i++) {
+	e = EduOM_ReadObject(&file->oids[rand() % file->nObjects], 0, REMAINDER, data);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    if (elapsed != NULL) *elapsed = bench_Now() - start;
+
+    return(eNOERROR);
+
+} /* bench_RandomReads() */
+
+
+
+/*
+ * Function: Four bench_RandomUpdates(bench_File*, Four)
+ *
+ * Description:
+ *  Overwrite the first bytes of 'nUpdates' objects of the file drawn at
+ *  random, the same ones at each call, with the number of the update.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_RandomUpdates(
+    bench_File *file,		/* IN the file */
+    Four nUpdates)		/* IN # of objects to update */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    OM_IOVec iov;		/* update of an object */
+
+
+    srand(1);
+
+    for (i = 0; i < nUpdates; i++) {
+	iov.start = 0;
+	iov.length = sizeof(Four);
+	iov.buf = (char *)&i;
+	e = EduOM_WriteObjectV(&file->oids[rand() % file->nObjects], 1, &iov);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* bench_RandomUpdates() */
+
+
+
+/*
+ * Function: Four bench_UseEduBfM(char*, BfM_Parameters*)
+ *
+ * Description:
+ *  Check that the bench is linked with the in-tree buffer manager, and
+ *  return its parameters in 'saved' if 'saved' is not NULL, to be
+ *  restored at the end of the benchmark. Otherwise, print that the part
+ *  of the benchmark named by 'what' requires it.
+ *
+ * Returns:
+ *  TRUE if the in-tree buffer manager is linked, FALSE if not, or an
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_UseEduBfM(
+    char *what,			/* IN part of the benchmark, printed before the message */
+    BfM_Parameters *saved)	/* OUT parameters of the buffer manager, or NULL */
+{
+    Four e;			/* error */
+
+
+    if (EduBfM_SetParameters == NULL) {
+	printf("%srequires the in-tree buffer manager (make BFM=intree)\n", what);
+	return(FALSE);
+    }
+
+    if (saved != NULL) {
+	e = EduBfM_GetParameters(saved);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    return(TRUE);
+
+} /* bench_UseEduBfM() */
+
+
+
+/*
+ * Function: Four bench_OnVolume(Four, Four, char**, Four*, Four (*)(Four, Four, char**), Four)
+ *
+ * Description:
+ *  Format the volume 'volNo' of the given devices and mount it outside
+ *  the transaction of the benchmarks, which is committed first and
+ *  restarted at the end, run 'work' on it in a transaction of its own,
+ *  with bench_DropCaches() dropping its devices, and dismount it. The
+ *  devices are removed by the caller.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_OnVolume(
+    Four volNo,			/* IN volume number */
+    Four numDevices,		/* IN # of devices of the volume */
+    char **devNames,		/* IN device names */
+    Four *numPagesInDevices,	/* IN # of pages of each device */
+    Four (*work)(Four, Four, char**), /* IN work on the mounted volume, given 'arg' and the devices */
+    Four arg)			/* IN argument of 'work' */
+{
+    Four e, e2;			/* error */
+    XactID xactId;		/* transaction of the volume */
+
+
+    e = LRDS_CommitTransaction(&benchXactId);
+    if (e < eNOERROR) ERR(e);
+
+    e = LRDS_FormatDataVolume(numDevices, devNames, "bench", volNo, 16, numPagesInDevices, 16);
+    if (e >= eNOERROR) e = LRDS_Mount(numDevices, devNames, &volNo);
+    if (e >= eNOERROR) {
+	e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+	if (e >= eNOERROR) {
+	    benchDropNames = devNames;
+	    benchDropNumDevices = numDevices;
+	    e = work(volNo, arg, devNames);
+	    benchDropNames = benchDevNames;
+	    benchDropNumDevices = 1;
+
+	    /* the volume is not logged, so its transaction is not aborted */
+	    e2 = LRDS_CommitTransaction(&xactId);
+	    if (e >= eNOERROR) e = e2;
+	}
+
+	e2 = LRDS_Dismount(volNo);
+	if (e >= eNOERROR) e = e2;
+    }
+
+    e2 = LRDS_BeginTransaction(&benchXactId, X_RR_RR);
+    if (e >= eNOERROR) e = e2;
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_OnVolume() */
+
+
+
+/*
+ * Function: Four bench_ColdScan(bench_File*)
+ *
+ * Description:
+ *  Full scans on a cold cache, without and with the read-ahead.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_ColdScan(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four useCursor;		/* TRUE to use the scan cursor */
+    Four readAhead;		/* TRUE to use the read-ahead */
+    Four nObjects;		/* # of objects scanned */
+    Four nRequests, nPages;	/* read-ahead statistics */
+    double elapsed;		/* time of a scan */
+
+
+    for (useCursor = FALSE; useCursor <= TRUE; useCursor++) {
+	for (readAhead = FALSE; readAhead <= TRUE; readAhead++) {
+	    e = bench_DropCaches();
+	    if (e < eNOERROR) ERR(e);
+
+	    if (readAhead) {
+		e = EduOM_InitReadAhead(file->volId, 1, benchDevNames, BENCH_RA_THREADS);
+		if (e < eNOERROR) ERR(e);
+	    }
+
+	    e = bench_ScanAll(&file->catalogEntry, useCursor, &nObjects, &elapsed);
+	    if (e < eNOERROR) ERR(e);
+
+	    printf("%-16s read-ahead %-3s : %8.2f ms, %d objects",
+		   useCursor ? "EduOM_ScanNext" : "EduOM_NextObject",
+		   readAhead ? "on" : "off", elapsed, nObjects);
+
+	    if (readAhead) {
+		EduOM_GetReadAheadStatistics(&nRequests, &nPages);
+		printf(", %d requests, %d pages read ahead", nRequests, nPages);
+		EduOM_FinalReadAhead();
+	    }
+	    printf("\n");
+	}
+    }
+
+    return(eNOERROR);
+
+} /* bench_ColdScan() */
+
+
+
+/*
+ * Function: Four bench_ChecksumObject(ObjectID*, Object*, void*)
+ *
+ * Description:
+ *  Callback of EduOM_ParallelScan() which adds up the bytes of the object.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+static Four bench_ChecksumObject(
+    ObjectID *oid,		/* IN object visited, not used */
+    Object *obj,		/* IN the object */
+    void *arg)			/* INOUT checksum */
+{
+    Four i;			/* index */
+    UFour sum = 0;		/* checksum of the object */
+
+    (void)oid;
+
+    for (i = 0; i < obj->header.length; i++) sum = sum * 31 + (unsigned char)obj->data[i];
+    __sync_fetch_and_add((UFour *)arg, sum);
+
+    return(eNOERROR);
+
+} /* bench_ChecksumObject() */
+
+
+
+/*
+ * Function: Four bench_ParallelScan(bench_File*)
+ *
+ * Description:
+ *  Full scans with EduOM_ParallelScan() on 1 to 8 threads, on a warm and
+ *  on a cold cache (with the read-ahead).
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_ParallelScan(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four cold;			/* TRUE to start on a cold cache */
+    Four nThreads;		/* # of worker threads */
+    UFour sum;			/* checksum of the file */
+    double start;		/* start time */
+
+
+    for (cold = FALSE; cold <= TRUE; cold++) {
+	for (nThreads = 1; nThreads <= 8; nThreads *= 2) {
+	    if (cold) {
+		e = bench_DropCaches();
+		if (e < eNOERROR) ERR(e);
+		e = EduOM_InitReadAhead(file->volId, 1, benchDevNames, BENCH_RA_THREADS);
+		if (e < eNOERROR) ERR(e);
+	    }
+	    else {
+		/* warm up the buffer */
+		e = EduOM_ParallelScan(&file->catalogEntry, 1, bench_ChecksumObject, &sum);
+		if (e < eNOERROR) ERR(e);
+	    }
+
+	    sum = 0;
+	    start = bench_Now();
+	    e = EduOM_ParallelScan(&file->catalogEntry, nThreads, bench_ChecksumObject, &sum);
+	    if (e < eNOERROR) ERR(e);
+
+	    printf("%s cache, %d thread(s) : %8.2f ms, checksum %08x\n",
+		   cold ? "cold" : "warm", nThreads, bench_Now() - start, sum);
+
+	    if (cold) EduOM_FinalReadAhead();
+	}
+    }
+
+    return(eNOERROR);
+
+} /* bench_ParallelScan() */
+
+
+
+/*
+ * Function: Four bench_FilterScan(bench_File*)
+ *
+ * Description:
+ *  Warm scans selecting the objects of one tag, filtered by the caller
+ *  and by the cursor.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_FilterScan(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four nObjects;		/* # of qualifying objects */
+    Four pushdown;		/* TRUE to push the predicate into the cursor */
+    ObjectID oid;		/* current object */
+    ObjectHdr objHdr;		/* header of the current object */
+    OM_ScanCursor cursor;	/* scan cursor */
+    OM_HdrPredicate pred;	/* predicate on the tag */
+    double start;		/* start time */
+
+
+    pred.conditions = PRED_TAG;
+    pred.nTags = 1;
+    pred.tags[0] = 3;
+
+    /* warm up the buffer */
+    e = bench_ScanAll(&file->catalogEntry, TRUE, &nObjects, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    for (pushdown = FALSE; pushdown <= TRUE; pushdown++) {
+	start = bench_Now();
+	if (pushdown)
+	    e = EduOM_OpenFilteredScan(&file->catalogEntry, FORWARD, &pred, &cursor);
+	else
+	    e = EduOM_OpenScan(&file->catalogEntry, FORWARD, &cursor);
+	if (e < eNOERROR) ERR(e);
+
+	nObjects = 0;
+	while ((e = EduOM_ScanNext(&cursor, &oid, &objHdr)) != EOS) {
+	    if (e < eNOERROR) ERR(e);
+	    if (pushdown || objHdr.tag == pred.tags[0]) nObjects++;
+	}
+
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+
+	printf("%-15s : %8.2f ms, %d objects with tag %d\n",
+	       pushdown ? "filtered scan" : "caller filters", bench_Now() - start, nObjects, pred.tags[0]);
+    }
+
+    return(eNOERROR);
+
+} /* bench_FilterScan() */
+
+
+
+/*
+ * Function: Four bench_ZoneMap(bench_File*)
+ *
+ * Description:
+ *  Cold filtered scans selecting one tag of a file whose tags are clustered,
+ *  without and with the zone map. The file is created for the benchmark.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_ZoneMap(
+    bench_File *file)		/* IN file of the benchmarks, only its volume is used */
+{
+    Four e;			/* error */
+    Four nObjects;		/* # of qualifying objects */
+    Four useZoneMap;		/* TRUE to use the zone map */
+    bench_File clustered;	/* file whose tags are clustered */
+    ObjectID oid;		/* current object */
+    OM_ScanCursor cursor;	/* scan cursor */
+    OM_HdrPredicate pred;	/* predicate on the tag */
+    double start;		/* start time */
+
+
+    e = bench_CreateFile(file->volId, BENCH_NUM_OBJECTS / 2, 'y', TRUE, &clustered);
+    if (e < eNOERROR) ERR(e);
+    free(clustered.oids);
+
+    pred.conditions = PRED_TAG;
+    pred.nTags = 1;
+    pred.tags[0] = BENCH_NUM_TAGS / 2;
+
+    for (useZoneMap = FALSE; useZoneMap <= TRUE; useZoneMap++) {
+	if (useZoneMap) {
+	    e = EduOM_BuildZoneMap(&clustered.catalogEntry);
+	    if (e < eNOERROR) ERR(e);
+	}
+
+	e = bench_DropCaches();
+	if (e < eNOERROR) ERR(e);
+
+	start = bench_Now();
+	e = EduOM_OpenFilteredScan(&clustered.catalogEntry, FORWARD, &pred, &cursor);
+	if (e < eNOERROR) ERR(e);
+	for (nObjects = 0; (e = EduOM_ScanNext(&cursor, &oid, NULL)) != EOS; nObjects++)
+	    if (e < eNOERROR) ERR(e);
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+
+	printf("zone map %-3s : %8.2f ms, %d objects with tag %d, %d pages skipped\n",
+	       useZoneMap ? "on" : "off", bench_Now() - start, nObjects, pred.tags[0], cursor.nSkipped);
+    }
+
+    e = EduOM_DropZoneMap(&clustered.catalogEntry);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_ZoneMap() */
+
+
+
+/*
+ * Function: Four bench_ScanRead(bench_File*)
+ *
+ * Description:
+ *  Warm scans reading every object, with EduOM_NextObject() and
+ *  EduOM_ReadObject(), with EduOM_ScanNextRead() and with
+ *  EduOM_ScanNextView(). The page fixes per object are reported.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_ScanRead(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four method;		/* 0: NextObject + ReadObject, 1: ScanNextRead, 2: ScanNextView */
+    Four nObjects;		/* # of objects read */
+    Four nRead;			/* # of bytes read */
+    Four nBytes;		/* total # of bytes read */
+    ObjectID oid;		/* current object */
+    ObjectHdr objHdr;		/* header of the current object */
+    OM_ScanCursor cursor;	/* scan cursor */
+    char buf[BENCH_OBJECT_SIZE]; /* data of the current object */
+    char *view;			/* data of the current object in the buffer */
+    double start;		/* start time */
+    static char *names[] = { "NextObject+ReadObject", "EduOM_ScanNextRead", "EduOM_ScanNextView" };
+
+
+    /* warm up the buffer */
+    e = bench_ScanAll(&file->catalogEntry, TRUE, &nObjects, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    for (method = 0; method < 3; method++) {
+	nObjects = nBytes = 0;
+	benchNumFixes = 0;
+	start = bench_Now();
+
+	if (method == 0) {
+	    e = EduOM_NextObject(&file->catalogEntry, NULL, &oid, &objHdr);
+	    while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		nRead = EduOM_ReadObject(&oid, 0, REMAINDER, buf);
+		if (nRead < eNOERROR) ERR(nRead);
+		nObjects++;
+		nBytes += nRead;
+		e = EduOM_NextObject(&file->catalogEntry, &oid, &oid, &objHdr);
+	    }
+	}
+	else {
+	    e = EduOM_OpenScan(&file->catalogEntry, FORWARD, &cursor);
+	    if (e < eNOERROR) ERR(e);
+	    for (;;) {
+		if (method == 1)
+		    e = EduOM_ScanNextRead(&cursor, 0, REMAINDER, &oid, &objHdr, buf, &nRead);
+		else {
+		    e = EduOM_ScanNextView(&cursor, &oid, &objHdr, &view);
+		    nRead = objHdr.length;
+		}
+		if (e == EOS) break;
+		if (e < eNOERROR) ERR(e);
+		nObjects++;
+		nBytes += nRead;
+	    }
+	    e = EduOM_CloseScan(&cursor);
+	    if (e < eNOERROR) ERR(e);
+	}
+
+	printf("%-21s : %8.2f ms, %d objects, %d bytes, %.3f fixes per object\n",
+	       names[method], bench_Now() - start, nObjects, nBytes, (double)benchNumFixes / nObjects);
+    }
+
+    return(eNOERROR);
+
+} /* bench_ScanRead() */
+
+
+
+/*
+ * Function: Four bench_MultiGet(bench_File*)
+ *
+ * Description:
+ *  Cold reads of random objects in batches, with EduOM_ReadObject() per
+ *  object and with EduOM_ReadObjects() without and with the read-ahead
+ *  announcing the pages of a batch. The page fixes per object are reported.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_MultiGet(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four i, j;			/* indexes */
+    Four method;		/* 0: ReadObject, 1: ReadObjects, 2: ReadObjects with read-ahead */
+    Four nBytes;		/* total # of bytes read */
+    ObjectID lookups[BENCH_NUM_LOOKUPS]; /* objects to read */
+    char *bufs[BENCH_LOOKUP_BATCH];	/* buffers of a batch */
+    Four results[BENCH_LOOKUP_BATCH];	/* outcomes of a batch */
+    static char data[BENCH_LOOKUP_BATCH][BENCH_OBJECT_SIZE]; /* data of a batch */
+    double start;		/* start time */
+    static char *names[] = { "EduOM_ReadObject", "EduOM_ReadObjects", "EduOM_ReadObjects+RA" };
+
+
+    srand(1);
+    for (i = 0; i < BENCH_NUM_LOOKUPS; i++) lookups[i] = file->oids[rand() % file->nObjects];
+
+    for (i = 0; i < BENCH_LOOKUP_BATCH; i++) bufs[i] = data[i];
+
+    for (method = 0; method < 3; method++) {
+	e = bench_DropCaches();
+	if (e < eNOERROR) ERR(e);
+
+	if (method == 2) {
+	    e = EduOM_InitReadAhead(file->volId, 1, benchDevNames, BENCH_RA_THREADS);
+	    if (e < eNOERROR) ERR(e);
+	}
+
+	nBytes = 0;
+	benchNumFixes = 0;
+	start = bench_Now();
+
+	for (i = 0; i < BENCH_NUM_LOOKUPS; i += BENCH_LOOKUP_BATCH) {
+	    if (method == 0) {
+		for (j = 0; j < BENCH_LOOKUP_BATCH; j++) {
+		    results[j] = EduOM_ReadObject(&lookups[i+j], 0, REMAINDER, bufs[j]);
+		    if (results[j] < eNOERROR) ERR(results[j]);
+		}
+	    }
+	    else {
+		e = EduOM_ReadObjects(BENCH_LOOKUP_BATCH, &lookups[i], NULL, NULL, bufs, results);
+		if (e < eNOERROR) ERR(e);
+	    }
+	    for (j = 0; j < BENCH_LOOKUP_BATCH; j++) {
+		if (results[j] < eNOERROR) ERR(results[j]);
+		nBytes += results[j];
+	    }
+	}
+
+	printf("%-21s : %8.2f ms, %d objects, %d bytes, %.3f fixes per object\n",
+	       names[method], bench_Now() - start, BENCH_NUM_LOOKUPS, nBytes,
+	       (double)benchNumFixes / BENCH_NUM_LOOKUPS);
+
+	if (method == 2) EduOM_FinalReadAhead();
+    }
+
+    return(eNOERROR);
+
+} /* bench_MultiGet() */
+
+
+
+/*
+ * Function: Four bench_PinRead(bench_File*)
+ *
+ * Description:
+ *  Warm lookups hashing every object of the file, with EduOM_ReadObject()
+ *  copying the object and with EduOM_PinObject() viewing it in the buffer.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_PinRead(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four method;		/* 0: ReadObject, 1: PinObject */
+    Four nObjects;		/* # of objects hashed */
+    Four length;		/* length of the current object */
+    UFour hash;			/* hash of all bytes */
+    ObjectID oid;		/* current object */
+    OM_ObjectView view;		/* view of the current object */
+    const char *data;		/* data of the current object */
+    char buf[BENCH_OBJECT_SIZE]; /* copy of the current object */
+    double start;		/* start time */
+    static char *names[] = { "EduOM_ReadObject", "EduOM_PinObject" };
+
+
+    /* warm up the buffer */
+    e = bench_ScanAll(&file->catalogEntry, TRUE, &nObjects, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    for (method = 0; method < 2; method++) {
+	nObjects = 0;
+	hash = 0;
+	start = bench_Now();
+
+	e = EduOM_NextObject(&file->catalogEntry, NULL, &oid, NULL);
+	while (e != EOS) {
+	    if (e < eNOERROR) ERR(e);
+	    if (method == 0) {
+		length = EduOM_ReadObject(&oid, 0, REMAINDER, buf);
+		if (length < eNOERROR) ERR(length);
+		data = buf;
+	    }
+	    else {
+		e = EduOM_PinObject(&oid, &view);
+		if (e < eNOERROR) ERR(e);
+		length = view.length;
+		data = OM_VIEW_DATA(&view);
+	    }
+	    for (i = 0; i < length; i++) hash = hash * 31 + (unsigned char)data[i];
+	    if (method == 1) {
+		e = EduOM_UnpinObject(&view);
+		if (e < eNOERROR) ERR(e);
+	    }
+	    nObjects++;
+	    e = EduOM_NextObject(&file->catalogEntry, &oid, &oid, NULL);
+	}
+
+	printf("%-16s : %8.2f ms, %d objects, hash %08x\n", names[method], bench_Now() - start, nObjects, hash);
+    }
+
+    return(eNOERROR);
+
+} /* bench_PinRead() */
+
+
+
+/*
+ * Function: Four bench_Fields(bench_File*)
+ *
+ * Description:
+ *  Warm reads of three fields of every object, with three calls of
+ *  EduOM_ReadObject() and with one call of EduOM_ReadObjectV(). The page
+ *  fixes per object, including those of the scan, are reported.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_Fields(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four method;		/* 0: ReadObject, 1: ReadObjectV */
+    Four nObjects;		/* # of objects read */
+    ObjectID oid;		/* current object */
+    OM_IOVec iov[3];		/* fields to read */
+    char fields[3][8];		/* data of the fields */
+    double start;		/* start time */
+    static Four offsets[3] = { 0, 64, 128 };
+    static char *names[] = { "EduOM_ReadObject x3", "EduOM_ReadObjectV" };
+
+
+    /* warm up the buffer */
+    e = bench_ScanAll(&file->catalogEntry, TRUE, &nObjects, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    for (method = 0; method < 2; method++) {
+	nObjects = 0;
+	benchNumFixes = 0;
+	start = bench_Now();
+
+	e = EduOM_NextObject(&file->catalogEntry, NULL, &oid, NULL);
+	while (e != EOS) {
+	    if (e < eNOERROR) ERR(e);
+	    if (method == 0) {
+		for (i = 0; i < 3; i++) {
+		    e = EduOM_ReadObject(&oid, offsets[i], 8, fields[i]);
+		    if (e < eNOERROR) ERR(e);
+		}
+	    }
+	    else {
+		for (i = 0; i < 3; i++) {
+		    iov[i].start = offsets[i];
+		    iov[i].length = 8;
+		    iov[i].buf = fields[i];
+		}
+		e = EduOM_ReadObjectV(&oid, 3, iov);
+		if (e < eNOERROR) ERR(e);
+	    }
+	    nObjects++;
+	    e = EduOM_NextObject(&file->catalogEntry, &oid, &oid, NULL);
+	}
+
+	printf("%-19s : %8.2f ms, %d objects, %.3f fixes per object (scan included)\n",
+	       names[method], bench_Now() - start, nObjects, (double)benchNumFixes / nObjects);
+    }
+
+    return(eNOERROR);
+
+} /* bench_Fields() */
+
+
+
+/*
+ * Function: Four bench_ObjectCache(bench_File*)
+ *
+ * Description:
+ *  Warm random reads of a hot set of objects, each preceded by the read of
+ *  the next object of a concurrent full scan, without and with the object
+ *  cache. Half of the reads go to the hot set, the others are scan reads
+ *  which the cache must not admit.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_ObjectCache(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four cached;		/* TRUE to use the object cache */
+    ObjectID oid;		/* object of the scan */
+    ObjectID hot[BENCH_HOT_OBJECTS]; /* hot objects */
+    char buf[BENCH_OBJECT_SIZE]; /* data of an object */
+    OM_ObjectCacheStats stats;	/* statistics of the object cache */
+    double start;		/* start time */
+
+
+    /* every 100th object is a hot one */
+    for (i = 0; i < BENCH_HOT_OBJECTS; i++) hot[i] = file->oids[(i * 100) % file->nObjects];
+
+    /* warm up the buffer and the read path */
+    for (i = 0; i < file->nObjects; i++) {
+	e = EduOM_ReadObject(&file->oids[i], 0, REMAINDER, buf);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    for (cached = FALSE; cached <= TRUE; cached++) {
+	if (cached) {
+	    e = EduOM_InitObjectCache(BENCH_CACHE_BUDGET);
+	    if (e < eNOERROR) ERR(e);
+	}
+
+	srand(1);
+	start = bench_Now();
+
+	e = EduOM_NextObject(&file->catalogEntry, NULL, &oid, NULL);
+	for (i = 0; e != EOS; i++) {
+	    if (e < eNOERROR) ERR(e);
+	    e = EduOM_ReadObject(&oid, 0, REMAINDER, buf);
+	    if (e < eNOERROR) ERR(e);
+	    e = EduOM_ReadObject(&hot[rand() % BENCH_HOT_OBJECTS], 0, REMAINDER, buf);
+	    if (e < eNOERROR) ERR(e);
+	    e = EduOM_NextObject(&file->catalogEntry, &oid, &oid, NULL);
+	}
+
+	printf("object cache %-3s : %8.2f ms, %d reads", cached ? "on" : "off", bench_Now() - start, 2 * i);
+	if (cached) {
+	    EduOM_GetObjectCacheStatistics(&stats);
+	    printf(", hit ratio %.3f, %d entries, %d bytes, hit %.0f ns, miss %.0f ns",
+		   (double)stats.nHits / stats.nLookups, stats.nEntries, stats.nBytes,
+		   stats.hitLatency, stats.missLatency);
+	    EduOM_FinalObjectCache();
+	}
+	printf("\n");
+    }
+
+    return(eNOERROR);
+
+} /* bench_ObjectCache() */
+
+
+
+/*
+ * Function: Four bench_CompareBfM(bench_File*, Four (*)(bench_File*, Four*))
+ *
+ * Description:
+ *  Run the workload 'work' from a cold buffer, once with the stock buffer
+ *  manager or once per replacement policy with the in-tree one, and report
+ *  the elapsed time, the trains read and written by the disk manager and,
+ *  for the in-tree buffer manager, the hit ratio.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_CompareBfM(
+    bench_File *file,		/* IN file of the benchmarks */
+    Four (*work)(bench_File*, Four*)) /* IN workload */
+{
+    Four e;			/* error */
+    Four policy;		/* replacement policy */
+    Four nPolicies;		/* # of replacement policies to run */
+    Four nOps;			/* # of operations done by the workload */
+    Four nReads, nWrites;	/* I/O counters before the workload */
+    BfM_Parameters params;	/* parameters of the in-tree buffer manager */
+    BfM_Parameters saved;	/* parameters restored at the end */
+    BfM_Statistics stats;	/* statistics of the in-tree buffer manager */
+    double start;		/* start time */
+    static char *names[] = { "EduBfM CLOCK", "EduBfM 2Q", "EduBfM LRU-K" };
+
+
+    nPolicies = (EduBfM_SetParameters != NULL) ? 3 : 1;
+
+    if (EduBfM_GetParameters != NULL) {
+	e = EduBfM_GetParameters(&saved);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    for (policy = 0; policy < nPolicies; policy++) {
+	e = bench_DropCaches();
+	if (e < eNOERROR) ERR(e);
+
+	if (EduBfM_SetParameters != NULL) {
+	    e = EduBfM_GetParameters(&params);
+	    if (e < eNOERROR) ERR(e);
+	    params.policy = policy;
+	    e = EduBfM_SetParameters(&params);
+	    if (e < eNOERROR) ERR(e);
+	}
+
+	nReads = io_num_of_reads;
+	nWrites = io_num_of_writes;
+	start = bench_Now();
+
+	e = work(file, &nOps);
+	if (e < eNOERROR) ERR(e);
+
+	e = BfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+
+	printf("%-12s : %8.2f ms, %d operations, %d reads, %d writes",
+	       (EduBfM_SetParameters != NULL) ? names[policy] : "stock BfM", bench_Now() - start,
+	       nOps, io_num_of_reads - nReads, io_num_of_writes - nWrites);
+
+	if (EduBfM_GetStatistics != NULL) {
+	    EduBfM_GetStatistics(&stats);
+	    printf(", hit ratio %.3f", (double)stats.nHits / MAX(1, stats.nFixes));
+	}
+	printf("\n");
+    }
+
+    if (EduBfM_SetParameters != NULL) {
+	e = EduBfM_SetParameters(&saved);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* bench_CompareBfM() */
+
+
+
+/*
+ * Function: Four bench_BfMLoadWork(bench_File*, Four*)
+ *
+ * Description:
+ *  Workload of EduOM_Test on a larger scale: objects of random sizes are
+ *  created in a new file, read, scanned forward and backward, and every
+ *  other one is destroyed before the file is scanned again.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four bench_BfMLoadWork(
+    bench_File *file,		/* IN file of the benchmarks, only its volume is used */
+    Four *nOps)			/* OUT # of operations */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    FileID fid;			/* file identifier */
+    ObjectID loadCatalogEntry;	/* catalog object of the new file */
+    ObjectID oid;		/* current object */
+    ObjectID *loadOids;		/* objects of the new file */
+    ObjectHdr objHdr;		/* header of the objects */
+    char data[BENCH_OBJECT_SIZE * 2]; /* data of an object */
+
+
+    loadOids = (ObjectID *)malloc(BENCH_LOAD_OBJECTS * sizeof(ObjectID));
+    if (loadOids == NULL) ERR(eMEMORYALLOCERR);
+
+    e = SM_CreateFile(file->volId, &fid, FALSE, NULL);
+    if (e < eNOERROR) { free(loadOids); ERR(e); }
+    e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &loadCatalogEntry);
+    if (e < eNOERROR) { free(loadOids); ERR(e); }
+
+    srand(1);
+    memset(data, 'y', sizeof(data));
+    objHdr.properties = 0;
+    objHdr.tag = 0;
+    *nOps = 0;
+
+    for (i = 0; i < BENCH_LOAD_OBJECTS; i++, (*nOps)++) {
+	e = EduOM_CreateObject(&loadCatalogEntry, (i == 0) ? NULL : &loadOids[i-1], &objHdr,
+			       1 + rand() % sizeof(data), data, &loadOids[i]);
+	if (e < eNOERROR) { free(loadOids); ERR(e); }
+    }
+
+    for (i = 0; i < BENCH_LOAD_OBJECTS; i++, (*nOps)++) {
+	e = EduOM_ReadObject(&loadOids[rand() % BENCH_LOAD_OBJECTS], 0, REMAINDER, data);
+	if (e < eNOERROR) { free(loadOids); ERR(e); }
+    }
+
+    for (e = EduOM_NextObject(&loadCatalogEntry, NULL, &oid, NULL); e != EOS; (*nOps)++) {
+	if (e < eNOERROR) { free(loadOids); ERR(e); }
+	e = EduOM_NextObject(&loadCatalogEntry, &oid, &oid, NULL);
+    }
+
+    for (e = EduOM_PrevObject(&loadCatalogEntry, NULL, &oid, NULL); e != EOS; (*nOps)++) {
+	if (e < eNOERROR) { free(loadOids); ERR(e); }
+	e = EduOM_PrevObject(&loadCatalogEntry, &oid, &oid, NULL);
+    }
+
+    for (i = 0; i < BENCH_LOAD_OBJECTS; i += 2, (*nOps)++) {
+	e = EduOM_DestroyObject(&loadCatalogEntry, &loadOids[i], &dlPool, &dlHead);
+	if (e < eNOERROR) { free(loadOids); ERR(e); }
+    }
+
+    for (e = EduOM_NextObject(&loadCatalogEntry, NULL, &oid, NULL); e != EOS; (*nOps)++) {
+	if (e < eNOERROR) { free(loadOids); ERR(e); }
+	e = EduOM_NextObject(&loadCatalogEntry, &oid, &oid, NULL);
+    }
+
+    free(loadOids);
+
+    return(eNOERROR);
+
+} /* bench_BfMLoadWork() */
+
+
+
+/*
+ * Function: Four bench_BfMZipfWork(bench_File*, Four*)
+ *
+ * Description:
+ *  Reads of objects drawn from a Zipf distribution whose ranks are spread
+ *  over the file, so the hot pages are scattered and the file does not fit
+ *  in the buffer.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four bench_BfMZipfWork(
+    bench_File *file,		/* IN file of the benchmarks */
+    Four *nOps)			/* OUT # of operations */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four lo, hi, mid;		/* bounds of the binary search */
+    double *cdf;		/* cumulative distribution of the ranks */
+    double u;			/* uniform random number */
+    char data[BENCH_OBJECT_SIZE]; /* data of an object */
+
+
+    cdf = (double *)malloc(file->nObjects * sizeof(double));
+    if (cdf == NULL) ERR(eMEMORYALLOCERR);
+
+    for (i = 0; i < file->nObjects; i++) cdf[i] = ((i > 0) ? cdf[i-1] : 0.0) + 1.0 / pow(i + 1, BENCH_ZIPF_SKEW);
+
+    srand(1);
+    for (*nOps = 0; *nOps < BENCH_ZIPF_READS; (*nOps)++) {
+	u = (double)rand() / RAND_MAX * cdf[file->nObjects - 1];
+	for (lo = 0, hi = file->nObjects - 1; lo < hi; ) {
+	    mid = (lo + hi) / 2;
+	    if (cdf[mid] < u) lo = mid + 1;
+	    else hi = mid;
+	}
+
+	/* spread the ranks over the file */
+	e = EduOM_ReadObject(&file->oids[(Four)((lo * 7919LL) % file->nObjects)], 0, REMAINDER, data);
+	if (e < eNOERROR) { free(cdf); ERR(e); }
+    }
+
+    free(cdf);
+
+    return(eNOERROR);
+
+} /* bench_BfMZipfWork() */
+
+
+
+/*
+ * Function: Four bench_BfMScanWork(bench_File*, Four*)
+ *
+ * Description:
+ *  Random reads of a hot set of objects interleaved with full scans of the
+ *  file, which a scan-resistant policy keeps from flushing the hot set.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_BfMScanWork(
+    bench_File *file,		/* IN file of the benchmarks */
+    Four *nOps)			/* OUT # of operations */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four round;			/* scan round */
+    Four nHot;			/* # of hot objects */
+    Four nScanned;		/* # of objects scanned */
+    char data[BENCH_OBJECT_SIZE]; /* data of an object */
+
+
+    nHot = MAX(1, file->nObjects * BENCH_HOT_PERCENT / 100);
+
+    srand(1);
+    *nOps = 0;
+
+    for (round = 0; round < BENCH_SCAN_ROUNDS; round++) {
+	for (i = 0; i < BENCH_HOT_READS; i++, (*nOps)++) {
+	    /* the hot objects are the first ones of the file */
+	    e = EduOM_ReadObject(&file->oids[rand() % nHot], 0, REMAINDER, data);
+	    if (e < eNOERROR) ERR(e);
+	}
+
+	e = bench_ScanAll(&file->catalogEntry, TRUE, &nScanned, NULL);
+	if (e < eNOERROR) ERR(e);
+	*nOps += nScanned;
+    }
+
+    return(eNOERROR);
+
+} /* bench_BfMScanWork() */
+
+
+
+/*
+ * Function: Four bench_BfMLoad(bench_File*)
+ *
+ * Description:
+ *  Compare the buffer managers on the workload of EduOM_Test.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_BfMLoad(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+
+
+    e = bench_CompareBfM(file, bench_BfMLoadWork);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_BfMLoad() */
+
+
+
+/*
+ * Function: Four bench_BfMZipf(bench_File*)
+ *
+ * Description:
+ *  Compare the buffer managers on skewed point reads.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_BfMZipf(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+
+
+    e = bench_CompareBfM(file, bench_BfMZipfWork);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_BfMZipf() */
+
+
+
+/*
+ * Function: Four bench_BfMScan(bench_File*)
+ *
+ * Description:
+ *  Compare the buffer managers on hot reads mixed with full scans.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_BfMScan(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+
+
+    e = bench_CompareBfM(file, bench_BfMScanWork);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_BfMScan() */
+
+
+
+/*
+ * Function: void *bench_HitWorker(void*)
+ *
+ * Description:
+ *  Fix and unfix random buffered pages BENCH_HIT_FIXES times.
+ */
+static void *bench_HitWorker(
+    void *arg)			/* IN bench_HitArg of the thread */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    bench_HitArg *hit;		/* argument of the thread */
+    PageID *pid;		/* page to fix */
+    char *page;			/* buffer holding the page */
+
+
+    hit = (bench_HitArg *)arg;
+    hit->error = eNOERROR;
+
+    for (i = 0; i < BENCH_HIT_FIXES; i++) {
+	pid = &hit->pids[rand_r(&hit->seed) % hit->nPids];
+	e = BfM_GetTrain(pid, &page, PAGE_BUF);
+	if (e < eNOERROR) { hit->error = e; break; }
+	e = BfM_FreeTrain(pid, PAGE_BUF);
+	if (e < eNOERROR) { hit->error = e; break; }
+    }
+
+    return(NULL);
+
+} /* bench_HitWorker() */
+
+
+
+/*
+ * Function: Four bench_BfMHit(bench_File*)
+ *
+ * Description:
+ *  Fix and unfix buffered pages from 1 to BENCH_MAX_THREADS threads and
+ *  report the fixes per second. The stock buffer manager is not thread
+ *  safe and runs with one thread only.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+static Four bench_BfMHit(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four nThreads;		/* # of threads */
+    Four maxThreads;		/* # of threads of the last run */
+    Four nPids;			/* # of buffered pages */
+    ObjectID *oids;		/* objects of the file */
+    PageID pids[BENCH_HIT_PAGES]; /* buffered pages */
+    char *page;			/* buffer holding a page */
+    pthread_t threads[BENCH_MAX_THREADS]; /* threads */
+    bench_HitArg args[BENCH_MAX_THREADS]; /* arguments of the threads */
+    double elapsed;		/* elapsed time */
+
+
+    /* the pages of the first objects, fixed once to have them in the buffer */
+    oids = file->oids;
+    for (i = 0, nPids = 0; i < file->nObjects && nPids < BENCH_HIT_PAGES; i++) {
+	if (nPids > 0 && pids[nPids-1].pageNo == oids[i].pageNo) continue;
+	MAKE_PAGEID(pids[nPids], oids[i].volNo, oids[i].pageNo);
+	e = BfM_GetTrain(&pids[nPids], &page, PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+	e = BfM_FreeTrain(&pids[nPids], PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+	nPids++;
+    }
+
+    maxThreads = (EduBfM_SetParameters != NULL) ? BENCH_MAX_THREADS : 1;
+
+    for (nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+	elapsed = bench_Now();
+
+	for (i = 0; i < nThreads; i++) {
+	    args[i].pids = pids;
+	    args[i].nPids = nPids;
+	    args[i].seed = i + 1;
+	    if (pthread_create(&threads[i], NULL, bench_HitWorker, &args[i]) != 0) ERR(eBADPARAMETER_OM);
+	}
+	for (i = 0; i < nThreads; i++) pthread_join(threads[i], NULL);
+
+	elapsed = bench_Now() - elapsed;
+
+	for (i = 0; i < nThreads; i++)
+	    if (args[i].error < eNOERROR) ERR(args[i].error);
+
+	printf("%-9s %d thread(s) : %8.2f ms, %d pages, %.2f M fixes/s\n",
+	       (EduBfM_SetParameters != NULL) ? "EduBfM" : "stock BfM", nThreads, elapsed, nPids,
+	       (double)nThreads * BENCH_HIT_FIXES / elapsed / 1000.0);
+    }
+
+    return(eNOERROR);
+
+} /* bench_BfMHit() */
+
+
+
+/*
+ * Function: int bench_OpenTLBCounter(void)
+ *
+ * Description:
+ *  Open a disabled counter of the data TLB load misses of the process in
+ *  user mode.
+ *
+ * Returns:
+ *  descriptor of the counter, or -1 if the counter is not available
+ */
+static int bench_OpenTLBCounter(void)
+{
+    struct perf_event_attr attr;	/* description of the counter */
+
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return((int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+
+} /* bench_OpenTLBCounter() */
+
+
+
+/*
+ * Function: int bench_CompareTimes(const void*, const void*)
+ *
+ * Description:
+ *  qsort() comparison of two elapsed times.
+ *
+ * Returns:
+ *  negative, 0 or positive as the first time is less, equal or greater
+ */
+static int bench_CompareTimes(
+    const void *a,		/* IN first time */
+    const void *b)		/* IN second time */
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+
+    return((x > y) - (x < y));
+
+} /* bench_CompareTimes() */
+
+
+
+/*
+ * Function: Four bench_HugePages(bench_File*)
+ *
+ * Description:
+ *  Warm scans and random reads of the file held entirely in the buffer,
+ *  with the frames backed by base pages, transparent huge pages and
+ *  explicit huge pages. Each of the BENCH_HUGE_ROUNDS rounds times every
+ *  backing, starting with a different one, and the median, the minimum
+ *  and the maximum over the rounds are reported, with the backing
+ *  obtained and the data TLB load misses of the last round. Requires the
+ *  in-tree buffer manager.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_HugePages(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four i, j;			/* indexes */
+    Four round;			/* round */
+    Four mode;			/* backing requested */
+    Four got[3];		/* backing obtained for each backing requested */
+    Four nScanned;		/* # of objects scanned */
+    BfM_Parameters params;	/* parameters of the in-tree buffer manager */
+    BfM_Parameters saved;	/* parameters restored at the end */
+    BfM_Statistics stats;	/* statistics of the in-tree buffer manager */
+    int fd;			/* descriptor of the TLB miss counter */
+    long long nMisses[3][2];	/* TLB misses of the scans and of the reads */
+    double scanTime[3][BENCH_HUGE_ROUNDS]; /* elapsed times of the scans, sorted at the end */
+    double readTime[3][BENCH_HUGE_ROUNDS]; /* elapsed times of the reads, sorted at the end */
+    double t;			/* a time */
+    static char *names[] = { "base pages", "transparent", "explicit" };
+    static char *obtained[] = { "base pages", "transparent huge pages", "explicit huge pages" };
+
+
+    e = bench_UseEduBfM("", &saved);
+    if (e < eNOERROR) ERR(e);
+    if (e == FALSE) return(eNOERROR);
+
+    fd = bench_OpenTLBCounter();
+
+    for (round = 0; round < BENCH_HUGE_ROUNDS; round++)
+	for (j = 0; j < 3; j++) {
+	    mode = BFM_HUGEPAGE_NONE + (round + j) % 3;
+	    params = saved;
+	    params.nBufs[PAGE_BUF] = BENCH_HUGE_BUFS;
+	    params.hugePages = mode;
+	    e = EduBfM_SetParameters(&params);
+	    if (e < eNOERROR) ERR(e);
+
+	    /* load the file in the buffer */
+	    e = bench_ScanAll(&file->catalogEntry, TRUE, &nScanned, NULL);
+	    if (e < eNOERROR) ERR(e);
+
+	    if (fd >= 0) { ioctl(fd, PERF_EVENT_IOC_RESET, 0); ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); }
+	    t = bench_Now();
+	    for (i = 0; i < BENCH_HUGE_SCANS; i++) {
+		e = bench_ScanAll(&file->catalogEntry, TRUE, &nScanned, NULL);
+		if (e < eNOERROR) ERR(e);
+	    }
+	    scanTime[mode][round] = bench_Now() - t;
+	    if (fd >= 0) { ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); read(fd, &nMisses[mode][0], sizeof(long long)); }
+
+	    if (fd >= 0) { ioctl(fd, PERF_EVENT_IOC_RESET, 0); ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); }
+	    e = bench_RandomReads(file, BENCH_ZIPF_READS, &readTime[mode][round]);
+	    if (e < eNOERROR) ERR(e);
+	    if (fd >= 0) { ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); read(fd, &nMisses[mode][1], sizeof(long long)); }
+
+	    EduBfM_GetStatistics(&stats);
+	    got[mode] = stats.hugePages;
+	}
+
+    printf("median (min - max) of %d rounds\n", BENCH_HUGE_ROUNDS);
+    for (mode = BFM_HUGEPAGE_NONE; mode <= BFM_HUGEPAGE_EXPLICIT; mode++) {
+	qsort(scanTime[mode], BENCH_HUGE_ROUNDS, sizeof(double), bench_CompareTimes);
+	qsort(readTime[mode], BENCH_HUGE_ROUNDS, sizeof(double), bench_CompareTimes);
+	printf("%-11s : %d scans %7.2f ms (%.2f - %.2f), %d random reads %7.2f ms (%.2f - %.2f), got %s",
+	       names[mode], BENCH_HUGE_SCANS, scanTime[mode][BENCH_HUGE_ROUNDS / 2],
+	       scanTime[mode][0], scanTime[mode][BENCH_HUGE_ROUNDS - 1],
+	       BENCH_ZIPF_READS, readTime[mode][BENCH_HUGE_ROUNDS / 2],
+	       readTime[mode][0], readTime[mode][BENCH_HUGE_ROUNDS - 1], obtained[got[mode]]);
+	if (fd >= 0) printf(", dTLB misses %lld / %lld", nMisses[mode][0], nMisses[mode][1]);
+	else printf(", dTLB misses n/a");
+	printf("\n");
+    }
+
+    if (fd >= 0) close(fd);
+
+    e = EduBfM_SetParameters(&saved);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_HugePages() */
+
+
+
+/*
+ * Function: Four bench_CachedPages(void)
+ *
+ * Description:
+ *  Return the number of pages of the volume in the OS page cache.
+ */
+static Four bench_CachedPages(void)
+{
+    int fd;			/* descriptor of the device */
+    struct stat st;		/* status of the device */
+    void *map;			/* mapping of the device */
+    unsigned char *vec;		/* residency of each page */
+    size_t nPages;		/* # of pages of the device */
+    size_t i;			/* index */
+    Four nCached;		/* # of pages in the page cache */
+
+
+    nCached = 0;
+    fd = open(BENCH_VOLUME, O_RDONLY);
+    if (fd < 0) return(0);
+
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+	nPages = (st.st_size + getpagesize() - 1) / getpagesize();
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	vec = malloc(nPages);
+	if (map != MAP_FAILED && vec != NULL && mincore(map, st.st_size, vec) == 0)
+	    for (i = 0; i < nPages; i++) nCached += vec[i] & 1;
+	if (map != MAP_FAILED) munmap(map, st.st_size);
+	free(vec);
+    }
+    close(fd);
+
+    return(nCached);
+
+} /* bench_CachedPages() */
+
+
+
+/*
+ * Function: Four bench_DirectIO(bench_File*)
+ *
+ * Description:
+ *  A cold scan followed by random reads of the file, with the volume read
+ *  through the OS page cache and with O_DIRECT, the latter also with the
+ *  buffer pool enlarged to hold the file, i.e. with the memory of the page
+ *  cache given to the buffer pool. The pages of the volume left in the
+ *  page cache are reported. Requires the in-tree buffer manager.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_DirectIO(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four c;			/* configuration */
+    Four nScanned;		/* # of objects scanned */
+    BfM_Parameters params;	/* parameters of the in-tree buffer manager */
+    BfM_Parameters saved;	/* parameters restored at the end */
+    BfM_Statistics before, after; /* statistics of the in-tree buffer manager */
+    double scanTime, readTime;	/* elapsed times */
+    static struct {
+	char *name;		/* name of the configuration */
+	Four directIO;		/* TRUE to use O_DIRECT */
+	Four nBufs;		/* # of page frames, 0 for the default */
+    } configs[] = {
+	{ "page cache", FALSE, 0 },
+	{ "O_DIRECT", TRUE, 0 },
+	{ "O_DIRECT+pool", TRUE, BENCH_HUGE_BUFS },
+    };
+
+
+    e = bench_UseEduBfM("", &saved);
+    if (e < eNOERROR) ERR(e);
+    if (e == FALSE) return(eNOERROR);
+
+    for (c = 0; c < (Four)(sizeof(configs) / sizeof(configs[0])); c++) {
+	params = saved;
+	params.directIO = configs[c].directIO;
+	if (configs[c].nBufs > 0) params.nBufs[PAGE_BUF] = configs[c].nBufs;
+	e = EduBfM_SetParameters(&params);
+	if (e < eNOERROR) ERR(e);
+
+	e = bench_DropCaches();
+	if (e < eNOERROR) ERR(e);
+
+	EduBfM_GetStatistics(&before);
+
+	e = bench_ScanAll(&file->catalogEntry, TRUE, &nScanned, &scanTime);
+	if (e < eNOERROR) ERR(e);
+
+	e = bench_RandomReads(file, BENCH_DIRECT_READS, &readTime);
+	if (e < eNOERROR) ERR(e);
+
+	EduBfM_GetStatistics(&after);
+	printf("%-13s %5d frames : cold scan %8.2f ms, %d random reads %8.2f ms, %d trains read, "
+	       "%d direct / %d buffered transfers, %d pages in the page cache\n",
+	       configs[c].name, params.nBufs[PAGE_BUF], scanTime, BENCH_DIRECT_READS, readTime,
+	       after.nReads - before.nReads, after.nDirectIOs - before.nDirectIOs,
+	       after.nBufferedIOs - before.nBufferedIOs, bench_CachedPages());
+    }
+
+    e = EduBfM_SetParameters(&saved);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_DirectIO() */
+
+
+
+/*
+ * Function: Four bench_BgWriter(bench_File*)
+ *
+ * Description:
+ *  Objects appended to a new file and random objects of the file updated
+ *  in place, with a small buffer pool so that most victims are dirty:
+ *  without the background writer, with it and with it rate-limited. The
+ *  trains written by the foreground and by the writer, the runs of
+ *  adjacent trains written at once and the pages written by the disk
+ *  manager are reported. Requires the in-tree buffer manager.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_BgWriter(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four c;			/* configuration */
+    Four nWrites;		/* I/O counter before the workload */
+    bench_File newFile;		/* file appended */
+    BfM_Parameters params;	/* parameters of the in-tree buffer manager */
+    BfM_Parameters saved;	/* parameters restored at the end */
+    BfM_Statistics stats;	/* statistics of the in-tree buffer manager */
+    double start;		/* start time */
+    static struct {
+	char *name;		/* name of the configuration */
+	Four cleanTarget;	/* clean frames kept by the writer */
+	Four writeRate;		/* trains per second of the writer */
+    } configs[] = {
+	{ "no writer", 0, 0 },
+	{ "writer", BENCH_CLEAN_TARGET, 0 },
+	{ "writer, limited", BENCH_CLEAN_TARGET, BENCH_WRITE_RATE },
+    };
+
+
+    e = bench_UseEduBfM("", &saved);
+    if (e < eNOERROR) ERR(e);
+    if (e == FALSE) return(eNOERROR);
+
+    for (c = 0; c < (Four)(sizeof(configs) / sizeof(configs[0])); c++) {
+	e = bench_DropCaches();
+	if (e < eNOERROR) ERR(e);
+
+	params = saved;
+	params.nBufs[PAGE_BUF] = BENCH_WRITER_BUFS;
+	params.cleanTarget = configs[c].cleanTarget;
+	params.writeRate = configs[c].writeRate;
+	e = EduBfM_SetParameters(&params);
+	if (e < eNOERROR) ERR(e);
+
+	nWrites = io_num_of_writes;
+	start = bench_Now();
+
+	e = bench_CreateFile(file->volId, BENCH_LOAD_OBJECTS, 'w', FALSE, &newFile);
+	if (e < eNOERROR) ERR(e);
+	free(newFile.oids);
+
+	e = bench_RandomUpdates(file, BENCH_WRITER_UPDATES);
+	if (e < eNOERROR) ERR(e);
+
+	e = BfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+
+	EduBfM_GetStatistics(&stats);
+	printf("%-15s : %8.2f ms, %d trains written by the foreground, %d by the writer, %d runs, %d pages written by the disk manager\n",
+	       configs[c].name, bench_Now() - start, stats.nWrites - stats.nBgWrites, stats.nBgWrites,
+	       stats.nRuns, io_num_of_writes - nWrites);
+    }
+
+    e = EduBfM_SetParameters(&saved);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_BgWriter() */
+
+
+
+/*
+ * Function: Four bench_ScanMix(bench_File*)
+ *
+ * Description:
+ *  Hot reads mixed with full scans, as in bfmscan, on a pool smaller than
+ *  the file, with the scans run under OM_HINT_NORMAL and under
+ *  OM_HINT_SEQUENTIAL for each policy. Every other scan uses
+ *  EduOM_NextObject() under the hint of the thread, the others the scan
+ *  cursor. The hit ratio of the hot reads and the trains read are
+ *  reported. Requires the in-tree buffer manager.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_ScanMix(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four policy;		/* replacement policy */
+    Four hint;			/* access hint of the scans */
+    Four prevHint;		/* access hint of the thread before a scan */
+    Four round;			/* scan round */
+    Four nHot;			/* # of hot objects */
+    Four nScanned;		/* # of objects scanned */
+    Four nFixes, nHits;		/* fixes and hits of the hot reads */
+    ObjectID oid;		/* current object of a scan */
+    OM_ScanCursor cursor;	/* scan cursor */
+    BfM_Parameters params;	/* parameters of the in-tree buffer manager */
+    BfM_Parameters saved;	/* parameters restored at the end */
+    BfM_Statistics before, after; /* statistics around the hot reads */
+    char data[BENCH_OBJECT_SIZE]; /* data of an object */
+    double start;		/* start time */
+    static char *names[] = { "CLOCK", "2Q", "LRU-K" };
+
+
+    e = bench_UseEduBfM("", &saved);
+    if (e < eNOERROR) ERR(e);
+    if (e == FALSE) return(eNOERROR);
+
+    nHot = MAX(1, file->nObjects * BENCH_HOT_PERCENT / 100);
+
+    for (policy = BFM_CLOCK; policy <= BFM_LRUK; policy++) {
+	for (hint = OM_HINT_NORMAL; hint <= OM_HINT_SEQUENTIAL; hint++) {
+	    e = bench_DropCaches();
+	    if (e < eNOERROR) ERR(e);
+
+	    params = saved;
+	    params.nBufs[PAGE_BUF] = BENCH_SCANMIX_BUFS;
+	    params.policy = policy;
+	    e = EduBfM_SetParameters(&params);
+	    if (e < eNOERROR) ERR(e);
+
+	    srand(1);
+	    nFixes = nHits = 0;
+	    start = bench_Now();
+
+	    for (round = 0; round < BENCH_SCAN_ROUNDS; round++) {
+		EduBfM_GetStatistics(&before);
+		for (i = 0; i < BENCH_HOT_READS; i++) {
+		    e = EduOM_ReadObject(&file->oids[rand() % nHot], 0, REMAINDER, data);
+		    if (e < eNOERROR) ERR(e);
+		}
+		EduBfM_GetStatistics(&after);
+
+		/* the first round warms the hot set up */
+		if (round > 0) {
+		    nFixes += after.nFixes - before.nFixes;
+		    nHits += after.nHits - before.nHits;
+		}
+
+		if (round % 2 == 0) {
+		    e = EduOM_OpenScan(&file->catalogEntry, FORWARD, &cursor);
+		    if (e < eNOERROR) ERR(e);
+		    e = EduOM_SetScanHint(&cursor, hint);
+		    if (e < eNOERROR) ERR(e);
+		    for (nScanned = 0; (e = EduOM_ScanNext(&cursor, &oid, NULL)) != EOS; nScanned++)
+			if (e < eNOERROR) break;
+		    (void) EduOM_CloseScan(&cursor);
+		}
+		else {
+		    prevHint = EduOM_SetAccessHint(hint);
+		    e = EduOM_NextObject(&file->catalogEntry, NULL, &oid, NULL);
+		    for (nScanned = 0; e != EOS; nScanned++) {
+			if (e < eNOERROR) break;
+			e = EduOM_NextObject(&file->catalogEntry, &oid, &oid, NULL);
+		    }
+		    (void) EduOM_SetAccessHint(prevHint);
+		}
+		if (e < eNOERROR) ERR(e);
+	    }
+
+	    EduBfM_GetStatistics(&after);
+	    printf("%-6s scans %-10s : %8.2f ms, hot read hit ratio %.3f (%d misses), %d trains read\n",
+		   names[policy], (hint == OM_HINT_SEQUENTIAL) ? "sequential" : "normal",
+		   bench_Now() - start, (double)nHits / MAX(1, nFixes), nFixes - nHits, after.nReads);
+	}
+    }
+
+    e = EduBfM_SetParameters(&saved);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_ScanMix() */
+
+
+
+/*
+ * Function: Four bench_MmapRead(bench_File*)
+ *
+ * Description:
+ *  A cold and a warm scan of the file, random reads of its objects, and
+ *  random updates written out by BfM_FlushAll(), with the pages copied
+ *  into the buffer pool and with the pages served from the mapping of the
+ *  volume. The trains read into the pool, the fixes served from the
+ *  mapping and the mapped pages written back are reported. Requires the
+ *  in-tree buffer manager.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_MmapRead(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four mmapReads;		/* TRUE to serve the pages from the mapping */
+    Four nScanned;		/* # of objects scanned */
+    BfM_Parameters params;	/* parameters of the in-tree buffer manager */
+    BfM_Parameters saved;	/* parameters restored at the end */
+    BfM_Statistics stats;	/* statistics of the in-tree buffer manager */
+    double coldTime, warmTime, readTime, writeTime; /* elapsed times */
+
+
+    e = bench_UseEduBfM("", &saved);
+    if (e < eNOERROR) ERR(e);
+    if (e == FALSE) return(eNOERROR);
+
+    for (mmapReads = FALSE; mmapReads <= TRUE; mmapReads++) {
+	params = saved;
+	params.directIO = FALSE;
+	params.mmapReads = mmapReads;
+	e = EduBfM_SetParameters(&params);
+	if (e < eNOERROR) ERR(e);
+
+	e = bench_DropCaches();
+	if (e < eNOERROR) ERR(e);
+
+	e = bench_ScanAll(&file->catalogEntry, TRUE, &nScanned, &coldTime);
+	if (e < eNOERROR) ERR(e);
+
+	e = bench_ScanAll(&file->catalogEntry, TRUE, &nScanned, &warmTime);
+	if (e < eNOERROR) ERR(e);
+
+	e = bench_RandomReads(file, BENCH_MMAP_READS, &readTime);
+	if (e < eNOERROR) ERR(e);
+
+	writeTime = bench_Now();
+	e = bench_RandomUpdates(file, BENCH_MMAP_UPDATES);
+	if (e < eNOERROR) ERR(e);
+	e = BfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+	writeTime = bench_Now() - writeTime;
+
+	EduBfM_GetStatistics(&stats);
+	printf("%-8s : cold scan %8.2f ms, warm scan %8.2f ms, %d reads %8.2f ms, %d updates %8.2f ms, "
+	       "%d trains read, %d mapped fixes, %d mapped pages written\n",
+	       mmapReads ? "mmap" : "buffered", coldTime, warmTime, BENCH_MMAP_READS, readTime,
+	       BENCH_MMAP_UPDATES, writeTime, stats.nReads, stats.nMappedFixes, stats.nMappedWrites);
+    }
+
+    e = EduBfM_SetParameters(&saved);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_MmapRead() */
+
+
+
+/*
+ * Function: Four bench_PageMap(bench_File*)
+ *
+ * Description:
+ *  The page map operations of RDsM on a fragmented page map page: searches
+ *  for runs of free pages over the whole page, and the searches, tests,
+ *  allocations and frees on one extent done by the page allocation. The
+ *  operations are the ones of the COSMOS object or the ones of EduRDsM
+ *  (make ALLOC=intree). The file of the benchmarks is not used.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_PageMap(
+    bench_File *file)		/* IN file of the benchmarks, not used */
+{
+    static Four runs[] = { 1, 4, BENCH_MAP_EXT_SIZE }; /* # of free pages searched */
+    Four i, j;			/* index */
+    Four pos;			/* position of a run found */
+    Four start;			/* first page of an extent */
+    Four nFound;		/* # of runs found */
+    char page[PAGESIZE];	/* page map page */
+    double elapsed;		/* elapsed time */
+
+    (void)file;
+
+    /* free pages scattered among the used ones, and one run at the end */
+    srand(1);
+    memset(page, 0, PAGESIZE);
+    for (i = 0; i < BENCH_MAP_BITS - BENCH_MAP_EXT_SIZE; i++)
+	if (rand() % 100 < BENCH_MAP_FREE) RDsM_set_bits(page, i, 1);
+    RDsM_set_bits(page, BENCH_MAP_BITS - BENCH_MAP_EXT_SIZE, BENCH_MAP_EXT_SIZE);
+
+    for (j = 0; j < (Four)(sizeof(runs) / sizeof(runs[0])); j++) {
+	elapsed = bench_Now();
+	for (i = 0; i < BENCH_MAP_SEARCHES; i++)
+	    pos = RDsM_find_bits(page, 0, BENCH_MAP_BITS, runs[j]);
+	elapsed = bench_Now() - elapsed;
+	printf("find %2d free pages in a page map page : %8.2f ms, %d searches, found at %d\n",
+	       runs[j], elapsed, BENCH_MAP_SEARCHES, pos);
+    }
+
+    elapsed = bench_Now();
+    for (nFound = 0, i = 0; i < BENCH_MAP_EXT_OPS; i++) {
+	start = (i * BENCH_MAP_EXT_SIZE) % (BENCH_MAP_BITS - BENCH_MAP_EXT_SIZE);
+	pos = RDsM_find_bits(page, start, BENCH_MAP_EXT_SIZE, 1);
+	if (pos >= 0) {
+	    nFound++;
+	    RDsM_clear_bits(page, start + pos, 1);
+	    if (RDsM_test_n_bits_set(page, start + pos, 1) == eNOERROR) RDsM_set_bits(page, start + pos, 1);
+	}
+    }
+    elapsed = bench_Now() - elapsed;
+    printf("allocate and free a page in an extent   : %8.2f ms, %d operations, %d pages found\n",
+	   elapsed, BENCH_MAP_EXT_OPS, nFound);
+
+    return(eNOERROR);
+
+} /* bench_PageMap() */
+
+
+
+/*
+ * Function: Four bench_IOUring(bench_File*)
+ *
+ * Description:
+ *  The volume I/O done outside RDsM with the synchronous engine and with
+ *  io_uring: cold scans with the read-ahead, by one worker and by
+ *  BENCH_RA_THREADS workers, and, with the in-tree buffer manager, the
+ *  write-out by BfM_FlushAll() of BENCH_IO_UPDATES updated pages spread
+ *  over the file, with the RDsM writes and with the asynchronous writes,
+ *  through the page cache and with O_DIRECT. The updates are read back
+ *  from the disk and checked.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_IOUring(
+    bench_File *file)		/* IN file of the benchmarks */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four k;			/* index of the engine */
+    Four kind;			/* RDSM_IO_SYNC or RDSM_IO_AUTO */
+    Four nThreads;		/* # of read-ahead workers */
+    Four asyncWrites;		/* TRUE to write through the engine */
+    Four directIO;		/* TRUE to write with O_DIRECT */
+    Four nScanned;		/* # of objects scanned */
+    Four nRequests, nPages;	/* read-ahead statistics */
+    RDsM_IOEngine engine;	/* engine probed for its kind */
+    BfM_Parameters params;	/* parameters of the in-tree buffer manager */
+    BfM_Parameters saved;	/* parameters restored at the end */
+    double elapsed;		/* time of a scan */
+    static Four kinds[] = { RDSM_IO_SYNC, RDSM_IO_AUTO };
+    static char *names[] = { "auto", "io_uring", "sync" };
+
+
+    for (k = 0; k < 2; k++) {
+	kind = kinds[k];
+	e = EduRDsM_SetIOEngine(kind);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduRDsM_InitIOEngine(&engine, 1);
+	if (e < eNOERROR) ERR(e);
+	printf("engine %s (%s)\n", names[kind], names[engine.kind]);
+	(void) EduRDsM_FinalIOEngine(&engine);
+
+	/*@ cold scans with the read-ahead */
+	for (nThreads = 1; nThreads <= BENCH_RA_THREADS; nThreads *= BENCH_RA_THREADS) {
+	    e = bench_DropCaches();
+	    if (e < eNOERROR) ERR(e);
+
+	    e = EduOM_InitReadAhead(file->volId, 1, benchDevNames, nThreads);
+	    if (e < eNOERROR) ERR(e);
+
+	    e = bench_ScanAll(&file->catalogEntry, TRUE, &nScanned, &elapsed);
+	    if (e < eNOERROR) { EduOM_FinalReadAhead(); ERR(e); }
+
+	    EduOM_GetReadAheadStatistics(&nRequests, &nPages);
+	    printf("  cold scan, %d read-ahead worker(s) : %8.2f ms, %d objects, %d requests, %d pages read ahead\n",
+		   nThreads, elapsed, nScanned, nRequests, nPages);
+	    EduOM_FinalReadAhead();
+	}
+
+	/*@ write-out of updated pages */
+	e = bench_UseEduBfM("  flush: ", &saved);
+	if (e < eNOERROR) ERR(e);
+	if (e == FALSE) continue;
+
+	for (i = 0; i < 4; i++) {
+	    directIO = i / 2;
+	    asyncWrites = i % 2;
+	    params = saved;
+	    params.mmapReads = FALSE;
+	    params.directIO = directIO;
+	    params.asyncWrites = asyncWrites;
+	    e = EduBfM_SetParameters(&params);
+	    if (e < eNOERROR) ERR(e);
+
+	    e = bench_FlushUpdates(file, kind * 1000000 + i * 100000, directIO, asyncWrites);
+	    if (e < eNOERROR) ERR(e);
+	}
+
+	e = EduBfM_SetParameters(&saved);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduRDsM_SetIOEngine(RDSM_IO_ENGINE);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_IOUring() */
+
+
+
+/*
+ * Function: Four bench_FlushUpdates(bench_File*, Four, Four, Four)
+ *
+ * Description:
+ *  Update BENCH_IO_UPDATES objects on distinct pages with the values
+ *  'base', 'base' + 1, ..., write them out with BfM_FlushAll() and report
+ *  the time, then read them back from the disk and check them. Used by
+ *  iouring and devices.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_FlushUpdates(
+    bench_File *file,		/* IN file updated */
+    Four base,			/* IN value written into the first object */
+    Four directIO,		/* IN TRUE if the volume is written with O_DIRECT */
+    Four asyncWrites)		/* IN TRUE if the trains are written through the engine */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four value;			/* value of an object */
+    OM_IOVec iov;		/* update of an object */
+    BfM_Statistics stats;	/* statistics of the in-tree buffer manager */
+    double start;		/* start time */
+
+
+    /* objects 7919 apart lie on distinct pages */
+    for (i = 0; i < BENCH_IO_UPDATES; i++) {
+	value = base + i;
+	iov.start = 0;
+	iov.length = sizeof(Four);
+	iov.buf = (char *)&value;
+	e = EduOM_WriteObjectV(&file->oids[(i * 7919L) % file->nObjects], 1, &iov);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    start = bench_Now();
+    e = BfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+    EduBfM_GetStatistics(&stats);
+    printf("  flush, %-6s %-5s writes    : %8.2f ms, %d trains written, %d through the engine",
+	   directIO ? "direct" : "cached", asyncWrites ? "async" : "RDsM", bench_Now() - start,
+	   stats.nWrites, stats.nAsyncWrites);
+
+    /* read the updates back from the disk */
+    e = bench_DropCaches();
+    if (e < eNOERROR) ERR(e);
+    for (i = 0; i < BENCH_IO_UPDATES; i++) {
+	e = EduOM_ReadObject(&file->oids[(i * 7919L) % file->nObjects], 0, sizeof(Four), (char *)&value);
+	if (e < eNOERROR) ERR(e);
+	if (value != base + i) break;
+    }
+    printf(", %s\n", (i == BENCH_IO_UPDATES) ? "checked" : "WRONG DATA");
+
+    return(eNOERROR);
+
+} /* bench_FlushUpdates() */
+
+
+
+/*
+ * Function: Four bench_Devices(bench_File*)
+ *
+ * Description:
+ *  The I/O of volumes of 1, 2 and BENCH_MAX_DEVICES devices of the same
+ *  total size, each measured by bench_DevicesWork() on its own volume
+ *  (see bench_OnVolume()) and removed. The file of the benchmarks is not
+ *  used.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_Devices(
+    bench_File *file)		/* IN file of the benchmarks, not used */
+{
+    Four e;			/* error */
+    Four i;			/* index of the devices */
+    Four numDevices;		/* # of devices of the volume */
+    Four numPagesInDevices[BENCH_MAX_DEVICES]; /* # of pages of each device */
+    char names[BENCH_MAX_DEVICES][32]; /* device names */
+    char *devNames[BENCH_MAX_DEVICES]; /* pointers to 'names' */
+
+    (void)file;
+
+    if (cosmos_RDsM_alloc_ext == NULL)
+	printf("extents allocated in the order of the devices (make ALLOC=intree to stripe them)\n");
+
+    for (i = 0; i < BENCH_MAX_DEVICES; i++) {
+	sprintf(names[i], "bench_dev%ld.vol", (long)i);
+	devNames[i] = names[i];
+    }
+
+    for (numDevices = 1; numDevices <= BENCH_MAX_DEVICES; numDevices *= 2) {
+	for (i = 0; i < numDevices; i++) numPagesInDevices[i] = BENCH_DEV_PAGES / numDevices;
+
+	e = bench_OnVolume(BENCH_DEV_VOLUME + numDevices, numDevices, devNames, numPagesInDevices,
+			   bench_DevicesWork, numDevices);
+	for (i = 0; i < numDevices; i++) unlink(devNames[i]);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* bench_Devices() */
+
+
+
+/*
+ * Function: Four bench_DevicesWork(Four, Four, char**)
+ *
+ * Description:
+ *  Build a file of BENCH_DEV_OBJECTS objects in the mounted volume 'volId'
+ *  of the given devices, sharing BENCH_DEV_PAGES pages, and report the
+ *  pages of the file on each device, a cold scan with one read-ahead
+ *  worker per device and, with the in-tree buffer manager, the write-out
+ *  of updated pages with the asynchronous writes. Used by devices.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_DevicesWork(
+    Four volId,			/* IN volume of the devices */
+    Four numDevices,		/* IN # of devices of the volume */
+    char **devNames)		/* IN device names */
+{
+    Four e;			/* error */
+    Four i, d;			/* indexes */
+    Four nScanned;		/* # of objects scanned */
+    Four nRequests, nPages;	/* read-ahead statistics */
+    Four nDevices;		/* # of devices of the mounted volume */
+    Four onDevice[BENCH_MAX_DEVICES]; /* # of pages of the file on each device */
+    PageNo firstPage[RDSM_MAX_DEVICES+1]; /* first page of each device */
+    PageNo lastPage;		/* page of the previous object */
+    bench_File file;		/* file of the volume */
+    BfM_Parameters params;	/* parameters of the in-tree buffer manager */
+    BfM_Parameters saved;	/* parameters restored at the end */
+    double elapsed;		/* time of the scan */
+
+
+    /*@ build the file */
+    e = bench_CreateFile(volId, BENCH_DEV_OBJECTS, 'x', FALSE, &file);
+    if (e < eNOERROR) ERR(e);
+
+    /*@ pages of the file on each device */
+    e = EduRDsM_GetDevices(volId, &nDevices, NULL, firstPage);
+    if (e < eNOERROR) { free(file.oids); ERR(e); }
+    for (d = 0; d < numDevices; d++) onDevice[d] = 0;
+    for (i = 0, lastPage = NIL; i < file.nObjects; i++) {
+	if (file.oids[i].pageNo == lastPage) continue;
+	lastPage = file.oids[i].pageNo;
+	for (d = 0; d < nDevices - 1 && file.oids[i].pageNo >= firstPage[d+1]; d++) ;
+	onDevice[d]++;
+    }
+    printf("%d device(s), pages of the file on each device:", numDevices);
+    for (d = 0; d < numDevices; d++) printf(" %d", onDevice[d]);
+    printf("\n");
+
+    /*@ cold scan with the read-ahead */
+    e = bench_DropCaches();
+    if (e < eNOERROR) { free(file.oids); ERR(e); }
+
+    e = EduOM_InitReadAhead(volId, numDevices, devNames, 1);
+    if (e < eNOERROR) { free(file.oids); ERR(e); }
+
+    e = bench_ScanAll(&file.catalogEntry, TRUE, &nScanned, &elapsed);
+    EduOM_GetReadAheadStatistics(&nRequests, &nPages);
+    EduOM_FinalReadAhead();
+    if (e < eNOERROR) { free(file.oids); ERR(e); }
+    printf("  cold scan, 1 read-ahead worker per device : %8.2f ms, %d objects, %d requests, %d pages read ahead\n",
+	   elapsed, nScanned, nRequests, nPages);
+
+    /*@ write-out of updated pages */
+    e = bench_UseEduBfM("  flush: ", &saved);
+    if (e < eNOERROR) { free(file.oids); ERR(e); }
+    if (e == TRUE) {
+	params = saved;
+	params.mmapReads = FALSE;
+	params.directIO = FALSE;
+	params.asyncWrites = TRUE;
+	e = EduBfM_SetParameters(&params);
+	if (e < eNOERROR) { free(file.oids); ERR(e); }
+
+	e = bench_FlushUpdates(&file, numDevices * 100000, FALSE, TRUE);
+	if (e < eNOERROR) { free(file.oids); ERR(e); }
+
+	e = EduBfM_SetParameters(&saved);
+	if (e < eNOERROR) { free(file.oids); ERR(e); }
+    }
+
+    free(file.oids);
+
+    return(eNOERROR);
+
+} /* bench_DevicesWork() */
+
+
+
+/*
+ * Function: Four bench_Compress(bench_File*)
+ *
+ * Description:
+ *  The same file in a plain volume and in a volume given a compressed page
+ *  store, each measured by bench_CompressWork() on its own volume (see
+ *  bench_OnVolume()) and removed with its store. The file of the
+ *  benchmarks is not used.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_Compress(
+    bench_File *file)		/* IN file of the benchmarks, not used */
+{
+    Four e;			/* error */
+    Four compressed;		/* TRUE for the volume with a store */
+    Four numPages;		/* # of pages of the volume */
+    char *names[2];		/* the volume and its store */
+
+    (void)file;
+
+    e = bench_UseEduBfM("compress: ", NULL);
+    if (e < eNOERROR) ERR(e);
+    if (e == FALSE) return(eNOERROR);
+
+    names[0] = "bench_lz.vol";
+    names[1] = "bench_lz.vol.lz";
+    numPages = BENCH_LZ_PAGES;
+
+    for (compressed = FALSE; compressed <= TRUE; compressed++) {
+	e = bench_OnVolume(BENCH_LZ_VOLUME + compressed, 1, names, &numPages, bench_CompressWork, compressed);
+	unlink(names[0]);
+	unlink(names[1]);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* bench_Compress() */
+
+
+
+/*
+ * Function: Four bench_CompressWork(Four, Four, char**)
+ *
+ * Description:
+ *  Give the mounted volume 'volId' its compressed page store if
+ *  'compressed', before any page of the volume is used, build a file of
+ *  BENCH_LZ_OBJECTS objects holding the strings of EduOM_Test in it, write
+ *  it out, and report the disk space of the volume and of its store, the
+ *  compression ratio of the store and a cold scan of the file. Used by
+ *  compress.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_CompressWork(
+    Four volId,			/* IN mounted volume */
+    Four compressed,		/* IN TRUE to give the volume a store */
+    char **names)		/* IN the volume and its store */
+{
+    Four e;			/* error */
+    Four i;			/* index of the devices */
+    Four nScanned;		/* # of objects scanned */
+    long long onDisk;		/* bytes of the disk used by the volume and its store */
+    bench_File file;		/* file of the volume */
+    BfM_CompressionStatistics stats; /* statistics of the store */
+    struct stat st;		/* disk space of a file */
+    double elapsed;		/* time of the scan */
+
+
+    if (compressed) {
+	e = EduBfM_SetCompression(volId, names[1]);
+	if (e < eNOERROR) ERR(e);
+
+	/* the pages of the store are dropped too */
+	benchDropNumDevices = 2;
+    }
+
+    /*@ build the file */
+    e = bench_CreateFile(volId, BENCH_LZ_OBJECTS, 0, FALSE, &file);
+    if (e < eNOERROR) ERR(e);
+    free(file.oids);
+
+    e = bench_DropCaches();
+    if (e < eNOERROR) ERR(e);
+
+    /*@ disk space */
+    for (i = 0, onDisk = 0; i < (compressed ? 2 : 1); i++)
+	if (stat(names[i], &st) == 0) onDisk += (long long)st.st_blocks * 512;
+    printf("%s volume: %6.2f MB on disk", compressed ? "compressed" : "plain     ", onDisk / 1048576.0);
+    if (compressed) {
+	e = EduBfM_GetCompressionStatistics(volId, &stats);
+	if (e < eNOERROR) ERR(e);
+	printf(", %d of %d pages stored in %.2f MB (ratio %.2f), %d page write(s) at their home",
+	       stats.nStoredPages, stats.nPages, stats.nStoredBytes / 1048576.0,
+	       (stats.nStoredBytes > 0) ? (double)stats.nStoredPages * PAGESIZE / stats.nStoredBytes : 0.0,
+	       stats.nHomeWrites);
+    }
+    printf("\n");
+
+    /*@ cold scan */
+    e = bench_ScanAll(&file.catalogEntry, TRUE, &nScanned, &elapsed);
+    if (e < eNOERROR) ERR(e);
+    printf("  cold scan : %8.2f ms, %d objects\n", elapsed, nScanned);
+
+    return(eNOERROR);
+
+} /* bench_CompressWork() */
+
+
+
+/*
+ * Function: Four bench_Format(bench_File*)
+ *
+ * Description:
+ *  The time to format and mount volumes of BENCH_FMT_MIN_PAGES to
+ *  BENCH_FMT_MAX_PAGES pages, and to allocate the first extent of a file
+ *  in them, with their disk space after formatting: a new file formatted
+ *  by LRDS_FormatDataVolume(), and a file filled by an earlier use
+ *  formatted as is, or prepared by EduRDsM_PrepareDevices() as a sparse
+ *  file or with its space reserved. The first extents are zeroed (see
+ *  EduRDsM_SetInitExt()). The volumes are formatted and mounted outside
+ *  the transaction of the benchmarks, which is committed first and
+ *  restarted at the end; the steps are timed one by one, so
+ *  bench_OnVolume() is not used. The file of the benchmarks is not used.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_Format(
+    bench_File *file)		/* IN file of the benchmarks, not used */
+{
+    Four e, e2;			/* error */
+    Four numPages;		/* # of pages of the volume */
+    Four volNo;			/* volume being measured */
+    Four mode;			/* index of 'modes' */
+    Four i;			/* index of the pages */
+    int fd;			/* descriptor of the volume */
+    char *names[1];		/* the volume */
+    static char page[PAGESIZE];	/* page of the earlier use of the file */
+    static char *modes[] = { "new file,  format ", "used file, format ", "used file, sparse ", "used file, reserve" };
+    struct stat st;		/* disk space of the volume */
+    FileID fid;			/* file created */
+    XactID xactId;		/* transaction of a volume */
+    double start;		/* start time */
+    double formatTime, mountTime, allocTime; /* times measured */
+
+    (void)file;
+
+    if (EduRDsM_SetInitExt == NULL)
+	printf("extents not zeroed at their first allocation (make ALLOC=intree to zero them)\n");
+    else
+	EduRDsM_SetInitExt(TRUE);
+
+    names[0] = "bench_fmt.vol";
+    memset(page, 'u', PAGESIZE);
+
+    e = LRDS_CommitTransaction(&benchXactId);
+    if (e < eNOERROR) ERR(e);
+
+    for (numPages = BENCH_FMT_MIN_PAGES; numPages <= BENCH_FMT_MAX_PAGES && e >= eNOERROR; numPages *= 4)
+	for (mode = 0; mode < 4 && e >= eNOERROR; mode++) {
+	    /* the file of an earlier use */
+	    unlink(names[0]);
+	    if (mode > 0) {
+		fd = open(names[0], O_WRONLY | O_CREAT, 0644);
+		for (i = 0; fd >= 0 && i < numPages; i++)
+		    if (write(fd, page, PAGESIZE) != PAGESIZE) break;
+		if (fd >= 0) {
+		    fdatasync(fd);
+		    close(fd);
+		}
+	    }
+
+	    volNo = BENCH_FMT_VOLUME;
+	    start = bench_Now();
+	    if (mode >= 2)
+		e = EduRDsM_PrepareDevices(1, names, &numPages, (mode == 2) ? RDSM_FORMAT_SPARSE : RDSM_FORMAT_RESERVE);
+	    if (e >= eNOERROR) e = LRDS_FormatDataVolume(1, names, "format", volNo, 16, &numPages, 16);
+	    if (e < eNOERROR) break;
+	    formatTime = bench_Now() - start;
+	    if (stat(names[0], &st) != 0) st.st_blocks = 0;
+
+	    start = bench_Now();
+	    e = LRDS_Mount(1, names, &volNo);
+	    if (e < eNOERROR) break;
+	    mountTime = bench_Now() - start;
+
+	    e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+	    if (e >= eNOERROR) {
+		start = bench_Now();
+		e = SM_CreateFile(volNo, &fid, FALSE, NULL);
+		allocTime = bench_Now() - start;
+
+		/* the volume is not logged, so its transaction is not aborted */
+		e2 = LRDS_CommitTransaction(&xactId);
+		if (e >= eNOERROR) e = e2;
+	    }
+
+	    e2 = LRDS_Dismount(volNo);
+	    if (e >= eNOERROR) e = e2;
+	    if (e < eNOERROR) break;
+
+	    printf("%5ld MB, %s: format %8.2f ms, mount %6.2f ms, first extent %6.2f ms, %8.2f MB on disk\n",
+		   (long)((long long)numPages * PAGESIZE / 1048576), modes[mode], formatTime, mountTime, allocTime,
+		   (long long)st.st_blocks * 512 / 1048576.0);
+	}
+    unlink(names[0]);
+    if (EduRDsM_SetInitExt != NULL) EduRDsM_SetInitExt(FALSE);
+
+    e2 = LRDS_BeginTransaction(&benchXactId, X_RR_RR);
+    if (e >= eNOERROR) e = e2;
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_Format() */
@@ -0,0 +1,156 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_BuildZoneMap.c
+ *
+ * Description:
+ *  Build the zone map of a data file.
+ *
+ * Export:
+ *  Four EduOM_BuildZoneMap(ObjectID*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+/*@================================
+ * EduOM_BuildZoneMap()
+ *================================*/
+/*
+ * Function: Four EduOM_BuildZoneMap(ObjectID*)
+ *
+ * Description:
+ *  Build the zone map of the data file given by 'catObjForFile' by reading
+ *  every page of the file once. From then on, EduOM_CreateObject() and
+ *  EduOM_DestroyObject() keep the zone map up to date, and the filtered
+ *  scans opened on the file pass over the pages which cannot hold a
+ *  qualifying object without fixing them. An existing zone map of the file
+ *  is rebuilt.
+ *
+ *  The zone map lives in main memory only. It must be dropped with
+ *  EduOM_DropZoneMap() before the file is destroyed, and it is not
+ *  maintained for objects changed by other means than EduOM.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+Four EduOM_BuildZoneMap(
+    ObjectID *catObjForFile)	/* IN informations about a data file */
+{
+    Four e;			/* error */
+    Two  i;			/* slot number */
+    PageID pid;			/* page being summarized */
+    PageNo nextPage;		/* next page of 'pid' */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+    OM_ZoneMap *map;		/* the zone map */
+    Object *obj;		/* an object of the page */
+    ObjectHdr objHdr;		/* header of 'obj' as a scan returns it */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    map = eduom_GetZoneMap(catObjForFile);
+    if (map != NULL) eduom_FreeZoneMap(map);
+
+    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+
+    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    map = eduom_NewZoneMap(catObjForFile);
+    if (map == NULL) ERR(eMEMORYALLOCERR);
+
+    /*@ summarize the pages along the page list */
+    while (pid.pageNo != NIL) {
+	e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
+	if (e < 0) {
+	    eduom_FreeZoneMap(map);
+	    ERR(e);
+	}
+
+	/* an empty page is summarized too, so that it can be passed over */
+	e = eduom_ZoneMapInsert(catObjForFile, apage, NULL);
+	if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+	for (i = 0; i < apage->header.nSlots; i++) {
+	    if (apage->slot[-i].offset == EMPTYSLOT) continue;
+	    obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+
+	    /* a stub is summarized with the header of its moved object */
+	    e = eduom_ScanHeader(obj, &objHdr);
+	    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+	    e = eduom_ZoneMapInsert(catObjForFile, apage, &objHdr);
+	    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+	}
+
+	nextPage = apage->header.nextPage;
+	e = BfM_FreeTrain(&pid, PAGE_BUF);
+	if (e < 0) ERR(e);
+
+	/* the zone map is given up if memory is short */
+	if (eduom_GetZoneMap(catObjForFile) == NULL) ERR(eMEMORYALLOCERR);
+
+	pid.pageNo = nextPage;
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_BuildZoneMap() */
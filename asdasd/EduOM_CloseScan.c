@@ -0,0 +1,104 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_CloseScan.c
+ *
+ * Description:
+ *  Close a scan cursor on a data file.
+ *
+ * Export:
+ *  Four EduOM_CloseScan(OM_ScanCursor*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+/*@================================
+ * EduOM_CloseScan()
+ *================================*/
+/*
+ * Function: Four EduOM_CloseScan(OM_ScanCursor*)
+ *
+ * Description:
+ *  Close the scan cursor. The pages fixed by the cursor, if any, are freed.
+ *  Closing a cursor twice is harmless.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_CloseScan(
+    OM_ScanCursor *cursor)		/* INOUT the scan cursor to close */
+{
+    Four e;			/* error */
+
+
+    /*@ parameter checking */
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    if (cursor->apage != NULL) {
+	cursor->apage = NULL;
+	e = BfM_FreeTrain(&cursor->pid, PAGE_BUF);
+	if (e < 0) ERR(e);
+    }
+
+    if (cursor->fwdPage != NULL) {
+	cursor->fwdPage = NULL;
+	e = BfM_FreeTrain(&cursor->fwdPid, PAGE_BUF);
+	if (e < 0) ERR(e);
+    }
+
+    cursor->eos = TRUE;
+
+    return(eNOERROR);
+
+} /* EduOM_CloseScan() */
@@ -0,0 +1,176 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_CollapseForwarding.c
+ *
+ * Description:
+ *  Remove the stubs left by the moved objects of a data file.
+ *
+ * Export:
+ *  Four EduOM_CollapseForwarding(ObjectID*, OM_RemapCallback, void*, Four*, Pool*, DeallocListElem*)
+ */
+
+
+#include "EduOM_common.h"
+#include "Util.h"		/* to get Pool */
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * EduOM_CollapseForwarding()
+ *================================*/
+/*
+ * Function: Four EduOM_CollapseForwarding(ObjectID*, OM_RemapCallback, void*, Four*, Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Turn every forwarded record of the data file into an ordinary object and
+ *  destroy the stub pointing to it, releasing the pages which become empty.
+ *  From then on, a moved object is known by the ID of its forwarded record:
+ *  'remap', if given, is called with the ID of the stub and the ID of the
+ *  forwarded record before the stub is destroyed.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    the negative value returned by 'remap'
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  *nPages, if not NULL, is set to the number of pages released.
+ */
+Four EduOM_CollapseForwarding(
+    ObjectID *catObjForFile,	/* IN informations about a data file */
+    OM_RemapCallback remap,	/* IN function told about the collapsed stubs, may be NULL */
+    void *arg,			/* IN argument of 'remap' */
+    Four *nPages,		/* OUT # of pages released, may be NULL */
+    Pool *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four e;			/* error */
+    Two  i, j;			/* slot numbers */
+    PageID pid;			/* page being visited */
+    PageID fwdPid;		/* page of the forwarded record */
+    PageNo firstPage;		/* first page of the file */
+    PageNo nextPage;		/* page to visit after 'pid' */
+    SlottedPage *apage;		/* buffer holding 'pid' */
+    SlottedPage *fwdPage;	/* buffer holding 'fwdPid' */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+    Object *obj;		/* stub */
+    Object *fwdObj;		/* forwarded record */
+    ObjectID stubOid;		/* ID of the stub */
+    ObjectID fwdOid;		/* ID of the forwarded record */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (nPages != NULL) *nPages = 0;
+
+    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    firstPage = catEntry->firstPage;
+
+    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    /*@ collapse the stubs page by page */
+    while (pid.pageNo != NIL) {
+	e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
+	if (e < 0) ERR(e);
+	nextPage = apage->header.nextPage;
+
+	for (i = 0; i < apage->header.nSlots; i++) {
+	    if (apage->slot[-i].offset == EMPTYSLOT) continue;
+	    obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+	    if (!(obj->header.properties & P_MOVED)) continue;
+
+	    /* the forwarded record becomes an ordinary object */
+	    fwdOid = *((ObjectID *)obj->data);
+	    MAKE_PAGEID(fwdPid, fwdOid.volNo, fwdOid.pageNo);
+	    e = BfM_GetTrain(&fwdPid, (char **)&fwdPage, PAGE_BUF);
+	    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+	    fwdObj = (Object *)&(fwdPage->data[fwdPage->slot[-fwdOid.slotNo].offset]);
+	    fwdObj->header.properties &= ~P_FORWARDED;
+	    e = BfM_SetDirty(&fwdPid, PAGE_BUF);
+	    if (e >= 0) e = BfM_FreeTrain(&fwdPid, PAGE_BUF);
+	    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+	    MAKE_OBJECTID(stubOid, pid.volNo, pid.pageNo, i, apage->slot[-i].unique);
+	    if (remap != NULL) {
+		e = remap(&stubOid, &fwdOid, arg);
+		if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+	    }
+
+	    /* count the page if the stub is the last object in it */
+	    for (j = 0; j < apage->header.nSlots; j++)
+		if (j != i && apage->slot[-j].offset != EMPTYSLOT) break;
+	    if (j == apage->header.nSlots && pid.pageNo != firstPage && nPages != NULL) (*nPages)++;
+
+	    /* the stub is destroyed as an ordinary object */
+	    obj->header.properties &= ~P_MOVED;
+	    e = EduOM_DestroyObject(catObjForFile, &stubOid, dlPool, dlHead);
+	    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+	}
+
+	e = BfM_FreeTrain(&pid, PAGE_BUF);
+	if (e < 0) ERR(e);
+
+	pid.pageNo = nextPage;
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_CollapseForwarding() */
@@ -121,14 +121,31 @@ FileID      fid;      /* ID of file where the object was placed */
     sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
     DeallocListElem *dlElem;   /* pointer to element of dealloc list */
     PhysicalFileID pFid;   /* physical ID of file */
+    PageID   fwdPid;   /* page holding the forwarded record of a moved object */
+    SlottedPage *fwdPage;   /* pointer to the buffer holding 'fwdPid' */
+    Object      *fwdObj;   /* forwarded record of a moved object */
     
     
 
     /*@ Check parameters. */
 
+   eduom_ObjectCacheInvalidate(oid);
    pid=*((PageID *)oid);
    e = BfM_GetTrain(&pid, &apage, PAGE_BUF);
    if (e < 0) ERR(e);
+   obj = (Object *)(apage->data + apage->slot[-oid->slotNo].offset);
+   if (obj->header.properties & P_FORWARDED)	/* a moved object is destroyed through its stub */
+      ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+   if (obj->header.properties & P_MOVED)	/* destroy the forwarded record too */
+   {
+      e = eduom_FixForwarded(obj, &fwdPid, &fwdPage, &fwdObj);
+      if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+      fwdObj->header.properties &= ~P_FORWARDED;
+      e = BfM_FreeTrain(&fwdPid, PAGE_BUF);
+      if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+      e = EduOM_DestroyObject(catObjForFile, (ObjectID *)obj->data, dlPool, dlHead);
+      if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+   }
    e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage); 
    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
    offset = apage->slot[-oid->slotNo].offset;
@@ -148,7 +165,7 @@ FileID      fid;      /* ID of file where the object was placed */
       apage->header.unused += alignedLen;
    }
    e = BfM_GetTrain((TrainID*)catObjForFile, &catPage, PAGE_BUF);
-   if (e < 0) ERR(e);
+   if (e < 0) ERRB1(e, &pid, PAGE_BUF);
    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
    fid = catEntry->fid;
    last = FALSE;
@@ -158,15 +175,26 @@ FileID      fid;      /* ID of file where the object was placed */
 	i++;
    }
    if (i == apage->header.nSlots)last = TRUE;
+   e = eduom_ZoneMapRemove(catObjForFile, apage, (last && pid.pageNo != catEntry->firstPage) ? TRUE : FALSE);
+   if (e < 0) {
+      (Four) BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+      ERRB1(e, &pid, PAGE_BUF);
+   }
    if (last)
    {
       if (pid.pageNo != catEntry->firstPage)
       {
          e = om_FileMapDeletePage(catObjForFile, &pid);
-         if (e < 0) ERR(e);
+         if (e < 0) {
+            (Four) BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+            ERRB1(e, &pid, PAGE_BUF);
+         }
 	 dlElem=dlHead;
          e = Util_getElementFromPool(dlPool, dlElem);
-         if (e < 0) ERR(e);
+         if (e < 0) {
+            (Four) BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+            ERRB1(e, &pid, PAGE_BUF);
+         }
          dlElem->type = DL_PAGE;
          dlElem->elem.pid = pid;
          dlElem->next = dlHead;
@@ -175,10 +203,13 @@ FileID      fid;      /* ID of file where the object was placed */
    }
    else {
       e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
-      if (e < 0) ERR(e);
+      if (e < 0) {
+         (Four) BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+         ERRB1(e, &pid, PAGE_BUF);
+      }
    }
    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
-   if (e < 0) ERR(e);
+   if (e < 0) ERRB1(e, &pid, PAGE_BUF);
    e = BfM_FreeTrain(&pid, PAGE_BUF);
    if (e < 0) ERR(e);
 
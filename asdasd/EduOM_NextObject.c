@@ -100,6 +100,7 @@ Four EduOM_NextObject(
     Four offset;		/* starting offset of object within a page */
     PageID pid;			/* a page identifier */
     PageNo pageNo;		/* a temporary var for next page's PageNo */
+    PageID fromPid;		/* page the scan moves from */
     SlottedPage *apage;		/* a pointer to the data page */
     Object *obj;		/* a pointer to the Object */
     PhysicalFileID pFid;	/* file in which the objects are located */
@@ -120,6 +121,7 @@ Four EduOM_NextObject(
 	MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
 	e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
 	if (e < 0) ERR(e);
+	MAKE_PAGEID(fromPid, pFid.volNo, NIL);
 	if (curOID == NULL) {//iod nullΰ
 		pid = *((PageID *)&pFid);//page ù id
 
@@ -129,28 +131,38 @@ Four EduOM_NextObject(
 		if (e < 0)  ERR(e);
 		for (i = curOID->slotNo + 1; i < apage->header.nSlots; i++) {// objectŽ
 			offset = apage->slot[-i].offset;
-			if (offset != EMPTYSLOT) {
+			if (OM_IS_OBJECT_SLOT(apage, i)) {
 				obj = (Object *)&(apage->data[offset]);
 				MAKE_OBJECTID(*nextOID, curOID->volNo, curOID->pageNo,i, apage->slot[-i].unique);
-				if (objHdr != NULL) *objHdr = obj->header;
+				if (objHdr != NULL) {
+					e = eduom_ScanHeader(obj, objHdr);
+					if (e < 0) ERRB1(e, (PageID *)curOID, PAGE_BUF);
+				}
 				e = BfM_FreeTrain((PageID *)curOID, PAGE_BUF);
 				if (e < 0)  ERR(e);
 				return(eNOERROR);
 				}
 			}
 		MAKE_PAGEID(pid, curOID->volNo, apage->header.nextPage);//    Ȯ
+		fromPid = *((PageID *)curOID);
 		e = BfM_FreeTrain((PageID *)curOID, PAGE_BUF);
 		if (e < 0)  ERR(e);
 	}
 	while (pid.pageNo != NIL) {
 		e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
 		if (e < 0)  ERR(e);
+		e = eduom_ReadAheadStep(NULL, &fromPid, apage, FORWARD);
+		if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+		fromPid = pid;
 		for (i = 0; i < apage->header.nSlots; i++) {
 			offset = apage->slot[-i].offset;
-			if (offset != EMPTYSLOT) {
+			if (OM_IS_OBJECT_SLOT(apage, i)) {
 				obj = (Object *)&(apage->data[offset]);
 				MAKE_OBJECTID(*nextOID, pid.volNo, pid.pageNo,i, apage->slot[-i].unique);
-				if (objHdr != NULL) *objHdr = obj->header;
+				if (objHdr != NULL) {
+					e = eduom_ScanHeader(obj, objHdr);
+					if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+				}
 				e = BfM_FreeTrain(&pid, PAGE_BUF);
 				if (e < 0) ERR(e);
 				return(eNOERROR);
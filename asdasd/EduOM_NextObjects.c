@@ -0,0 +1,167 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_NextObjects.c
+ *
+ * Description:
+ *  Return the objects following the given current object in bulk.
+ *
+ * Export:
+ *  Four EduOM_NextObjects(ObjectID*, ObjectID*, Four, ObjectID*, ObjectHdr*, Four*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+/*@================================
+ * EduOM_NextObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_NextObjects(ObjectID*, ObjectID*, Four, ObjectID*, ObjectHdr*, Four*)
+ *
+ * Description:
+ *  Return at most 'maxN' objects following the current object in one call.
+ *  This is the batch version of EduOM_NextObject(): it walks the same
+ *  'nextPage' chain, but each page is fixed only once and all its live
+ *  objects are copied into the caller's arrays before moving on, so the
+ *  buffer is accessed once per page instead of once per object.
+ *  The catalog object is accessed only when 'curOID' is NULL, i.e. when the
+ *  scan starts from the first object of the file.
+ *  To continue the scan, pass the last returned ObjectID as 'curOID'.
+ *  A moved object is returned under the ID of its stub, with the header of
+ *  its forwarded record.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *  EOS if there is no more object
+ *
+ * Side effect:
+ *  1) parameter oids
+ *     oids[0..*n-1] are filled with the identifiers of the next objects
+ *  2) parameter objHdrs
+ *     objHdrs[0..*n-1] are filled with the headers of the next objects
+ *  3) parameter n
+ *     n is set to the number of objects returned
+ */
+Four EduOM_NextObjects(
+    ObjectID  *catObjForFile,	/* IN informations about a data file */
+    ObjectID  *curOID,		/* IN a ObjectID of the current Object */
+    Four      maxN,		/* IN capacity of 'oids' and 'objHdrs' */
+    ObjectID  *oids,		/* OUT the next objects of a current Object */
+    ObjectHdr *objHdrs,		/* OUT the object headers of next objects, may be NULL */
+    Four      *n)		/* OUT number of objects returned */
+{
+    Four e;			/* error */
+    Two  i;			/* index */
+    Four offset;		/* starting offset of object within a page */
+    PageID pid;			/* a page identifier */
+    PageNo pageNo;		/* a temporary var for next page's PageNo */
+    SlottedPage *apage;		/* a pointer to the data page */
+    Object *obj;		/* a pointer to the Object */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (oids == NULL) ERR(eBADOBJECTID_OM);
+
+    if (n == NULL || maxN <= 0) ERR(eBADPARAMETER_OM);
+
+    *n = 0;
+
+    if (curOID == NULL) {
+	e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+	if (e < 0) ERR(e);
+	GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+	MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+	e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+	if (e < 0) ERR(e);
+	i = 0;
+    }
+    else {
+	MAKE_PAGEID(pid, curOID->volNo, curOID->pageNo);
+	i = curOID->slotNo + 1;
+    }
+
+    while (pid.pageNo != NIL) {
+	e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
+	if (e < 0) ERR(e);
+
+	for ( ; i < apage->header.nSlots && *n < maxN; i++) {
+	    if (!OM_IS_OBJECT_SLOT(apage, i)) continue;
+	    offset = apage->slot[-i].offset;
+
+	    MAKE_OBJECTID(oids[*n], pid.volNo, pid.pageNo, i, apage->slot[-i].unique);
+	    if (objHdrs != NULL) {
+		obj = (Object *)&(apage->data[offset]);
+		e = eduom_ScanHeader(obj, &objHdrs[*n]);
+		if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+	    }
+	    (*n)++;
+	}
+
+	pageNo = (*n < maxN) ? apage->header.nextPage : NIL;
+	e = BfM_FreeTrain(&pid, PAGE_BUF);
+	if (e < 0) ERR(e);
+
+	MAKE_PAGEID(pid, pid.volNo, pageNo);
+	i = 0;
+    }
+
+    return((*n > 0) ? eNOERROR : EOS);
+
+} /* EduOM_NextObjects() */
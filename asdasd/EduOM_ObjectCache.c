@@ -0,0 +1,539 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_ObjectCache.c
+ *
+ * Description:
+ *  Cache of hot small objects in front of the buffer manager.
+ *  EduOM_ReadObject() looks the object up here first, and a hit is served
+ *  without fixing the page. The cache holds copies of whole objects keyed
+ *  by ObjectID; an entry is checked against the 'unique' of the object ID,
+ *  so a slot reused by another object is never served from a stale entry.
+ *  Since the copies do not depend on where an object lies in its page, the
+ *  compaction of a page does not touch the cache; an object is dropped when
+ *  it is destroyed or updated.
+ *
+ *  The memory used by the entries stays within a budget; the entries are
+ *  evicted in CLOCK order. To resist scans, an object is admitted only when
+ *  it is read the second time while it is still remembered by the door
+ *  keeper, a small table of the objects missed recently; objects read once
+ *  by a scan thus never displace the hot ones.
+ *
+ *  The cache is off until EduOM_InitObjectCache() is called. It does not
+ *  make reads of objects whose pages are in the buffer faster: a hit
+ *  saves the fix of a buffered page, which costs about as much as the
+ *  lookup and the copy, and a miss pays for the lookup on top of the
+ *  read (see the "objcache" benchmark of EduOM_Bench.c).
+ *
+ * Exports:
+ *  Four EduOM_InitObjectCache(Four)
+ *  Four EduOM_FinalObjectCache(void)
+ *  Four EduOM_GetObjectCacheStatistics(OM_ObjectCacheStats*)
+ *  Boolean eduom_ObjectCacheRead(ObjectID*, Four, Four, char*, Four*, double*)
+ *  void eduom_ObjectCacheAdmit(ObjectID*, Object*, double)
+ *  void eduom_ObjectCacheInvalidate(ObjectID*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+#define OC_MIN_BUCKETS      1024    /* minimum # of hash buckets */
+#define OC_BYTES_PER_BUCKET 256     /* budget per hash bucket */
+#define OC_MAX_FRACTION     8       /* an object may use at most 1/8 of the budget */
+
+/*
+ * Typedef for a cached object
+ */
+typedef struct oc_Entry {
+    ObjectID oid;                       /* object identifier */
+    Four     length;                    /* length of the object */
+    Boolean  referenced;                /* CLOCK reference bit */
+    struct oc_Entry *hashNext;          /* next entry in the hash bucket */
+    struct oc_Entry *clockPrev;         /* previous entry in the CLOCK ring */
+    struct oc_Entry *clockNext;         /* next entry in the CLOCK ring */
+    char     data[1];                   /* data of the object */
+} oc_Entry;
+
+#define OC_ENTRY_SIZE(length)   (sizeof(oc_Entry) + (length))
+
+
+static Boolean          ocEnabled = FALSE;
+static pthread_mutex_t  ocMutex = PTHREAD_MUTEX_INITIALIZER;
+static Four             ocBudget;                   /* memory budget */
+static oc_Entry         **ocBuckets;                /* hash buckets */
+static UFour            ocMask;                     /* # of buckets - 1 */
+static oc_Entry         *ocHand;                    /* CLOCK hand, NULL if empty */
+static UFour            ocDoorkeeper[OC_DOORKEEPER_SIZE]; /* hashes of the objects missed recently */
+static OM_ObjectCacheStats ocStats;                 /* statistics */
+static double           ocHitTime, ocMissTime;      /* total time of the timed reads */
+static Four             ocNumTimedHits, ocNumTimedMisses; /* # of timed reads */
+
+
+static UFour eduom_ObjectCacheHash(ObjectID*);
+static oc_Entry **eduom_ObjectCacheFind(ObjectID*);
+static void eduom_ObjectCacheRemove(oc_Entry**);
+static double eduom_ObjectCacheNow(void);
+
+
+
+/*@================================
+ * EduOM_InitObjectCache()
+ *================================*/
+/*
+ * Function: Four EduOM_InitObjectCache(Four)
+ *
+ * Description:
+ *  Enable the object cache with a memory budget of 'budget' bytes. The
+ *  cache is emptied and its statistics are reset if it is enabled already.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eMEMORYALLOCERR
+ */
+Four EduOM_InitObjectCache(
+    Four budget)		/* IN memory budget in bytes */
+{
+    UFour nBuckets;		/* # of hash buckets */
+
+
+    /*@ parameter checking */
+    if (budget <= 0) ERR(eBADPARAMETER_OM);
+
+    EduOM_FinalObjectCache();
+
+    for (nBuckets = OC_MIN_BUCKETS; nBuckets < (UFour)(budget / OC_BYTES_PER_BUCKET); nBuckets *= 2) ;
+
+    pthread_mutex_lock(&ocMutex);
+    ocBuckets = (oc_Entry **)calloc(nBuckets, sizeof(oc_Entry *));
+    if (ocBuckets == NULL) {
+	pthread_mutex_unlock(&ocMutex);
+	ERR(eMEMORYALLOCERR);
+    }
+    ocMask = nBuckets - 1;
+    ocBudget = budget;
+    ocHand = NULL;
+    memset(ocDoorkeeper, 0, sizeof(ocDoorkeeper));
+    memset(&ocStats, 0, sizeof(ocStats));
+    ocHitTime = ocMissTime = 0.0;
+    ocNumTimedHits = ocNumTimedMisses = 0;
+    ocEnabled = TRUE;
+    pthread_mutex_unlock(&ocMutex);
+
+    return(eNOERROR);
+
+} /* EduOM_InitObjectCache() */
+
+
+
+/*@================================
+ * EduOM_FinalObjectCache()
+ *================================*/
+/*
+ * Function: Four EduOM_FinalObjectCache(void)
+ *
+ * Description:
+ *  Disable the object cache and free its entries.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four EduOM_FinalObjectCache(void)
+{
+    UFour i;			/* index */
+    oc_Entry *entry;		/* entry to free */
+
+
+    pthread_mutex_lock(&ocMutex);
+    if (ocEnabled) {
+	for (i = 0; i <= ocMask; i++) {
+	    while ((entry = ocBuckets[i]) != NULL) {
+		ocBuckets[i] = entry->hashNext;
+		free(entry);
+	    }
+	}
+	free(ocBuckets);
+	ocBuckets = NULL;
+	ocHand = NULL;
+	ocStats.nEntries = ocStats.nBytes = 0;
+	ocEnabled = FALSE;
+    }
+    pthread_mutex_unlock(&ocMutex);
+
+    return(eNOERROR);
+
+} /* EduOM_FinalObjectCache() */
+
+
+
+/*@================================
+ * EduOM_GetObjectCacheStatistics()
+ *================================*/
+/*
+ * Function: Four EduOM_GetObjectCacheStatistics(OM_ObjectCacheStats*)
+ *
+ * Description:
+ *  Return the statistics of the object cache since it was enabled. The
+ *  latencies are averaged over one read in OC_LATENCY_SAMPLE.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_GetObjectCacheStatistics(
+    OM_ObjectCacheStats *stats)	/* OUT statistics */
+{
+    /*@ parameter checking */
+    if (stats == NULL) ERR(eBADPARAMETER_OM);
+
+    pthread_mutex_lock(&ocMutex);
+    *stats = ocStats;
+    stats->hitLatency = (ocNumTimedHits > 0) ? ocHitTime / ocNumTimedHits : 0.0;
+    stats->missLatency = (ocNumTimedMisses > 0) ? ocMissTime / ocNumTimedMisses : 0.0;
+    pthread_mutex_unlock(&ocMutex);
+
+    return(eNOERROR);
+
+} /* EduOM_GetObjectCacheStatistics() */
+
+
+
+/*@================================
+ * eduom_ObjectCacheRead()
+ *================================*/
+/*
+ * Function: Boolean eduom_ObjectCacheRead(ObjectID*, Four, Four, char*, Four*, double*)
+ *
+ * Description:
+ *  Serve a read of EduOM_ReadObject() from the cache if the object is in
+ *  it. On a hit, 'result' is set to what EduOM_ReadObject() returns. On a
+ *  miss, the caller reads the object from its page and offers it to the
+ *  cache with eduom_ObjectCacheAdmit(), passing on 'missStart'.
+ *
+ * Returns:
+ *  TRUE if the read has been served
+ */
+Boolean eduom_ObjectCacheRead(
+    ObjectID *oid,		/* IN object to read */
+    Four start,			/* IN starting offset of read */
+    Four length,		/* IN amount of data to read */
+    char *buf,			/* OUT user buffer */
+    Four *result,		/* OUT # of bytes read or an error code */
+    double *missStart)		/* OUT start of the read if it is a timed miss, else 0 */
+{
+    oc_Entry **link;		/* link to the entry of the object */
+    oc_Entry *entry;		/* entry of the object */
+    double begin;		/* start time of a timed read, 0 if not timed */
+
+
+    *missStart = 0.0;
+    if (!ocEnabled) return(FALSE);
+
+    pthread_mutex_lock(&ocMutex);
+
+    begin = (++ocStats.nLookups % OC_LATENCY_SAMPLE == 0) ? eduom_ObjectCacheNow() : 0.0;
+
+    link = eduom_ObjectCacheFind(oid);
+    if (link != NULL && (*link)->oid.unique != oid->unique) {
+	/* the slot has been reused by another object */
+	eduom_ObjectCacheRemove(link);
+	ocStats.nInvalidations++;
+	link = NULL;
+    }
+
+    if (link == NULL) {
+	*missStart = begin;
+	pthread_mutex_unlock(&ocMutex);
+	return(FALSE);
+    }
+
+    entry = *link;
+    entry->referenced = TRUE;
+    ocStats.nHits++;
+
+    if (start < 0 || start >= entry->length)
+	*result = eBADSTART_OM;
+    else {
+	if (length == REMAINDER || length + start > entry->length) length = entry->length - start;
+	memcpy(buf, &entry->data[start], length);
+	*result = length;
+    }
+
+    if (begin > 0.0) {
+	ocHitTime += eduom_ObjectCacheNow() - begin;
+	ocNumTimedHits++;
+    }
+
+    pthread_mutex_unlock(&ocMutex);
+
+    return(TRUE);
+
+} /* eduom_ObjectCacheRead() */
+
+
+
+/*@================================
+ * eduom_ObjectCacheAdmit()
+ *================================*/
+/*
+ * Function: void eduom_ObjectCacheAdmit(ObjectID*, Object*, double)
+ *
+ * Description:
+ *  Offer the object just read from its page after a miss. It is entered
+ *  if it was missed recently as well, evicting entries in CLOCK order as
+ *  needed to stay within the budget; otherwise it is only remembered by
+ *  the door keeper. Large objects and stubs are not cached. 'missStart'
+ *  is the one returned by eduom_ObjectCacheRead() for the miss.
+ */
+void eduom_ObjectCacheAdmit(
+    ObjectID *oid,		/* IN object read */
+    Object *obj,		/* IN the object in the buffer */
+    double missStart)		/* IN start of the read if it is a timed miss, else 0 */
+{
+    UFour h;			/* hash of the object ID with its unique */
+    UFour *door;		/* door keeper slot of the object */
+    Four size;			/* memory needed by the entry */
+    oc_Entry **link;		/* link to an entry */
+    oc_Entry *entry;		/* new entry */
+
+
+    if (!ocEnabled) return;
+
+    pthread_mutex_lock(&ocMutex);
+
+    if (missStart > 0.0) {
+	ocMissTime += eduom_ObjectCacheNow() - missStart;
+	ocNumTimedMisses++;
+    }
+
+    size = OC_ENTRY_SIZE(obj->header.length);
+    if ((obj->header.properties & (P_LRGOBJ | P_MOVED)) || size > ocBudget / OC_MAX_FRACTION ||
+	eduom_ObjectCacheFind(oid) != NULL) {
+	pthread_mutex_unlock(&ocMutex);
+	return;
+    }
+
+    /*@ admit the object on its second miss */
+    h = (eduom_ObjectCacheHash(oid) ^ (UFour)oid->unique * 0x9E3779B1U) | 1;
+    door = &ocDoorkeeper[h % OC_DOORKEEPER_SIZE];
+    if (*door != h) {
+	*door = h;
+	pthread_mutex_unlock(&ocMutex);
+	return;
+    }
+    *door = 0;
+
+    /*@ evict entries in CLOCK order */
+    while (ocHand != NULL && ocStats.nBytes + size > ocBudget) {
+	if (ocHand->referenced) {
+	    ocHand->referenced = FALSE;
+	    ocHand = ocHand->clockNext;
+	    continue;
+	}
+	link = eduom_ObjectCacheFind(&ocHand->oid);
+	eduom_ObjectCacheRemove(link);
+	ocStats.nEvictions++;
+    }
+
+    entry = (oc_Entry *)malloc(size);
+    if (entry != NULL) {
+	entry->oid = *oid;
+	entry->length = obj->header.length;
+	entry->referenced = FALSE;
+	memcpy(entry->data, obj->data, obj->header.length);
+
+	link = &ocBuckets[eduom_ObjectCacheHash(oid) & ocMask];
+	entry->hashNext = *link;
+	*link = entry;
+
+	/* the new entry is the last one the hand reaches */
+	if (ocHand == NULL) {
+	    entry->clockPrev = entry->clockNext = entry;
+	    ocHand = entry;
+	}
+	else {
+	    entry->clockNext = ocHand;
+	    entry->clockPrev = ocHand->clockPrev;
+	    ocHand->clockPrev->clockNext = entry;
+	    ocHand->clockPrev = entry;
+	}
+
+	ocStats.nEntries++;
+	ocStats.nBytes += size;
+	ocStats.nAdmits++;
+    }
+
+    pthread_mutex_unlock(&ocMutex);
+
+} /* eduom_ObjectCacheAdmit() */
+
+
+
+/*@================================
+ * eduom_ObjectCacheInvalidate()
+ *================================*/
+/*
+ * Function: void eduom_ObjectCacheInvalidate(ObjectID*)
+ *
+ * Description:
+ *  Drop the object from the cache because it is destroyed or updated.
+ */
+void eduom_ObjectCacheInvalidate(
+    ObjectID *oid)		/* IN object changed */
+{
+    oc_Entry **link;		/* link to the entry of the object */
+
+
+    if (!ocEnabled) return;
+
+    pthread_mutex_lock(&ocMutex);
+    link = eduom_ObjectCacheFind(oid);
+    if (link != NULL) {
+	eduom_ObjectCacheRemove(link);
+	ocStats.nInvalidations++;
+    }
+    pthread_mutex_unlock(&ocMutex);
+
+} /* eduom_ObjectCacheInvalidate() */
+
+
+
+/*
+ * Function: UFour eduom_ObjectCacheHash(ObjectID*)
+ *
+ * Description:
+ *  Hash the slot of the object, i.e. the object ID without its unique.
+ */
+static UFour eduom_ObjectCacheHash(
+    ObjectID *oid)		/* IN object identifier */
+{
+    return(((UFour)oid->pageNo * 0x9E3779B1U) ^ ((UFour)oid->slotNo * 0x85EBCA6BU) ^ (UFour)oid->volNo);
+
+} /* eduom_ObjectCacheHash() */
+
+
+
+/*
+ * Function: oc_Entry **eduom_ObjectCacheFind(ObjectID*)
+ *
+ * Description:
+ *  Return the link to the entry for the slot of the object, whatever its
+ *  unique, or NULL. The caller holds 'ocMutex'.
+ */
+static oc_Entry **eduom_ObjectCacheFind(
+    ObjectID *oid)		/* IN object identifier */
+{
+    oc_Entry **link;		/* link to an entry */
+
+
+    for (link = &ocBuckets[eduom_ObjectCacheHash(oid) & ocMask]; *link != NULL; link = &(*link)->hashNext)
+	if ((*link)->oid.pageNo == oid->pageNo && (*link)->oid.slotNo == oid->slotNo &&
+	    (*link)->oid.volNo == oid->volNo) return(link);
+
+    return(NULL);
+
+} /* eduom_ObjectCacheFind() */
+
+
+
+/*
+ * Function: void eduom_ObjectCacheRemove(oc_Entry**)
+ *
+ * Description:
+ *  Unlink the entry from its hash bucket and from the CLOCK ring and free
+ *  it. The caller holds 'ocMutex'.
+ */
+static void eduom_ObjectCacheRemove(
+    oc_Entry **link)		/* IN link to the entry */
+{
+    oc_Entry *entry = *link;	/* entry to remove */
+
+
+    *link = entry->hashNext;
+
+    if (entry->clockNext == entry)
+	ocHand = NULL;
+    else {
+	entry->clockPrev->clockNext = entry->clockNext;
+	entry->clockNext->clockPrev = entry->clockPrev;
+	if (ocHand == entry) ocHand = entry->clockNext;
+    }
+
+    ocStats.nEntries--;
+    ocStats.nBytes -= OC_ENTRY_SIZE(entry->length);
+    free(entry);
+
+} /* eduom_ObjectCacheRemove() */
+
+
+
+/*
+ * Function: double eduom_ObjectCacheNow(void)
+ *
+ * Description:
+ *  Return the time of the monotonic clock in nanoseconds, never 0.
+ */
+static double eduom_ObjectCacheNow(void)
+{
+    struct timespec now;	/* current time */
+
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return(now.tv_sec * 1e9 + now.tv_nsec + 1.0);
+
+} /* eduom_ObjectCacheNow() */
@@ -0,0 +1,115 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_OpenFilteredScan.c
+ *
+ * Description:
+ *  Open a scan cursor which returns only the objects whose header satisfies
+ *  a predicate.
+ *
+ * Export:
+ *  Four EduOM_OpenFilteredScan(ObjectID*, Four, OM_HdrPredicate*, OM_ScanCursor*)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+/*@================================
+ * EduOM_OpenFilteredScan()
+ *================================*/
+/*
+ * Function: Four EduOM_OpenFilteredScan(ObjectID*, Four, OM_HdrPredicate*, OM_ScanCursor*)
+ *
+ * Description:
+ *  Open a scan cursor like EduOM_OpenScan(), but EduOM_ScanNext() returns
+ *  only the objects whose header satisfies 'pred'. The predicate is copied
+ *  into the cursor and evaluated on a whole page at once when the cursor
+ *  moves to the page, so the objects which do not qualify never leave the
+ *  page loop. If the file has a zone map (see EduOM_BuildZoneMap()), the
+ *  scan uses it to pass over whole pages.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter cursor
+ *     cursor is initialized to be positioned before the first qualifying object
+ */
+Four EduOM_OpenFilteredScan(
+    ObjectID        *catObjForFile,	/* IN informations about a data file */
+    Four            direction,		/* IN FORWARD or BACKWARD */
+    OM_HdrPredicate *pred,		/* IN predicate on the object header */
+    OM_ScanCursor   *cursor)		/* OUT the opened scan cursor */
+{
+    Four e;			/* error */
+
+
+    /*@ parameter checking */
+    if (pred == NULL) ERR(eBADPARAMETER_OM);
+
+    if (pred->conditions & ~(PRED_TAG | PRED_LENGTH | PRED_PROPERTIES)) ERR(eBADPARAMETER_OM);
+
+    if ((pred->conditions & PRED_TAG) && (pred->nTags < 0 || pred->nTags > PRED_MAX_TAGS)) ERR(eBADPARAMETER_OM);
+
+    e = EduOM_OpenScan(catObjForFile, direction, cursor);
+    if (e < 0) ERR(e);
+
+    cursor->filtered = TRUE;
+    cursor->pred = *pred;
+    cursor->zoneMap = eduom_GetZoneMap(catObjForFile);
+    if (cursor->zoneMap != NULL) cursor->zoneMapGen = cursor->zoneMap->generation;
+
+    return(eNOERROR);
+
+} /* EduOM_OpenFilteredScan() */
@@ -0,0 +1,129 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_OpenScan.c
+ *
+ * Description:
+ *  Open a scan cursor on a data file.
+ *
+ * Export:
+ *  Four EduOM_OpenScan(ObjectID*, Four, OM_ScanCursor*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+/*@================================
+ * EduOM_OpenScan()
+ *================================*/
+/*
+ * Function: Four EduOM_OpenScan(ObjectID*, Four, OM_ScanCursor*)
+ *
+ * Description:
+ *  Open a scan cursor on the data file given by 'catObjForFile'.
+ *  The catalog object is read only once here; EduOM_ScanNext() walks the
+ *  page list of the file from the first page (FORWARD) or from the last
+ *  page (BACKWARD) without accessing the catalog again.
+ *  No page is fixed until the first call of EduOM_ScanNext().
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter cursor
+ *     cursor is initialized to be positioned before the first object
+ */
+Four EduOM_OpenScan(
+    ObjectID      *catObjForFile,	/* IN informations about a data file */
+    Four          direction,		/* IN FORWARD or BACKWARD */
+    OM_ScanCursor *cursor)		/* OUT the opened scan cursor */
+{
+    Four e;			/* error */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    if (direction != FORWARD && direction != BACKWARD) ERR(eBADPARAMETER_OM);
+
+    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+    MAKE_PHYSICALFILEID(cursor->pFid, catEntry->fid.volNo, catEntry->firstPage);
+    cursor->lastPage = catEntry->lastPage;
+
+    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    cursor->direction = direction;
+    MAKE_PAGEID(cursor->pid, cursor->pFid.volNo, NIL);
+    cursor->apage = NULL;
+    cursor->slotNo = NIL;
+    cursor->obj = NULL;
+    cursor->fwdPage = NULL;
+    cursor->eos = FALSE;
+    cursor->filtered = FALSE;
+    cursor->zoneMap = NULL;
+    cursor->nSkipped = 0;
+    cursor->accessHint = OM_HINT_NORMAL;
+    eduom_InitReadAheadStream(&cursor->ra, direction);
+
+    return(eNOERROR);
+
+} /* EduOM_OpenScan() */
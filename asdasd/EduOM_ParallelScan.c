@@ -0,0 +1,600 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_ParallelScan.c
+ *
+ * Description:
+ *  Morsel-driven parallel scan of a data file.
+ *  With the in-tree buffer manager, which may be called by several
+ *  threads, the file is cut into morsels of up to PS_MORSEL_SIZE pages of
+ *  one of its extents, which the calling thread finds by following the
+ *  extents of the file from the extent of its first page, without reading
+ *  any page; each worker thread fixes the pages of its morsels by itself,
+ *  skips the pages of the extents which are not pages of the file, and
+ *  calls the user function on the objects of the others. With the stock
+ *  buffer manager, which may only be used by one thread, the morsels are
+ *  PS_MORSEL_SIZE consecutive pages of the page list instead, whose pages
+ *  the calling thread fixes for the workers. Each worker has its own queue
+ *  of morsels and steals from the other queues when its own is empty. The
+ *  moved objects, whose forwarded records lie on other pages, are visited
+ *  by the thread which fixes the page holding their stubs.
+ *
+ * Exports:
+ *  Four EduOM_ParallelScan(ObjectID*, Four, OM_ScanCallback, void*)
+ */
+
+
+#include <pthread.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+/* set only if the in-tree buffer manager is linked */
+#pragma weak EduBfM_SetAccessHint
+Four EduBfM_SetAccessHint(Four);
+
+
+#define PS_MAX_MORSELS      (PS_MAX_FIXED_PAGES / PS_MORSEL_SIZE)   /* morsels in flight */
+
+/*
+ * Typedef for a morsel
+ */
+typedef struct {
+    Four   nPages;                      /* # of pages in the morsel */
+    PageID pid[PS_MORSEL_SIZE];         /* pages of the morsel */
+    SlottedPage *apage[PS_MORSEL_SIZE]; /* buffers holding the pages, fixed by the calling thread */
+} ps_Morsel;
+
+/*
+ * Typedef for the queue of morsels of a worker
+ * The owner takes morsels from the head, thieves from the tail.
+ */
+typedef struct {
+    Four head;                          /* position of the first morsel */
+    Four count;                         /* # of morsels in the queue */
+    ps_Morsel *morsel[PS_MAX_MORSELS];  /* queued morsels */
+} ps_Queue;
+
+/*
+ * Typedef for the state shared by the threads of a parallel scan
+ */
+typedef struct {
+    pthread_mutex_t mutex;              /* protects all fields below */
+    pthread_cond_t  workCond;           /* signaled when a morsel is queued */
+    pthread_cond_t  doneCond;           /* signaled when a morsel is done */
+    Four            nThreads;           /* # of worker threads */
+    ps_Queue        queue[PS_MAX_THREADS]; /* queue of each worker */
+    ps_Morsel       *done[PS_MAX_MORSELS]; /* morsels processed by the workers */
+    Four            nDone;              /* # of morsels in 'done' */
+    Boolean         finished;           /* TRUE if no more morsel will be queued */
+    Four            error;              /* first error returned by 'callback' */
+    Boolean         workersFix;         /* TRUE if the workers fix the pages of the morsels */
+    FileID          fid;                /* file being scanned */
+    OM_ScanCallback callback;           /* function called on each object */
+    void            *arg;               /* argument of 'callback' */
+} ps_Scan;
+
+/*
+ * Typedef for the argument of a worker thread
+ */
+typedef struct {
+    ps_Scan *scan;                      /* shared state */
+    Four    myQueue;                    /* index of the worker's own queue */
+} ps_Worker;
+
+
+static void *eduom_ParallelScanWorker(void*);
+static Four eduom_ScanMorsel(ps_Scan*, ps_Morsel*);
+static Four eduom_FixMorsel(ps_Scan*, ps_Morsel*);
+static Four eduom_ScanPage(ps_Scan*, PageID*, SlottedPage*);
+static Four eduom_ScanMovedObjects(ps_Scan*, PageID*, SlottedPage*);
+static Four eduom_FreeMorsel(ps_Morsel*);
+
+
+
+/*@================================
+ * EduOM_ParallelScan()
+ *================================*/
+/*
+ * Function: Four EduOM_ParallelScan(ObjectID*, Four, OM_ScanCallback, void*)
+ *
+ * Description:
+ *  Call 'callback' on every object of the data file given by 'catObjForFile'
+ *  using 'nThreads' worker threads. The objects are visited in no particular
+ *  order and 'callback' is called concurrently, with the object ID, the
+ *  object in the buffer (read-only) and 'arg'. A moved object is visited
+ *  under the ID of its stub, with its forwarded record.
+ *
+ *  The calling thread hands the morsels to the workers in round-robin
+ *  order. With the in-tree buffer manager, the pages of a new morsel are
+ *  announced to the read-ahead, and each worker fixes a page of its morsel
+ *  at a time. Otherwise at most PS_MAX_FIXED_PAGES pages are fixed at a
+ *  time: the calling thread fixes the pages of a new morsel and frees the
+ *  pages of the morsels the workers have finished, and the page moves are
+ *  reported to the read-ahead so that the I/O of the following morsels
+ *  overlaps with the processing.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eBADCATALOGOBJECT_OM
+ *    the first negative value returned by 'callback'
+ *    some errors caused by function calls
+ */
+Four EduOM_ParallelScan(
+    ObjectID *catObjForFile,	/* IN information about a data file */
+    Four nThreads,		/* IN # of worker threads */
+    OM_ScanCallback callback,	/* IN function called on each object */
+    void *arg)			/* IN argument of 'callback' */
+{
+    Four e;			/* error */
+    Four e2;			/* error of freeing a morsel */
+    Four i;			/* index */
+    Four nextQueue;		/* queue receiving the next morsel */
+    Four nFree;			/* # of unused morsel buffers */
+    Four nReturned;		/* # of morsels returned by the workers */
+    Four ext;			/* extent of 'pid' */
+    Two  extSize;		/* # of pages in an extent */
+    PageID pid;			/* next page of the page list */
+    PageID prevPid;		/* page fixed before 'pid' */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+    ps_Scan scan;		/* shared state */
+    ps_Worker workers[PS_MAX_THREADS]; /* arguments of the workers */
+    pthread_t threads[PS_MAX_THREADS]; /* worker threads */
+    ps_Morsel morsels[PS_MAX_MORSELS]; /* morsel buffers */
+    ps_Morsel *freeMorsels[PS_MAX_MORSELS]; /* unused morsel buffers */
+    ps_Morsel *returned[PS_MAX_MORSELS]; /* morsels returned by the workers */
+    ps_Morsel *morsel;		/* morsel being filled */
+    OM_ReadAheadStream ra;	/* read-ahead state of the scan */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (nThreads <= 0 || nThreads > PS_MAX_THREADS || callback == NULL) ERR(eBADPARAMETER_OM);
+
+    /*@ get the first page of the file */
+    MAKE_PAGEID(pid, catObjForFile->volNo, catObjForFile->pageNo);
+    e = BfM_GetTrain(&pid, (char **)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    scan.fid = catEntry->fid;
+
+    e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    /*@ with the in-tree buffer manager, start from the first extent of the file */
+    scan.workersFix = (EduBfM_SetAccessHint != NULL) ? TRUE : FALSE;
+    if (scan.workersFix) {
+	e = RDsM_GetSizeOfExt(pid.volNo, &extSize);
+	if (e < 0) ERR(e);
+
+	e = RDsM_PageIdToExtNo(&pid, &ext);
+	if (e < 0) ERR(e);
+	pid.pageNo = ext * extSize;
+    }
+
+    /*@ start the workers */
+    pthread_mutex_init(&scan.mutex, NULL);
+    pthread_cond_init(&scan.workCond, NULL);
+    pthread_cond_init(&scan.doneCond, NULL);
+    for (i = 0; i < nThreads; i++) scan.queue[i].head = scan.queue[i].count = 0;
+    scan.nDone = 0;
+    scan.finished = FALSE;
+    scan.error = eNOERROR;
+    scan.callback = callback;
+    scan.arg = arg;
+
+    for (scan.nThreads = 0; scan.nThreads < nThreads; scan.nThreads++) {
+	workers[scan.nThreads].scan = &scan;
+	workers[scan.nThreads].myQueue = scan.nThreads;
+	if (pthread_create(&threads[scan.nThreads], NULL, eduom_ParallelScanWorker, &workers[scan.nThreads]) != 0) break;
+    }
+    e = (scan.nThreads == 0) ? eBADPARAMETER_OM : eNOERROR;
+
+    for (nFree = 0; nFree < PS_MAX_MORSELS; nFree++) freeMorsels[nFree] = &morsels[nFree];
+    eduom_InitReadAheadStream(&ra, FORWARD);
+    MAKE_PAGEID(prevPid, pid.volNo, NIL);
+    nextQueue = 0;
+
+    /*@ cut the page list into morsels */
+    while (e >= eNOERROR && pid.pageNo != NIL) {
+
+	/* take back the morsels done by the workers, waiting if all are in use */
+	pthread_mutex_lock(&scan.mutex);
+	while (nFree == 0 && scan.nDone == 0) pthread_cond_wait(&scan.doneCond, &scan.mutex);
+	for (nReturned = 0; scan.nDone > 0; nReturned++) returned[nReturned] = scan.done[--scan.nDone];
+	if (scan.error < eNOERROR) e = scan.error;
+	pthread_mutex_unlock(&scan.mutex);
+
+	for (i = 0; i < nReturned; i++) {
+	    e2 = eduom_FreeMorsel(returned[i]);
+	    if (e2 < eNOERROR && e >= eNOERROR) e = e2;
+	    freeMorsels[nFree++] = returned[i];
+	}
+	if (e < eNOERROR) break;
+
+	morsel = freeMorsels[--nFree];
+	if (scan.workersFix) {
+	    /* take the next pages of the extent, going on with the next extent at its end */
+	    for (morsel->nPages = 0; morsel->nPages < PS_MORSEL_SIZE && pid.pageNo != NIL; ) {
+		morsel->pid[morsel->nPages++] = pid;
+		pid.pageNo++;
+		if (pid.pageNo % extSize == 0) {
+		    e = EduRDsM_GetNextExt(pid.volNo, ext, &ext);
+		    if (e >= eNOERROR) pid.pageNo = (ext == NIL) ? NIL : ext * extSize;
+		    break;
+		}
+	    }
+	    /* the pages are not fixed here */
+	    if (e < eNOERROR) morsel->nPages = 0;
+	    else (void) eduom_ReadAheadPages(morsel->nPages, morsel->pid);
+	}
+	else {
+	    /* fix the pages of a new morsel */
+	    for (morsel->nPages = 0; morsel->nPages < PS_MORSEL_SIZE && pid.pageNo != NIL; morsel->nPages++) {
+		e = BfM_GetTrain(&pid, (char **)&morsel->apage[morsel->nPages], PAGE_BUF);
+		if (e < 0) break;
+		morsel->pid[morsel->nPages] = pid;
+
+		e = eduom_ReadAheadStep(&ra, &prevPid, morsel->apage[morsel->nPages], FORWARD);
+		prevPid = pid;
+		pid.pageNo = morsel->apage[morsel->nPages]->header.nextPage;
+		if (e >= eNOERROR) e = eduom_ScanMovedObjects(&scan, &prevPid, morsel->apage[morsel->nPages]);
+		if (e < 0) { morsel->nPages++; break; }
+	    }
+	}
+	if (e < eNOERROR) {
+	    (void) eduom_FreeMorsel(morsel);
+	    break;
+	}
+
+	/* hand the morsel to the next worker */
+	pthread_mutex_lock(&scan.mutex);
+	scan.queue[nextQueue].morsel[(scan.queue[nextQueue].head + scan.queue[nextQueue].count) % PS_MAX_MORSELS] = morsel;
+	scan.queue[nextQueue].count++;
+	pthread_cond_broadcast(&scan.workCond);
+	pthread_mutex_unlock(&scan.mutex);
+	nextQueue = (nextQueue + 1) % scan.nThreads;
+    }
+
+    /*@ let the workers drain their queues and free the remaining morsels */
+    pthread_mutex_lock(&scan.mutex);
+    scan.finished = TRUE;
+    pthread_cond_broadcast(&scan.workCond);
+    pthread_mutex_unlock(&scan.mutex);
+
+    for (i = 0; i < scan.nThreads; i++) pthread_join(threads[i], NULL);
+
+    while (scan.nDone > 0) {
+	e2 = eduom_FreeMorsel(scan.done[--scan.nDone]);
+	if (e2 < eNOERROR && e >= eNOERROR) e = e2;
+    }
+    if (scan.error < eNOERROR && e >= eNOERROR) e = scan.error;
+
+    pthread_cond_destroy(&scan.doneCond);
+    pthread_cond_destroy(&scan.workCond);
+    pthread_mutex_destroy(&scan.mutex);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_ParallelScan() */
+
+
+
+/*
+ * Function: void *eduom_ParallelScanWorker(void*)
+ *
+ * Description:
+ *  Body of a worker thread. The worker takes morsels from the head of its
+ *  own queue, or steals them from the tail of another queue, until the
+ *  scan is finished and all queues are empty, and processes them, fixing
+ *  their pages itself if 'workersFix' is set. Once an error has occurred,
+ *  the remaining morsels are returned without being processed.
+ */
+static void *eduom_ParallelScanWorker(
+    void *arg)			/* IN ps_Worker of the thread */
+{
+    ps_Scan *scan = ((ps_Worker *)arg)->scan; /* shared state */
+    Four myQueue = ((ps_Worker *)arg)->myQueue; /* own queue */
+    Four e;			/* error */
+    Four i;			/* index */
+    ps_Queue *q;		/* queue to take a morsel from */
+    ps_Morsel *morsel;		/* morsel taken */
+    Boolean skip;		/* TRUE if the morsel is not processed */
+
+
+    pthread_mutex_lock(&scan->mutex);
+    for (;;) {
+	morsel = NULL;
+	q = &scan->queue[myQueue];
+	if (q->count > 0) {
+	    morsel = q->morsel[q->head];
+	    q->head = (q->head + 1) % PS_MAX_MORSELS;
+	    q->count--;
+	}
+	else {
+	    for (i = 1; i < scan->nThreads; i++) {
+		q = &scan->queue[(myQueue + i) % scan->nThreads];
+		if (q->count > 0) {
+		    q->count--;
+		    morsel = q->morsel[(q->head + q->count) % PS_MAX_MORSELS];
+		    break;
+		}
+	    }
+	}
+
+	if (morsel == NULL) {
+	    if (scan->finished) break;
+	    pthread_cond_wait(&scan->workCond, &scan->mutex);
+	    continue;
+	}
+
+	skip = (scan->error < eNOERROR) ? TRUE : FALSE;
+	pthread_mutex_unlock(&scan->mutex);
+
+	if (skip) e = eNOERROR;
+	else if (scan->workersFix) e = eduom_FixMorsel(scan, morsel);
+	else e = eduom_ScanMorsel(scan, morsel);
+
+	/* the pages fixed by the worker are already freed */
+	if (scan->workersFix) morsel->nPages = 0;
+
+	pthread_mutex_lock(&scan->mutex);
+	if (e < eNOERROR && scan->error >= eNOERROR) scan->error = e;
+	scan->done[scan->nDone++] = morsel;
+	pthread_cond_signal(&scan->doneCond);
+    }
+    pthread_mutex_unlock(&scan->mutex);
+
+    return(NULL);
+
+} /* eduom_ParallelScanWorker() */
+
+
+
+/*
+ * Function: Four eduom_ScanMorsel(ps_Scan*, ps_Morsel*)
+ *
+ * Description:
+ *  Call the user function on every object of the pages of a morsel fixed
+ *  by the calling thread, but the moved objects, which are visited by
+ *  eduom_ScanMovedObjects() when the pages are fixed.
+ *
+ * Returns:
+ *  error code
+ *    the first negative value returned by the user function
+ */
+static Four eduom_ScanMorsel(
+    ps_Scan *scan,		/* IN shared state */
+    ps_Morsel *morsel)		/* IN morsel to process */
+{
+    Four e;			/* error */
+    Four p;			/* index of the page in the morsel */
+
+
+    for (p = 0; p < morsel->nPages; p++) {
+	e = eduom_ScanPage(scan, &morsel->pid[p], morsel->apage[p]);
+	if (e < eNOERROR) return(e);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_ScanMorsel() */
+
+
+
+/*
+ * Function: Four eduom_FixMorsel(ps_Scan*, ps_Morsel*)
+ *
+ * Description:
+ *  Fix the pages of a morsel of an extent of the file one at a time, and
+ *  call the user function on every object of those which are pages of the
+ *  file, including the moved objects. The other pages of the extent are
+ *  not allocated, or left by another file, and are skipped. Each page is
+ *  freed before the next one is fixed.
+ *
+ * Returns:
+ *  error code
+ *    the first negative value returned by the user function
+ *    some errors caused by function calls
+ */
+static Four eduom_FixMorsel(
+    ps_Scan *scan,		/* IN shared state */
+    ps_Morsel *morsel)		/* IN morsel to process */
+{
+    Four e;			/* error */
+    Four e2;			/* error of freeing the page */
+    Four p;			/* index of the page in the morsel */
+    PageID *pid;		/* a page of the morsel */
+    SlottedPage *apage;		/* buffer holding 'pid' */
+
+
+    for (p = 0; p < morsel->nPages; p++) {
+	pid = &morsel->pid[p];
+	e = BfM_GetTrain(pid, (char **)&apage, PAGE_BUF);
+	if (e < 0) ERR(e);
+
+	e = eNOERROR;
+	if (EQUAL_PAGEID(apage->header.pid, *pid) && EQUAL_FILEID(apage->header.fid, scan->fid) &&
+	    (apage->header.flags & PAGE_TYPE_VECTOR_MASK) == SLOTTED_PAGE_TYPE) {
+	    e = eduom_ScanPage(scan, pid, apage);
+	    if (e >= eNOERROR) e = eduom_ScanMovedObjects(scan, pid, apage);
+	}
+
+	e2 = BfM_FreeTrain(pid, PAGE_BUF);
+	if (e < eNOERROR) return(e);
+	if (e2 < 0) ERR(e2);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_FixMorsel() */
+
+
+
+/*
+ * Function: Four eduom_ScanPage(ps_Scan*, PageID*, SlottedPage*)
+ *
+ * Description:
+ *  Call the user function on every object of the page 'apage', but the
+ *  moved objects, which are visited by eduom_ScanMovedObjects().
+ *
+ * Returns:
+ *  error code
+ *    the first negative value returned by the user function
+ */
+static Four eduom_ScanPage(
+    ps_Scan *scan,		/* IN shared state */
+    PageID *pid,		/* IN page to scan */
+    SlottedPage *apage)		/* IN buffer holding 'pid' */
+{
+    Four e;			/* error */
+    Two  i;			/* slot number */
+    ObjectID oid;		/* object identifier */
+
+
+    for (i = 0; i < apage->header.nSlots; i++) {
+	if (!OM_IS_DATA_SLOT(apage, i) || !OM_IS_OBJECT_SLOT(apage, i)) continue;
+
+	MAKE_OBJECTID(oid, pid->volNo, pid->pageNo, i, apage->slot[-i].unique);
+	e = scan->callback(&oid, (Object *)&(apage->data[apage->slot[-i].offset]), scan->arg);
+	if (e < eNOERROR) return(e);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_ScanPage() */
+
+
+
+/*
+ * Function: Four eduom_ScanMovedObjects(ps_Scan*, PageID*, SlottedPage*)
+ *
+ * Description:
+ *  Call the user function on the moved objects whose stubs are in the page
+ *  'apage', with their forwarded records. It is called by the thread which
+ *  fixed the page, which is the only one allowed to fix the pages of the
+ *  forwarded records with the stock buffer manager.
+ *
+ * Returns:
+ *  error code
+ *    the first negative value returned by the user function
+ *    some errors caused by function calls
+ */
+static Four eduom_ScanMovedObjects(
+    ps_Scan *scan,		/* IN shared state */
+    PageID *pid,		/* IN page holding the stubs */
+    SlottedPage *apage)		/* IN buffer holding 'pid' */
+{
+    Four e;			/* error */
+    Four e2;			/* error of freeing the forwarded record */
+    Two  i;			/* slot number */
+    Object *obj;		/* an object of the page */
+    Object *fwdObj;		/* forwarded record of 'obj' */
+    PageID fwdPid;		/* page holding 'fwdObj' */
+    SlottedPage *fwdPage;	/* buffer holding 'fwdPid' */
+    ObjectID oid;		/* object identifier */
+
+
+    for (i = 0; i < apage->header.nSlots; i++) {
+	if (OM_IS_DATA_SLOT(apage, i) || apage->slot[-i].offset == EMPTYSLOT) continue;
+
+	obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+	e = eduom_FixForwarded(obj, &fwdPid, &fwdPage, &fwdObj);
+	if (e < 0) ERR(e);
+
+	MAKE_OBJECTID(oid, pid->volNo, pid->pageNo, i, apage->slot[-i].unique);
+	e = scan->callback(&oid, fwdObj, scan->arg);
+
+	e2 = BfM_FreeTrain(&fwdPid, PAGE_BUF);
+	if (e < eNOERROR) return(e);
+	if (e2 < 0) ERR(e2);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_ScanMovedObjects() */
+
+
+
+/*
+ * Function: Four eduom_FreeMorsel(ps_Morsel*)
+ *
+ * Description:
+ *  Free the pages of a morsel in the buffer.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_FreeMorsel(
+    ps_Morsel *morsel)		/* IN morsel to free */
+{
+    Four e;			/* error */
+    Four p;			/* index of the page in the morsel */
+    Four firstError = eNOERROR;	/* first error */
+
+
+    for (p = 0; p < morsel->nPages; p++) {
+	e = BfM_FreeTrain(&morsel->pid[p], PAGE_BUF);
+	if (e < eNOERROR && firstError >= eNOERROR) firstError = e;
+    }
+    morsel->nPages = 0;
+
+    return(firstError);
+
+} /* eduom_FreeMorsel() */
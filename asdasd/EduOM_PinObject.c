@@ -0,0 +1,139 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_PinObject.c
+ *
+ * Description :
+ *  EduOM_PinObject() gives a view of an object in the buffer without copying it.
+ *
+ * Exports:
+ *  Four EduOM_PinObject(ObjectID*, OM_ObjectView*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+#ifndef NDEBUG
+Four eduom_numPinnedViews = 0;	/* # of views not released yet */
+#endif
+
+
+
+/*@================================
+ * EduOM_PinObject()
+ *================================*/
+/*
+ * Function: Four EduOM_PinObject(ObjectID*, OM_ObjectView*)
+ *
+ * Description :
+ *  Fix the page holding the object 'oid' and return in 'view' a read-only
+ *  pointer to the object's data in the buffer and its length, in place of
+ *  copying the data as EduOM_ReadObject() does. A moved object is viewed
+ *  at its forwarded record.
+ *
+ *  The page stays fixed until the view is released with EduOM_UnpinObject(),
+ *  so the views should be short-lived: every pinned view holds a buffer
+ *  page, and the data must not be used after the release. In debug builds
+ *  the number of views not released yet is kept in eduom_numPinnedViews.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_PinObject(
+    ObjectID	*oid,		/* IN object to view */
+    OM_ObjectView *view)	/* OUT view of the object */
+{
+    Four	e;		/* error code */
+    PageID	pid;		/* page containing the object */
+    SlottedPage	*apage;		/* pointer to the buffer of the page */
+    Object	*obj;		/* pointer to the object in the slotted page */
+    ObjectID	movedOid;	/* ID of the forwarded record of a moved object */
+
+
+    /*@ check parameters */
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (view == NULL) ERR(eBADPARAMETER_OM);
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+    e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+	ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    obj = (Object *)&(apage->data[apage->slot[-oid->slotNo].offset]);
+
+    /*@ view a moved object at its forwarded record */
+    if (obj->header.properties & P_MOVED) {
+	movedOid = *((ObjectID *)obj->data);
+	e = BfM_FreeTrain(&pid, PAGE_BUF);
+	if (e < 0) ERR(e);
+	return(EduOM_PinObject(&movedOid, view));
+    }
+
+    /*@ the page stays fixed for the view */
+    view->data = obj->data;
+    view->length = obj->header.length;
+    view->pid = pid;
+    view->oid = *oid;
+#ifndef NDEBUG
+    view->magic = OM_VIEW_PINNED;
+    __sync_fetch_and_add(&eduom_numPinnedViews, 1);
+#endif
+
+    return(eNOERROR);
+
+} /* EduOM_PinObject() */
@@ -100,6 +100,7 @@ Four EduOM_PrevObject(
     Four offset;		/* starting offset of object within a page */
     PageID pid;			/* a page identifier */
     PageNo pageNo;		/* a temporary var for previous page's PageNo */
+    PageID fromPid;		/* page the scan moves from */
     SlottedPage *apage;		/* a pointer to the data page */
     Object *obj;		/* a pointer to the Object */
     SlottedPage *catPage;	/* buffer page containing the catalog object */
@@ -116,6 +117,7 @@ Four EduOM_PrevObject(
 		if (e < 0) ERR(e);
 		GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
 		MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->lastPage);// 
+		MAKE_PAGEID(fromPid, pid.volNo, NIL);
 		e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
 		if (e < 0) ERR(e);
 	}
@@ -124,10 +126,13 @@ Four EduOM_PrevObject(
 		if (e < 0)  ERR(e);
 		for (i = curOID->slotNo - 1; i >= 0; i--) {//curoid ϴ objectŽ
 			offset = apage->slot[-i].offset;
-			if (offset != EMPTYSLOT) {
+			if (OM_IS_OBJECT_SLOT(apage, i)) {
 				obj = (Object *)&(apage->data[offset]);
 				MAKE_OBJECTID(*prevOID, curOID->volNo, curOID->pageNo, i, apage->slot[-i].unique);
-				if (objHdr != NULL) *objHdr = obj->header;
+				if (objHdr != NULL) {
+					e = eduom_ScanHeader(obj, objHdr);
+					if (e < 0) ERRB1(e, (PageID *)curOID, PAGE_BUF);
+				}
 				e = BfM_FreeTrain((PageID *)curOID, PAGE_BUF);
 				if (e < 0)  ERR(e);
 				return(eNOERROR);
@@ -135,19 +140,26 @@ Four EduOM_PrevObject(
 		}
 		//   Ѿ Ȯ
 		MAKE_PAGEID(pid, curOID->volNo, apage->header.prevPage);
+		fromPid = *((PageID *)curOID);
 		e = BfM_FreeTrain((PageID *)curOID, PAGE_BUF);
 		if (e < 0)  ERR(e);
 	}
 	while (pid.pageNo != NIL) {
 		e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
 		if (e < 0)  ERR(e);
+		e = eduom_ReadAheadStep(NULL, &fromPid, apage, BACKWARD);
+		if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+		fromPid = pid;
 
 		for (i = apage->header.nSlots - 1; i >= 0; i--) {
 			offset = apage->slot[-i].offset;
-			if (offset != EMPTYSLOT) { //Ʈã ȯ
+			if (OM_IS_OBJECT_SLOT(apage, i)) { //Ʈã ȯ
 				obj = (Object *)&(apage->data[offset]);
 				MAKE_OBJECTID(*prevOID, pid.volNo, pid.pageNo,i, apage->slot[-i].unique);
-				if (objHdr != NULL) *objHdr = obj->header;
+				if (objHdr != NULL) {
+					e = eduom_ScanHeader(obj, objHdr);
+					if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+				}
 				e = BfM_FreeTrain(&pid, PAGE_BUF);
 				if (e < 0) ERR(e);
 				return(eNOERROR);
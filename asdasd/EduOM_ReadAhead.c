@@ -0,0 +1,976 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_ReadAhead.c
+ *
+ * Description:
+ *  Asynchronous read-ahead along the page list of data files.
+ *  Sequential traversals by the scan cursor, EduOM_NextObject() and
+ *  EduOM_PrevObject() are detected, and the pages following the current
+ *  page in the page list are read by worker threads before the scan
+ *  arrives there, so that BfM_GetTrain() finds them in the OS page cache
+ *  instead of waiting for the disk.
+ *
+ *  The workers read the volume's device files through their own file
+ *  descriptors at explicit offsets, which neither disturbs the file
+ *  offsets used by the raw disk manager nor needs its (single-threaded)
+ *  read buffer. Each device of a volume has its own queue of requests and
+ *  its own workers, so that the devices of a volume, whose extents are
+ *  striped across them by the extent allocation, are read concurrently: a
+ *  request is queued to the device of its first page, and a request whose
+ *  page list goes on in another device is passed to the queue of that
+ *  device. Each worker serves up to RA_MAX_ACTIVE requests at once through
+ *  its own I/O engine: the reads of all of them are submitted together
+ *  and each request goes on when its read completes, so a few threads
+ *  keep many reads in flight. A read covers the rest of the extent of the
+ *  page, and the page list is followed in the pages read as long as it
+ *  stays there; a page list known to be physically contiguous is read
+ *  with one large read per device.
+ *  A page read by a worker is only a hint: if the page was changed in the
+ *  buffer since it was written, the scan still sees the buffered version.
+ *
+ *  With the in-tree buffer manager, which may be called by several
+ *  threads, the workers install the pages in the buffer instead: a request
+ *  is served by fixing and freeing its pages one by one with
+ *  BfM_GetTrain(), so the pages are read through the buffer manager
+ *  (including the recovery and the compressed page store) and are found
+ *  in the buffer by the scan even if the buffer does its own direct I/O
+ *  and bypasses the OS page cache. A page being read by a worker is
+ *  inserted in the buffer only when it has been read, and BfM_GetTrain()
+ *  on the same page by the scan waits for the read on the mutex of its
+ *  partition and then finds it there. The workers of a device still
+ *  follow the page list only within their device.
+ *  The read-ahead is off until EduOM_InitReadAhead() is called: when the
+ *  device is on a fast disk the kernel's own read-ahead is usually enough,
+ *  and the workers then only add their cost to the scan (see the
+ *  "coldscan" benchmark of EduOM_Bench.c).
+ *
+ * Exports:
+ *  Four EduOM_InitReadAhead(Four, Four, char**, Four)
+ *  Four EduOM_FinalReadAhead(void)
+ *  Four EduOM_GetReadAheadStatistics(Four*, Four*)
+ *  void eduom_InitReadAheadStream(OM_ReadAheadStream*, Four)
+ *  Four eduom_ReadAheadStep(OM_ReadAheadStream*, PageID*, SlottedPage*, Four)
+ *  Four eduom_ReadAheadPages(Four, PageID*)
+ */
+
+#define _FILE_OFFSET_BITS 64
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+/* set only if the in-tree buffer manager is linked */
+#pragma weak EduBfM_SetAccessHint
+Four EduBfM_SetAccessHint(Four);
+
+
+#define RA_MAX_VOLUMES      20      /* volumes attached to the read-ahead */
+#define RA_MAX_DEVICES      20      /* devices in a volume */
+#define RA_MAX_THREADS      16      /* worker threads of a device */
+#define RA_QUEUE_SIZE       64      /* pending read-ahead requests of a device */
+#define RA_MAX_ACTIVE       8       /* requests served at once by a worker */
+
+/*
+ * Typedef for a read-ahead request
+ */
+typedef struct {
+    PageID  pid;            /* first page to read */
+    Four    direction;      /* follow 'nextPage' (FORWARD) or 'prevPage' (BACKWARD) */
+    Four    nSkip;          /* # of pages already requested before, only followed */
+    Four    nPages;         /* # of pages to read */
+    Boolean contiguous;     /* TRUE if the page list was physically contiguous so far */
+} ra_Request;
+
+struct ra_Volume;
+
+/*
+ * Typedef for a device of a volume attached to the read-ahead
+ */
+typedef struct {
+    struct ra_Volume *vol;              /* volume of the device */
+    Four   devNo;                       /* index of the device in the volume */
+    int    fd;                          /* read-only descriptor of the device */
+    ra_Request queue[RA_QUEUE_SIZE];    /* pending requests */
+    Four   head, count;                 /* first and # of the pending requests */
+    pthread_cond_t cond;                /* signaled when a request is queued */
+    pthread_t threads[RA_MAX_THREADS];  /* workers of the device */
+    Four   nThreads;                    /* # of workers started */
+} ra_Device;
+
+/*
+ * Typedef for a volume attached to the read-ahead
+ */
+typedef struct ra_Volume {
+    Four   volNo;                       /* volume number, NIL if unused */
+    Four   numDevices;                  /* # of devices of the volume */
+    Two    extSize;                     /* # of pages in an extent */
+    Boolean stop;                       /* TRUE to make the workers of the volume exit */
+    PageNo firstPage[RA_MAX_DEVICES+1]; /* first PageNo of each device */
+    ra_Device *dev;                     /* devices of the volume */
+} ra_Volume;
+
+/*
+ * Typedef for a request being served by a worker
+ */
+typedef struct {
+    ra_Request req;         /* request, 'pid' being the next page to read */
+    ra_Device  *dev;        /* device of the request */
+    Four       n;           /* # of pages followed for the request */
+    Boolean    window;      /* TRUE if the rest of the window is being read at once */
+    PageNo     start;       /* first page read */
+    Four       nRead;       /* # of pages read */
+    char       *buf;        /* RA_MAX_WINDOW pages read */
+} ra_Active;
+
+
+static Boolean         raInitialized = FALSE;
+static volatile Boolean raShutdown;
+static ra_Volume       raVolumes[RA_MAX_VOLUMES];
+static pthread_mutex_t raMutex = PTHREAD_MUTEX_INITIALIZER;
+static OM_ReadAheadStream raStreams[RA_MAX_STREAMS];
+static UFour           raClock;
+static Four            raNumRequests;   /* # of requests issued */
+static Four            raNumPages;      /* # of pages read by the workers */
+
+
+static void *eduom_ReadAheadWorker(void*);
+static void *eduom_ReadAheadFixWorker(void*);
+static ra_Volume *eduom_ReadAheadVolume(Four);
+static Four eduom_ReadAheadDevice(ra_Volume*, PageNo);
+static Boolean eduom_ReadAheadQueue(ra_Volume*, ra_Request*);
+static void eduom_ReadAheadStopVolume(ra_Volume*);
+static Boolean eduom_ReadAheadIssue(RDsM_IOEngine*, ra_Active*);
+static Boolean eduom_ReadAheadDone(ra_Active*, Four);
+static void eduom_ReadAheadEnd(ra_Active*);
+
+
+
+/*@================================
+ * EduOM_InitReadAhead()
+ *================================*/
+/*
+ * Function: Four EduOM_InitReadAhead(Four, Four, char**, Four)
+ *
+ * Description:
+ *  Attach the mounted volume 'volNo' consisting of the given devices to the
+ *  read-ahead, and start 'nThreads' worker threads for each of its
+ *  devices. The devices must be given in the same order as to
+ *  LRDS_Mount().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+Four EduOM_InitReadAhead(
+    Four  volNo,		/* IN volume to attach */
+    Four  numDevices,		/* IN # of devices of the volume */
+    char  **devNames,		/* IN device names of the volume */
+    Four  nThreads)		/* IN # of worker threads of a device */
+{
+    Four e;			/* error */
+    Four i, j;			/* indexes */
+    Two  extSize;		/* # of pages in an extent of the volume */
+    ra_Volume *vol;		/* entry for the volume */
+    ra_Device *dev;		/* a device of the volume */
+    struct stat st;		/* status of a device */
+
+
+    /*@ parameter checking */
+    if (numDevices <= 0 || numDevices > RA_MAX_DEVICES || devNames == NULL) ERR(eBADPARAMETER_OM);
+
+    if (nThreads <= 0 || nThreads > RA_MAX_THREADS) ERR(eBADPARAMETER_OM);
+
+    if (!raInitialized) {
+	for (i = 0; i < RA_MAX_VOLUMES; i++) raVolumes[i].volNo = NIL;
+	for (i = 0; i < RA_MAX_STREAMS; i++) eduom_InitReadAheadStream(&raStreams[i], FORWARD);
+	raNumRequests = raNumPages = 0;
+	raShutdown = FALSE;
+	raInitialized = TRUE;
+    }
+
+    if (eduom_ReadAheadVolume(volNo) != NULL) ERR(eBADPARAMETER_OM);
+
+    for (vol = NULL, i = 0; i < RA_MAX_VOLUMES; i++)
+	if (raVolumes[i].volNo == NIL) { vol = &raVolumes[i]; break; }
+    if (vol == NULL) ERR(eBADPARAMETER_OM);
+
+    /* RDsM allocates whole extents in each device */
+    e = RDsM_GetSizeOfExt(volNo, &extSize);
+    if (e < 0) ERR(e);
+
+    vol->dev = (ra_Device *)calloc(numDevices, sizeof(ra_Device));
+    if (vol->dev == NULL) ERR(eMEMORYALLOCERR);
+
+    vol->firstPage[0] = 0;
+    for (i = 0; i < numDevices; i++) {
+	dev = &vol->dev[i];
+	dev->fd = open(devNames[i], O_RDONLY);
+	if (dev->fd < 0 || fstat(dev->fd, &st) < 0) {
+	    for ( ; i >= 0; i--) if (vol->dev[i].fd >= 0) close(vol->dev[i].fd);
+	    free(vol->dev);
+	    ERR(eBADPARAMETER_OM);
+	}
+	vol->firstPage[i+1] = vol->firstPage[i] + (st.st_size / PAGESIZE / extSize) * extSize;
+	dev->vol = vol;
+	dev->devNo = i;
+	pthread_cond_init(&dev->cond, NULL);
+    }
+    vol->numDevices = numDevices;
+    vol->extSize = extSize;
+
+    pthread_mutex_lock(&raMutex);
+    vol->volNo = volNo;
+    pthread_mutex_unlock(&raMutex);
+
+    /*@ start the workers of the devices */
+    for (i = 0; i < numDevices; i++) {
+	dev = &vol->dev[i];
+	for (j = 0; j < nThreads; j++) {
+	    if (pthread_create(&dev->threads[j], NULL,
+			       (EduBfM_SetAccessHint != NULL) ? eduom_ReadAheadFixWorker : eduom_ReadAheadWorker,
+			       dev) != 0) break;
+	    dev->nThreads++;
+	}
+	if (dev->nThreads == 0) {
+	    eduom_ReadAheadStopVolume(vol);
+	    ERR(eBADPARAMETER_OM);
+	}
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_InitReadAhead() */
+
+
+
+/*@================================
+ * EduOM_FinalReadAhead()
+ *================================*/
+/*
+ * Function: Four EduOM_FinalReadAhead(void)
+ *
+ * Description:
+ *  Stop the worker threads and detach all volumes. Pending requests are
+ *  dropped. It must be called before the volumes are dismounted.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four EduOM_FinalReadAhead(void)
+{
+    Four i;			/* index */
+
+
+    if (!raInitialized) return(eNOERROR);
+
+    pthread_mutex_lock(&raMutex);
+    raShutdown = TRUE;
+    pthread_mutex_unlock(&raMutex);
+
+    for (i = 0; i < RA_MAX_VOLUMES; i++)
+	if (raVolumes[i].volNo != NIL) eduom_ReadAheadStopVolume(&raVolumes[i]);
+
+    raInitialized = FALSE;
+
+    return(eNOERROR);
+
+} /* EduOM_FinalReadAhead() */
+
+
+
+
+/*@================================
+ * EduOM_GetReadAheadStatistics()
+ *================================*/
+/*
+ * Function: Four EduOM_GetReadAheadStatistics(Four*, Four*)
+ *
+ * Description:
+ *  Return the number of read-ahead requests issued and the number of pages
+ *  read by the worker threads.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four EduOM_GetReadAheadStatistics(
+    Four *nRequests,		/* OUT # of requests issued */
+    Four *nPages)		/* OUT # of pages read ahead */
+{
+    pthread_mutex_lock(&raMutex);
+    if (nRequests != NULL) *nRequests = raNumRequests;
+    if (nPages != NULL) *nPages = raNumPages;
+    pthread_mutex_unlock(&raMutex);
+
+    return(eNOERROR);
+
+} /* EduOM_GetReadAheadStatistics() */
+
+
+
+/*@================================
+ * eduom_InitReadAheadStream()
+ *================================*/
+/*
+ * Function: void eduom_InitReadAheadStream(OM_ReadAheadStream*, Four)
+ *
+ * Description:
+ *  Initialize a stream so that it is not regarded as sequential.
+ */
+void eduom_InitReadAheadStream(
+    OM_ReadAheadStream *stream,	/* OUT stream to initialize */
+    Four direction)		/* IN FORWARD or BACKWARD */
+{
+    stream->lastPid.volNo = NIL;
+    stream->lastPid.pageNo = NIL;
+    stream->direction = direction;
+    stream->nSeq = 0;
+    stream->nContig = 0;
+    stream->window = RA_MIN_WINDOW;
+    stream->nAhead = 0;
+    stream->lastUsed = 0;
+
+} /* eduom_InitReadAheadStream() */
+
+
+
+/*@================================
+ * eduom_ReadAheadStep()
+ *================================*/
+/*
+ * Function: Four eduom_ReadAheadStep(OM_ReadAheadStream*, PageID*, SlottedPage*, Four)
+ *
+ * Description:
+ *  Tell the read-ahead that a scan has moved from the page 'from' to the
+ *  page 'apage' (which is fixed by the caller) in the given direction.
+ *  If 'stream' is NULL, the stream is looked up by 'from' among the streams
+ *  kept for EduOM_NextObject() and EduOM_PrevObject().
+ *
+ *  Once a stream has moved along the page list RA_SEQ_THRESHOLD times in a
+ *  row, the pages following 'apage' are requested. The window starts at
+ *  RA_MIN_WINDOW pages and doubles on every request up to RA_MAX_WINDOW;
+ *  the next request, for the pages following those already requested, is
+ *  issued when less than half of the window is left ahead of the scan, so
+ *  the reads stay ahead of it. A non-sequential move resets the window.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four eduom_ReadAheadStep(
+    OM_ReadAheadStream *stream,	/* INOUT stream of the scan, may be NULL */
+    PageID *from,		/* IN page the scan moved from, may be NULL */
+    SlottedPage *apage,		/* IN page the scan moved to */
+    Four direction)		/* IN FORWARD or BACKWARD */
+{
+    Four i;			/* index */
+    PageID *to;			/* page the scan moved to */
+    PageNo next;		/* page following 'to' in the page list */
+    ra_Request req;		/* new request */
+    ra_Volume *vol;		/* volume of the scan */
+
+
+    if (!raInitialized) return(eNOERROR);
+
+    to = &apage->header.pid;
+
+    if (stream == NULL) {
+	for (i = 0; i < RA_MAX_STREAMS; i++) {
+	    if (from != NULL && raStreams[i].direction == direction && EQUAL_PAGEID(raStreams[i].lastPid, *from)) break;
+	}
+	if (i == RA_MAX_STREAMS) {
+	    /* replace the least recently used stream */
+	    for (stream = &raStreams[0], i = 1; i < RA_MAX_STREAMS; i++)
+		if (raStreams[i].lastUsed < stream->lastUsed) stream = &raStreams[i];
+	    eduom_InitReadAheadStream(stream, direction);
+	}
+	else
+	    stream = &raStreams[i];
+    }
+
+    if (from != NULL && from->pageNo != NIL && EQUAL_PAGEID(stream->lastPid, *from)) {
+	stream->nSeq++;
+	if (to->pageNo == from->pageNo + ((direction == FORWARD) ? 1 : -1)) stream->nContig++;
+	else stream->nContig = 0;
+    }
+    else {
+	stream->nSeq = 0;
+	stream->nContig = 0;
+	stream->window = RA_MIN_WINDOW;
+	stream->nAhead = 0;
+    }
+    stream->lastPid = *to;
+    stream->lastUsed = ++raClock;
+
+    if (stream->nAhead > 0) stream->nAhead--;
+
+    if (stream->nSeq < RA_SEQ_THRESHOLD) return(eNOERROR);
+
+    if (stream->nAhead > stream->window / 2) return(eNOERROR);
+
+    next = (direction == FORWARD) ? apage->header.nextPage : apage->header.prevPage;
+    if (next == NIL) return(eNOERROR);
+
+    MAKE_PAGEID(req.pid, to->volNo, next);
+    req.direction = direction;
+    req.nSkip = stream->nAhead;
+    req.nPages = stream->window;
+    req.contiguous = (stream->nContig >= stream->nSeq) ? TRUE : FALSE;
+
+    pthread_mutex_lock(&raMutex);
+    vol = eduom_ReadAheadVolume(to->volNo);
+    if (vol != NULL && eduom_ReadAheadQueue(vol, &req)) raNumRequests++;
+    pthread_mutex_unlock(&raMutex);
+
+    stream->nAhead += stream->window;
+    stream->window = (stream->window * 2 > RA_MAX_WINDOW) ? RA_MAX_WINDOW : stream->window * 2;
+
+    return(eNOERROR);
+
+} /* eduom_ReadAheadStep() */
+
+
+
+/*@================================
+ * eduom_ReadAheadPages()
+ *================================*/
+/*
+ * Function: Four eduom_ReadAheadPages(Four, PageID*)
+ *
+ * Description:
+ *  Announce to the kernel that the given pages, sorted by PageID, are about
+ *  to be fixed, so that their reads proceed in parallel instead of one by
+ *  one in BfM_GetTrain(). Runs of consecutive pages are announced together.
+ *  Nothing is done if the volume is not attached to the read-ahead.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four eduom_ReadAheadPages(
+    Four nPages,		/* IN # of pages */
+    PageID *pids)		/* IN pages sorted by PageID */
+{
+    Four i, j;			/* indexes */
+    Four dev;			/* device holding the pages */
+    ra_Volume *vol;		/* volume of the pages */
+
+
+    if (!raInitialized) return(eNOERROR);
+
+    for (i = 0; i < nPages; i = j) {
+	/* the run of consecutive pages starting at 'i' */
+	for (j = i + 1; j < nPages; j++)
+	    if (pids[j].volNo != pids[i].volNo || pids[j].pageNo != pids[j-1].pageNo + 1) break;
+
+	pthread_mutex_lock(&raMutex);
+	vol = eduom_ReadAheadVolume(pids[i].volNo);
+	pthread_mutex_unlock(&raMutex);
+	if (vol == NULL) continue;
+
+	dev = eduom_ReadAheadDevice(vol, pids[i].pageNo);
+	if (dev == NIL) continue;
+
+	/* a run crossing to the next device is announced on this device only */
+	(void) posix_fadvise(vol->dev[dev].fd, (pids[i].pageNo - vol->firstPage[dev]) * (off_t)PAGESIZE,
+			     (j - i) * (off_t)PAGESIZE, POSIX_FADV_WILLNEED);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_ReadAheadPages() */
+
+
+
+/*
+ * Function: ra_Volume *eduom_ReadAheadVolume(Four)
+ *
+ * Description:
+ *  Return the entry of an attached volume, or NULL.
+ */
+static ra_Volume *eduom_ReadAheadVolume(
+    Four volNo)			/* IN volume number */
+{
+    Four i;			/* index */
+
+    for (i = 0; i < RA_MAX_VOLUMES; i++)
+	if (raVolumes[i].volNo == volNo) return(&raVolumes[i]);
+
+    return(NULL);
+
+} /* eduom_ReadAheadVolume() */
+
+
+
+/*
+ * Function: Four eduom_ReadAheadDevice(ra_Volume*, PageNo)
+ *
+ * Description:
+ *  Return the index of the device of 'vol' holding the page 'pageNo'.
+ *
+ * Returns:
+ *  index of the device, or NIL if no device holds the page
+ */
+static Four eduom_ReadAheadDevice(
+    ra_Volume *vol,		/* IN volume */
+    PageNo pageNo)		/* IN page */
+{
+    Four d;			/* device index */
+
+
+    if (pageNo < 0) return(NIL);
+
+    for (d = 0; d < vol->numDevices; d++)
+	if (pageNo < vol->firstPage[d+1]) return(d);
+
+    return(NIL);
+
+} /* eduom_ReadAheadDevice() */
+
+
+
+/*
+ * Function: Boolean eduom_ReadAheadQueue(ra_Volume*, ra_Request*)
+ *
+ * Description:
+ *  Queue the request 'req' to the device of its first page and wake a
+ *  worker of the device. The caller holds raMutex.
+ *
+ * Returns:
+ *  TRUE if the request is queued, FALSE if it is dropped
+ */
+static Boolean eduom_ReadAheadQueue(
+    ra_Volume *vol,		/* IN volume of the request */
+    ra_Request *req)		/* IN request */
+{
+    Four d;			/* device of the first page */
+    ra_Device *dev;		/* the device */
+
+
+    d = eduom_ReadAheadDevice(vol, req->pid.pageNo);
+    if (d == NIL || vol->stop || raShutdown) return(FALSE);
+
+    dev = &vol->dev[d];
+    if (dev->count == RA_QUEUE_SIZE) return(FALSE);
+
+    dev->queue[(dev->head + dev->count) % RA_QUEUE_SIZE] = *req;
+    dev->count++;
+    pthread_cond_signal(&dev->cond);
+
+    return(TRUE);
+
+} /* eduom_ReadAheadQueue() */
+
+
+
+/*
+ * Function: void eduom_ReadAheadStopVolume(ra_Volume*)
+ *
+ * Description:
+ *  Stop the workers of the volume 'vol', dropping its pending requests,
+ *  and detach it.
+ */
+static void eduom_ReadAheadStopVolume(
+    ra_Volume *vol)		/* INOUT volume to detach */
+{
+    Four d, j;			/* indexes */
+    ra_Device *dev;		/* a device of the volume */
+
+
+    pthread_mutex_lock(&raMutex);
+    vol->stop = TRUE;
+    for (d = 0; d < vol->numDevices; d++) {
+	vol->dev[d].count = 0;
+	pthread_cond_broadcast(&vol->dev[d].cond);
+    }
+    pthread_mutex_unlock(&raMutex);
+
+    for (d = 0; d < vol->numDevices; d++) {
+	dev = &vol->dev[d];
+	for (j = 0; j < dev->nThreads; j++) pthread_join(dev->threads[j], NULL);
+	close(dev->fd);
+	pthread_cond_destroy(&dev->cond);
+    }
+
+    pthread_mutex_lock(&raMutex);
+    free(vol->dev);
+    vol->dev = NULL;
+    vol->stop = FALSE;
+    vol->volNo = NIL;
+    pthread_mutex_unlock(&raMutex);
+
+} /* eduom_ReadAheadStopVolume() */
+
+
+
+/*
+ * Function: void *eduom_ReadAheadWorker(void*)
+ *
+ * Description:
+ *  Body of a worker thread of the device 'arg'. The worker takes up to
+ *  RA_MAX_ACTIVE requests from the queue of the device, submits the next
+ *  read of each of them at once, and goes on with a request when its read
+ *  completes. A request is served by following the page list from the
+ *  requested page, reading each page to find the next one, together with
+ *  the pages following it in its extent; the first 'nSkip' pages were
+ *  requested before and are only followed. If the page list has been
+ *  physically contiguous, the rest of the window is read at once instead.
+ */
+static void *eduom_ReadAheadWorker(
+    void *arg)			/* IN device of the worker */
+{
+    Four i, k;			/* indexes */
+    Four nActive;		/* # of requests being served */
+    Four nNew;			/* # of requests taken from the queue */
+    Four newOnes[RA_MAX_ACTIVE]; /* requests taken from the queue */
+    Four nDone;			/* # of reads completed */
+    char *bufs;			/* read buffers of the requests */
+    size_t bufSize;		/* size of 'bufs' */
+    ra_Device *dev = (ra_Device *)arg; /* device of the worker */
+    ra_Volume *vol = dev->vol;	/* volume of the device */
+    ra_Active active[RA_MAX_ACTIVE]; /* requests being served */
+    ra_Active *a;		/* a request being served */
+    RDsM_IOEngine engine;	/* I/O engine of the worker */
+    RDsM_IOCompletion done[RA_MAX_ACTIVE]; /* reads completed */
+
+
+    bufSize = (size_t)RA_MAX_ACTIVE * RA_MAX_WINDOW * PAGESIZE;
+    if (posix_memalign((void **)&bufs, PAGESIZE, bufSize) != 0) return(NULL);
+
+    if (EduRDsM_InitIOEngine(&engine, RA_MAX_ACTIVE) < eNOERROR) {
+	free(bufs);
+	return(NULL);
+    }
+    (void) EduRDsM_RegisterIOBuffers(&engine, 1, &bufs, &bufSize);
+
+    for (i = 0; i < RA_MAX_ACTIVE; i++) {
+	active[i].dev = NULL;
+	active[i].buf = bufs + (size_t)i * RA_MAX_WINDOW * PAGESIZE;
+    }
+    nActive = 0;
+
+    for (;;) {
+	/*@ take new requests */
+	pthread_mutex_lock(&raMutex);
+	while (dev->count == 0 && nActive == 0 && !raShutdown && !vol->stop) pthread_cond_wait(&dev->cond, &raMutex);
+	if (raShutdown || vol->stop) {
+	    pthread_mutex_unlock(&raMutex);
+	    break;
+	}
+	for (i = 0, nNew = 0; i < RA_MAX_ACTIVE && dev->count > 0; i++) {
+	    if (active[i].dev != NULL) continue;
+	    active[i].req = dev->queue[dev->head];
+	    dev->head = (dev->head + 1) % RA_QUEUE_SIZE;
+	    dev->count--;
+	    active[i].dev = dev;
+	    active[i].n = 0;
+	    active[i].nRead = 0;
+	    newOnes[nNew++] = i;
+	}
+	pthread_mutex_unlock(&raMutex);
+
+	for (k = 0; k < nNew; k++)
+	    if (eduom_ReadAheadIssue(&engine, &active[newOnes[k]])) nActive++;
+
+	/*@ submit the reads and go on with the completed ones */
+	if (EduRDsM_SubmitIO(&engine) < eNOERROR) break;
+	if (nActive == 0) continue;
+
+	nDone = EduRDsM_WaitIO(&engine, 1, done, RA_MAX_ACTIVE);
+	if (nDone < eNOERROR) break;
+
+	for (k = 0; k < nDone; k++) {
+	    a = (ra_Active *)done[k].tag;
+	    if (!eduom_ReadAheadDone(a, done[k].result) || !eduom_ReadAheadIssue(&engine, a)) nActive--;
+	}
+    }
+
+    (void) EduRDsM_FinalIOEngine(&engine);
+    free(bufs);
+
+    return(NULL);
+
+} /* eduom_ReadAheadWorker() */
+
+
+
+/*
+ * Function: void *eduom_ReadAheadFixWorker(void*)
+ *
+ * Description:
+ *  Body of a worker thread of the device 'arg' with the in-tree buffer
+ *  manager. The worker takes one request at a time from the queue of the
+ *  device and serves it by following the page list from the requested
+ *  page, fixing each page with BfM_GetTrain() to find the next one and
+ *  freeing it at once, so that the pages are left in the buffer for the
+ *  scan. The first 'nSkip' pages are usually in the buffer already.
+ */
+static void *eduom_ReadAheadFixWorker(
+    void *arg)			/* IN device of the worker */
+{
+    Four e;			/* error */
+    Four total;			/* # of pages to follow */
+    PageNo first, last;		/* pages of the device */
+    PageNo next;		/* page following the current one */
+    SlottedPage *apage;		/* a page fixed */
+    ra_Device *dev = (ra_Device *)arg; /* device of the worker */
+    ra_Volume *vol = dev->vol;	/* volume of the device */
+    ra_Active a;		/* request being served */
+
+
+    first = vol->firstPage[dev->devNo];
+    last = vol->firstPage[dev->devNo + 1] - 1;
+
+    for (;;) {
+	/*@ take a new request */
+	pthread_mutex_lock(&raMutex);
+	while (dev->count == 0 && !raShutdown && !vol->stop) pthread_cond_wait(&dev->cond, &raMutex);
+	if (raShutdown || vol->stop) {
+	    pthread_mutex_unlock(&raMutex);
+	    break;
+	}
+	a.req = dev->queue[dev->head];
+	dev->head = (dev->head + 1) % RA_QUEUE_SIZE;
+	dev->count--;
+	a.dev = dev;
+	a.n = 0;
+	pthread_mutex_unlock(&raMutex);
+
+	/*@ install the pages of the request in the buffer */
+	total = a.req.nSkip + a.req.nPages;
+	while (a.n < total && a.req.pid.pageNo >= first && a.req.pid.pageNo <= last && !raShutdown && !vol->stop) {
+	    e = BfM_GetTrain(&a.req.pid, (char **)&apage, PAGE_BUF);
+	    if (e < eNOERROR) {
+		a.req.pid.pageNo = NIL;
+		break;
+	    }
+
+	    /* a page which is not a page of the file any more ends the request */
+	    if (EQUAL_PAGEID(apage->header.pid, a.req.pid)) {
+		next = (a.req.direction == FORWARD) ? apage->header.nextPage : apage->header.prevPage;
+		a.n++;
+	    }
+	    else
+		next = NIL;
+
+	    (void) BfM_FreeTrain(&a.req.pid, PAGE_BUF);
+
+	    a.req.pid.pageNo = next;
+	}
+
+	eduom_ReadAheadEnd(&a);
+    }
+
+    return(NULL);
+
+} /* eduom_ReadAheadFixWorker() */
+
+
+
+/*
+ * Function: Boolean eduom_ReadAheadIssue(RDsM_IOEngine*, ra_Active*)
+ *
+ * Description:
+ *  Prepare the next read of the request 'a': the page 'a->req.pid' and the
+ *  pages following it in its extent, or the rest of the window if the
+ *  page list is contiguous and the pages requested before have been
+ *  followed, up to the pages left to read and the end of the device. A
+ *  request going on in another device is passed to that device and, like
+ *  a request which is over, ended here.
+ *
+ * Returns:
+ *  TRUE if a read is prepared, FALSE if the request is ended
+ */
+static Boolean eduom_ReadAheadIssue(
+    RDsM_IOEngine *engine,	/* INOUT engine of the worker */
+    ra_Active *a)		/* INOUT request being served */
+{
+    Four nLeft;			/* # of pages left to read */
+    PageNo pageNo;		/* next page to read */
+    PageNo first, last;		/* pages of the device */
+    PageNo extFirst;		/* first page of the extent of 'pageNo' */
+    PageNo start, end;		/* pages read at once */
+    ra_Device *dev = a->dev;	/* device of the request */
+    ra_Volume *vol = dev->vol;	/* volume of the request */
+
+
+    nLeft = a->req.nSkip + a->req.nPages - a->n;
+    pageNo = a->req.pid.pageNo;
+    first = vol->firstPage[dev->devNo];
+    last = vol->firstPage[dev->devNo + 1] - 1;
+
+    if (nLeft > 0 && pageNo >= first && pageNo <= last && !raShutdown && !vol->stop) {
+	a->window = (a->n >= a->req.nSkip && a->req.contiguous) ? TRUE : FALSE;
+	if (a->req.direction == FORWARD) {
+	    extFirst = first + (pageNo - first) / vol->extSize * vol->extSize;
+	    start = pageNo;
+	    end = (a->window) ? last + 1 : extFirst + vol->extSize;
+	    end = MIN(end, start + MIN(nLeft, RA_MAX_WINDOW));
+	}
+	else {
+	    extFirst = first + (pageNo - first) / vol->extSize * vol->extSize;
+	    end = pageNo + 1;
+	    start = (a->window) ? first : extFirst;
+	    start = MAX(start, end - MIN(nLeft, RA_MAX_WINDOW));
+	}
+	a->start = start;
+	if (EduRDsM_PrepareIO(engine, RDSM_IO_READ, dev->fd, a->buf, (end - start) * PAGESIZE,
+			      (start - first) * (long long)PAGESIZE, a) >= eNOERROR)
+	    return(TRUE);
+	a->req.pid.pageNo = NIL;
+    }
+
+    eduom_ReadAheadEnd(a);
+
+    return(FALSE);
+
+} /* eduom_ReadAheadIssue() */
+
+
+
+/*
+ * Function: Boolean eduom_ReadAheadDone(ra_Active*, Four)
+ *
+ * Description:
+ *  Account for the completed read of the request 'a' with the result
+ *  'result', and follow the page list through the pages read. A read of
+ *  the rest of the window counts all its pages and goes on with the page
+ *  following them.
+ *
+ * Returns:
+ *  TRUE if the request goes on
+ */
+static Boolean eduom_ReadAheadDone(
+    ra_Active *a,		/* INOUT request being served */
+    Four result)		/* IN # of bytes read, or -errno */
+{
+    Four i;			/* index of a page in the buffer */
+    Four total;			/* # of pages to follow */
+    Four nBefore;		/* # of pages followed before the read */
+    SlottedPage *apage;		/* a page read */
+
+
+    a->nRead = MAX(result, 0) / PAGESIZE;
+    total = a->req.nSkip + a->req.nPages;
+
+    if (a->window) {
+	a->n += a->nRead;
+	if (a->nRead == 0) a->req.pid.pageNo = NIL;
+	else if (a->req.direction == FORWARD) a->req.pid.pageNo = a->start + a->nRead;
+	else a->req.pid.pageNo = a->start - 1;
+    }
+    else {
+	nBefore = a->n;
+	while (a->req.pid.pageNo != NIL && a->n < total) {
+	    i = a->req.pid.pageNo - a->start;
+	    if (i < 0 || i >= a->nRead) break;
+	    apage = (SlottedPage *)(a->buf + (size_t)i * PAGESIZE);
+	    if (!EQUAL_PAGEID(apage->header.pid, a->req.pid)) {
+		a->req.pid.pageNo = NIL;
+		break;
+	    }
+	    a->n++;
+	    a->req.pid.pageNo = (a->req.direction == FORWARD) ? apage->header.nextPage : apage->header.prevPage;
+	}
+	/* the requested page itself could not be read */
+	if (a->n == nBefore) a->req.pid.pageNo = NIL;
+    }
+
+    if (a->req.pid.pageNo != NIL && a->n < total) return(TRUE);
+
+    a->req.pid.pageNo = NIL;
+    eduom_ReadAheadEnd(a);
+
+    return(FALSE);
+
+} /* eduom_ReadAheadDone() */
+
+
+
+/*
+ * Function: void eduom_ReadAheadEnd(ra_Active*)
+ *
+ * Description:
+ *  End the request 'a' on its device: its pages are counted, and the rest
+ *  of the request, if its next page is in another device of the volume,
+ *  is queued to that device. 'a' is freed.
+ */
+static void eduom_ReadAheadEnd(
+    ra_Active *a)		/* INOUT request being served */
+{
+    Four nCounted;		/* # of pages read for the request here */
+    ra_Request rest;		/* rest of the request */
+
+
+    nCounted = MAX(a->n - a->req.nSkip, 0);
+
+    pthread_mutex_lock(&raMutex);
+    raNumPages += nCounted;
+    if (a->req.pid.pageNo != NIL && a->n < a->req.nSkip + a->req.nPages) {
+	rest = a->req;
+	rest.nSkip = MAX(a->req.nSkip - a->n, 0);
+	rest.nPages = a->req.nPages - nCounted;
+	(void) eduom_ReadAheadQueue(a->dev->vol, &rest);
+    }
+    pthread_mutex_unlock(&raMutex);
+
+    a->dev = NULL;
+
+} /* eduom_ReadAheadEnd() */
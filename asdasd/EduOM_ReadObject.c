@@ -122,6 +122,8 @@ Four EduOM_ReadObject(
     SlottedPage	*apage;		/* pointer to the buffer of the page  */
     Object	*obj;		/* pointer to the object in the slotted page */
     Four	offset;		/* offset of the object in the page */
+    ObjectID	movedOid;	/* ID of the forwarded record of a moved object */
+    double	missStart;	/* start of a timed miss of the object cache, 0 if not timed */
 
     
     
@@ -132,15 +134,26 @@ Four EduOM_ReadObject(
     if (length < 0 && length != REMAINDER) ERR(eBADLENGTH_OM);
     
     if (buf == NULL) ERR(eBADUSERBUF_OM);
+    if (eduom_ObjectCacheRead(oid, start, length, buf, &e, &missStart)) {	/* a hot object is in the object cache */
+        if (e < 0) ERR(e);
+        return(e);
+    }
     pid = *((PageID*)oid);//pid pageid 
     e = BfM_GetTrain(&pid,(char**)&apage, PAGE_BUF);// pid 
     if (e < 0)ERR(e);//
     offset = apage->slot[-(oid->slotNo)].offset;//offset 
     obj = &apage->data[offset];//obj
+    if (obj->header.properties & P_MOVED) {	/* read the forwarded record */
+        movedOid = *((ObjectID *)obj->data);
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+        return(EduOM_ReadObject(&movedOid, start, length, buf));
+    }
     if (start >= obj->header.length || start < 0) ERRB1(eBADSTART_OM, &pid, PAGE_BUF);//start   
     if (length == REMAINDER)length = obj->header.length - start;//length remainder   
     if (length + start > obj->header.length)length = obj->header.length - start;//length  
     memcpy(buf, &(obj->data[start]), length);
+    eduom_ObjectCacheAdmit(oid, obj, missStart);
     e = BfM_FreeTrain(&pid, PAGE_BUF);
     if (e < 0)ERR(e);
     return(length);
@@ -0,0 +1,132 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_ReadObjectV.c
+ *
+ * Description :
+ *  EduOM_ReadObjectV() reads several byte ranges of an object at once.
+ *
+ * Exports:
+ *  Four EduOM_ReadObjectV(ObjectID*, Four, OM_IOVec*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * EduOM_ReadObjectV()
+ *================================*/
+/*
+ * Function: Four EduOM_ReadObjectV(ObjectID*, Four, OM_IOVec*)
+ *
+ * Description :
+ *  Read the 'n' byte ranges given by 'iov' of the object 'oid' into their
+ *  buffers, as 'n' calls of EduOM_ReadObject() would, but with one page fix
+ *  and one validation of the object ID. On return, the length of each
+ *  segment is the number of bytes read into it. A segment starting at or
+ *  beyond the end of the object fails the whole call before anything is
+ *  copied.
+ *
+ * Returns:
+ *  1) total number of bytes read (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADOBJECTID_OM
+ *    eBADPARAMETER_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eBADSTART_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_ReadObjectV(
+    ObjectID	*oid,		/* IN object to read */
+    Four	n,		/* IN # of segments */
+    OM_IOVec	*iov)		/* INOUT segments to read */
+{
+    Four	e;		/* error code */
+    Four	i;		/* index */
+    Four	total;		/* # of bytes read */
+    OM_ObjectView view;		/* the object in the buffer */
+
+
+    /*@ check parameters */
+    if (n < 0 || (n > 0 && iov == NULL)) ERR(eBADPARAMETER_OM);
+
+    for (i = 0; i < n; i++) {
+	if (iov[i].length < 0 && iov[i].length != REMAINDER) ERR(eBADLENGTH_OM);
+	if (iov[i].buf == NULL) ERR(eBADUSERBUF_OM);
+    }
+
+    e = EduOM_PinObject(oid, &view);
+    if (e < 0) ERR(e);
+
+    for (i = 0; i < n; i++)
+	if (iov[i].start < 0 || iov[i].start >= view.length) {
+	    EduOM_UnpinObject(&view);
+	    ERR(eBADSTART_OM);
+	}
+
+    /*@ copy the segments */
+    for (total = 0, i = 0; i < n; i++) {
+	if (iov[i].length == REMAINDER || iov[i].start + iov[i].length > view.length)
+	    iov[i].length = view.length - iov[i].start;
+	memcpy(iov[i].buf, OM_VIEW_DATA(&view) + iov[i].start, iov[i].length);
+	total += iov[i].length;
+    }
+
+    e = EduOM_UnpinObject(&view);
+    if (e < 0) ERR(e);
+
+    return(total);
+
+} /* EduOM_ReadObjectV() */
@@ -0,0 +1,219 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_ReadObjects.c
+ *
+ * Description :
+ *  EduOM_ReadObjects() reads many objects at once, visiting each page once.
+ *
+ * Exports:
+ *  Four EduOM_ReadObjects(Four, ObjectID*, Four*, Four*, char**, Four*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+#define RO_BATCH_SIZE   512     /* requests sorted and served together */
+
+/*
+ * Typedef for a request sorted by its page
+ */
+typedef struct {
+    Four   volNo;               /* volume of the object */
+    PageNo pageNo;              /* page of the object */
+    Four   idx;                 /* index of the request */
+} ro_Request;
+
+
+static int eduom_CompareRequest(const void*, const void*);
+
+
+
+/*@================================
+ * EduOM_ReadObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_ReadObjects(Four, ObjectID*, Four*, Four*, char**, Four*)
+ *
+ * Description :
+ *  Read 'n' objects as EduOM_ReadObject() does: for each k, 'lengths[k]'
+ *  bytes (or the remainder if REMAINDER) from 'starts[k]' of the object
+ *  'oids[k]' are copied into 'bufs[k]'. 'starts' and 'lengths' may be NULL
+ *  to read the whole objects.
+ *
+ *  The requests are served in batches of RO_BATCH_SIZE, sorted by PageID, so
+ *  that each page is fixed once per batch and the pages are visited in the
+ *  order of the volume. If the read-ahead is initialized, the distinct pages
+ *  of a batch are announced first so that their reads overlap.
+ *
+ *  The outcome of each request is returned in 'results[k]': the number of
+ *  bytes read, or
+ *    eBADOBJECTID_OM if the object does not exist
+ *    eBADSTART_OM, eBADLENGTH_OM or eBADUSERBUF_OM for a bad request
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_ReadObjects(
+    Four	n,		/* IN # of objects to read */
+    ObjectID	*oids,		/* IN objects to read */
+    Four	*starts,	/* IN starting offsets of read, may be NULL */
+    Four	*lengths,	/* IN amounts of data to read, may be NULL */
+    char	**bufs,		/* OUT user buffers to return the read data */
+    Four	*results)	/* OUT # of bytes read or an error code of each object */
+{
+    Four	e;		/* error code */
+    Four	b;		/* first request of the batch */
+    Four	nBatch;		/* # of requests in the batch */
+    Four	i, j;		/* indexes */
+    Four	k;		/* index of a request */
+    Four	nPages;		/* # of distinct pages of the batch */
+    Four	start;		/* starting offset of read */
+    Four	length;		/* amount of data to read */
+    PageID	pid;		/* page being read */
+    SlottedPage	*apage;		/* pointer to the buffer of the page */
+    Object	*obj;		/* pointer to the object in the slotted page */
+    ro_Request	reqs[RO_BATCH_SIZE];	/* requests of the batch sorted by page */
+    PageID	pids[RO_BATCH_SIZE];	/* distinct pages of the batch */
+
+
+    /*@ check parameters */
+    if (n < 0 || (n > 0 && (oids == NULL || bufs == NULL || results == NULL))) ERR(eBADPARAMETER_OM);
+
+    for (b = 0; b < n; b += nBatch) {
+	nBatch = (n - b > RO_BATCH_SIZE) ? RO_BATCH_SIZE : n - b;
+
+	/*@ sort the batch by page */
+	for (i = 0; i < nBatch; i++) {
+	    reqs[i].volNo = oids[b+i].volNo;
+	    reqs[i].pageNo = oids[b+i].pageNo;
+	    reqs[i].idx = b + i;
+	}
+	qsort(reqs, nBatch, sizeof(ro_Request), eduom_CompareRequest);
+
+	for (nPages = 0, i = 0; i < nBatch; i++)
+	    if (i == 0 || reqs[i].volNo != reqs[i-1].volNo || reqs[i].pageNo != reqs[i-1].pageNo) {
+		MAKE_PAGEID(pids[nPages], reqs[i].volNo, reqs[i].pageNo);
+		nPages++;
+	    }
+
+	e = eduom_ReadAheadPages(nPages, pids);
+	if (e < 0) ERR(e);
+
+	/*@ fix each page once and serve its requests */
+	for (i = 0; i < nBatch; i = j) {
+	    MAKE_PAGEID(pid, reqs[i].volNo, reqs[i].pageNo);
+	    e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
+	    if (e < 0) ERR(e);
+
+	    for (j = i; j < nBatch && reqs[j].volNo == pid.volNo && reqs[j].pageNo == pid.pageNo; j++) {
+		k = reqs[j].idx;
+		start = (starts != NULL) ? starts[k] : 0;
+		length = (lengths != NULL) ? lengths[k] : REMAINDER;
+
+		if (oids[k].slotNo < 0 || oids[k].slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(&oids[k], apage)) {
+		    results[k] = eBADOBJECTID_OM;
+		    continue;
+		}
+		if (length < 0 && length != REMAINDER) { results[k] = eBADLENGTH_OM; continue; }
+		if (bufs[k] == NULL) { results[k] = eBADUSERBUF_OM; continue; }
+
+		obj = (Object *)&(apage->data[apage->slot[-oids[k].slotNo].offset]);
+
+		/* a moved object is read through its stub */
+		if (obj->header.properties & P_MOVED) {
+		    results[k] = EduOM_ReadObject(&oids[k], start, length, bufs[k]);
+		    continue;
+		}
+
+		if (start >= obj->header.length || start < 0) { results[k] = eBADSTART_OM; continue; }
+		if (length == REMAINDER || length + start > obj->header.length) length = obj->header.length - start;
+
+		memcpy(bufs[k], &(obj->data[start]), length);
+		results[k] = length;
+	    }
+
+	    e = BfM_FreeTrain(&pid, PAGE_BUF);
+	    if (e < 0) ERR(e);
+	}
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_ReadObjects() */
+
+
+
+/*
+ * Function: int eduom_CompareRequest(const void*, const void*)
+ *
+ * Description:
+ *  Order the requests by PageID, and by their position for the same page.
+ */
+static int eduom_CompareRequest(
+    const void *a,		/* IN a request */
+    const void *b)		/* IN another request */
+{
+    const ro_Request *ra = (const ro_Request *)a;
+    const ro_Request *rb = (const ro_Request *)b;
+
+    if (ra->volNo != rb->volNo) return((ra->volNo < rb->volNo) ? -1 : 1);
+    if (ra->pageNo != rb->pageNo) return((ra->pageNo < rb->pageNo) ? -1 : 1);
+
+    return((ra->idx < rb->idx) ? -1 : (ra->idx > rb->idx));
+
+} /* eduom_CompareRequest() */
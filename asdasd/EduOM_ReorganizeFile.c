@@ -0,0 +1,392 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_ReorganizeFile.c
+ *
+ * Description:
+ *  Online reorganization of a data file for physical page contiguity.
+ *
+ * Export:
+ *  Four EduOM_ReorganizeFile(ObjectID*, OM_ReorgCursor*, Four, OM_RemapCallback, void*, Pool*, DeallocListElem*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "Util.h"		/* to get Pool */
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+static Four eduom_IsInPageList(PageNo, FileID*, PageNo, Boolean*);
+
+
+/*@================================
+ * EduOM_ReorganizeFile()
+ *================================*/
+/*
+ * Function: Four EduOM_ReorganizeFile(ObjectID*, OM_ReorgCursor*, Four, OM_RemapCallback, void*, Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Rewrite the objects of the data file into freshly allocated pages in
+ *  the order of the page list. Each new page is allocated next to the
+ *  previous one and appended to the page list, so that once all old pages
+ *  have been emptied (and released by EduOM_DestroyObject()), the page list
+ *  runs through consecutive pages and a sequential scan reads the volume
+ *  sequentially. The file map and the available space lists are kept up
+ *  to date as the pages come and go.
+ *
+ *  The objects of the first page of the file stay where they are, since
+ *  the first page identifies the file and is never released.
+ *
+ *  If 'remap' is given, a moved object gets a new object ID, which is told
+ *  to 'remap' with the old one before the old object is destroyed, so that
+ *  the caller can maintain a remap table. An object moved by
+ *  EduOM_VacuumFile() is moved from its forwarded record when its stub is
+ *  met, also in the first page, and its stub is destroyed; the new ID is
+ *  reported for the ID of the stub.
+ *
+ *  If 'remap' is NULL, the object IDs stay valid: as in EduOM_VacuumFile(),
+ *  a moved object leaves a stub (P_MOVED) at its old ID, holding the ID of
+ *  its forwarded record (P_FORWARDED) in the new page, and a stub met on
+ *  the way is pointed to the new place of its record. The old pages then
+ *  hold only stubs and are released by EduOM_CollapseForwarding(). An
+ *  object too small to be replaced by a stub is not moved.
+ *
+ *  In both modes, the forwarded records themselves are passed over, since
+ *  they move with their stubs, so that the stubs left by calls of
+ *  EduOM_VacuumFile() between two chunks are handled like the others.
+ *
+ *  The work is done in chunks: each call reorganizes whole pages until at
+ *  least 'maxObjects' objects have been moved, and the position is kept in
+ *  'cursor', which must be initialized with INIT_REORG_CURSOR() before the
+ *  first call. The pages allocated by the reorganization are appended to
+ *  the page list, so the pass ends at the first of them. Objects may be
+ *  created and destroyed between the calls, and a page emptied meanwhile
+ *  leaves the page list: each call checks that the pages of 'cursor' are
+ *  still in the list, and starts again from the first page of the file if
+ *  the next page to reorganize is not, or ends at the end of the list
+ *  (moving some objects twice) if the first new page is not. Pages
+ *  appended to the file after the first new page are not reorganized.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    the negative value returned by 'remap'
+ *    some errors caused by function calls
+ *  EOS if the reorganization is complete
+ */
+Four EduOM_ReorganizeFile(
+    ObjectID *catObjForFile,	/* IN informations about a data file */
+    OM_ReorgCursor *cursor,	/* INOUT position of the reorganization */
+    Four maxObjects,		/* IN # of objects to move in this call */
+    OM_RemapCallback remap,	/* IN function told about the moved objects, NULL to leave stubs */
+    void *arg,			/* IN argument of 'remap' */
+    Pool *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four e;			/* error */
+    Two  i;			/* slot number */
+    Four nMoved;		/* # of objects moved in this call */
+    Boolean inList;		/* TRUE if a page is in the page list */
+    Boolean restart;		/* TRUE to go on from the first page */
+    FileID fid;			/* ID of the file */
+    PageNo firstPage;		/* first page of the file */
+    PageID oldPid;		/* page being reorganized */
+    PageNo nextPage;		/* page to reorganize after 'oldPid' */
+    SlottedPage *oldPage;	/* buffer holding 'oldPid' */
+    PageID fwdPid;		/* page of the forwarded record of a moved object */
+    SlottedPage *fwdPage = NULL; /* buffer holding 'fwdPid', NULL if not fixed */
+    SlottedPage *newPage;	/* buffer holding cursor->newPage, NULL if not fixed */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+    Object *obj;		/* object to move */
+    Object *stub;		/* object of the slot, the stub of 'obj' if it is moved */
+    ObjectHdr objHdr;		/* header of the object in its new place */
+    ObjectID oldOid;		/* ID of the object to move */
+    ObjectID newOid;		/* ID of the moved object */
+    ObjectID fwdOid;		/* old forwarded record of a stub kept */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (cursor == NULL || maxObjects <= 0) ERR(eBADPARAMETER_OM);
+
+    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+    fid = catEntry->fid;
+    firstPage = catEntry->firstPage;
+
+    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    restart = !cursor->started;
+    if (restart) {
+	cursor->firstNewPage = NIL;
+	MAKE_PAGEID(cursor->newPage, fid.volNo, NIL);
+	cursor->nMoved = cursor->nPages = 0;
+	cursor->started = TRUE;
+    }
+    else if (cursor->nextOldPage == NIL) return(EOS);
+
+    /*@ forget the pages of the cursor emptied and released since the last call */
+    if (cursor->newPage.pageNo != NIL) {
+	e = eduom_IsInPageList(cursor->newPage.pageNo, &fid, firstPage, &inList);
+	if (e < 0) ERR(e);
+	if (!inList) cursor->newPage.pageNo = NIL;
+    }
+    if (cursor->firstNewPage != NIL) {
+	e = eduom_IsInPageList(cursor->firstNewPage, &fid, firstPage, &inList);
+	if (e < 0) ERR(e);
+	/* the pages filled so far are reorganized again, the next one ends the pass */
+	if (!inList) cursor->firstNewPage = cursor->newPage.pageNo = NIL;
+    }
+    if (!restart && cursor->nextOldPage != cursor->firstNewPage) {
+	e = eduom_IsInPageList(cursor->nextOldPage, &fid, firstPage, &inList);
+	if (e < 0) ERR(e);
+	restart = !inList;
+    }
+
+    /*@ start from the first page, of which only the moved objects move */
+    if (restart) cursor->nextOldPage = firstPage;
+
+    if (cursor->nextOldPage == cursor->firstNewPage) cursor->nextOldPage = NIL;
+    if (cursor->nextOldPage == NIL) return(EOS);
+
+    /*@ continue filling the last new page */
+    newPage = NULL;
+    if (cursor->newPage.pageNo != NIL) {
+	e = BfM_GetTrain(&cursor->newPage, (char **)&newPage, PAGE_BUF);
+	if (e < 0) ERR(e);
+	e = om_RemoveFromAvailSpaceList(catObjForFile, &cursor->newPage, newPage);
+	if (e < 0) ERRB1(e, &cursor->newPage, PAGE_BUF);
+    }
+
+    /*@ move the objects page by page */
+    for (nMoved = 0; cursor->nextOldPage != NIL && nMoved < maxObjects; ) {
+	MAKE_PAGEID(oldPid, catObjForFile->volNo, cursor->nextOldPage);
+	e = BfM_GetTrain(&oldPid, (char **)&oldPage, PAGE_BUF);
+	if (e < 0) goto fail;
+	nextPage = oldPage->header.nextPage;
+
+	for (i = 0; i < oldPage->header.nSlots; i++) {
+	    if (oldPage->slot[-i].offset == EMPTYSLOT) continue;
+	    obj = stub = (Object *)&(oldPage->data[oldPage->slot[-i].offset]);
+
+	    /* a forwarded record moves with its stub */
+	    if (obj->header.properties & P_FORWARDED) continue;
+	    if (!(obj->header.properties & P_MOVED)) {
+		if (oldPid.pageNo == firstPage) continue;
+		if (remap == NULL && OM_OBJECT_SPACE(obj->header.length) < OM_OBJECT_SPACE(OM_STUB_LENGTH)) continue;
+	    }
+
+	    /* a moved object is taken from its forwarded record */
+	    if (obj->header.properties & P_MOVED) {
+		e = eduom_FixForwarded(stub, &fwdPid, &fwdPage, &obj);
+		if (e < 0) { fwdPage = NULL; goto failOld; }
+	    }
+	    objHdr = obj->header;
+	    objHdr.properties &= ~(P_MOVED | P_FORWARDED);
+	    if (remap == NULL) objHdr.properties |= P_FORWARDED;
+
+	    /* the current new page is full, or holds the forwarded record and
+	       may not be compacted under it; start the next one beside it */
+	    if (newPage == NULL || SP_FREE(newPage) < OM_NEEDED_SPACE(obj->header.length) ||
+		(fwdPage != NULL && fwdPid.pageNo == cursor->newPage.pageNo)) {
+		if (newPage != NULL) {
+		    e = om_PutInAvailSpaceList(catObjForFile, &cursor->newPage, newPage);
+		    if (e >= 0) e = BfM_FreeTrain(&cursor->newPage, PAGE_BUF);
+		    newPage = NULL;
+		    if (e < 0) goto failOld;
+		}
+		e = eduom_AllocPage(catObjForFile, (cursor->newPage.pageNo != NIL) ? &cursor->newPage : NULL,
+				    NULL, &cursor->newPage, &newPage);
+		if (e < 0) {
+		    newPage = NULL;
+		    MAKE_PAGEID(cursor->newPage, oldPid.volNo, NIL);
+		    goto failOld;
+		}
+		if (cursor->firstNewPage == NIL) cursor->firstNewPage = cursor->newPage.pageNo;
+	    }
+
+	    e = eduom_PlaceObject(catObjForFile, &cursor->newPage, newPage, &objHdr,
+				  obj->header.length, obj->data, &newOid);
+	    if (e < 0) goto failOld;
+
+	    if (fwdPage != NULL) {
+		/* a kept stub loses its old record below */
+		if (remap == NULL) obj->header.properties &= ~P_FORWARDED;
+		fwdPage = NULL;
+		e = BfM_FreeTrain(&fwdPid, PAGE_BUF);
+		if (e < 0) goto failOld;
+	    }
+
+	    MAKE_OBJECTID(oldOid, oldPid.volNo, oldPid.pageNo, i, oldPage->slot[-i].unique);
+	    if (remap != NULL) {
+		e = remap(&oldOid, &newOid, arg);
+		if (e < 0) goto failOld;
+
+		/* the page is released when its last object is destroyed; a
+		   stub is destroyed with its forwarded record */
+		e = EduOM_DestroyObject(catObjForFile, &oldOid, dlPool, dlHead);
+		if (e < 0) goto failOld;
+	    }
+	    else if (stub != obj) {
+		/* point the stub to the new place of its record */
+		fwdOid = *((ObjectID *)stub->data);
+		e = EduOM_DestroyObject(catObjForFile, &fwdOid, dlPool, dlHead);
+		if (e < 0) goto failOld;
+
+		memcpy(stub->data, (char *)&newOid, OM_STUB_LENGTH);
+		e = BfM_SetDirty(&oldPid, PAGE_BUF);
+		if (e < 0) goto failOld;
+	    }
+	    else {
+		/* replace the object by a stub */
+		e = om_RemoveFromAvailSpaceList(catObjForFile, &oldPid, oldPage);
+		if (e < 0) goto failOld;
+
+		oldPage->header.unused += OM_OBJECT_SPACE(obj->header.length) - OM_OBJECT_SPACE(OM_STUB_LENGTH);
+		obj->header.properties |= P_MOVED;
+		obj->header.length = OM_STUB_LENGTH;
+		memcpy(obj->data, (char *)&newOid, OM_STUB_LENGTH);
+
+		e = BfM_SetDirty(&oldPid, PAGE_BUF);
+		if (e >= 0) e = om_PutInAvailSpaceList(catObjForFile, &oldPid, oldPage);
+		if (e < 0) goto failOld;
+	    }
+
+	    nMoved++;
+	}
+
+	e = BfM_FreeTrain(&oldPid, PAGE_BUF);
+	if (e < 0) goto fail;
+
+	cursor->nextOldPage = (nextPage == cursor->firstNewPage) ? NIL : nextPage;
+	if (oldPid.pageNo != firstPage) cursor->nPages++;
+    }
+    cursor->nMoved += nMoved;
+
+    if (newPage != NULL) {
+	e = om_PutInAvailSpaceList(catObjForFile, &cursor->newPage, newPage);
+	if (e < 0) ERRB1(e, &cursor->newPage, PAGE_BUF);
+	e = BfM_FreeTrain(&cursor->newPage, PAGE_BUF);
+	if (e < 0) ERR(e);
+    }
+
+    return((cursor->nextOldPage == NIL) ? EOS : eNOERROR);
+
+failOld:
+    if (fwdPage != NULL) BfM_FreeTrain(&fwdPid, PAGE_BUF);
+    BfM_FreeTrain(&oldPid, PAGE_BUF);
+fail:
+    cursor->nMoved += nMoved;
+    if (newPage != NULL) {
+	om_PutInAvailSpaceList(catObjForFile, &cursor->newPage, newPage);
+	BfM_FreeTrain(&cursor->newPage, PAGE_BUF);
+    }
+    ERR(e);
+
+} /* EduOM_ReorganizeFile() */
+
+
+
+/*
+ * Function: Four eduom_IsInPageList(PageNo, FileID*, PageNo, Boolean*)
+ *
+ * Description:
+ *  Tell if the page 'pageNo' of the volume of the file 'fid', whose first
+ *  page is 'firstPage', is in the page list of the file. A page which left
+ *  the list keeps its links, so a page other than the first one is in the
+ *  list if it belongs to the file and its previous page, which belongs to
+ *  the file, links to it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_IsInPageList(
+    PageNo pageNo,		/* IN page to look for */
+    FileID *fid,		/* IN ID of the file */
+    PageNo firstPage,		/* IN first page of the file */
+    Boolean *inList)		/* OUT TRUE if the page is in the page list */
+{
+    Four e;			/* error */
+    PageID pid;			/* page to look for */
+    PageID prevPid;		/* previous page of 'pid' */
+    SlottedPage *apage;		/* buffer holding a page */
+
+
+    *inList = (pageNo == firstPage) ? TRUE : FALSE;
+    if (*inList) return(eNOERROR);
+
+    MAKE_PAGEID(pid, fid->volNo, pageNo);
+    e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    MAKE_PAGEID(prevPid, fid->volNo, apage->header.prevPage);
+    if (!EQUAL_FILEID(apage->header.fid, *fid)) prevPid.pageNo = NIL;
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (prevPid.pageNo == NIL) return(eNOERROR);
+
+    e = BfM_GetTrain(&prevPid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    *inList = (EQUAL_FILEID(apage->header.fid, *fid) && apage->header.nextPage == pageNo) ? TRUE : FALSE;
+    e = BfM_FreeTrain(&prevPid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_IsInPageList() */
@@ -0,0 +1,247 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_ScanNext.c
+ *
+ * Description:
+ *  Return the next object of a scan cursor.
+ *
+ * Export:
+ *  Four EduOM_ScanNext(OM_ScanCursor*, ObjectID*, ObjectHdr*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+/*@================================
+ * EduOM_ScanNext()
+ *================================*/
+/*
+ * Function: Four EduOM_ScanNext(OM_ScanCursor*, ObjectID*, ObjectHdr*)
+ *
+ * Description:
+ *  Return the next object of the scan in the direction the cursor was opened
+ *  with. Unlike EduOM_NextObject()/EduOM_PrevObject(), the page holding the
+ *  current object stays fixed in the buffer between calls and the position
+ *  within the page is remembered by the cursor; the page is freed only when
+ *  the cursor moves to 'nextPage' (FORWARD) or 'prevPage' (BACKWARD).
+ *  So a scan costs one BfM_GetTrain()/BfM_FreeTrain() pair per page instead
+ *  of several buffer calls per object. Every page move is reported to the
+ *  read-ahead. The pages are fixed under the access hint of the cursor.
+ *  For a cursor opened by EduOM_OpenFilteredScan(), the qualifying slots of
+ *  a page are computed when the cursor moves to the page, and only those
+ *  slots are visited; if the file has a zone map, the pages which cannot
+ *  hold a qualifying object are passed over without being fixed.
+ *  A moved object is returned under the ID of its stub, with the header of
+ *  its forwarded record, and qualifies on that header; the page holding
+ *  the forwarded record stays fixed until the next call.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ *  EOS if there is no more object
+ *
+ * Side effect:
+ *  1) parameter oid
+ *     oid is filled with the next object's identifier
+ *  2) parameter objHdr
+ *     objHdr is filled with the next object's header
+ */
+Four EduOM_ScanNext(
+    OM_ScanCursor *cursor,		/* INOUT the scan cursor */
+    ObjectID      *oid,			/* OUT the next object */
+    ObjectHdr     *objHdr)		/* OUT the object header of next object */
+{
+    Four e;			/* error */
+    Two  i;			/* index */
+    Boolean found;		/* TRUE if an object is found in the page */
+    PageNo pageNo;		/* PageNo of the page to move to */
+    PageID prevPid;		/* page the cursor moves from */
+    Four prevHint;		/* access hint of the thread */
+    SlottedPage *apage;		/* a pointer to the data page */
+    Object *obj;		/* a pointer to the Object */
+    ObjectHdr hdr;		/* header of a moved object */
+
+
+    /*@ parameter checking */
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (cursor->eos) return(EOS);
+
+    /*@ free the forwarded record returned last */
+    if (cursor->fwdPage != NULL) {
+	cursor->fwdPage = NULL;
+	e = BfM_FreeTrain(&cursor->fwdPid, PAGE_BUF);
+	if (e < 0) ERR(e);
+    }
+
+    /*@ fix the first page on the first call */
+    if (cursor->apage == NULL) {
+	pageNo = (cursor->direction == FORWARD) ? cursor->pFid.pageNo : cursor->lastPage;
+	if (cursor->zoneMap != NULL) {
+	    pageNo = eduom_ZoneMapSkip(cursor->zoneMap, cursor->zoneMapGen, pageNo, &cursor->pred,
+				       cursor->direction, &cursor->nSkipped);
+	    if (pageNo == NIL) {
+		cursor->eos = TRUE;
+		return(EOS);
+	    }
+	}
+	MAKE_PAGEID(cursor->pid, cursor->pFid.volNo, pageNo);
+
+	if (cursor->accessHint != OM_HINT_NORMAL) prevHint = EduOM_SetAccessHint(cursor->accessHint);
+	e = BfM_GetTrain(&cursor->pid, (char **)&cursor->apage, PAGE_BUF);
+	if (cursor->accessHint != OM_HINT_NORMAL) (void) EduOM_SetAccessHint(prevHint);
+	if (e < 0) {
+	    cursor->apage = NULL;
+	    cursor->eos = TRUE;
+	    ERR(e);
+	}
+	cursor->slotNo = (cursor->direction == FORWARD) ? -1 : cursor->apage->header.nSlots;
+	if (cursor->filtered) {
+	    cursor->nQual = eduom_FilterPage(cursor->apage, &cursor->pred, cursor->qual);
+	    cursor->qualPos = (cursor->direction == FORWARD) ? -1 : cursor->nQual;
+	}
+
+	/* the read-ahead is only a hint; its failure does not fail the scan */
+	(void) eduom_ReadAheadStep(&cursor->ra, NULL, cursor->apage, cursor->direction);
+    }
+
+    for (;;) {
+	apage = cursor->apage;
+
+	if (cursor->filtered) {
+	    cursor->qualPos += (cursor->direction == FORWARD) ? 1 : -1;
+	    found = (cursor->qualPos >= 0 && cursor->qualPos < cursor->nQual) ? TRUE : FALSE;
+	    if (found) i = cursor->qual[cursor->qualPos];
+	    pageNo = (cursor->direction == FORWARD) ? apage->header.nextPage : apage->header.prevPage;
+	}
+	else if (cursor->direction == FORWARD) {
+	    for (i = cursor->slotNo + 1; i < apage->header.nSlots; i++)
+		if (OM_IS_OBJECT_SLOT(apage, i)) break;
+	    found = (i < apage->header.nSlots) ? TRUE : FALSE;
+	    pageNo = apage->header.nextPage;
+	}
+	else {
+	    for (i = cursor->slotNo - 1; i >= 0; i--)
+		if (OM_IS_OBJECT_SLOT(apage, i)) break;
+	    found = (i >= 0) ? TRUE : FALSE;
+	    pageNo = apage->header.prevPage;
+	}
+
+	if (found) {
+	    cursor->slotNo = i;
+	    obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+	    if (!(obj->header.properties & P_MOVED)) break;
+
+	    /* a moved object is returned with its forwarded record */
+	    e = eduom_FixForwarded(obj, &cursor->fwdPid, &cursor->fwdPage, &obj);
+	    if (e < 0) {
+		cursor->fwdPage = NULL;
+		ERR(e);
+	    }
+	    hdr = obj->header;
+	    hdr.properties &= ~P_FORWARDED;
+	    if (!cursor->filtered || eduom_MatchPredicate(&hdr, &cursor->pred)) break;
+
+	    cursor->fwdPage = NULL;
+	    e = BfM_FreeTrain(&cursor->fwdPid, PAGE_BUF);
+	    if (e < 0) ERR(e);
+	    continue;
+	}
+
+	/*@ no more object in this page; move to the neighboring page */
+	cursor->apage = NULL;
+	e = BfM_FreeTrain(&cursor->pid, PAGE_BUF);
+	if (e < 0) ERR(e);
+
+	if (pageNo != NIL && cursor->zoneMap != NULL)
+	    pageNo = eduom_ZoneMapSkip(cursor->zoneMap, cursor->zoneMapGen, pageNo, &cursor->pred,
+				       cursor->direction, &cursor->nSkipped);
+
+	if (pageNo == NIL) {
+	    cursor->eos = TRUE;
+	    return(EOS);
+	}
+
+	prevPid = cursor->pid;
+	MAKE_PAGEID(cursor->pid, cursor->pFid.volNo, pageNo);
+	if (cursor->accessHint != OM_HINT_NORMAL) prevHint = EduOM_SetAccessHint(cursor->accessHint);
+	e = BfM_GetTrain(&cursor->pid, (char **)&cursor->apage, PAGE_BUF);
+	if (cursor->accessHint != OM_HINT_NORMAL) (void) EduOM_SetAccessHint(prevHint);
+	if (e < 0) {
+	    cursor->apage = NULL;
+	    cursor->eos = TRUE;
+	    ERR(e);
+	}
+	cursor->slotNo = (cursor->direction == FORWARD) ? -1 : cursor->apage->header.nSlots;
+	if (cursor->filtered) {
+	    cursor->nQual = eduom_FilterPage(cursor->apage, &cursor->pred, cursor->qual);
+	    cursor->qualPos = (cursor->direction == FORWARD) ? -1 : cursor->nQual;
+	}
+
+	(void) eduom_ReadAheadStep(&cursor->ra, &prevPid, cursor->apage, cursor->direction);
+    }
+
+    cursor->obj = obj;
+    MAKE_OBJECTID(*oid, cursor->pid.volNo, cursor->pid.pageNo, i, apage->slot[-i].unique);
+    if (objHdr != NULL) {
+	*objHdr = obj->header;
+	objHdr->properties &= ~P_FORWARDED;
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_ScanNext() */
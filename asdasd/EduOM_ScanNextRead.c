@@ -0,0 +1,134 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_ScanNextRead.c
+ *
+ * Description:
+ *  Return the next object of a scan cursor together with its data.
+ *
+ * Export:
+ *  Four EduOM_ScanNextRead(OM_ScanCursor*, Four, Four, ObjectID*, ObjectHdr*, void*, Four*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+/*@================================
+ * EduOM_ScanNextRead()
+ *================================*/
+/*
+ * Function: Four EduOM_ScanNextRead(OM_ScanCursor*, Four, Four, ObjectID*, ObjectHdr*, void*, Four*)
+ *
+ * Description:
+ *  Move the cursor to the next object like EduOM_ScanNext() and copy the
+ *  'length' bytes from 'start' of the object into 'buf', as
+ *  EduOM_ReadObject() would. The data are copied from the page the cursor
+ *  keeps fixed, so the loop of EduOM_NextObject() and EduOM_ReadObject(),
+ *  which fixes the catalog page and the data page twice per object, is
+ *  replaced by one fix per page.
+ *  If 'length' is REMAINDER, the data from 'start' to the end of the object
+ *  are copied. An object shorter than 'start' yields no data.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eBADOBJECTID_OM
+ *    eBADSTART_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    some errors caused by function calls
+ *  EOS if there is no more object
+ *
+ * Side effect:
+ *  1) parameter oid, objHdr
+ *     filled with the next object's identifier and header
+ *  2) parameter buf, nRead
+ *     buf is filled with the data read, nRead with the # of bytes read
+ */
+Four EduOM_ScanNextRead(
+    OM_ScanCursor *cursor,		/* INOUT the scan cursor */
+    Four          start,		/* IN starting offset of read */
+    Four          length,		/* IN amount of data to read */
+    ObjectID      *oid,			/* OUT the next object */
+    ObjectHdr     *objHdr,		/* OUT the object header of next object */
+    void          *buf,			/* OUT user buffer to return the read data */
+    Four          *nRead)		/* OUT # of bytes read */
+{
+    Four e;			/* error */
+    Object *obj;		/* the object in the fixed page */
+
+
+    /*@ parameter checking */
+    if (start < 0) ERR(eBADSTART_OM);
+
+    if (length < 0 && length != REMAINDER) ERR(eBADLENGTH_OM);
+
+    if (buf == NULL || nRead == NULL) ERR(eBADUSERBUF_OM);
+
+    e = EduOM_ScanNext(cursor, oid, objHdr);
+    if (e < 0) ERR(e);
+    if (e == EOS) return(EOS);
+
+    obj = cursor->obj;
+
+    if (start >= obj->header.length)
+	*nRead = 0;
+    else if (length == REMAINDER || start + length > obj->header.length)
+	*nRead = obj->header.length - start;
+    else
+	*nRead = length;
+
+    memcpy(buf, &(obj->data[start]), *nRead);
+
+    return(eNOERROR);
+
+} /* EduOM_ScanNextRead() */
@@ -0,0 +1,113 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_ScanNextView.c
+ *
+ * Description:
+ *  Return the next object of a scan cursor with a pointer to its data in
+ *  the buffer.
+ *
+ * Export:
+ *  Four EduOM_ScanNextView(OM_ScanCursor*, ObjectID*, ObjectHdr*, char**)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+/*@================================
+ * EduOM_ScanNextView()
+ *================================*/
+/*
+ * Function: Four EduOM_ScanNextView(OM_ScanCursor*, ObjectID*, ObjectHdr*, char**)
+ *
+ * Description:
+ *  Move the cursor to the next object like EduOM_ScanNext() and return a
+ *  pointer to the data of the object in the page the cursor keeps fixed,
+ *  so that no copy is made. The data must not be modified, and the pointer
+ *  is valid only until the next call on the cursor or EduOM_CloseScan().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eBADOBJECTID_OM
+ *    eBADUSERBUF_OM
+ *    some errors caused by function calls
+ *  EOS if there is no more object
+ *
+ * Side effect:
+ *  1) parameter oid, objHdr
+ *     filled with the next object's identifier and header
+ *  2) parameter data
+ *     data points to the object's data
+ */
+Four EduOM_ScanNextView(
+    OM_ScanCursor *cursor,		/* INOUT the scan cursor */
+    ObjectID      *oid,			/* OUT the next object */
+    ObjectHdr     *objHdr,		/* OUT the object header of next object */
+    char          **data)		/* OUT the object's data in the buffer */
+{
+    Four e;			/* error */
+    Object *obj;		/* the object in the fixed page */
+
+
+    /*@ parameter checking */
+    if (data == NULL) ERR(eBADUSERBUF_OM);
+
+    e = EduOM_ScanNext(cursor, oid, objHdr);
+    if (e < 0) ERR(e);
+    if (e == EOS) return(EOS);
+
+    obj = cursor->obj;
+    *data = obj->data;
+
+    return(eNOERROR);
+
+} /* EduOM_ScanNextView() */
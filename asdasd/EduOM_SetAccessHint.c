@@ -0,0 +1,143 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_SetAccessHint.c
+ *
+ * Description:
+ *  Access hints of the scans.
+ *  A scan declared sequential reads its pages as cold trains of the buffer
+ *  manager: they are recycled through a small ring of frames instead of
+ *  entering the replacement order, so a scan does not flush the pages of
+ *  the point reads. The hint is applied only with the in-tree buffer
+ *  manager (EduBfM_SetAccessHint()); with the stock one, a sequential hint
+ *  is refused with eNOTSUPPORTED_EDUOM.
+ *
+ * Exports:
+ *  Four EduOM_SetAccessHint(Four)
+ *  Four EduOM_SetScanHint(OM_ScanCursor*, Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+#pragma weak EduBfM_SetAccessHint
+Four EduBfM_SetAccessHint(Four);
+
+
+
+/*@================================
+ * EduOM_SetAccessHint()
+ *================================*/
+/*
+ * Function: Four EduOM_SetAccessHint(Four)
+ *
+ * Description:
+ *  Set the access hint of the calling thread for the following
+ *  EduOM_NextObject()/EduOM_PrevObject() calls and any other page access
+ *  of the thread. A scan with EduOM_NextObject() is bracketed by a call
+ *  with OM_HINT_SEQUENTIAL and a call with the returned previous hint.
+ *  Without the in-tree buffer manager, the hint is always OM_HINT_NORMAL.
+ *
+ * Returns:
+ *  the previous hint, or an error code
+ *    eBADPARAMETER_OM
+ *    eNOTSUPPORTED_EDUOM
+ */
+Four EduOM_SetAccessHint(
+    Four hint)			/* IN OM_HINT_NORMAL or OM_HINT_SEQUENTIAL */
+{
+    /*@ parameter checking */
+    if (hint != OM_HINT_NORMAL && hint != OM_HINT_SEQUENTIAL) ERR(eBADPARAMETER_OM);
+
+    if (EduBfM_SetAccessHint == NULL) {
+	if (hint != OM_HINT_NORMAL) ERR(eNOTSUPPORTED_EDUOM);
+	return(OM_HINT_NORMAL);
+    }
+
+    return(EduBfM_SetAccessHint(hint));
+
+} /* EduOM_SetAccessHint() */
+
+
+
+/*@================================
+ * EduOM_SetScanHint()
+ *================================*/
+/*
+ * Function: Four EduOM_SetScanHint(OM_ScanCursor*, Four)
+ *
+ * Description:
+ *  Set the access hint of the scan cursor. EduOM_ScanNext() fixes the
+ *  pages of the scan under this hint, whatever the hint of the thread.
+ *  A cursor is opened with OM_HINT_NORMAL, the only hint allowed without
+ *  the in-tree buffer manager.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eNOTSUPPORTED_EDUOM
+ */
+Four EduOM_SetScanHint(
+    OM_ScanCursor *cursor,	/* INOUT the scan cursor */
+    Four hint)			/* IN OM_HINT_NORMAL or OM_HINT_SEQUENTIAL */
+{
+    /*@ parameter checking */
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    if (hint != OM_HINT_NORMAL && hint != OM_HINT_SEQUENTIAL) ERR(eBADPARAMETER_OM);
+
+    if (hint != OM_HINT_NORMAL && EduBfM_SetAccessHint == NULL) ERR(eNOTSUPPORTED_EDUOM);
+
+    cursor->accessHint = hint;
+
+    return(eNOERROR);
+
+} /* EduOM_SetScanHint() */
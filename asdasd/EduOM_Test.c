@@ -56,6 +56,7 @@
  *  Four EduOM_Test(Four, Four)
  */
 #include <string.h>
+#include <ctype.h>
 #include "EduOM_common.h"
 #include "EduOM.h"
 #include "EduOM_Internal.h"
@@ -67,6 +68,11 @@ Four eduom_DumpOnePage(PageID *);
 Four eduom_DumpAllPage(PageID *);
 Four eduom_GetNextPageID(PageID *);
 char* itoa(Four val, Four base);
+Four eduom_CountObject(ObjectID *, Object *, void *);
+Four eduom_CountRemap(ObjectID *, ObjectID *, void *);
+Four SM_CreateFile(Four, FileID *, Boolean, void *);
+Four SM_DestroyFile(FileID *, void *);
+Four sm_GetCatalogEntryFromDataFileId(Four, FileID *, ObjectID *);
 
 
 /*@================================
@@ -103,6 +109,37 @@ Four EduOM_Test(Four volId, Four handle){
 	PageID		dumpPage;								/* dump page */
 	char		omTestObjectNo[32] = "EduOM_TestModule_OBJECT_NUM_";	/* test object */
 	char		buffer[32];							/* buffer for reading object */
+	OM_ScanCursor	cursor;								/* scan cursor */
+	ObjectID	scanOid;								/* object returned by the scan cursor */
+	Four		nObjects;								/* # of objects returned by the scan */
+	ObjectID	batchOids[32];							/* objects returned in bulk */
+	ObjectHdr	batchHdrs[32];							/* headers of the objects returned in bulk */
+	Four		nBatch;									/* # of objects returned in bulk */
+	Four		counts[2];								/* # of objects and bytes visited by the parallel scan */
+	Four		nBytes;									/* # of bytes of the objects */
+	ObjectHdr	objHdr;									/* header of an object */
+	OM_HdrPredicate	pred;								/* predicate of a filtered scan */
+	Four		nExpected;								/* # of objects expected */
+	Four		nRead;									/* # of bytes read */
+	char		scanBuffer[32];							/* buffer for the data returned by the scan */
+	char		*view;									/* data of an object in the buffer */
+	OM_ReorgCursor	reorg;								/* position of the reorganization */
+	Four		nRemaps;								/* # of objects moved by the reorganization */
+	Four		nCalls;									/* # of calls of the reorganization */
+	ObjectID	sparseOids[300];						/* objects of the sparse pages */
+	ObjectID	reorgOids[300];							/* objects destroyed during the reorganization */
+	ShortPageID	reorgPages[2];							/* pages emptied during the reorganization */
+	FileID		reorgFid;								/* file reorganized while objects are destroyed */
+	ObjectID	reorgCatalogEntry;						/* catalog object of 'reorgFid' */
+	Four		nPages;									/* # of pages emptied or released */
+	ObjectID	multiOids[201];							/* objects read at once */
+	char		multiData[201][32];						/* data of the objects read at once */
+	char		*multiBufs[201];						/* buffers of the objects read at once */
+	Four		multiResults[201];						/* outcome of each read */
+	OM_ObjectView	objView;							/* view of a pinned object */
+	OM_IOVec	iov[3];									/* segments of a vectored read or write */
+	OM_ObjectCacheStats	cacheStats;						/* statistics of the object cache */
+	Four		prevHint;								/* access hint before the sequential scan */
 
 	printf("Loading EduOM_Test() complete...\n");
 
@@ -467,7 +504,777 @@ Four EduOM_Test(Four volId, Four handle){
 	printf("\n\n");
 	printf("****************************** TEST#4, EduOM_NextObject. ******************************\n");
 
-	
+/* #5 Start the test for the scan cursor */
+	printf("****************************** TEST#5, EduOM_OpenScan, EduOM_ScanNext and EduOM_CloseScan. ******************************\n");
+	/* Test for EduOM_ScanNext() in the forward direction */
+	printf("*Test 5_1 : Test for EduOM_ScanNext() in the forward direction\n");
+	printf("->Scan all objects of the file and compare them with EduOM_NextObject()\n\n");
+	e = EduOM_OpenScan(&catalogEntry, FORWARD, &cursor);
+	if (e < eNOERROR) ERR(e);
+	e = EduOM_NextObject(&catalogEntry, NULL, &oid, NULL);
+	if (e < eNOERROR) ERR(e);
+	for (nObjects = 0; (e = EduOM_ScanNext(&cursor, &scanOid, NULL)) != EOS; nObjects++) {
+		if (e < eNOERROR) ERR(e);
+		if (scanOid.pageNo != oid.pageNo || scanOid.slotNo != oid.slotNo || scanOid.unique != oid.unique) {
+			printf("The object ( %d, %d ) is returned instead of ( %d, %d )\n", scanOid.pageNo, scanOid.slotNo, oid.pageNo, oid.slotNo);
+			break;
+		}
+		EduOM_NextObject(&catalogEntry, &oid, &oid, NULL);
+	}
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects are scanned\n", nObjects);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for EduOM_ScanNext() in the backward direction */
+	printf("*Test 5_2 : Test for EduOM_ScanNext() in the backward direction\n");
+	printf("->Scan all objects of the file and compare them with EduOM_PrevObject()\n\n");
+	e = EduOM_OpenScan(&catalogEntry, BACKWARD, &cursor);
+	if (e < eNOERROR) ERR(e);
+	e = EduOM_PrevObject(&catalogEntry, NULL, &oid, NULL);
+	if (e < eNOERROR) ERR(e);
+	for (nObjects = 0; (e = EduOM_ScanNext(&cursor, &scanOid, NULL)) != EOS; nObjects++) {
+		if (e < eNOERROR) ERR(e);
+		if (scanOid.pageNo != oid.pageNo || scanOid.slotNo != oid.slotNo || scanOid.unique != oid.unique) {
+			printf("The object ( %d, %d ) is returned instead of ( %d, %d )\n", scanOid.pageNo, scanOid.slotNo, oid.pageNo, oid.slotNo);
+			break;
+		}
+		EduOM_PrevObject(&catalogEntry, &oid, &oid, NULL);
+	}
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects are scanned\n", nObjects);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#5, EduOM_OpenScan, EduOM_ScanNext and EduOM_CloseScan. ******************************\n");
+/* #5 End the test */
+
+/* #6 Start the test for EduOM_NextObjects */
+	printf("****************************** TEST#6, EduOM_NextObjects. ******************************\n");
+	/* Test for EduOM_NextObjects() */
+	printf("*Test 6_1 : Test for EduOM_NextObjects()\n");
+	printf("->Get all objects of the file in batches of 32 objects\n\n");
+	printf("---------------------------------- Result ----------------------------------\n");
+	nObjects = 0;
+	e = EduOM_NextObjects(&catalogEntry, NULL, 32, batchOids, batchHdrs, &nBatch);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		printf("%d objects from ( %d, %d ) to ( %d, %d ) are returned\n", nBatch,
+			   batchOids[0].pageNo, batchOids[0].slotNo, batchOids[nBatch-1].pageNo, batchOids[nBatch-1].slotNo);
+		nObjects += nBatch;
+		oid = batchOids[nBatch-1];
+		e = EduOM_NextObjects(&catalogEntry, &oid, 32, batchOids, batchHdrs, &nBatch);
+	}
+	printf("%d objects are returned\n", nObjects);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#6, EduOM_NextObjects. ******************************\n");
+/* #6 End the test */
+
+/* #7 Start the test for EduOM_ParallelScan */
+	printf("****************************** TEST#7, EduOM_ParallelScan. ******************************\n");
+	/* Test for EduOM_ParallelScan() */
+	printf("*Test 7_1 : Test for EduOM_ParallelScan()\n");
+	printf("->Visit all objects of the file with 4 threads and compare them with EduOM_NextObject()\n\n");
+	nObjects = nBytes = 0;
+	e = EduOM_NextObject(&catalogEntry, NULL, &oid, &objHdr);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		nObjects++;
+		nBytes += objHdr.length;
+		e = EduOM_NextObject(&catalogEntry, &oid, &oid, &objHdr);
+	}
+	counts[0] = counts[1] = 0;
+	e = EduOM_ParallelScan(&catalogEntry, 4, eduom_CountObject, counts);
+	if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects of %d bytes are visited\n", counts[0], counts[1]);
+	if (counts[0] != nObjects || counts[1] != nBytes)
+		printf("%d objects of %d bytes are expected\n", nObjects, nBytes);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#7, EduOM_ParallelScan. ******************************\n");
+/* #7 End the test */
+
+/* #8 Start the test for the filtered scan */
+	printf("****************************** TEST#8, EduOM_OpenFilteredScan. ******************************\n");
+	/* Test for EduOM_OpenFilteredScan() with a length range */
+	printf("*Test 8_1 : Test for EduOM_OpenFilteredScan() with a length range\n");
+	printf("->Scan the objects of 30 bytes and compare them with EduOM_NextObject()\n\n");
+	pred.conditions = PRED_LENGTH;
+	pred.minLength = pred.maxLength = 30;
+	e = EduOM_OpenFilteredScan(&catalogEntry, FORWARD, &pred, &cursor);
+	if (e < eNOERROR) ERR(e);
+	nObjects = nExpected = 0;
+	e = EduOM_NextObject(&catalogEntry, NULL, &oid, &objHdr);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		if (objHdr.length == 30) {
+			nExpected++;
+			e = EduOM_ScanNext(&cursor, &scanOid, NULL);
+			if (e < eNOERROR) ERR(e);
+			if (e == EOS || scanOid.pageNo != oid.pageNo || scanOid.slotNo != oid.slotNo) {
+				printf("The object ( %d, %d ) is not returned\n", oid.pageNo, oid.slotNo);
+				break;
+			}
+			nObjects++;
+		}
+		e = EduOM_NextObject(&catalogEntry, &oid, &oid, &objHdr);
+	}
+	if (EduOM_ScanNext(&cursor, &scanOid, NULL) != EOS)
+		printf("The object ( %d, %d ) does not qualify\n", scanOid.pageNo, scanOid.slotNo);
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d of %d objects of 30 bytes are scanned\n", nObjects, nExpected);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for EduOM_OpenFilteredScan() with tags and properties */
+	printf("*Test 8_2 : Test for EduOM_OpenFilteredScan() with tags and properties\n");
+	printf("->Scan backward the small objects with tag 0 or 1\n\n");
+	pred.conditions = PRED_TAG | PRED_PROPERTIES;
+	pred.nTags = 2;
+	pred.tags[0] = 0;
+	pred.tags[1] = 1;
+	pred.propMask = P_LRGOBJ;
+	pred.propValue = 0;
+	e = EduOM_OpenFilteredScan(&catalogEntry, BACKWARD, &pred, &cursor);
+	if (e < eNOERROR) ERR(e);
+	for (nObjects = 0; (e = EduOM_ScanNext(&cursor, &scanOid, NULL)) != EOS; nObjects++)
+		if (e < eNOERROR) ERR(e);
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects are scanned\n", nObjects);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#8, EduOM_OpenFilteredScan. ******************************\n");
+/* #8 End the test */
+
+/* #9 Start the test for the zone map */
+	printf("****************************** TEST#9, EduOM_BuildZoneMap and EduOM_DropZoneMap. ******************************\n");
+	/* Test for a filtered scan which no page can satisfy */
+	printf("*Test 9_1 : Test for EduOM_BuildZoneMap() with a length range no page can satisfy\n");
+	printf("->Scan the objects of 1000 to 2000 bytes\n\n");
+	e = EduOM_BuildZoneMap(&catalogEntry);
+	if (e < eNOERROR) ERR(e);
+	pred.conditions = PRED_LENGTH;
+	pred.minLength = 1000;
+	pred.maxLength = 2000;
+	e = EduOM_OpenFilteredScan(&catalogEntry, FORWARD, &pred, &cursor);
+	if (e < eNOERROR) ERR(e);
+	for (nObjects = 0; (e = EduOM_ScanNext(&cursor, &scanOid, NULL)) != EOS; nObjects++)
+		if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects are scanned, %d pages are skipped\n", nObjects, cursor.nSkipped);
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for the maintenance of the zone map */
+	printf("*Test 9_2 : Test for the zone map after EduOM_CreateObject() and EduOM_DestroyObject()\n");
+	printf("->Insert an object with tag 7, scan the objects with tag 7, destroy it and scan again\n\n");
+	objHdr.properties = 0;
+	objHdr.tag = 7;
+	e = EduOM_CreateObject(&catalogEntry, NULL, &objHdr, 8, "TAGGED_7", &oid);
+	if (e < eNOERROR) ERR(e);
+	pred.conditions = PRED_TAG;
+	pred.nTags = 1;
+	pred.tags[0] = 7;
+	e = EduOM_OpenFilteredScan(&catalogEntry, FORWARD, &pred, &cursor);
+	if (e < eNOERROR) ERR(e);
+	for (nObjects = 0; (e = EduOM_ScanNext(&cursor, &scanOid, NULL)) != EOS; nObjects++)
+		if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects are scanned, %d pages are skipped\n", nObjects, cursor.nSkipped);
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+	e = EduOM_DestroyObject(&catalogEntry, &oid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	e = EduOM_OpenFilteredScan(&catalogEntry, FORWARD, &pred, &cursor);
+	if (e < eNOERROR) ERR(e);
+	for (nObjects = 0; (e = EduOM_ScanNext(&cursor, &scanOid, NULL)) != EOS; nObjects++)
+		if (e < eNOERROR) ERR(e);
+	printf("%d objects are scanned after the destroy\n", nObjects);
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+	e = EduOM_DropZoneMap(&catalogEntry);
+	if (e < eNOERROR) ERR(e);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#9, EduOM_BuildZoneMap and EduOM_DropZoneMap. ******************************\n");
+/* #9 End the test */
+
+/* #10 Start the test for the fused scan-and-read */
+	printf("****************************** TEST#10, EduOM_ScanNextRead and EduOM_ScanNextView. ******************************\n");
+	/* Test for EduOM_ScanNextRead() with a projection */
+	printf("*Test 10_1 : Test for EduOM_ScanNextRead() with a projection\n");
+	printf("->Read the bytes 17 to 26 of all objects and compare them with EduOM_ReadObject()\n\n");
+	e = EduOM_OpenScan(&catalogEntry, FORWARD, &cursor);
+	if (e < eNOERROR) ERR(e);
+	for (nObjects = 0; (e = EduOM_ScanNextRead(&cursor, 17, 10, &scanOid, NULL, scanBuffer, &nRead)) != EOS; nObjects++) {
+		if (e < eNOERROR) ERR(e);
+		e = EduOM_ReadObject(&scanOid, 17, 10, buffer);
+		if (e < eNOERROR) ERR(e);
+		if (e != nRead || memcmp(buffer, scanBuffer, nRead) != 0) {
+			printf("The data of the object ( %d, %d ) differ\n", scanOid.pageNo, scanOid.slotNo);
+			break;
+		}
+	}
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects are read\n", nObjects);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for EduOM_ScanNextView() */
+	printf("*Test 10_2 : Test for EduOM_ScanNextView()\n");
+	printf("->View all objects backward and compare them with EduOM_ReadObject()\n\n");
+	e = EduOM_OpenScan(&catalogEntry, BACKWARD, &cursor);
+	if (e < eNOERROR) ERR(e);
+	for (nObjects = 0; (e = EduOM_ScanNextView(&cursor, &scanOid, &objHdr, &view)) != EOS; nObjects++) {
+		if (e < eNOERROR) ERR(e);
+		e = EduOM_ReadObject(&scanOid, 0, REMAINDER, buffer);
+		if (e < eNOERROR) ERR(e);
+		if (e != objHdr.length || memcmp(buffer, view, e) != 0) {
+			printf("The data of the object ( %d, %d ) differ\n", scanOid.pageNo, scanOid.slotNo);
+			break;
+		}
+	}
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects are viewed\n", nObjects);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#10, EduOM_ScanNextRead and EduOM_ScanNextView. ******************************\n");
+/* #10 End the test */
+
+/* #11 Start the test for the file reorganization */
+	printf("****************************** TEST#11, EduOM_ReorganizeFile. ******************************\n");
+	/* Test for EduOM_ReorganizeFile() */
+	printf("*Test 11_1 : Test for EduOM_ReorganizeFile()\n");
+	printf("->Reorganize the file by 20 objects at a time and compare the objects with EduOM_NextObject()\n\n");
+	nObjects = nBytes = 0;
+	e = EduOM_NextObject(&catalogEntry, NULL, &oid, &objHdr);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		nObjects++;
+		nBytes += objHdr.length;
+		e = EduOM_NextObject(&catalogEntry, &oid, &oid, &objHdr);
+	}
+	INIT_REORG_CURSOR(&reorg);
+	nRemaps = nCalls = 0;
+	do {
+		e = EduOM_ReorganizeFile(&catalogEntry, &reorg, 20, eduom_CountRemap, &nRemaps, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+		nCalls++;
+	} while (e != EOS);
+	counts[0] = counts[1] = 0;
+	e = EduOM_NextObject(&catalogEntry, NULL, &oid, &objHdr);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		counts[0]++;
+		counts[1] += objHdr.length;
+		e = EduOM_NextObject(&catalogEntry, &oid, &oid, &objHdr);
+	}
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects of %d pages are moved in %d calls\n", nRemaps, reorg.nPages, nCalls);
+	printf("%d objects of %d bytes are in the file\n", counts[0], counts[1]);
+	if (nRemaps != reorg.nMoved || counts[0] != nObjects || counts[1] != nBytes)
+		printf("%d objects of %d bytes are expected\n", nObjects, nBytes);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for EduOM_ReorganizeFile() with objects destroyed between the calls */
+	printf("*Test 11_2 : Test for EduOM_ReorganizeFile() with objects destroyed between the calls\n");
+	printf("->Insert 400 objects into a new file, and empty the next page to reorganize and the last page of the file after the first call\n\n");
+	e = SM_CreateFile(volId, &reorgFid, FALSE, NULL);
+	if (e < eNOERROR) ERR(e);
+	e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &reorgFid, &reorgCatalogEntry);
+	if (e < eNOERROR) ERR(e);
+	nObjects = nBytes = 0;
+	for (i = 0; i < 400; i++) {
+		strcpy(omTestObjectNo, "EduOM_TestModule_OBJECT_NUM_");
+		strcat(omTestObjectNo, itoa(i, 10));
+		e = EduOM_CreateObject(&reorgCatalogEntry, (i == 0) ? NULL : &oid, NULL, strlen(omTestObjectNo), omTestObjectNo, &oid);
+		if (e < eNOERROR) ERR(e);
+		nObjects++;
+		nBytes += strlen(omTestObjectNo);
+	}
+	reorgPages[1] = oid.pageNo;
+	INIT_REORG_CURSOR(&reorg);
+	nRemaps = 0;
+	e = EduOM_ReorganizeFile(&reorgCatalogEntry, &reorg, 20, eduom_CountRemap, &nRemaps, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	reorgPages[0] = reorg.nextOldPage;
+	j = 0;
+	e = EduOM_NextObject(&reorgCatalogEntry, NULL, &oid, &objHdr);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		if ((oid.pageNo == reorgPages[0] || oid.pageNo == reorgPages[1]) && j < 300) {
+			reorgOids[j++] = oid;
+			nObjects--;
+			nBytes -= objHdr.length;
+		}
+		e = EduOM_NextObject(&reorgCatalogEntry, &oid, &oid, &objHdr);
+	}
+	for (i = 0; i < j; i++) {
+		e = EduOM_DestroyObject(&reorgCatalogEntry, &reorgOids[i], &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+	for (nCalls = 1; nCalls < 1000; nCalls++) {
+		e = EduOM_ReorganizeFile(&reorgCatalogEntry, &reorg, 20, eduom_CountRemap, &nRemaps, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+		if (e == EOS) break;
+	}
+	counts[0] = counts[1] = 0;
+	e = EduOM_NextObject(&reorgCatalogEntry, NULL, &oid, &objHdr);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		counts[0]++;
+		counts[1] += objHdr.length;
+		e = EduOM_NextObject(&reorgCatalogEntry, &oid, &oid, &objHdr);
+	}
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects are destroyed after the first call\n", j);
+	if (nCalls == 1000) printf("The reorganization does not end\n");
+	printf("%d objects of %d bytes are in the file\n", counts[0], counts[1]);
+	if (nRemaps != reorg.nMoved || counts[0] != nObjects || counts[1] != nBytes)
+		printf("%d objects of %d bytes are expected\n", nObjects, nBytes);
+	e = SM_DestroyFile(&reorgFid, NULL);
+	if (e < eNOERROR) ERR(e);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for EduOM_ReorganizeFile() with stubs left between the calls */
+	printf("*Test 11_3 : Test for EduOM_ReorganizeFile() with stubs left between the calls\n");
+	printf("->Insert 400 objects into a new file, destroy 9 of every 10 of the last 200, and merge the pages leaving stubs after the first call\n\n");
+	e = SM_CreateFile(volId, &reorgFid, FALSE, NULL);
+	if (e < eNOERROR) ERR(e);
+	e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &reorgFid, &reorgCatalogEntry);
+	if (e < eNOERROR) ERR(e);
+	nObjects = nBytes = 0;
+	for (i = 0; i < 400; i++) {
+		strcpy(omTestObjectNo, "EduOM_TestModule_OBJECT_NUM_");
+		strcat(omTestObjectNo, itoa(i, 10));
+		e = EduOM_CreateObject(&reorgCatalogEntry, (i == 0) ? NULL : &oid, NULL, strlen(omTestObjectNo), omTestObjectNo, &oid);
+		if (e < eNOERROR) ERR(e);
+		if (i >= 200) reorgOids[i - 200] = oid;
+		nObjects++;
+		nBytes += strlen(omTestObjectNo);
+	}
+	for (i = 0; i < 200; i++) {
+		if (i % 10 == 0) continue;
+		strcpy(omTestObjectNo, "EduOM_TestModule_OBJECT_NUM_");
+		strcat(omTestObjectNo, itoa(200 + i, 10));
+		e = EduOM_DestroyObject(&reorgCatalogEntry, &reorgOids[i], &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+		nObjects--;
+		nBytes -= strlen(omTestObjectNo);
+	}
+	INIT_REORG_CURSOR(&reorg);
+	nRemaps = 0;
+	e = EduOM_ReorganizeFile(&reorgCatalogEntry, &reorg, 20, eduom_CountRemap, &nRemaps, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	e = EduOM_VacuumFile(&reorgCatalogEntry, 50, NULL, NULL, &nPages, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	for (nCalls = 1; nCalls < 1000; nCalls++) {
+		e = EduOM_ReorganizeFile(&reorgCatalogEntry, &reorg, 20, eduom_CountRemap, &nRemaps, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+		if (e == EOS) break;
+	}
+	counts[0] = counts[1] = 0;
+	e = EduOM_NextObject(&reorgCatalogEntry, NULL, &oid, &objHdr);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		counts[0]++;
+		counts[1] += objHdr.length;
+		if (objHdr.properties & (P_MOVED | P_FORWARDED)) printf("The object ( %d, %d ) is flagged as moved\n", oid.pageNo, oid.slotNo);
+		e = EduOM_ReadObject(&oid, 0, REMAINDER, buffer);
+		if (e < eNOERROR) ERR(e);
+		if (e != objHdr.length || strncmp(buffer, "EduOM_TestModule_OBJECT_NUM_", 28) != 0)
+			printf("The data of the object ( %d, %d ) differ\n", oid.pageNo, oid.slotNo);
+		e = EduOM_NextObject(&reorgCatalogEntry, &oid, &oid, &objHdr);
+	}
+	j = nRemaps;
+	nRemaps = 0;
+	e = EduOM_CollapseForwarding(&reorgCatalogEntry, eduom_CountRemap, &nRemaps, NULL, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	if (nCalls == 1000) printf("The reorganization does not end\n");
+	printf("%d objects of %d bytes are in the file, %d stubs are left in the pages filled by the reorganization\n", counts[0], counts[1], nRemaps);
+	if (j != reorg.nMoved || counts[0] != nObjects || counts[1] != nBytes)
+		printf("%d objects of %d bytes are expected\n", nObjects, nBytes);
+	e = SM_DestroyFile(&reorgFid, NULL);
+	if (e < eNOERROR) ERR(e);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for EduOM_ReorganizeFile() leaving stubs */
+	printf("*Test 11_4 : Test for EduOM_ReorganizeFile() leaving stubs\n");
+	printf("->Insert 300 objects into a new file, reorganize it without a remap function, read the objects through their old object ID and collapse the stubs\n\n");
+	e = SM_CreateFile(volId, &reorgFid, FALSE, NULL);
+	if (e < eNOERROR) ERR(e);
+	e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &reorgFid, &reorgCatalogEntry);
+	if (e < eNOERROR) ERR(e);
+	for (i = 0; i < 300; i++) {
+		strcpy(omTestObjectNo, "EduOM_TestModule_OBJECT_NUM_");
+		strcat(omTestObjectNo, itoa(i, 10));
+		e = EduOM_CreateObject(&reorgCatalogEntry, (i == 0) ? NULL : &reorgOids[i - 1], NULL, strlen(omTestObjectNo), omTestObjectNo, &reorgOids[i]);
+		if (e < eNOERROR) ERR(e);
+	}
+	INIT_REORG_CURSOR(&reorg);
+	for (nCalls = 0; nCalls < 1000; nCalls++) {
+		e = EduOM_ReorganizeFile(&reorgCatalogEntry, &reorg, 20, NULL, NULL, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+		if (e == EOS) break;
+	}
+	for (j = 0, i = 0; i < 300; i++) {
+		strcpy(omTestObjectNo, "EduOM_TestModule_OBJECT_NUM_");
+		strcat(omTestObjectNo, itoa(i, 10));
+		e = EduOM_ReadObject(&reorgOids[i], 0, REMAINDER, buffer);
+		if (e < eNOERROR) ERR(e);
+		if (e == (Four)strlen(omTestObjectNo) && memcmp(buffer, omTestObjectNo, e) == 0) j++;
+	}
+	nObjects = 0;
+	e = EduOM_NextObject(&reorgCatalogEntry, NULL, &oid, NULL);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		nObjects++;
+		e = EduOM_NextObject(&reorgCatalogEntry, &oid, &oid, NULL);
+	}
+	nRemaps = 0;
+	e = EduOM_CollapseForwarding(&reorgCatalogEntry, eduom_CountRemap, &nRemaps, &nPages, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	if (nCalls == 1000) printf("The reorganization does not end\n");
+	printf("%d objects of %d pages are moved, %d objects are read through their old object ID, %d objects are in the file\n", reorg.nMoved, reorg.nPages, j, nObjects);
+	printf("%d stubs are collapsed, %d pages are released\n", nRemaps, nPages);
+	e = SM_DestroyFile(&reorgFid, NULL);
+	if (e < eNOERROR) ERR(e);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#11, EduOM_ReorganizeFile. ******************************\n");
+/* #11 End the test */
+
+/* #12 Start the test for the merge of underfilled pages */
+	printf("****************************** TEST#12, EduOM_VacuumFile and EduOM_CollapseForwarding. ******************************\n");
+	/* Test for EduOM_VacuumFile() leaving stubs */
+	printf("*Test 12_1 : Test for EduOM_VacuumFile() leaving stubs\n");
+	printf("->Insert 300 objects, destroy 9 of every 10, merge the pages filled less than 50%% and read the 30 others\n\n");
+	for (i = 0; i < 300; i++) {
+		strcpy(omTestObjectNo, "EduOM_TestModule_OBJECT_NUM_");
+		strcat(omTestObjectNo, itoa(1000 + i, 10));
+		e = EduOM_CreateObject(&catalogEntry, NULL, NULL, strlen(omTestObjectNo), omTestObjectNo, &sparseOids[i]);
+		if (e < eNOERROR) ERR(e);
+	}
+	for (i = 0; i < 300; i++) {
+		if (i % 10 == 0) continue;
+		e = EduOM_DestroyObject(&catalogEntry, &sparseOids[i], &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+	e = EduOM_VacuumFile(&catalogEntry, 50, NULL, NULL, &nPages, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	for (i = 0; i < 30; i++) {
+		strcpy(omTestObjectNo, "EduOM_TestModule_OBJECT_NUM_");
+		strcat(omTestObjectNo, itoa(1000 + i * 10, 10));
+		e = EduOM_ReadObject(&sparseOids[i * 10], 0, REMAINDER, buffer);
+		if (e < eNOERROR) ERR(e);
+		if (e != (Four)strlen(omTestObjectNo) || memcmp(buffer, omTestObjectNo, e) != 0) {
+			printf("The data of the object ( %d, %d ) differ\n", sparseOids[i * 10].pageNo, sparseOids[i * 10].slotNo);
+			break;
+		}
+	}
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d pages hold only stubs, %d objects are read through their old object ID\n", nPages, i);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for EduOM_CollapseForwarding() */
+	printf("*Test 12_2 : Test for EduOM_CollapseForwarding()\n");
+	printf("->Collapse the stubs and count the objects with EduOM_NextObject()\n\n");
+	nRemaps = 0;
+	e = EduOM_CollapseForwarding(&catalogEntry, eduom_CountRemap, &nRemaps, &nPages, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	nObjects = 0;
+	e = EduOM_NextObject(&catalogEntry, NULL, &oid, NULL);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		nObjects++;
+		e = EduOM_NextObject(&catalogEntry, &oid, &oid, NULL);
+	}
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d stubs are collapsed, %d pages are released, %d objects are in the file\n", nRemaps, nPages, nObjects);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for the scans of moved objects */
+	printf("*Test 12_3 : Test for the scans of moved objects\n");
+	printf("->Insert 300 objects, destroy 9 of every 10, merge the pages leaving stubs, destroy the 30 others through the object IDs returned by a scan and collapse the stubs\n\n");
+	for (i = 0; i < 300; i++) {
+		strcpy(omTestObjectNo, "EduOM_TestModule_OBJECT_NUM_");
+		strcat(omTestObjectNo, itoa(2000 + i, 10));
+		e = EduOM_CreateObject(&catalogEntry, NULL, NULL, strlen(omTestObjectNo), omTestObjectNo, &sparseOids[i]);
+		if (e < eNOERROR) ERR(e);
+	}
+	for (i = 0; i < 300; i++) {
+		if (i % 10 == 0) continue;
+		e = EduOM_DestroyObject(&catalogEntry, &sparseOids[i], &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+	e = EduOM_VacuumFile(&catalogEntry, 50, NULL, NULL, &nPages, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	for (counts[0] = counts[1] = 0, i = 0; i < 30; i++) {
+		e = EduOM_PinObject(&sparseOids[i * 10], &objView);
+		if (e < eNOERROR) ERR(e);
+		oid = objView.oid;
+		e = EduOM_UnpinObject(&objView);
+		if (e < eNOERROR) ERR(e);
+		if (oid.pageNo == sparseOids[i * 10].pageNo && oid.slotNo == sparseOids[i * 10].slotNo) continue;
+		counts[0]++;
+		e = EduOM_DestroyObject(&catalogEntry, &oid, &dlPool, &dlHead);
+		if (e == eBADOBJECTID_OM) counts[1]++;
+		else if (e < eNOERROR) ERR(e);
+	}
+	e = EduOM_OpenScan(&catalogEntry, FORWARD, &cursor);
+	if (e < eNOERROR) ERR(e);
+	for (nObjects = 0; (e = EduOM_ScanNextRead(&cursor, 0, REMAINDER, &scanOid, &objHdr, scanBuffer, &nRead)) != EOS; ) {
+		if (e < eNOERROR) ERR(e);
+		for (i = 0; i < 30; i++)
+			if (scanOid.pageNo == sparseOids[i * 10].pageNo && scanOid.slotNo == sparseOids[i * 10].slotNo) break;
+		if (i == 30) continue;
+		strcpy(omTestObjectNo, "EduOM_TestModule_OBJECT_NUM_");
+		strcat(omTestObjectNo, itoa(2000 + i * 10, 10));
+		if (objHdr.length != (Four)strlen(omTestObjectNo) || nRead != objHdr.length || memcmp(scanBuffer, omTestObjectNo, nRead) != 0) {
+			printf("The data of the object ( %d, %d ) differ\n", scanOid.pageNo, scanOid.slotNo);
+			continue;
+		}
+		reorgOids[nObjects++] = scanOid;
+	}
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+	for (i = 0; i < nObjects; i++) {
+		e = EduOM_DestroyObject(&catalogEntry, &reorgOids[i], &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+	nRemaps = 0;
+	e = EduOM_CollapseForwarding(&catalogEntry, eduom_CountRemap, &nRemaps, &nPages, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	for (j = 0, i = 0; i < 30; i++) {
+		e = EduOM_PinObject(&sparseOids[i * 10], &objView);
+		if (e == eBADOBJECTID_OM) continue;
+		if (e < eNOERROR) ERR(e);
+		e = EduOM_UnpinObject(&objView);
+		if (e < eNOERROR) ERR(e);
+		j++;
+	}
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects are moved, %d forwarded records are refused by EduOM_DestroyObject()\n", counts[0], counts[1]);
+	printf("%d objects are returned by the scan under their old object ID and destroyed, %d stubs are left, %d objects can still be read\n", nObjects, nRemaps, j);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#12, EduOM_VacuumFile and EduOM_CollapseForwarding. ******************************\n");
+/* #12 End the test */
+
+/* #13 Start the test for EduOM_ReadObjects */
+	printf("****************************** TEST#13, EduOM_ReadObjects. ******************************\n");
+	/* Test for EduOM_ReadObjects() */
+	printf("*Test 13_1 : Test for EduOM_ReadObjects()\n");
+	printf("->Read all objects at once in backward order with an invalid object ID, and compare them with EduOM_ReadObject()\n\n");
+	nObjects = 0;
+	e = EduOM_PrevObject(&catalogEntry, NULL, &oid, NULL);
+	while (e != EOS && nObjects < 200) {
+		if (e < eNOERROR) ERR(e);
+		multiOids[nObjects] = oid;
+		multiBufs[nObjects] = multiData[nObjects];
+		nObjects++;
+		e = EduOM_PrevObject(&catalogEntry, &oid, &oid, NULL);
+	}
+	multiOids[nObjects] = multiOids[0];
+	multiOids[nObjects].unique++;
+	multiBufs[nObjects] = multiData[nObjects];
+	e = EduOM_ReadObjects(nObjects + 1, multiOids, NULL, NULL, multiBufs, multiResults);
+	if (e < eNOERROR) ERR(e);
+	for (i = 0; i < nObjects; i++) {
+		e = EduOM_ReadObject(&multiOids[i], 0, REMAINDER, buffer);
+		if (e < eNOERROR) ERR(e);
+		if (e != multiResults[i] || memcmp(buffer, multiData[i], e) != 0) {
+			printf("The data of the object ( %d, %d ) differ\n", multiOids[i].pageNo, multiOids[i].slotNo);
+			break;
+		}
+	}
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects are read, the invalid object ID is %s\n", i,
+		   (multiResults[nObjects] == eBADOBJECTID_OM) ? "rejected" : "NOT rejected");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#13, EduOM_ReadObjects. ******************************\n");
+/* #13 End the test */
+
+/* #14 Start the test for the pinned object views */
+	printf("****************************** TEST#14, EduOM_PinObject and EduOM_UnpinObject. ******************************\n");
+	/* Test for EduOM_PinObject() and EduOM_UnpinObject() */
+	printf("*Test 14_1 : Test for EduOM_PinObject() and EduOM_UnpinObject()\n");
+	printf("->View all objects without copying them and compare them with EduOM_ReadObject()\n\n");
+	nObjects = 0;
+	e = EduOM_NextObject(&catalogEntry, NULL, &oid, NULL);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		e = EduOM_PinObject(&oid, &objView);
+		if (e < eNOERROR) ERR(e);
+		e = EduOM_ReadObject(&oid, 0, REMAINDER, buffer);
+		if (e < eNOERROR) ERR(e);
+		if (e != objView.length || memcmp(buffer, OM_VIEW_DATA(&objView), e) != 0) {
+			printf("The data of the object ( %d, %d ) differ\n", oid.pageNo, oid.slotNo);
+			EduOM_UnpinObject(&objView);
+			break;
+		}
+		e = EduOM_UnpinObject(&objView);
+		if (e < eNOERROR) ERR(e);
+		nObjects++;
+		e = EduOM_NextObject(&catalogEntry, &oid, &oid, NULL);
+	}
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d objects are viewed\n", nObjects);
+#ifndef NDEBUG
+	printf("releasing a view twice is %s\n", (EduOM_UnpinObject(&objView) == eBADPARAMETER_OM) ? "rejected" : "NOT rejected");
+#endif
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#14, EduOM_PinObject and EduOM_UnpinObject. ******************************\n");
+/* #14 End the test */
+
+/* #15 Start the test for the vectored reads and writes */
+	printf("****************************** TEST#15, EduOM_ReadObjectV and EduOM_WriteObjectV. ******************************\n");
+	/* Test for EduOM_WriteObjectV() and EduOM_ReadObjectV() */
+	printf("*Test 15_1 : Test for EduOM_WriteObjectV() and EduOM_ReadObjectV()\n");
+	printf("->Overwrite the bytes 0 to 3 and 10 to 11 of the first object, and read 3 fields of it at once\n\n");
+	e = EduOM_NextObject(&catalogEntry, NULL, &oid, NULL);
+	if (e < eNOERROR) ERR(e);
+	iov[0].start = 0;  iov[0].length = 4; iov[0].buf = "ABCD";
+	iov[1].start = 10; iov[1].length = 2; iov[1].buf = "XY";
+	e = EduOM_WriteObjectV(&oid, 2, iov);
+	if (e < eNOERROR) ERR(e);
+	iov[0].start = 0;  iov[0].length = 4;         iov[0].buf = &scanBuffer[0];
+	iov[1].start = 10; iov[1].length = 2;         iov[1].buf = &scanBuffer[4];
+	iov[2].start = 12; iov[2].length = REMAINDER; iov[2].buf = &scanBuffer[6];
+	nRead = EduOM_ReadObjectV(&oid, 3, iov);
+	if (nRead < eNOERROR) ERR(nRead);
+	e = EduOM_ReadObject(&oid, 0, REMAINDER, buffer);
+	if (e < eNOERROR) ERR(e);
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("The object ( %d, %d ) is %.*s\n", oid.pageNo, oid.slotNo, e, buffer);
+	printf("%d bytes are read in 3 fields: %.4s, %.2s, %.*s\n", nRead, &scanBuffer[0], &scanBuffer[4], iov[2].length, &scanBuffer[6]);
+	if (memcmp(buffer, "ABCD", 4) != 0 || memcmp(&buffer[10], "XY", 2) != 0 ||
+		nRead != e - 6 || memcmp(&scanBuffer[6], &buffer[12], iov[2].length) != 0)
+		printf("The fields differ from EduOM_ReadObject()\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#15, EduOM_ReadObjectV and EduOM_WriteObjectV. ******************************\n");
+/* #15 End the test */
+
+/* #16 Start the test for the object cache */
+	printf("****************************** TEST#16, EduOM_InitObjectCache. ******************************\n");
+	/* Test for the object cache */
+	printf("*Test 16_1 : Test for the object cache\n");
+	printf("->Scan all objects once, read the first object 5 times, update it and read it again\n\n");
+	e = EduOM_InitObjectCache(64 * 1024);
+	if (e < eNOERROR) ERR(e);
+	e = EduOM_NextObject(&catalogEntry, NULL, &oid, NULL);
+	while (e != EOS) {
+		if (e < eNOERROR) ERR(e);
+		e = EduOM_ReadObject(&oid, 0, REMAINDER, buffer);
+		if (e < eNOERROR) ERR(e);
+		e = EduOM_NextObject(&catalogEntry, &oid, &oid, NULL);
+	}
+	e = EduOM_NextObject(&catalogEntry, NULL, &oid, NULL);
+	if (e < eNOERROR) ERR(e);
+	for (i = 0; i < 5; i++) {
+		e = EduOM_ReadObject(&oid, 0, REMAINDER, buffer);
+		if (e < eNOERROR) ERR(e);
+	}
+	iov[0].start = 0; iov[0].length = 4; iov[0].buf = "WXYZ";
+	e = EduOM_WriteObjectV(&oid, 1, iov);
+	if (e < eNOERROR) ERR(e);
+	e = EduOM_ReadObject(&oid, 0, 4, buffer);
+	if (e < eNOERROR) ERR(e);
+	EduOM_GetObjectCacheStatistics(&cacheStats);
+	EduOM_FinalObjectCache();
+	printf("---------------------------------- Result ----------------------------------\n");
+	printf("%d reads, %d hits, %d objects admitted, %d invalidated\n",
+		   cacheStats.nLookups, cacheStats.nHits, cacheStats.nAdmits, cacheStats.nInvalidations);
+	printf("The object ( %d, %d ) begins with %.4s after the update\n", oid.pageNo, oid.slotNo, buffer);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#16, EduOM_InitObjectCache. ******************************\n");
+/* #16 End the test */
+
+/* #17 Start the test for the access hints */
+	printf("****************************** TEST#17, EduOM_SetAccessHint and EduOM_SetScanHint. ******************************\n");
+	/* Test for the sequential hint of the thread and of a scan cursor */
+	printf("*Test 17_1 : Test for EduOM_SetAccessHint() and EduOM_SetScanHint()\n");
+	printf("->Scan all objects under the sequential hint of the thread, then of a scan cursor\n\n");
+	prevHint = EduOM_SetAccessHint(OM_HINT_SEQUENTIAL);
+	if (prevHint == eNOTSUPPORTED_EDUOM) {
+		printf("---------------------------------- Result ----------------------------------\n");
+		printf("Skipped : the access hints require the in-tree buffer manager\n");
+	}
+	else {
+		if (prevHint < eNOERROR) ERR(prevHint);
+		e = EduOM_NextObject(&catalogEntry, NULL, &oid, NULL);
+		for (nObjects = 0; e != EOS; nObjects++) {
+			if (e < eNOERROR) ERR(e);
+			e = EduOM_NextObject(&catalogEntry, &oid, &oid, NULL);
+		}
+		e = EduOM_SetAccessHint(prevHint);
+		if (e < eNOERROR) ERR(e);
+		printf("---------------------------------- Result ----------------------------------\n");
+		printf("%d objects are scanned, the hint %s restored\n", nObjects,
+			   (prevHint == OM_HINT_NORMAL && e == OM_HINT_SEQUENTIAL) ? "is" : "is not");
+		e = EduOM_OpenScan(&catalogEntry, FORWARD, &cursor);
+		if (e < eNOERROR) ERR(e);
+		e = EduOM_SetScanHint(&cursor, OM_HINT_SEQUENTIAL);
+		if (e < eNOERROR) ERR(e);
+		for (nObjects = 0; (e = EduOM_ScanNext(&cursor, &scanOid, NULL)) != EOS; nObjects++)
+			if (e < eNOERROR) ERR(e);
+		e = EduOM_CloseScan(&cursor);
+		if (e < eNOERROR) ERR(e);
+		printf("%d objects are scanned by the cursor\n", nObjects);
+	}
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#17, EduOM_SetAccessHint and EduOM_SetScanHint. ******************************\n");
+/* #17 End the test */
+
 	/* Destroy File */
 	e = SM_DestroyFile(&fid, NULL);
 	if (e < eNOERROR) ERR(e); 
@@ -502,7 +1309,7 @@ Four eduom_DumpPage(
 	printf("|  nSlots = %-3d         free = %-4d          unused = %-4d   |\n",
 			apage->header.nSlots, apage->header.free, apage->header.unused);
 	printf("| FREE = %-4d           CFREE = %-4d                         |\n",
-			SP_FREE(apage), SP_CFREE(apage));
+			(Four)SP_FREE(apage), (Four)SP_CFREE(apage));
 	printf("+------------------------------------------------------------+\n");
 	printf("| fid = (%4d, %4d)                                         |\n",
 			apage->header.fid.volNo, apage->header.fid.serial);                 /* COOKIE17NOV1999 */
@@ -701,6 +1508,60 @@ Four eduom_GetNextPageID(
 	
 } /* eduom_GetNextPageID() */
 
+/*@================================
+ * eduom_CountObject()
+ *================================*/
+/*
+ * Function: Four eduom_CountObject(ObjectID*, Object*, void*)
+ *
+ * Description:
+ *  Callback of EduOM_ParallelScan() which counts the objects and their bytes.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four eduom_CountObject(
+		ObjectID *oid,		/* IN object visited */
+		Object *obj,		/* IN the object */
+		void *arg)			/* INOUT counters */
+{
+	(void)oid;
+
+	__sync_fetch_and_add(&((Four *)arg)[0], 1);
+	__sync_fetch_and_add(&((Four *)arg)[1], obj->header.length);
+
+	return(eNOERROR);
+
+} /* eduom_CountObject() */
+
+/*@================================
+ * eduom_CountRemap()
+ *================================*/
+/*
+ * Function: Four eduom_CountRemap(ObjectID*, ObjectID*, void*)
+ *
+ * Description:
+ *  Callback of EduOM_ReorganizeFile() which counts the moved objects.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four eduom_CountRemap(
+		ObjectID *oldOid,	/* IN object before the move */
+		ObjectID *newOid,	/* IN object after the move */
+		void *arg)			/* INOUT counter */
+{
+	(void)oldOid;
+	(void)newOid;
+
+	(*(Four *)arg)++;
+
+	return(eNOERROR);
+
+} /* eduom_CountRemap() */
+
 char* itoa(Four val, Four base){
 	static char buf[32] = {0};
 	int i = 30;
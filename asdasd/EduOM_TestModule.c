@@ -56,6 +56,7 @@
 
 #include <stdlib.h>
 #include "EduOM_common.h"
+#include "EduOM.h"
 #include "EduOM_Internal.h"
 #include "EduOM_TestModule.h"
 
@@ -153,6 +154,12 @@ Four main()
 		LRDS_Final();
 	}
 
+#ifndef NDEBUG
+	/* Report the object views which outlived the test */
+	if (eduom_numPinnedViews != 0)
+		printf("%d object views are not released!!!\n", eduom_numPinnedViews);
+#endif
+
 	/* Dismount volume */
 	e= LRDS_Dismount(volId);
 	if (e < eNOERROR){
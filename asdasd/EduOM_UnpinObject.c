@@ -0,0 +1,106 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_UnpinObject.c
+ *
+ * Description :
+ *  EduOM_UnpinObject() releases a view given by EduOM_PinObject().
+ *
+ * Exports:
+ *  Four EduOM_UnpinObject(OM_ObjectView*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_UnpinObject()
+ *================================*/
+/*
+ * Function: Four EduOM_UnpinObject(OM_ObjectView*)
+ *
+ * Description :
+ *  Unfix the page held by the view. In debug builds, releasing a view which
+ *  is not pinned (e.g. twice) is reported, and the view is poisoned so that
+ *  a use of its data after the release fails at once instead of reading a
+ *  buffer page which may hold another page by then.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_UnpinObject(
+    OM_ObjectView *view)	/* INOUT view to release */
+{
+    Four	e;		/* error code */
+
+
+    /*@ check parameters */
+    if (view == NULL) ERR(eBADPARAMETER_OM);
+
+#ifndef NDEBUG
+    if (view->magic != OM_VIEW_PINNED) ERR(eBADPARAMETER_OM);
+
+    view->magic = 0;
+    view->data = NULL;
+    view->length = -1;
+    __sync_fetch_and_sub(&eduom_numPinnedViews, 1);
+#endif
+
+    e = BfM_FreeTrain(&view->pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_UnpinObject() */
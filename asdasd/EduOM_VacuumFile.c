@@ -0,0 +1,295 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_VacuumFile.c
+ *
+ * Description:
+ *  Merge the objects of underfilled pages into other pages of a data file.
+ *
+ * Export:
+ *  Four EduOM_VacuumFile(ObjectID*, Four, OM_RemapCallback, void*, Four*, Pool*, DeallocListElem*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "Util.h"		/* to get Pool */
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+/* percentage of the data area of the page used by the objects */
+#define VACUUM_FILL(p)	((Four)(((PAGESIZE - SP_FIXED) - SP_FREE(p)) * 100 / (PAGESIZE - SP_FIXED)))
+
+
+static Four eduom_ReleaseTarget(ObjectID*, PageID*, SlottedPage*);
+
+
+
+/*@================================
+ * EduOM_VacuumFile()
+ *================================*/
+/*
+ * Function: Four EduOM_VacuumFile(ObjectID*, Four, OM_RemapCallback, void*, Four*, Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Move the objects of the pages filled less than 'fillFactor' percent into
+ *  the free space of other pages of the same file. The page list is walked
+ *  from both ends: the objects of the underfilled pages at the end of the
+ *  list are moved into the pages at the front until the two walks meet, so
+ *  that the objects are packed into as few pages as possible.
+ *
+ *  If 'remap' is given, a moved object gets a new object ID, which is told
+ *  to 'remap' before the old object is destroyed; the emptied pages are
+ *  released at once.
+ *
+ *  If 'remap' is NULL, the object IDs stay valid: a moved object leaves a
+ *  stub (P_MOVED) holding the ID of the forwarded record (P_FORWARDED), and
+ *  EduOM_ReadObject() and EduOM_DestroyObject() follow the stub. The pages
+ *  holding only stubs are released when the stubs are collapsed with
+ *  EduOM_CollapseForwarding(). An object too small to be replaced by a stub
+ *  is not moved. The scans return a moved object under the ID of its stub
+ *  and skip the forwarded record, whose ID is refused by
+ *  EduOM_DestroyObject() and EduOM_WriteObjectV().
+ *
+ *  The stubs and the forwarded records themselves are never moved.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    the negative value returned by 'remap'
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  *nPages is set to the number of pages released if 'remap' is given, or
+ *  to the number of pages left holding only stubs otherwise.
+ */
+Four EduOM_VacuumFile(
+    ObjectID *catObjForFile,	/* IN informations about a data file */
+    Four fillFactor,		/* IN pages filled less than this percentage are merged */
+    OM_RemapCallback remap,	/* IN function told about the moved objects, NULL to leave stubs */
+    void *arg,			/* IN argument of 'remap' */
+    Four *nPages,		/* OUT # of pages emptied */
+    Pool *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four e;			/* error */
+    Two  i;			/* slot number */
+    Boolean empty;		/* TRUE if no data is left in the source page */
+    PageID srcPid;		/* page whose objects are moved */
+    PageID dstPid;		/* page receiving the moved objects */
+    PageNo prevPage;		/* page before 'srcPid' in the page list */
+    PageNo nextPage;		/* page after 'dstPid' in the page list */
+    SlottedPage *srcPage;	/* buffer holding 'srcPid' */
+    SlottedPage *dstPage;	/* buffer holding 'dstPid', NULL if not fixed */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+    Object *obj;		/* object to move */
+    ObjectHdr objHdr;		/* header of the forwarded record */
+    Four objSpace;		/* space of the object in the source page */
+    ObjectID oldOid;		/* ID of the object to move */
+    ObjectID newOid;		/* ID of the moved object */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (fillFactor <= 0 || fillFactor > 100 || nPages == NULL) ERR(eBADPARAMETER_OM);
+
+    *nPages = 0;
+
+    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+    MAKE_PAGEID(dstPid, catEntry->fid.volNo, catEntry->firstPage);
+    MAKE_PAGEID(srcPid, catEntry->fid.volNo, catEntry->lastPage);
+
+    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    /*@ walk the page list backward for the underfilled pages */
+    dstPage = NULL;
+    while (srcPid.pageNo != dstPid.pageNo) {
+	e = BfM_GetTrain(&srcPid, (char **)&srcPage, PAGE_BUF);
+	if (e < 0) goto fail;
+	prevPage = srcPage->header.prevPage;
+
+	if (VACUUM_FILL(srcPage) >= fillFactor) {
+	    e = BfM_FreeTrain(&srcPid, PAGE_BUF);
+	    if (e < 0) goto fail;
+	    srcPid.pageNo = prevPage;
+	    continue;
+	}
+
+	/* the stubs change the free space of the page */
+	if (remap == NULL) {
+	    e = om_RemoveFromAvailSpaceList(catObjForFile, &srcPid, srcPage);
+	    if (e < 0) goto failSrc;
+	}
+
+	for (i = 0; i < srcPage->header.nSlots && srcPid.pageNo != dstPid.pageNo; i++) {
+	    if (srcPage->slot[-i].offset == EMPTYSLOT) continue;
+	    obj = (Object *)&(srcPage->data[srcPage->slot[-i].offset]);
+	    if (obj->header.properties & (P_MOVED | P_FORWARDED)) continue;
+
+	    objSpace = OM_OBJECT_SPACE(obj->header.length);
+	    if (remap == NULL && objSpace < (Four)OM_OBJECT_SPACE(OM_STUB_LENGTH)) continue;
+
+	    /* walk the page list forward for a page with enough space */
+	    while (dstPage == NULL || SP_FREE(dstPage) < OM_NEEDED_SPACE(obj->header.length)) {
+		if (dstPage != NULL) {
+		    nextPage = dstPage->header.nextPage;
+		    e = eduom_ReleaseTarget(catObjForFile, &dstPid, dstPage);
+		    dstPage = NULL;
+		    if (e < 0) goto failSrc;
+		    dstPid.pageNo = nextPage;
+		    if (dstPid.pageNo == srcPid.pageNo) break;
+		}
+		e = BfM_GetTrain(&dstPid, (char **)&dstPage, PAGE_BUF);
+		if (e < 0) { dstPage = NULL; goto failSrc; }
+		e = om_RemoveFromAvailSpaceList(catObjForFile, &dstPid, dstPage);
+		if (e < 0) goto failSrc;
+	    }
+	    if (dstPage == NULL) break;
+
+	    objHdr = obj->header;
+	    if (remap == NULL) objHdr.properties |= P_FORWARDED;
+
+	    e = eduom_PlaceObject(catObjForFile, &dstPid, dstPage, &objHdr, obj->header.length, obj->data, &newOid);
+	    if (e < 0) goto failSrc;
+
+	    MAKE_OBJECTID(oldOid, srcPid.volNo, srcPid.pageNo, i, srcPage->slot[-i].unique);
+	    if (remap != NULL) {
+		e = remap(&oldOid, &newOid, arg);
+		if (e < 0) goto failSrc;
+
+		e = EduOM_DestroyObject(catObjForFile, &oldOid, dlPool, dlHead);
+		if (e < 0) goto failSrc;
+	    }
+	    else {
+		/* replace the object by a stub */
+		obj->header.properties |= P_MOVED;
+		obj->header.length = OM_STUB_LENGTH;
+		memcpy(obj->data, (char *)&newOid, OM_STUB_LENGTH);
+		srcPage->header.unused += objSpace - OM_OBJECT_SPACE(OM_STUB_LENGTH);
+
+		e = BfM_SetDirty(&srcPid, PAGE_BUF);
+		if (e < 0) goto failSrc;
+	    }
+	}
+
+	/* count the page if nothing but stubs is left */
+	for (i = 0; i < srcPage->header.nSlots; i++)
+	    if (OM_IS_DATA_SLOT(srcPage, i)) break;
+	empty = (i == srcPage->header.nSlots) ? TRUE : FALSE;
+	if (empty) (*nPages)++;
+
+	if (remap == NULL) {
+	    e = om_PutInAvailSpaceList(catObjForFile, &srcPid, srcPage);
+	    if (e < 0) goto failSrc;
+	}
+
+	e = BfM_FreeTrain(&srcPid, PAGE_BUF);
+	if (e < 0) goto fail;
+
+	if (srcPid.pageNo != dstPid.pageNo) srcPid.pageNo = prevPage;
+    }
+
+    if (dstPage != NULL) {
+	e = eduom_ReleaseTarget(catObjForFile, &dstPid, dstPage);
+	if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+failSrc:
+    if (remap == NULL) om_PutInAvailSpaceList(catObjForFile, &srcPid, srcPage);
+    BfM_FreeTrain(&srcPid, PAGE_BUF);
+fail:
+    if (dstPage != NULL) eduom_ReleaseTarget(catObjForFile, &dstPid, dstPage);
+    ERR(e);
+
+} /* EduOM_VacuumFile() */
+
+
+
+/*@================================
+ * eduom_ReleaseTarget()
+ *================================*/
+/*
+ * Function: static Four eduom_ReleaseTarget(ObjectID*, PageID*, SlottedPage*)
+ *
+ * Description:
+ *  Put the page which has received moved objects back into the available
+ *  space list and unfix it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_ReleaseTarget(
+    ObjectID *catObjForFile,	/* IN informations about a data file */
+    PageID *pid,		/* IN the page */
+    SlottedPage *apage)		/* IN buffer holding the page */
+{
+    Four e;			/* error */
+
+
+    e = om_PutInAvailSpaceList(catObjForFile, pid, apage);
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+
+    e = BfM_FreeTrain(pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_ReleaseTarget() */
@@ -0,0 +1,151 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_WriteObjectV.c
+ *
+ * Description :
+ *  EduOM_WriteObjectV() overwrites several byte ranges of an object in place.
+ *
+ * Exports:
+ *  Four EduOM_WriteObjectV(ObjectID*, Four, OM_IOVec*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * EduOM_WriteObjectV()
+ *================================*/
+/*
+ * Function: Four EduOM_WriteObjectV(ObjectID*, Four, OM_IOVec*)
+ *
+ * Description :
+ *  Overwrite the 'n' byte ranges given by 'iov' of the object 'oid' with the
+ *  contents of their buffers, with one page fix and one validation of the
+ *  object ID. The object neither grows nor shrinks: every segment must lie
+ *  within the object, which is checked for all segments before anything is
+ *  written. The segments are written in order, so a later one wins where
+ *  they overlap. A moved object is written through the ID of its stub; the
+ *  ID of its forwarded record is refused.
+ *
+ * Returns:
+ *  1) total number of bytes written (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADOBJECTID_OM
+ *    eBADPARAMETER_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eBADSTART_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_WriteObjectV(
+    ObjectID	*oid,		/* IN object to update */
+    Four	n,		/* IN # of segments */
+    OM_IOVec	*iov)		/* IN segments to write */
+{
+    Four	e;		/* error code */
+    Four	i;		/* index */
+    Four	total;		/* # of bytes written */
+    OM_ObjectView view;		/* the object in the buffer */
+    Object	*obj;		/* the object viewed */
+
+
+    /*@ check parameters */
+    if (n < 0 || (n > 0 && iov == NULL)) ERR(eBADPARAMETER_OM);
+
+    for (i = 0; i < n; i++) {
+	if (iov[i].length < 0) ERR(eBADLENGTH_OM);
+	if (iov[i].buf == NULL) ERR(eBADUSERBUF_OM);
+    }
+
+    e = EduOM_PinObject(oid, &view);
+    if (e < 0) ERR(e);
+
+    obj = (Object *)(OM_VIEW_DATA(&view) - sizeof(ObjectHdr));
+    if ((obj->header.properties & P_FORWARDED) &&
+	view.oid.volNo == oid->volNo && view.oid.pageNo == oid->pageNo && view.oid.slotNo == oid->slotNo) {
+	EduOM_UnpinObject(&view);
+	ERR(eBADOBJECTID_OM);
+    }
+
+    for (i = 0; i < n; i++) {
+	e = (iov[i].start < 0 || iov[i].start >= view.length) ? eBADSTART_OM :
+	    (iov[i].start + iov[i].length > view.length) ? eBADLENGTH_OM : eNOERROR;
+	if (e < 0) {
+	    EduOM_UnpinObject(&view);
+	    ERR(e);
+	}
+    }
+
+    /*@ update the object in the buffer */
+    eduom_ObjectCacheInvalidate(oid);
+    eduom_ObjectCacheInvalidate(&view.oid);
+    for (total = 0, i = 0; i < n; i++) {
+	memcpy((char *)OM_VIEW_DATA(&view) + iov[i].start, iov[i].buf, iov[i].length);
+	total += iov[i].length;
+    }
+
+    e = BfM_SetDirty(&view.pid, PAGE_BUF);
+    if (e < 0) {
+	EduOM_UnpinObject(&view);
+	ERR(e);
+    }
+
+    e = EduOM_UnpinObject(&view);
+    if (e < 0) ERR(e);
+
+    return(total);
+
+} /* EduOM_WriteObjectV() */
@@ -62,6 +62,8 @@ Four BfM_FreeTrain(TrainID *, Four);
 Four BfM_GetTrain(TrainID *, char **, Four);
 Four BfM_GetNewTrain(TrainID *, char **, Four);
 Four BfM_SetDirty(TrainID *, Four);
+Four BfM_FlushAll(void);
+Four BfM_DiscardAll(void);
 
 
 #endif /* _BFM_H_ */
@@ -0,0 +1,81 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+#ifndef _EDUBFM_H_
+#define _EDUBFM_H_
+
+
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * Function Prototypes
+ */
+/* Interface Function Prototypes */
+Four BfM_Init(void);
+Four BfM_Final(void);
+Four BfM_GetTrain(TrainID*, char**, Four);
+Four BfM_GetNewTrain(TrainID*, char**, Four);
+Four BfM_FreeTrain(TrainID*, Four);
+Four BfM_SetDirty(TrainID*, Four);
+Four BfM_FlushAll(void);
+Four BfM_DiscardAll(void);
+Four BfM_DiscardAllTrainsInVolume(Four);
+Four BfM_Dismount(Four);
+Four BfM_RemoveTrain(TrainID*, Four, Boolean);
+Four BfM_readTrain(TrainID*, char*, Four);
+Four EduBfM_SetParameters(BfM_Parameters*);
+Four EduBfM_GetParameters(BfM_Parameters*);
+Four EduBfM_GetStatistics(BfM_Statistics*);
+Four EduBfM_SetAccessHint(Four);
+Four EduBfM_SetCompression(Four, char*);
+Four EduBfM_GetCompressionStatistics(Four, BfM_CompressionStatistics*);
+
+
+#endif /* _EDUBFM_H_ */
@@ -0,0 +1,548 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+#ifndef _EDUBFM_INTERNAL_H_
+#define _EDUBFM_INTERNAL_H_
+
+#include <pthread.h>
+#include <sys/uio.h>
+#include "BfM.h"
+
+
+/*@
+ * Constant Definitions
+ */
+#define NUM_BUF_TYPES           2       /* PAGE_BUF and LOT_LEAF_BUF */
+
+/* train sizes (in pages) of the buffer types */
+#define PAGE_BUF_TRAIN_SIZE     1
+#define LOT_LEAF_BUF_TRAIN_SIZE 4
+
+/* replacement policies */
+#define BFM_CLOCK               0       /* second chance given by the reference bit */
+#define BFM_2Q                  1       /* FIFO probation queue, LRU main queue and ghost queue */
+#define BFM_LRUK                2       /* victim is the frame with the oldest K-th last reference */
+
+/* backings of the frames of a buffer pool */
+#define BFM_HUGEPAGE_NONE       0       /* base pages */
+#define BFM_HUGEPAGE_TRANSPARENT 1      /* transparent huge pages requested with madvise() */
+#define BFM_HUGEPAGE_EXPLICIT   2       /* huge pages of the hugetlb pool, else transparent ones */
+#define BFM_HUGEPAGE_SIZE       (2 * 1024 * 1024)
+
+#define BFM_MAX_FDS             1024    /* descriptors tracked by the direct I/O of the volumes */
+#define BFM_MAX_MAPPINGS        16      /* volumes mapped at a time by the mmap read path */
+
+/*
+ * Build-time defaults of the parameters of the buffer manager.
+ * They may be given on the compiler command line (see BFMFLAGS in the
+ * Makefile) and changed at run time with EduBfM_SetParameters().
+ */
+#ifndef BFM_POLICY
+#define BFM_POLICY              BFM_CLOCK
+#endif
+#ifndef BFM_NUM_PAGE_BUFS
+#define BFM_NUM_PAGE_BUFS       3000    /* as many as the stock buffer manager */
+#endif
+#ifndef BFM_NUM_LOT_LEAF_BUFS
+#define BFM_NUM_LOT_LEAF_BUFS   4000    /* as many as the stock buffer manager */
+#endif
+#ifndef BFM_NUM_PARTITIONS
+#define BFM_NUM_PARTITIONS      8
+#endif
+#ifndef BFM_HUGE_PAGES
+#define BFM_HUGE_PAGES          BFM_HUGEPAGE_NONE /* huge pages gave no measurable gain in 'hugepages' */
+#endif
+#ifndef BFM_DIRECT_IO
+#define BFM_DIRECT_IO           FALSE
+#endif
+#ifndef BFM_CLEAN_TARGET
+#define BFM_CLEAN_TARGET        0       /* no background writer */
+#endif
+#ifndef BFM_WRITE_RATE
+#define BFM_WRITE_RATE          0       /* no limit */
+#endif
+#ifndef BFM_MMAP_READS
+#define BFM_MMAP_READS          FALSE
+#endif
+#ifndef BFM_ASYNC_WRITES
+#define BFM_ASYNC_WRITES        FALSE
+#endif
+
+#define BFM_MAX_PARTITIONS      64
+#define BFM_MIN_PARTITION_BUFS  16      /* minimum # of frames of a partition */
+
+/* replacement parameters */
+#define BFM_LRUK_K              2       /* K of LRU-K */
+#define BFM_LRUK_CRP            4       /* correlated reference period, in ticks of the partition's clock */
+#define BFM_2Q_KIN_PERCENT      25      /* share of the frames of a partition in the probation queue */
+#define BFM_2Q_KOUT_PERCENT     50      /* ghosts remembered (also by LRU-K), in percent of the frames of a partition */
+
+/* write-back parameters */
+#define BFM_MAX_RUN             32      /* maximum # of adjacent trains written with one call */
+#define BFM_WRITER_INTERVAL     10      /* milliseconds between two passes of the background writer */
+#define BFM_ASYNC_DEPTH         128     /* trains being written at once by the asynchronous writes */
+#define BFM_MAX_LOCATIONS       8       /* volumes located for the asynchronous writes */
+#define BFM_MAX_DEVICES         20      /* devices of a volume located for the asynchronous writes */
+#define BFM_MAX_STREAMS         32      /* devices whose runs are queued in turn by the asynchronous writes */
+
+/* compressed page stores */
+#define BFM_MAX_STORES          8       /* volumes with a compressed page store at a time */
+#define BFM_STORE_NAME_SIZE     256     /* size of the file name of a store */
+#define BFM_STORE_MIN_SAVING    (PAGESIZE / 8)  /* bytes a page must save to be stored compressed */
+#define BFM_LZ_MAX_INPUT        65535   /* longest input of edubfm_LZCompress() */
+#define BFM_STORE_MAGIC         "EduBfMZ1"
+
+/* 2Q queues */
+#define BFM_NOQUEUE             -1
+#define BFM_A1IN                0       /* trains referenced once, in FIFO order */
+#define BFM_AM                  1       /* trains referenced again after their probation, in LRU order */
+#define BFM_NUM_QUEUES          2
+
+/* access hints of a thread (see EduBfM_SetAccessHint()) */
+#define BFM_HINT_NORMAL         0       /* trains fixed are entered into the replacement state */
+#define BFM_HINT_SEQUENTIAL     1       /* trains loaded are cold and recycled through the scan ring */
+#define BFM_SCAN_RING           8       /* frames of the scan ring of a partition */
+
+/* states of a slot of the mmap read path */
+#define BFM_MAP_UNUSED          0       /* free slot */
+#define BFM_MAP_MAPPED          1       /* the pages of the volume are served from its mapping */
+#define BFM_MAP_REFUSED         2       /* the volume cannot be mapped, its pages are buffered */
+
+/* value of 'fixed' of a frame being given a train under the partition mutex */
+#define BFM_CLAIMED             -1
+
+/* bits of a buffer table entry */
+#define BFM_DIRTY               0x01    /* the train has been modified */
+#define BFM_VALID               0x02    /* the frame holds a train */
+#define BFM_REFER               0x04    /* the train has been referenced, for CLOCK */
+#define BFM_NEW                 0x08    /* the train has been allocated by BfM_GetNewTrain() */
+#define BFM_COLD                0x10    /* the train has been loaded and only fixed under BFM_HINT_SEQUENTIAL */
+
+/*
+ * Recovery hooks
+ * While a transaction may be rolled back, trains are read through the
+ * recovery manager and written to it, as the stock buffer manager does,
+ * except for new trains, trains of temporary volumes and pages flagged to
+ * be written in place.
+ */
+#define BFM_TMP_VOLUME_BIT      0x4000  /* set in the volume numbers of temporary volumes */
+#define BFM_WRITE_IN_PLACE      0x10    /* page flag: never saved in the log volume */
+#define RM_NOT_IN_LOG           1       /* returned by RM_LoadTrain() for trains not in the log */
+#define BFM_NOT_MAPPED          1       /* returned by the edubfm_*Mapped() functions for trains of the buffer pool */
+#define BFM_NOT_STORED          1       /* returned by the edubfm_*Stored() functions when the caller does the I/O with RDsM */
+
+
+/*@
+ * Type Definitions
+ */
+
+/*
+ * Typedef for the parameters of the buffer manager
+ */
+typedef struct {
+	Four nBufs[NUM_BUF_TYPES];  /* # of frames of each buffer type */
+	Four nPartitions;           /* # of partitions of each buffer pool */
+	Four policy;                /* BFM_CLOCK, BFM_2Q or BFM_LRUK */
+	Four hugePages;             /* backing requested for the frames, BFM_HUGEPAGE_* */
+	Four directIO;              /* TRUE to bypass the page cache of the OS with O_DIRECT */
+	Four cleanTarget;           /* clean frames kept in each pool by the background writer, 0 for no writer */
+	Four writeRate;             /* trains written per second by the background writer, 0 for no limit */
+	Four mmapReads;             /* TRUE to serve the trains of PAGE_BUF from mappings of the volumes */
+	Four asyncWrites;           /* TRUE to write out the dirty trains through the asynchronous I/O engine */
+} BfM_Parameters;
+
+/*
+ * Typedef for the statistics of the buffer manager
+ */
+typedef struct {
+	Four nFixes;                /* # of BfM_GetTrain()/BfM_GetNewTrain() calls */
+	Four nHits;                 /* # of fixes of trains found in the buffer */
+	Four nReads;                /* # of trains read from the disk */
+	Four nWrites;               /* # of trains written to the disk */
+	Four nEvictions;            /* # of trains evicted to make room for others */
+	Four hugePages;             /* backing obtained for the frames of PAGE_BUF, BFM_HUGEPAGE_* */
+	Four nDirectIOs;            /* # of volume transfers done with O_DIRECT, since the start */
+	Four nBufferedIOs;          /* # of unaligned transfers of volumes with O_DIRECT, since the start */
+	Four nBgWrites;             /* # of trains written by the background writer */
+	Four nRuns;                 /* # of runs of adjacent trains written with one call */
+	Four nMappedFixes;          /* # of fixes served from the mappings of the volumes */
+	Four nMappedWrites;         /* # of trains of the mappings written to the disk */
+	Four nAsyncWrites;          /* # of trains written through the asynchronous I/O engine */
+} BfM_Statistics;
+
+/*
+ * Typedef for the statistics of the compressed page store of a volume
+ */
+typedef struct {
+	Four nPages;                /* # of pages of the volume */
+	Four nStoredPages;          /* # of pages whose compressed image is in the store */
+	long long nStoredBytes;     /* # of bytes of their images */
+	long long storeSize;        /* size of the store, with the images replaced since its last compaction */
+	Four nReads;                /* # of pages read from the store */
+	Four nWrites;               /* # of pages written to the store */
+	Four nHomeWrites;           /* # of pages written to their home in the devices of the volume */
+} BfM_CompressionStatistics;
+
+/*
+ * Typedef for a buffer table entry, describing one frame
+ */
+typedef struct {
+	TrainID key;                /* train held by the frame, key.pageNo is NIL if the frame is free */
+	Two     fixed;              /* # of fixes or BFM_CLAIMED, updated atomically */
+	One     bits;               /* BFM_DIRTY, BFM_VALID, BFM_REFER and BFM_NEW, updated atomically */
+	One     queue;              /* 2Q queue holding the frame, BFM_NOQUEUE if none */
+	Four    nextHashEntry;      /* next frame of the hash chain or of the free list */
+	Four    prev;               /* neighbour towards the head of the 2Q queue */
+	Four    next;               /* neighbour towards the tail of the 2Q queue */
+	UFour   hist[BFM_LRUK_K];   /* times of the last K uncorrelated references, 0 if none */
+} BufferTable;
+
+/*
+ * Typedef for a ghost, the key of an evicted train: under 2Q a train
+ * evicted from A1in, under LRU-K any evicted train with its history
+ */
+typedef struct {
+	TrainID key;                /* evicted train, key.pageNo is NIL if unused */
+	Four    nextHashEntry;      /* next ghost of the hash chain */
+	UFour   hist[BFM_LRUK_K];   /* history of the train under LRU-K */
+} BufferGhost;
+
+/*
+ * Typedef for the state of a page of a mapped volume
+ */
+typedef struct {
+	Two     fixed;              /* # of fixes, updated atomically */
+	One     bits;               /* BFM_DIRTY, BFM_NEW, and BFM_VALID once loaded, updated atomically */
+} BufferMapped;
+
+/*
+ * Typedef for a volume mapped by the mmap read path
+ * The device of the volume is mapped privately: a page modified in the
+ * mapping becomes a copy of the process, which stays off the disk until
+ * it is written back through RDsM.
+ */
+typedef struct {
+	Four    state;              /* BFM_MAP_UNUSED, BFM_MAP_MAPPED or BFM_MAP_REFUSED */
+	Four    volNo;              /* volume of the slot */
+	char    *base;              /* page 0 of the volume */
+	char    *mapBase;           /* mapping of the device */
+	size_t  mapSize;            /* size of the mapping */
+	Four    nPages;             /* # of pages of the volume in the mapping */
+	BufferMapped *pages;        /* state of each page */
+} BufferMapping;
+
+/*
+ * Typedef for a volume located for the asynchronous writes: page p of
+ * the device d of the volume is at offset (p - firstPage[d]) * PAGESIZE
+ * of the descriptor fd[d]
+ */
+typedef struct {
+	Four    volNo;              /* volume, NIL if the slot is unused */
+	Four    numDevices;         /* # of devices of the volume */
+	int     fd[BFM_MAX_DEVICES]; /* descriptor of each device, -1 if it cannot be written directly */
+	PageNo  firstPage[BFM_MAX_DEVICES+1]; /* first page of each device, then # of pages */
+} BufferLocation;
+
+/*
+ * Typedef for the location of a page of a volume with a compressed page
+ * store
+ */
+typedef struct {
+	long long offset;           /* offset of the compressed image in the store, -1 if the page is at its home */
+	Two     length;             /* # of bytes of the image */
+} BufferStored;
+
+/*
+ * Typedef for the compressed page store of a volume
+ * The store is a file of records appended one after the other, each the
+ * compressed image of a page or a mark that the page went back to its
+ * home in the devices of the volume; the last record of a page wins. The
+ * home of a page whose image is in the store is a hole of its device.
+ */
+typedef struct {
+	Four    volNo;              /* volume, NIL if the slot is unused */
+	int     fd;                 /* descriptor of the store */
+	char    name[BFM_STORE_NAME_SIZE]; /* file name of the store */
+	long long end;              /* offset at which the next record is appended */
+	Four    numDevices;         /* # of devices of the volume */
+	int     devFd[BFM_MAX_DEVICES]; /* descriptor of each device */
+	PageNo  firstPage[BFM_MAX_DEVICES+1]; /* first page of each device, then # of pages */
+	BufferStored *pages;        /* location of each page of the volume */
+	BfM_CompressionStatistics stats; /* statistics of the store */
+} BufferStore;
+
+/*
+ * Typedef for the header of a compressed page store, at its start
+ */
+typedef struct {
+	char    magic[8];           /* BFM_STORE_MAGIC */
+	Four    pageSize;           /* PAGESIZE */
+	Four    nPages;             /* # of pages of the volume */
+} BufferStoreHeader;
+
+/*
+ * Typedef for the header of a record of a compressed page store
+ */
+typedef struct {
+	PageNo  pageNo;             /* page of the record */
+	Two     length;             /* # of bytes of the image which follows, 0 if the page is at its home */
+	Two     check;              /* ~length, to detect a record torn by a crash */
+} BufferStoreRecord;
+
+/*
+ * Typedef for a dirty train collected by edubfm_WriteDirtyTrains()
+ */
+typedef struct {
+	TrainID key;                /* dirty train */
+	Four    index;              /* frame holding the train */
+} BufferDirty;
+
+/*
+ * Typedef for the dirty trains of one device, collected by
+ * edubfm_WriteDirtyTrains(), whose runs are written in turn with those of
+ * the other devices
+ */
+typedef struct {
+	Four    next;               /* index of the next train to write */
+	Four    end;                /* index after the last train of the device */
+} BufferStream;
+
+/*
+ * Typedef for a run of adjacent trains being written asynchronously
+ */
+typedef struct {
+	BufferDirty *run;           /* first train of the run, NULL if the slot is free */
+	Four    nRun;               /* # of trains of the run */
+	struct iovec iov[BFM_MAX_RUN]; /* frames of the trains */
+} BufferWrite;
+
+/*
+ * Typedef for a partition of a buffer pool
+ * A train belongs to the partition chosen by the hash of its ID and is
+ * held by one of the frames of that partition; each partition has its own
+ * hash table, replacement state and mutex, so operations on trains of
+ * different partitions do not contend.
+ * The mutex serializes the changes to the hash table, the free list and the
+ * replacement state. Fixing a train found in the buffer, unfixing it and
+ * setting its dirty bit take no mutex: the hash chains are walked with
+ * acquire loads and the fix counts are updated with compare-and-swap; a
+ * victim is claimed by swapping its fix count from 0 to BFM_CLAIMED, so a
+ * frame fixed without the mutex is never evicted.
+ */
+typedef struct {
+	pthread_mutex_t mutex;      /* serializes the operations on the partition */
+	Four    firstFrame;         /* first frame of the partition */
+	Four    nFrames;            /* # of frames of the partition */
+	UFour   hashMask;           /* # of hash buckets - 1 */
+	Four    *hashTable;         /* first frame of each hash chain */
+	Four    freeFrames;         /* first free frame, chained by nextHashEntry */
+	Four    nextVictim;         /* CLOCK hand */
+	UFour   clock;              /* time of LRU-K, advanced when another frame is referenced */
+	Four    lastFrame;          /* frame referenced last, NIL if none */
+	Four    head[BFM_NUM_QUEUES];   /* most recently inserted frame of each 2Q queue */
+	Four    tail[BFM_NUM_QUEUES];   /* least recently inserted frame of each 2Q queue */
+	Four    count[BFM_NUM_QUEUES];  /* # of frames in each 2Q queue */
+	Four    nGhosts;            /* # of ghost slots */
+	Four    nextGhost;          /* ghost slot reused next */
+	BufferGhost *ghosts;        /* ring of ghosts */
+	Four    *ghostHash;         /* first ghost of each hash chain, hashMask+1 chains */
+	Four    ring[BFM_SCAN_RING];    /* frames given to cold trains, oldest first from ringHead */
+	Four    ringHead;           /* oldest frame of the scan ring */
+	Four    ringCount;          /* # of frames in the scan ring */
+	BfM_Statistics stats;       /* statistics of the partition */
+} BufferPartition;
+
+/*
+ * Typedef for a buffer pool
+ */
+typedef struct {
+	Two     bufSize;            /* # of pages of a train */
+	Four    nBufs;              /* # of frames */
+	BufferTable *bufTable;      /* descriptors of the frames */
+	char    *bufferPool;        /* frames, aligned to PAGESIZE */
+	char    *poolBase;          /* mapping holding the frames */
+	size_t  poolSize;           /* size of the mapping */
+	Four    hugePages;          /* backing obtained for the frames, BFM_HUGEPAGE_* */
+	Four    nPartitions;        /* # of partitions */
+	BufferPartition *partitions; /* partitions of the pool */
+	BufferDirty *dirty;         /* dirty trains being written out, nBufs entries */
+	char    *runBuffer;         /* copy of a run of adjacent trains, aligned to PAGESIZE */
+} BufferInfo;
+
+
+/*@
+ * Macro Function Definitions
+ */
+
+/*
+ * Description: hash a train ID; the low bits select the hash chain, the high
+ *              bits the partition
+ * Parameter:
+ *  TrainID *key        : pointer to the train ID
+ * Returns: (UFour) hash value
+ */
+#define BFM_HASH(key) \
+	((UFour)(key)->pageNo * 0x9E3779B1U ^ (UFour)(key)->volNo * 0x85EBCA77U)
+
+/*
+ * Description: atomic accesses to the fields shared with the lock-free paths
+ */
+#define BFM_LOAD(p)                     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define BFM_STORE(p, v)                 __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define BFM_SET_BITS(entry, b) \
+	((void) ((((entry)->bits & (b)) == (b)) || __atomic_fetch_or(&(entry)->bits, (b), __ATOMIC_RELAXED)))
+#define BFM_CLEAR_BITS(entry, b)        ((void) __atomic_fetch_and(&(entry)->bits, ~(b), __ATOMIC_RELAXED))
+
+/*
+ * Description: check whether a train is written to its volume rather than
+ *              saved by the recovery manager (see the recovery hooks)
+ * Parameter:
+ *  Four volNo          : volume of the train
+ *  One bits            : bits of the frame or of the mapped page
+ *  char *aTrain        : frame or mapped page holding the train
+ * Returns: (Boolean) TRUE if the train is written in place
+ */
+#define BFM_IS_WRITTEN_IN_PLACE(volNo, bits, aTrain) \
+	(((volNo) & BFM_TMP_VOLUME_BIT) || !RM_RollbackRequiredFlag || \
+	 (((Page *)(aTrain))->header.flags & BFM_WRITE_IN_PLACE) || ((bits) & BFM_NEW))
+
+/*
+ * Description: count an event in the statistics of a partition without the
+ *              mutex; concurrent counts may be lost, which is accepted to
+ *              keep the lock-free paths free of locked instructions
+ */
+#define BFM_COUNT(part, counter) \
+	__atomic_store_n(&(part)->stats.counter, __atomic_load_n(&(part)->stats.counter, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED)
+
+#define IS_BAD_BUFFERTYPE(type)         ((type) < 0 || (type) >= NUM_BUF_TYPES)
+
+#define BI_BUFSIZE(type)                (edubfm_bufInfo[type].bufSize)
+#define BI_NBUFS(type)                  (edubfm_bufInfo[type].nBufs)
+#define BI_BUFTABLE_ENTRY(type, idx)    (&edubfm_bufInfo[type].bufTable[idx])
+#define BI_BUFFER(type, idx) \
+	(edubfm_bufInfo[type].bufferPool + (size_t)(idx) * BI_BUFSIZE(type) * PAGESIZE)
+#define BI_NPARTITIONS(type)            (edubfm_bufInfo[type].nPartitions)
+#define BI_PARTITION(type, p)           (&edubfm_bufInfo[type].partitions[p])
+/* the high 16 bits of the hash are scaled to the # of partitions, without a division */
+#define BI_PARTITION_OF(type, key) \
+	BI_PARTITION(type, ((BFM_HASH(key) >> 16) * (UFour)BI_NPARTITIONS(type)) >> 16)
+
+
+/*@
+ * Global Variables
+ */
+extern BufferInfo       edubfm_bufInfo[NUM_BUF_TYPES];
+extern BfM_Parameters   edubfm_params;
+extern pthread_mutex_t  edubfm_ioMutex;     /* serializes the calls to RDsM */
+extern pthread_mutex_t  edubfm_writeMutex;  /* serializes the write-backs and the drops of trains */
+extern __thread Four    edubfm_accessHint;  /* access hint of the calling thread, BFM_HINT_* */
+extern Boolean          edubfm_mapProbing;  /* TRUE while the reads of RDsM locate a volume to map */
+
+
+/*@
+ * Function Prototypes
+ */
+/* Internal Function Prototypes */
+Four edubfm_InitBufferInfo(Four, Four, Four, Four);
+Four edubfm_FinalBufferInfo(Four);
+void edubfm_ResetPartition(Four, BufferPartition*);
+Four edubfm_LookUp(TrainID*, Four);
+Four edubfm_LockFreeLookUp(TrainID*, Four);
+Boolean edubfm_TryFix(BufferTable*);
+Boolean edubfm_Claim(BufferTable*);
+Boolean edubfm_Unfix(BufferTable*);
+Four edubfm_Insert(TrainID*, Four, Four);
+Four edubfm_Delete(TrainID*, Four);
+Four edubfm_AllocTrain(Four, BufferPartition*);
+Four edubfm_ReleaseTrain(Four, BufferPartition*, Four);
+void edubfm_Touch(Four, BufferPartition*, Four);
+void edubfm_Admit(Four, BufferPartition*, Four);
+void edubfm_Forget(Four, BufferPartition*, Four);
+Four edubfm_SelectVictim(Four, BufferPartition*);
+Four edubfm_ReadTrain(TrainID*, char*, Four);
+Four edubfm_FlushTrain(Four, Four);
+void edubfm_SetDirectIO(Four);
+void edubfm_GetDirectIOStatistics(Four*, Four*);
+Four edubfm_WriteDirtyTrains(Four, Four, Boolean);
+void edubfm_StartWriter(void);
+void edubfm_StopWriter(void);
+void edubfm_WakeWriter(void);
+void edubfm_GetWriterStatistics(Four*, Four*, Four*);
+void edubfm_ForgetLocations(Four);
+Four edubfm_FixMapped(TrainID*, char**, Boolean);
+Four edubfm_UnfixMapped(TrainID*);
+Four edubfm_SetDirtyMapped(TrainID*);
+Four edubfm_DropMapped(TrainID*, char*, Boolean);
+Four edubfm_FlushMapped(Four);
+Four edubfm_DiscardMapped(Four);
+Four edubfm_UnmapVolumes(Four);
+Four edubfm_LocateTrain(TrainID*, char*, int*, long long*);
+void edubfm_ProbeRead(int, size_t);
+void edubfm_GetMapStatistics(Four*, Four*);
+Four edubfm_AttachStore(Four, char*);
+Four edubfm_DetachStore(Four, Boolean);
+Boolean edubfm_HasStore(Four);
+Four edubfm_ReadStored(TrainID*, char*, Four);
+Four edubfm_WriteStored(TrainID*, char*, Four);
+Four edubfm_DropStored(TrainID*, Four);
+Four edubfm_GetStoreStatistics(Four, BfM_CompressionStatistics*);
+Four edubfm_LZCompress(const char*, Four, char*, Four);
+Four edubfm_LZDecompress(const char*, Four, char*, Four);
+
+/* Interfaces of the lower and recovery layers used by the buffer manager */
+Four RDsM_ReadTrain(TrainID*, char*, Four);
+Four RDsM_WriteTrain(char*, TrainID*, Four);
+Four RDsM_WriteTrains(char*, TrainID*, Four, Two);
+Four RDsM_PageIdToExtNo(PageID*, Four*);
+Four RM_LoadTrain(TrainID*, char*, Four);
+Four RM_SaveTrain(TrainID*, char*, Four);
+Four rm_LookUpInLogTable(TrainID*, Four*);
+extern Four RM_RollbackRequiredFlag;
+
+
+#endif /* _EDUBFM_INTERNAL_H_ */
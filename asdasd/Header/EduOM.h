@@ -65,6 +65,32 @@ Four EduOM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*);
 Four EduOM_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_PrevObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_ReadObject(ObjectID*, Four, Four, void*);
+Four EduOM_ReadObjects(Four, ObjectID*, Four*, Four*, char**, Four*);
+Four EduOM_ReadObjectV(ObjectID*, Four, OM_IOVec*);
+Four EduOM_WriteObjectV(ObjectID*, Four, OM_IOVec*);
+Four EduOM_PinObject(ObjectID*, OM_ObjectView*);
+Four EduOM_UnpinObject(OM_ObjectView*);
+Four EduOM_OpenScan(ObjectID*, Four, OM_ScanCursor*);
+Four EduOM_ScanNext(OM_ScanCursor*, ObjectID*, ObjectHdr*);
+Four EduOM_CloseScan(OM_ScanCursor*);
+Four EduOM_ScanNextRead(OM_ScanCursor*, Four, Four, ObjectID*, ObjectHdr*, void*, Four*);
+Four EduOM_ScanNextView(OM_ScanCursor*, ObjectID*, ObjectHdr*, char**);
+Four EduOM_OpenFilteredScan(ObjectID*, Four, OM_HdrPredicate*, OM_ScanCursor*);
+Four EduOM_BuildZoneMap(ObjectID*);
+Four EduOM_DropZoneMap(ObjectID*);
+Four EduOM_ReorganizeFile(ObjectID*, OM_ReorgCursor*, Four, OM_RemapCallback, void*, Pool*, DeallocListElem*);
+Four EduOM_VacuumFile(ObjectID*, Four, OM_RemapCallback, void*, Four*, Pool*, DeallocListElem*);
+Four EduOM_CollapseForwarding(ObjectID*, OM_RemapCallback, void*, Four*, Pool*, DeallocListElem*);
+Four EduOM_NextObjects(ObjectID*, ObjectID*, Four, ObjectID*, ObjectHdr*, Four*);
+Four EduOM_InitReadAhead(Four, Four, char**, Four);
+Four EduOM_FinalReadAhead(void);
+Four EduOM_GetReadAheadStatistics(Four*, Four*);
+Four EduOM_InitObjectCache(Four);
+Four EduOM_FinalObjectCache(void);
+Four EduOM_GetObjectCacheStatistics(OM_ObjectCacheStats*);
+Four EduOM_ParallelScan(ObjectID*, Four, OM_ScanCallback, void*);
+Four EduOM_SetAccessHint(Four);
+Four EduOM_SetScanHint(OM_ScanCursor*, Four);
 
 Four OM_DumpObject(ObjectID *);
 
@@ -49,6 +49,8 @@
 #ifndef _EDUOM_INTERNAL_H_
 #define _EDUOM_INTERNAL_H_
 
+#include <assert.h>
+
 
 /*@
  * Type Definitions
@@ -99,6 +101,235 @@ typedef struct {
 } SlottedPage;
 
 
+/*
+ *----------------- Typedefs for Scan Structures --------------------
+ */
+
+/* scan directions */
+#define FORWARD         0
+#define BACKWARD        1
+
+/* access hints of a scan, same values as the BFM_HINT_* of EduBfM */
+#define OM_HINT_NORMAL      0       /* pages enter the replacement order of the buffer */
+#define OM_HINT_SEQUENTIAL  1       /* pages are cold and recycled through the scan ring */
+
+/* read-ahead parameters (in pages) */
+#define RA_SEQ_THRESHOLD    2       /* sequential page moves before read-ahead starts */
+#define RA_MIN_WINDOW       4       /* initial read-ahead window */
+#define RA_MAX_WINDOW       64      /* maximum read-ahead window */
+#define RA_MAX_STREAMS      8       /* streams tracked for EduOM_NextObject()/EduOM_PrevObject() */
+
+/*
+ * Typedef for a sequential access stream watched by the read-ahead
+ */
+typedef struct {
+	PageID lastPid;         /* page the stream moved to last, pageNo is NIL if unused */
+	Four direction;         /* FORWARD or BACKWARD */
+	Four nSeq;              /* # of consecutive page moves along the page list */
+	Four nContig;           /* # of consecutive page moves to the physically adjacent page */
+	Four window;            /* current read-ahead window */
+	Four nAhead;            /* # of pages requested beyond the current page */
+	UFour lastUsed;         /* clock value of the last use, for stream replacement */
+} OM_ReadAheadStream;
+
+/* upper bound of the # of slots in a slotted page */
+#define OM_MAX_SLOTS        ((PAGESIZE - SP_FIXED) / sizeof(SlottedPageSlot) + 1)
+
+/* conditions of a header predicate */
+#define PRED_TAG            0x1     /* tag is one of 'tags' */
+#define PRED_LENGTH         0x2     /* length is within [minLength, maxLength] */
+#define PRED_PROPERTIES     0x4     /* (properties & propMask) == propValue */
+
+#define PRED_MAX_TAGS       8       /* maximum # of tags in a predicate */
+
+/*
+ * Typedef for a predicate on the object header
+ * An object qualifies if it satisfies all conditions set in 'conditions'.
+ */
+typedef struct {
+	Four conditions;        /* PRED_TAG | PRED_LENGTH | PRED_PROPERTIES */
+	Four nTags;             /* # of tags in 'tags' */
+	Two tags[PRED_MAX_TAGS]; /* qualifying tags */
+	Four minLength;         /* minimum length of the object */
+	Four maxLength;         /* maximum length of the object */
+	Two propMask;           /* property bits to test */
+	Two propValue;          /* required values of the bits in 'propMask' */
+} OM_HdrPredicate;
+
+/* zone map parameters */
+#define ZM_INIT_FILES       8       /* initial # of entries of the table of the zone maps */
+#define ZM_INIT_SIZE        64      /* initial # of buckets of a zone map */
+
+/*
+ * Typedef for the summary of a page kept in a zone map
+ * The ranges only grow while objects are destroyed, so they are
+ * conservative: a page outside them cannot hold a qualifying object.
+ */
+typedef struct {
+	ShortPageID pageNo;     /* page summarized, NIL if the bucket is empty */
+	ShortPageID nextPage;   /* next page of the page list */
+	ShortPageID prevPage;   /* previous page of the page list */
+	Two nLive;              /* # of objects in the page */
+	Two minTag;             /* minimum tag of the objects */
+	Two maxTag;             /* maximum tag of the objects */
+	Four minLength;         /* minimum length of the objects */
+	Four maxLength;         /* maximum length of the objects */
+} OM_PageSummary;
+
+/*
+ * Typedef for the zone map of a data file
+ * The page summaries are kept in a hash table on the page number; their
+ * page list links let a scan move past pages without fixing them.
+ */
+typedef struct {
+	ObjectID catObj;        /* catalog object of the file, pageNo is NIL if unused */
+	UFour generation;       /* distinct for each zone map allocated, 0 if unused */
+	Four nPages;            /* # of pages summarized */
+	Four size;              /* # of buckets, a power of 2 */
+	OM_PageSummary *pages;  /* buckets */
+} OM_ZoneMap;
+
+/*
+ * Typedef for the scan cursor on a data file
+ * The cursor keeps the current page fixed in the buffer between calls.
+ */
+typedef struct {
+	PhysicalFileID pFid;    /* physical ID of the file being scanned */
+	ShortPageID lastPage;   /* last page of the file, start of backward scan */
+	Four direction;         /* FORWARD or BACKWARD */
+	PageID pid;             /* page currently fixed by the cursor */
+	SlottedPage *apage;     /* buffer holding 'pid', NULL if no page is fixed */
+	Two slotNo;             /* slot of the object returned last */
+	Object *obj;            /* object returned last, the forwarded record of a moved object */
+	PageID fwdPid;          /* page holding the forwarded record returned last */
+	SlottedPage *fwdPage;   /* buffer holding 'fwdPid', NULL if no forwarded record is fixed */
+	Boolean eos;            /* TRUE if the end of the scan is reached */
+	OM_ReadAheadStream ra;  /* read-ahead state of the scan */
+	Boolean filtered;       /* TRUE if only objects satisfying 'pred' are returned */
+	OM_HdrPredicate pred;   /* predicate of a filtered scan */
+	Two nQual;              /* # of qualifying slots of the fixed page */
+	Two qualPos;            /* position in 'qual' of the object returned last */
+	Two qual[OM_MAX_SLOTS]; /* qualifying slots of the fixed page, in ascending order */
+	OM_ZoneMap *zoneMap;    /* zone map used by a filtered scan to skip pages, or NULL */
+	UFour zoneMapGen;       /* generation of 'zoneMap' when the scan was opened */
+	Four nSkipped;          /* # of pages skipped with the zone map */
+	Four accessHint;        /* OM_HINT_* under which the pages are fixed */
+} OM_ScanCursor;
+
+/* parallel scan parameters */
+#define PS_MAX_THREADS      16      /* maximum # of worker threads */
+#define PS_MORSEL_SIZE      16      /* pages in a morsel */
+#define PS_MAX_FIXED_PAGES  256     /* pages fixed in the buffer by a parallel scan at a time */
+
+/*
+ * Typedef for the function called on each object by a parallel scan
+ * It is called concurrently by the worker threads and must not call the
+ * buffer manager; a negative return value stops the scan.
+ */
+typedef Four (*OM_ScanCallback)(ObjectID*, Object*, void*);
+
+
+/*
+ *----------------- Typedefs for File Reorganization --------------------
+ */
+
+/*
+ * Typedef for the function told about each object moved by a reorganization
+ * It is called with the old and the new object ID; a negative return value
+ * stops the reorganization.
+ */
+typedef Four (*OM_RemapCallback)(ObjectID*, ObjectID*, void*);
+
+/*
+ * Typedef for the state of a reorganization done in chunks
+ * It must be initialized with INIT_REORG_CURSOR() before the first call.
+ */
+typedef struct {
+	Boolean started;        /* FALSE before the first call */
+	ShortPageID firstNewPage; /* first page allocated by the reorganization, NIL if none */
+	ShortPageID nextOldPage; /* next page to reorganize, NIL when done */
+	PageID newPage;         /* page receiving the moved objects, pageNo is NIL if none */
+	Four nMoved;            /* # of objects moved so far */
+	Four nPages;            /* # of pages reorganized so far */
+} OM_ReorgCursor;
+
+#define INIT_REORG_CURSOR(c)    ((c)->started = FALSE)
+
+/*
+ * A moved object leaves a stub in its slot: the stub has P_MOVED set and
+ * holds the ObjectID of the forwarded record, which has P_FORWARDED set.
+ */
+#define OM_STUB_LENGTH          sizeof(ObjectID)        /* data length of a stub */
+
+
+/*
+ *----------------- Typedefs for Vectored Object Access --------------------
+ */
+
+/*
+ * Typedef for a segment of a vectored read or write of an object
+ */
+typedef struct {
+	Four start;             /* starting offset in the object */
+	Four length;            /* amount of data, REMAINDER to the end; OUT: amount done */
+	char *buf;              /* user buffer */
+} OM_IOVec;
+
+
+/*
+ *----------------- Typedefs for the Object Cache --------------------
+ */
+
+/* object cache parameters */
+#define OC_DOORKEEPER_SIZE  4096    /* objects missed recently, remembered for the admission */
+#define OC_LATENCY_SAMPLE   64      /* one read in this many is timed */
+
+/*
+ * Typedef for the statistics of the object cache
+ */
+typedef struct {
+	Four nLookups;          /* # of reads looked up in the cache */
+	Four nHits;             /* # of reads served by the cache */
+	Four nAdmits;           /* # of objects entered into the cache */
+	Four nEvictions;        /* # of objects evicted to stay within the budget */
+	Four nInvalidations;    /* # of objects dropped because they changed */
+	Four nEntries;          /* # of objects in the cache */
+	Four nBytes;            /* memory used by the cache */
+	double hitLatency;      /* average time of a read served by the cache (ns) */
+	double missLatency;     /* average time of a read served by the buffer (ns) */
+} OM_ObjectCacheStats;
+
+
+/*
+ *----------------- Typedefs for Pinned Object Views --------------------
+ */
+
+/*
+ * Typedef for a view of an object pinned in the buffer
+ * The data stay valid until the view is released with EduOM_UnpinObject();
+ * the page holding the object stays fixed meanwhile. In debug builds (NDEBUG
+ * not defined) a released view is poisoned and OM_VIEW_DATA() checks it.
+ */
+typedef struct {
+	const char *data;       /* data of the object in the buffer */
+	Four length;            /* length of the object */
+	PageID pid;             /* page fixed for the view */
+	ObjectID oid;           /* object viewed, the forwarded record of a moved object */
+#ifndef NDEBUG
+	UFour magic;            /* OM_VIEW_PINNED while the view is pinned */
+#endif
+} OM_ObjectView;
+
+#define OM_VIEW_PINNED          0x50494E44      /* magic of a pinned view */
+
+#ifndef NDEBUG
+#define OM_VIEW_DATA(v)         (assert((v)->magic == OM_VIEW_PINNED), (v)->data)
+extern Four eduom_numPinnedViews;              /* # of views not released yet */
+#else
+#define OM_VIEW_DATA(v)         ((v)->data)
+#endif
+
+
 /*@
  * Macro Function Definitions
  */
@@ -145,6 +376,50 @@ typedef struct {
 
 #define LRGOBJ_THRESHOLD (PAGESIZE - SP_FIXED - sizeof(ObjectHdr))
 
+/* Macro: OM_OBJECT_SPACE(length)
+ * Description: return the space of a page taken by a small object, as
+ *              ALIGNED_LENGTH() does for a length which is not negative
+ * Parameter:
+ *  Four length         : length of the object's data
+ * Returns: (size_t) space taken by the object and its header
+ */
+#define OM_OBJECT_SPACE(length) \
+	(sizeof(ObjectHdr) + MAX(sizeof(ShortPageID), ((size_t)(length) + ALIGN - 1) / ALIGN * ALIGN))
+
+/* Macro: OM_NEEDED_SPACE(length)
+ * Description: return the space of a page needed to store a new small object
+ * Parameter:
+ *  Four length         : length of the object's data
+ * Returns: (size_t) space needed for the object, its header and a new slot
+ */
+#define OM_NEEDED_SPACE(length) \
+	(OM_OBJECT_SPACE(length) + sizeof(SlottedPageSlot))
+
+/* Macro: OM_IS_DATA_SLOT(p, i)
+ * Description: check whether the slot holds an object's data, i.e. it is
+ *              neither empty nor the stub of a moved object
+ * Parameters:
+ *  SlottedPage *p      : pointer to the page
+ *  Two i               : slot number
+ * Returns: (Boolean) TRUE if the slot holds data
+ */
+#define OM_IS_DATA_SLOT(p, i) \
+	((p)->slot[-(i)].offset != EMPTYSLOT && \
+	 !(((Object *)&(p)->data[(p)->slot[-(i)].offset])->header.properties & P_MOVED))
+
+/* Macro: OM_IS_OBJECT_SLOT(p, i)
+ * Description: check whether a scan returns the object of the slot, i.e. the
+ *              slot is neither empty nor the forwarded record of a moved
+ *              object, which is returned at its stub
+ * Parameters:
+ *  SlottedPage *p      : pointer to the page
+ *  Two i               : slot number
+ * Returns: (Boolean) TRUE if a scan returns the slot
+ */
+#define OM_IS_OBJECT_SLOT(p, i) \
+	((p)->slot[-(i)].offset != EMPTYSLOT && \
+	 !(((Object *)&(p)->data[(p)->slot[-(i)].offset])->header.properties & P_FORWARDED))
+
 /* Macro: GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry)
  * Description: get the information about the data file(sm_CatOverlayForData) residing in the catalog object for data file
  * Parameters:
@@ -165,6 +440,8 @@ typedef struct {
  */
 /* internal function prototypes */
 Four eduom_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*);
+Four eduom_AllocPage(ObjectID*, PageID*, PageID*, PageID*, SlottedPage**);
+Four eduom_PlaceObject(ObjectID*, PageID*, SlottedPage*, ObjectHdr*, Four, char*, ObjectID*);
 
 Four om_FileMapAddPage(ObjectID*, PageID*, PageID*);
 Four om_FileMapDeletePage(ObjectID*, PageID*);
@@ -173,5 +450,23 @@ Four om_IsTemporary(FileID*, Boolean*);
 Four om_PutInAvailSpaceList(ObjectID*, PageID*, SlottedPage*);
 Four om_RemoveFromAvailSpaceList(ObjectID*, PageID*, SlottedPage*);
 
+void eduom_InitReadAheadStream(OM_ReadAheadStream*, Four);
+Four eduom_ReadAheadStep(OM_ReadAheadStream*, PageID*, SlottedPage*, Four);
+Four eduom_ReadAheadPages(Four, PageID*);
+Boolean eduom_ObjectCacheRead(ObjectID*, Four, Four, char*, Four*, double*);
+void eduom_ObjectCacheAdmit(ObjectID*, Object*, double);
+void eduom_ObjectCacheInvalidate(ObjectID*);
+Two eduom_FilterPage(SlottedPage*, OM_HdrPredicate*, Two*);
+Boolean eduom_MatchPredicate(ObjectHdr*, OM_HdrPredicate*);
+Four eduom_FixForwarded(Object*, PageID*, SlottedPage**, Object**);
+Four eduom_ScanHeader(Object*, ObjectHdr*);
+
+OM_ZoneMap *eduom_GetZoneMap(ObjectID*);
+OM_ZoneMap *eduom_NewZoneMap(ObjectID*);
+void eduom_FreeZoneMap(OM_ZoneMap*);
+Four eduom_ZoneMapInsert(ObjectID*, SlottedPage*, ObjectHdr*);
+Four eduom_ZoneMapRemove(ObjectID*, SlottedPage*, Boolean);
+PageNo eduom_ZoneMapSkip(OM_ZoneMap*, UFour, PageNo, OM_HdrPredicate*, Four, Four*);
+
     
 #endif /* _EDUOM_INTERNAL_H_ */
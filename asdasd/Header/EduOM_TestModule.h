@@ -117,6 +117,18 @@ typedef struct {        /* 8 byte unsigned integer */
 typedef enum { X_BROWSE_BROWSE, X_CS_BROWSE, X_CS_CS, X_RR_BROWSE, X_RR_CS, X_RR_RR } ConcurrencyLevel; /* isolation degree */
 
 
+/*
+ * Mount table of the storage manager; sm_GetCatalogEntryFromDataFileId()
+ * takes the index of the volume in it (ARRAYINDEX for the first volume)
+ */
+typedef struct {
+    Four volId;			/* volume, NIL if the entry is unused */
+    char reserved[100];		/* used by the storage manager */
+} SM_MountTableEntry;
+
+extern SM_MountTableEntry smMountTable[];
+
+
 /*@
  * Function Prototypes
  */
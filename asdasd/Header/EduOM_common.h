@@ -361,6 +361,8 @@ typedef struct _DeallocListElem DeallocListElem;
  */
 #undef MAX
 #define MAX(a,b) (((a) >= (b)) ? (a):(b))
+#undef MIN
+#define MIN(a,b) (((a) <= (b)) ? (a):(b))
 
 
 /*
@@ -54,8 +54,35 @@
 /*
  * Error Base Definitions
  */
+#define GENERAL_ERR_BASE                         1
+#define RDSM_ERR_BASE                            3
+#define BFM_ERR_BASE                             4
 #define OM_ERR_BASE                              6
 
+/*
+ * Error Definitions for GENERAL_ERR_BASE
+ */
+#define eBADPARAMETER                            ERR_ENCODE_ERROR_CODE(GENERAL_ERR_BASE,2)
+#define eMEMORYALLOCERR                          ERR_ENCODE_ERROR_CODE(GENERAL_ERR_BASE,12)
+
+/*
+ * Error Definitions for RDSM_ERR_BASE
+ */
+#define eDEVICEOPENFAIL_RDSM                     ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,3)
+#define eREADFAIL_RDSM                           ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,5)
+#define eWRITEFAIL_RDSM                          ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,6)
+#define eALREADYSETBIT_RDSM                      ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,17)
+
+/*
+ * Error Definitions for BFM_ERR_BASE
+ */
+#define eBADBUFFERTYPE_BFM                       ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,0)
+#define eBADBUFFER_BFM                           ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,2)
+#define eBADHASHKEY_BFM                          ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,3)
+#define eFLUSHFIXEDBUF_BFM                       ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,5)
+#define eNOTFOUND_BFM                            ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,6)
+#define eNOUNFIXEDBUF_BFM                        ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,7)
+
 /*
  * Error Definitions for OM_ERR_BASE
  */
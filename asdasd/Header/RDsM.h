@@ -50,9 +50,149 @@
 #define _RDsM_H_
 
 
+#include <sys/uio.h>
+
+#define RDSM_PAGEMAP_HDR_SIZE   16      /* bytes of a page map page before its bits */
+
+/*
+ * Constants for the I/O engine
+ */
+#define RDSM_IO_AUTO            0       /* io_uring if the kernel has it, else synchronous */
+#define RDSM_IO_URING           1       /* io_uring */
+#define RDSM_IO_SYNC            2       /* pread() and pwrite() at submission */
+
+#define RDSM_IO_READ            0       /* read request */
+#define RDSM_IO_WRITE           1       /* write request */
+
+#define RDSM_IO_MAX_DEPTH       256     /* maximum # of requests of an engine */
+#define RDSM_IO_MAX_BUFFERS     4       /* maximum # of registered buffers of an engine */
+
+/* default engine, set with -DRDSM_IO_ENGINE=... at build time */
+#ifndef RDSM_IO_ENGINE
+#define RDSM_IO_ENGINE          RDSM_IO_AUTO
+#endif
+
+/*
+ * Constants for EduRDsM_PrepareDevices()
+ */
+#define RDSM_FORMAT_SPARSE      0       /* devices emptied and left sparse */
+#define RDSM_FORMAT_RESERVE     1       /* devices emptied and their space reserved */
+
+/*
+ * Constants for the volume table of RDsM
+ */
+#define RDSM_MAX_VOLUMES        20      /* # of entries of the volume table */
+#define RDSM_MAX_DEVICES        20      /* maximum # of devices of a volume */
+#define RDSM_DEVNAME_SIZE       256     /* size of the device name of a device entry */
+
+/*
+ * Typedef for a device of a mounted volume, as kept by RDsM
+ */
+typedef struct {
+    char      devName[RDSM_DEVNAME_SIZE]; /* name of the device */
+    int       fd;                       /* descriptor of the device */
+    Four      firstExtNo;               /* first extent of the device */
+    char      reserved[36];             /* not used outside RDsM */
+} RDsM_DevInfo;
+
+/*
+ * Typedef for an entry of the volume table of RDsM
+ * Only the fields used outside RDsM are named; 'volNo' is NIL if the
+ * entry is not used.
+ */
+typedef struct {
+    char      reserved0[50];            /* not used outside RDsM */
+    VolNo     volNo;                    /* volume number */
+    Two       sizeOfExt;                /* # of pages in an extent */
+    Two       reserved1;
+    Four      numOfExts;                /* # of extents of the volume */
+    Four      numOfFreeExts;            /* # of free extents, loaded at the first use */
+    Four      firstFreeExt;             /* head of the list of the free extents */
+    char      reserved2[24];            /* not used outside RDsM */
+    Four      numDevices;               /* # of devices of the volume */
+    char      reserved3[8];             /* not used outside RDsM */
+    RDsM_DevInfo *devInfo;              /* devices of the volume */
+} RDsM_VolTableEntry;
+
+/*
+ * Typedef for an I/O request of the synchronous engine
+ */
+typedef struct {
+    Four      op;                       /* RDSM_IO_READ or RDSM_IO_WRITE */
+    int       fd;                       /* file descriptor */
+    char      *buf;                     /* buffer */
+    Four      len;                      /* # of bytes */
+    struct iovec *iov;                  /* buffers of a vectored request, instead of 'buf' */
+    Four      iovcnt;                   /* # of buffers of 'iov' */
+    long long offset;                   /* offset in the file */
+    void      *tag;                     /* tag of the request */
+} RDsM_IORequest;
+
+/*
+ * Typedef for a completed I/O request
+ */
+typedef struct {
+    void *tag;                          /* tag given to EduRDsM_PrepareIO() */
+    Four result;                        /* # of bytes transferred, or -errno */
+} RDsM_IOCompletion;
+
+/*
+ * Typedef for an I/O engine
+ * The requests are prepared, submitted together, and reaped when they
+ * complete. An engine is used by one thread at a time.
+ */
+typedef struct {
+    Four     kind;                      /* RDSM_IO_URING or RDSM_IO_SYNC */
+    Four     depth;                     /* maximum # of requests prepared and not reaped */
+    Four     nQueued;                   /* # of requests prepared and not submitted */
+    Four     nInFlight;                 /* # of requests submitted and not reaped */
+    Four     nSubmits;                  /* # of submissions */
+    Four     nRequests;                 /* # of requests submitted */
+    /* io_uring */
+    int      ringFd;                    /* descriptor of the ring */
+    char     *ring;                     /* mapping of the submission and completion rings */
+    size_t   ringSize;                  /* size of 'ring' */
+    void     *sqes;                     /* mapping of the submission queue entries */
+    size_t   sqesSize;                  /* size of 'sqes' */
+    unsigned *sqTail, *sqMask, *sqArray; /* fields of the submission ring */
+    unsigned *cqHead, *cqTail, *cqMask; /* fields of the completion ring */
+    void     *cqes;                     /* completion queue entries */
+    Four     nBuffers;                  /* # of registered buffers */
+    char     *bufBase[RDSM_IO_MAX_BUFFERS]; /* registered buffers */
+    size_t   bufSize[RDSM_IO_MAX_BUFFERS]; /* sizes of the registered buffers */
+    /* synchronous engine */
+    RDsM_IORequest    *queued;          /* requests prepared */
+    RDsM_IOCompletion *done;            /* requests completed at submission */
+    Four     nDone;                     /* # of requests in 'done' */
+} RDsM_IOEngine;
+
+
 Four    RDsM_AllocTrains(Four, Four, PageID *, Two, Four, Two, PageID *);
 Four    RDsM_GetUnique(PageID*, Unique*, Four*);
 Four	RDsM_PageIdToExtNo(PageID *, Four *);
+Four	RDsM_GetSizeOfExt(Four, Two*);
+Four	RDsM_find_bits(char*, Four, Four, Four);
+Four	RDsM_test_n_bits_set(char*, Four, Four);
+void	RDsM_set_bits(char*, Four, Four);
+void	RDsM_clear_bits(char*, Four, Four);
+Four	RDsM_alloc_ext(RDsM_VolTableEntry*, Four, Four*);
+Four	RDsM_get_prev_next_ext(RDsM_VolTableEntry*, Four, Four*, Four*);
+Four	RDsM_set_prev_next_ext(RDsM_VolTableEntry*, Four, Four, Four);
+Four	RDsM_change_NumOfFreeExts_FirstFreeExt(RDsM_VolTableEntry*);
+Four	RDsM_Dismount(Four);
+Four	EduRDsM_GetDevices(Four, Four*, int*, PageNo*);
+Four	EduRDsM_GetNextExt(Four, Four, Four*);
+Four	EduRDsM_PrepareDevices(Four, char**, Four*, Four);
+Four	EduRDsM_SetInitExt(Boolean);
+Four	EduRDsM_InitExt(RDsM_VolTableEntry*, Four);
+Four	EduRDsM_SetIOEngine(Four);
+Four	EduRDsM_InitIOEngine(RDsM_IOEngine*, Four);
+Four	EduRDsM_FinalIOEngine(RDsM_IOEngine*);
+Four	EduRDsM_RegisterIOBuffers(RDsM_IOEngine*, Four, char**, size_t*);
+Four	EduRDsM_PrepareIO(RDsM_IOEngine*, Four, int, char*, Four, long long, void*);
+Four	EduRDsM_PrepareIOV(RDsM_IOEngine*, Four, int, struct iovec*, Four, long long, void*);
+Four	EduRDsM_SubmitIO(RDsM_IOEngine*);
+Four	EduRDsM_WaitIO(RDsM_IOEngine*, Four, RDsM_IOCompletion*, Four);
 
 
 #endif /* _RDsM_H_ */
@@ -0,0 +1,176 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_AllocTrain.c
+ *
+ * Description:
+ *  Allocation and release of the frames of a partition.
+ *  The caller holds the mutex of the partition.
+ *
+ * Exports:
+ *  Four edubfm_AllocTrain(Four, BufferPartition*)
+ *  Four edubfm_ReleaseTrain(Four, BufferPartition*, Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * edubfm_AllocTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_AllocTrain(Four, BufferPartition*)
+ *
+ * Description:
+ *  Allocate a frame of the partition 'part'. A free frame is used if there
+ *  is one; otherwise the victim chosen by the replacement policy is written
+ *  out if it is dirty and its train is dropped from the buffer.
+ *  The returned frame holds no train, is in no replacement queue and is
+ *  claimed; the caller stores its fix count before it releases the mutex
+ *  of the partition.
+ *
+ * Returns:
+ *  index of the frame
+ *  error code
+ *    eNOUNFIXEDBUF_BFM
+ *    some errors caused by function calls
+ */
+Four edubfm_AllocTrain(
+    Four type,			/* IN buffer type */
+    BufferPartition *part)	/* IN partition of the frame */
+{
+    Four e;			/* error */
+    Four victim;		/* allocated frame */
+    BufferTable *entry;		/* buffer table entry of the frame */
+
+
+    /*@ take a free frame */
+    if (part->freeFrames != NIL) {
+	victim = part->freeFrames;
+	entry = BI_BUFTABLE_ENTRY(type, victim);
+	part->freeFrames = entry->nextHashEntry;
+	BFM_STORE(&entry->nextHashEntry, NIL);
+
+	/* a lock-free lookup may fix the frame for a moment before it
+	   sees that the frame holds another train */
+	while (!edubfm_Claim(entry)) ;
+
+	return(victim);
+    }
+
+    /*@ evict a train */
+    victim = edubfm_SelectVictim(type, part);
+    if (victim < eNOERROR) ERR(victim);
+
+    entry = BI_BUFTABLE_ENTRY(type, victim);
+
+    if (entry->bits & BFM_DIRTY) {
+	/* the background writer fell behind */
+	edubfm_WakeWriter();
+	e = edubfm_FlushTrain(type, victim);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    e = edubfm_Delete(&entry->key, type);
+    if (e < eNOERROR) ERR(e);
+
+    edubfm_Forget(type, part, victim);
+    entry->key.pageNo = NIL;
+    entry->bits = 0;
+    part->stats.nEvictions++;
+
+    return(victim);
+
+} /* edubfm_AllocTrain() */
+
+
+
+/*@================================
+ * edubfm_ReleaseTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_ReleaseTrain(Four, BufferPartition*, Four)
+ *
+ * Description:
+ *  Drop the train held by the frame 'index', without writing it out, and
+ *  return the frame to the free list of the partition.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_ReleaseTrain(
+    Four type,			/* IN buffer type */
+    BufferPartition *part,	/* IN partition of the frame */
+    Four index)			/* IN frame index */
+{
+    Four e;			/* error */
+    BufferTable *entry;		/* buffer table entry of the frame */
+
+
+    entry = BI_BUFTABLE_ENTRY(type, index);
+
+    if (entry->key.pageNo != NIL) {
+	e = edubfm_Delete(&entry->key, type);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_Forget(type, part, index);
+    entry->key.pageNo = NIL;
+    entry->bits = 0;
+    BFM_STORE(&entry->fixed, 0);
+    BFM_STORE(&entry->nextHashEntry, part->freeFrames);
+    part->freeFrames = index;
+
+    return(eNOERROR);
+
+} /* edubfm_ReleaseTrain() */
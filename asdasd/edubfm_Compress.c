@@ -0,0 +1,788 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Compress.c
+ *
+ * Description:
+ *  Compressed page stores of the volumes.
+ *  A volume given a store with EduBfM_SetCompression() keeps its data
+ *  pages compressed: a train of PAGE_BUF holding a slotted page is
+ *  compressed with the LZ codec of edubfm_LZ.c when it is written out, and
+ *  if it saves at least BFM_STORE_MIN_SAVING bytes, its image is appended
+ *  to the store instead of being written with RDsM, and its home in the
+ *  device of the volume is made a hole. Any other train, and a page which
+ *  does not compress well, is written to its home with RDsM as usual; a
+ *  page of the store written to its home is marked so in the store.
+ *  The store is a log of records (see BufferStore): the location of each
+ *  page, its image in the store or its home, is kept in memory and
+ *  rebuilt by reading the records when the store is attached, a record
+ *  torn by a crash being cut off. Replaced images stay in the store until
+ *  it is compacted, when the volume is dismounted with as many bytes of
+ *  replaced images as of current ones.
+ *  The trains saved by the recovery manager are written to their home by
+ *  it, so a page of the store saved so is first put back to its home.
+ *  The pages of a volume with a store are never mapped by the mmap read
+ *  path nor queued to the asynchronous writes; the read-ahead of EduOM,
+ *  which reads the devices itself, finds holes for the stored pages and
+ *  only serves the pages at their home.
+ *  The caller of the functions below holds edubfm_ioMutex.
+ *
+ * Exports:
+ *  Four edubfm_AttachStore(Four, char*)
+ *  Four edubfm_DetachStore(Four, Boolean)
+ *  Boolean edubfm_HasStore(Four)
+ *  Four edubfm_ReadStored(TrainID*, char*, Four)
+ *  Four edubfm_WriteStored(TrainID*, char*, Four)
+ *  Four edubfm_DropStored(TrainID*, Four)
+ *  Four edubfm_GetStoreStatistics(Four, BfM_CompressionStatistics*)
+ */
+
+
+#define _GNU_SOURCE
+#define _FILE_OFFSET_BITS 64
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+#include "RDsM.h"
+
+
+static BufferStore bfmStores[BFM_MAX_STORES] = { [0 ... BFM_MAX_STORES - 1] = { NIL } }; /* stores of the volumes */
+
+static BufferStore *edubfm_FindStore(Four);
+static Four edubfm_LoadStore(BufferStore*);
+static void edubfm_SetLocation(BufferStore*, PageNo, long long, Four);
+static Four edubfm_AppendRecord(BufferStore*, PageNo, char*, Four);
+static Four edubfm_ReadImage(BufferStore*, PageNo, char*);
+static Four edubfm_PutHome(BufferStore*, PageNo);
+static Four edubfm_CompactStore(BufferStore*);
+static void edubfm_PunchHome(BufferStore*, PageNo);
+
+
+
+/*@================================
+ * edubfm_AttachStore()
+ *================================*/
+/*
+ * Function: Four edubfm_AttachStore(Four, char*)
+ *
+ * Description:
+ *  Give the mounted volume 'volNo' the compressed page store 'name',
+ *  creating it if it does not exist, and locate the pages of the volume
+ *  found in it.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eMEMORYALLOCERR
+ *    eDEVICEOPENFAIL_RDSM
+ *    some errors caused by function calls
+ */
+Four edubfm_AttachStore(
+    Four volNo,			/* IN volume */
+    char *name)			/* IN file name of the store */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    PageNo p;			/* page number */
+    BufferStore *store;		/* slot of the store */
+    Four numDevices;		/* # of devices of the volume */
+    int fds[RDSM_MAX_DEVICES];	/* descriptor of each device */
+    PageNo firstPage[RDSM_MAX_DEVICES+1]; /* first page of each device */
+
+
+    if (name == NULL || strlen(name) >= BFM_STORE_NAME_SIZE || edubfm_FindStore(volNo) != NULL)
+	ERR(eBADPARAMETER);
+
+    for (i = 0; i < BFM_MAX_STORES && bfmStores[i].volNo != NIL; i++) ;
+    if (i == BFM_MAX_STORES) ERR(eBADPARAMETER);
+    store = &bfmStores[i];
+
+    e = EduRDsM_GetDevices(volNo, &numDevices, fds, firstPage);
+    if (e < eNOERROR) ERR(e);
+    if (numDevices > BFM_MAX_DEVICES) ERR(eBADPARAMETER);
+
+    memset(store, 0, sizeof(BufferStore));
+    store->volNo = NIL;
+    strcpy(store->name, name);
+    store->numDevices = numDevices;
+    for (i = 0; i < numDevices; i++) {
+	store->devFd[i] = fds[i];
+	store->firstPage[i] = firstPage[i];
+    }
+    store->firstPage[i] = firstPage[i];
+
+    store->stats.nPages = store->firstPage[store->numDevices];
+    store->pages = malloc(MAX(store->stats.nPages, 1) * sizeof(BufferStored));
+    if (store->pages == NULL) ERR(eMEMORYALLOCERR);
+    for (p = 0; p < store->stats.nPages; p++) store->pages[p].offset = -1;
+
+    store->fd = open(store->name, O_RDWR | O_CREAT, 0644);
+    if (store->fd < 0) {
+	free(store->pages);
+	ERR(eDEVICEOPENFAIL_RDSM);
+    }
+
+    e = edubfm_LoadStore(store);
+    if (e < eNOERROR) {
+	close(store->fd);
+	free(store->pages);
+	ERR(e);
+    }
+
+    BFM_STORE(&store->volNo, volNo);
+
+    return(eNOERROR);
+
+} /* edubfm_AttachStore() */
+
+
+
+/*@================================
+ * edubfm_DetachStore()
+ *================================*/
+/*
+ * Function: Four edubfm_DetachStore(Four, Boolean)
+ *
+ * Description:
+ *  Close the compressed page store of the volume 'volNo', if any. With
+ *  'restore', the pages of the store are written back to their home and
+ *  the store is removed; otherwise the store is kept, compacted first if
+ *  it holds as many bytes of replaced images as of current ones.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_DetachStore(
+    Four volNo,			/* IN volume */
+    Boolean restore)		/* IN TRUE to put the pages back to their home */
+{
+    Four e;			/* error */
+    PageNo p;			/* page number */
+    BufferStore *store;		/* store of the volume */
+    long long nBytes;		/* # of bytes of the current records */
+
+
+    store = edubfm_FindStore(volNo);
+    if (store == NULL) return(eNOERROR);
+
+    if (restore) {
+	for (p = 0; p < store->stats.nPages; p++) {
+	    if (store->pages[p].offset < 0) continue;
+	    e = edubfm_PutHome(store, p);
+	    if (e < eNOERROR) ERR(e);
+	}
+	(void) unlink(store->name);
+    }
+    else {
+	nBytes = sizeof(BufferStoreHeader) + store->stats.nStoredBytes +
+		 (long long)store->stats.nStoredPages * sizeof(BufferStoreRecord);
+	if (store->end - nBytes >= nBytes) {
+	    e = edubfm_CompactStore(store);
+	    if (e < eNOERROR) ERR(e);
+	}
+    }
+
+    close(store->fd);
+    free(store->pages);
+    store->pages = NULL;
+    BFM_STORE(&store->volNo, NIL);
+
+    return(eNOERROR);
+
+} /* edubfm_DetachStore() */
+
+
+
+/*@================================
+ * edubfm_HasStore()
+ *================================*/
+/*
+ * Function: Boolean edubfm_HasStore(Four)
+ *
+ * Description:
+ *  Tell whether the volume 'volNo' has a compressed page store. The caller
+ *  need not hold edubfm_ioMutex.
+ *
+ * Returns:
+ *  TRUE if the volume has a store
+ */
+Boolean edubfm_HasStore(
+    Four volNo)			/* IN volume */
+{
+    return((edubfm_FindStore(volNo) != NULL) ? TRUE : FALSE);
+
+} /* edubfm_HasStore() */
+
+
+
+/*@================================
+ * edubfm_ReadStored()
+ *================================*/
+/*
+ * Function: Four edubfm_ReadStored(TrainID*, char*, Four)
+ *
+ * Description:
+ *  Read the train 'trainId' of the buffer type 'type' into 'aTrain' if
+ *  some of its pages are in the compressed page store of its volume: the
+ *  train is read from its home and its stored pages are decompressed over
+ *  it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *  BFM_NOT_STORED if no page of the train is in a store
+ */
+Four edubfm_ReadStored(
+    TrainID *trainId,		/* IN train to read */
+    char *aTrain,		/* OUT frame receiving the train */
+    Four type)			/* IN buffer type */
+{
+    Four e;			/* error */
+    Four k;			/* index of a page of the train */
+    Four nStored;		/* # of pages of the train in the store */
+    BufferStore *store;		/* store of the volume */
+
+
+    store = edubfm_FindStore(trainId->volNo);
+    if (store == NULL) return(BFM_NOT_STORED);
+
+    for (k = 0, nStored = 0; k < BI_BUFSIZE(type); k++)
+	if (trainId->pageNo + k < store->stats.nPages && store->pages[trainId->pageNo + k].offset >= 0) nStored++;
+    if (nStored == 0) return(BFM_NOT_STORED);
+
+    if (nStored < BI_BUFSIZE(type)) {
+	e = RDsM_ReadTrain(trainId, aTrain, BI_BUFSIZE(type));
+	if (e < eNOERROR) ERR(e);
+    }
+
+    for (k = 0; k < BI_BUFSIZE(type); k++) {
+	if (trainId->pageNo + k >= store->stats.nPages || store->pages[trainId->pageNo + k].offset < 0) continue;
+	e = edubfm_ReadImage(store, trainId->pageNo + k, aTrain + (size_t)k * PAGESIZE);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    store->stats.nReads += nStored;
+
+    return(eNOERROR);
+
+} /* edubfm_ReadStored() */
+
+
+
+/*@================================
+ * edubfm_WriteStored()
+ *================================*/
+/*
+ * Function: Four edubfm_WriteStored(TrainID*, char*, Four)
+ *
+ * Description:
+ *  Write out the train 'trainId' of the buffer type 'type' held by
+ *  'aTrain' if its volume has a compressed page store: a slotted page
+ *  which compresses well is appended to the store, any other train is
+ *  written to its home, and its pages are marked so in the store.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *  BFM_NOT_STORED if the volume has no store
+ */
+Four edubfm_WriteStored(
+    TrainID *trainId,		/* IN train to write */
+    char *aTrain,		/* IN frame holding the train */
+    Four type)			/* IN buffer type */
+{
+    Four e;			/* error */
+    Four k;			/* index of a page of the train */
+    Four length;		/* # of bytes of the compressed image */
+    Boolean atHome;		/* TRUE if the page was at its home */
+    BufferStore *store;		/* store of the volume */
+    char image[PAGESIZE];	/* compressed image of the page */
+
+
+    store = edubfm_FindStore(trainId->volNo);
+    if (store == NULL) return(BFM_NOT_STORED);
+    if (trainId->pageNo < 0 || trainId->pageNo + BI_BUFSIZE(type) > store->stats.nPages) ERR(eBADPARAMETER);
+
+    /*@ append a slotted page which compresses well to the store */
+    if (BI_BUFSIZE(type) == 1 &&
+	(((Page *)aTrain)->header.flags & PAGE_TYPE_VECTOR_MASK) == SLOTTED_PAGE_TYPE) {
+	length = edubfm_LZCompress(aTrain, PAGESIZE, image, PAGESIZE - BFM_STORE_MIN_SAVING);
+	if (length > 0) {
+	    atHome = (store->pages[trainId->pageNo].offset < 0) ? TRUE : FALSE;
+	    e = edubfm_AppendRecord(store, trainId->pageNo, image, length);
+	    if (e < eNOERROR) ERR(e);
+	    if (atHome) edubfm_PunchHome(store, trainId->pageNo);
+	    store->stats.nWrites++;
+	    return(eNOERROR);
+	}
+    }
+
+    /*@ write any other train to its home */
+    e = RDsM_WriteTrain(aTrain, trainId, BI_BUFSIZE(type));
+    if (e < eNOERROR) ERR(e);
+    store->stats.nHomeWrites += BI_BUFSIZE(type);
+
+    for (k = 0; k < BI_BUFSIZE(type); k++) {
+	if (store->pages[trainId->pageNo + k].offset < 0) continue;
+	e = edubfm_AppendRecord(store, trainId->pageNo + k, NULL, 0);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* edubfm_WriteStored() */
+
+
+
+/*@================================
+ * edubfm_DropStored()
+ *================================*/
+/*
+ * Function: Four edubfm_DropStored(TrainID*, Four)
+ *
+ * Description:
+ *  Put the pages of the train 'trainId' of the buffer type 'type' found in
+ *  the compressed page store of its volume back to their home, before the
+ *  train is written there by another layer.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_DropStored(
+    TrainID *trainId,		/* IN train */
+    Four type)			/* IN buffer type */
+{
+    Four e;			/* error */
+    Four k;			/* index of a page of the train */
+    BufferStore *store;		/* store of the volume */
+
+
+    store = edubfm_FindStore(trainId->volNo);
+    if (store == NULL) return(eNOERROR);
+
+    for (k = 0; k < BI_BUFSIZE(type); k++) {
+	if (trainId->pageNo + k >= store->stats.nPages || store->pages[trainId->pageNo + k].offset < 0) continue;
+	e = edubfm_PutHome(store, trainId->pageNo + k);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* edubfm_DropStored() */
+
+
+
+/*@================================
+ * edubfm_GetStoreStatistics()
+ *================================*/
+/*
+ * Function: Four edubfm_GetStoreStatistics(Four, BfM_CompressionStatistics*)
+ *
+ * Description:
+ *  Return the statistics of the compressed page store of the volume
+ *  'volNo'.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four edubfm_GetStoreStatistics(
+    Four volNo,			/* IN volume */
+    BfM_CompressionStatistics *stats) /* OUT statistics of the store */
+{
+    BufferStore *store;		/* store of the volume */
+
+
+    store = edubfm_FindStore(volNo);
+    if (store == NULL || stats == NULL) ERR(eBADPARAMETER);
+
+    *stats = store->stats;
+    stats->storeSize = store->end;
+
+    return(eNOERROR);
+
+} /* edubfm_GetStoreStatistics() */
+
+
+
+/*
+ * Function: BufferStore *edubfm_FindStore(Four)
+ *
+ * Description:
+ *  Return the compressed page store of the volume 'volNo', or NULL.
+ */
+static BufferStore *edubfm_FindStore(
+    Four volNo)			/* IN volume */
+{
+    Four i;			/* index */
+
+
+    if (volNo == NIL) return(NULL);
+
+    for (i = 0; i < BFM_MAX_STORES; i++)
+	if (BFM_LOAD(&bfmStores[i].volNo) == volNo) return(&bfmStores[i]);
+
+    return(NULL);
+
+} /* edubfm_FindStore() */
+
+
+
+/*
+ * Function: Four edubfm_LoadStore(BufferStore*)
+ *
+ * Description:
+ *  Write the header of the new store 'store', or check the header of an
+ *  existing one and locate the pages of its records. A record torn by a
+ *  crash, and what follows it, are cut off.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eREADFAIL_RDSM
+ *    eWRITEFAIL_RDSM
+ */
+static Four edubfm_LoadStore(
+    BufferStore *store)		/* INOUT store */
+{
+    struct stat st;		/* status of the store */
+    long long offset;		/* offset of the current record */
+    BufferStoreHeader header;	/* header of the store */
+    BufferStoreRecord rec;	/* header of the current record */
+
+
+    if (fstat(store->fd, &st) < 0) ERR(eREADFAIL_RDSM);
+
+    /*@ a new store */
+    if (st.st_size == 0) {
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, BFM_STORE_MAGIC, sizeof(header.magic));
+	header.pageSize = PAGESIZE;
+	header.nPages = store->stats.nPages;
+	if (pwrite(store->fd, &header, sizeof(header), 0) != sizeof(header)) ERR(eWRITEFAIL_RDSM);
+	store->end = sizeof(header);
+	return(eNOERROR);
+    }
+
+    /*@ an existing store */
+    if (pread(store->fd, &header, sizeof(header), 0) != sizeof(header)) ERR(eREADFAIL_RDSM);
+    if (memcmp(header.magic, BFM_STORE_MAGIC, sizeof(header.magic)) != 0 ||
+	header.pageSize != PAGESIZE || header.nPages != store->stats.nPages) ERR(eBADPARAMETER);
+
+    for (offset = sizeof(header); offset + (long long)sizeof(rec) <= st.st_size; ) {
+	if (pread(store->fd, &rec, sizeof(rec), offset) != sizeof(rec)) ERR(eREADFAIL_RDSM);
+	if (rec.check != (Two)~rec.length || rec.length < 0 || rec.length >= PAGESIZE ||
+	    rec.pageNo < 0 || rec.pageNo >= store->stats.nPages ||
+	    offset + (long long)sizeof(rec) + rec.length > st.st_size) break;
+	edubfm_SetLocation(store, rec.pageNo, (rec.length > 0) ? offset + (long long)sizeof(rec) : -1, rec.length);
+	offset += sizeof(rec) + rec.length;
+    }
+
+    if (offset != st.st_size && ftruncate(store->fd, offset) < 0) ERR(eWRITEFAIL_RDSM);
+    store->end = offset;
+
+    return(eNOERROR);
+
+} /* edubfm_LoadStore() */
+
+
+
+/*
+ * Function: void edubfm_SetLocation(BufferStore*, PageNo, long long, Four)
+ *
+ * Description:
+ *  Locate the page 'pageNo' of the store 'store' at the image of 'length'
+ *  bytes at 'offset' of the store, or at its home if 'offset' is -1.
+ */
+static void edubfm_SetLocation(
+    BufferStore *store,		/* INOUT store */
+    PageNo pageNo,		/* IN page */
+    long long offset,		/* IN offset of the image, -1 for the home */
+    Four length)		/* IN # of bytes of the image */
+{
+    BufferStored *loc = &store->pages[pageNo]; /* location of the page */
+
+
+    if (loc->offset >= 0) {
+	store->stats.nStoredPages--;
+	store->stats.nStoredBytes -= loc->length;
+    }
+
+    loc->offset = offset;
+    loc->length = (offset >= 0) ? length : 0;
+
+    if (loc->offset >= 0) {
+	store->stats.nStoredPages++;
+	store->stats.nStoredBytes += loc->length;
+    }
+
+} /* edubfm_SetLocation() */
+
+
+
+/*
+ * Function: Four edubfm_AppendRecord(BufferStore*, PageNo, char*, Four)
+ *
+ * Description:
+ *  Append to the store 'store' the record of the page 'pageNo' with its
+ *  image 'image' of 'length' bytes, or with no image if 'length' is 0,
+ *  and locate the page there.
+ *
+ * Returns:
+ *  error code
+ *    eWRITEFAIL_RDSM
+ */
+static Four edubfm_AppendRecord(
+    BufferStore *store,		/* INOUT store */
+    PageNo pageNo,		/* IN page */
+    char *image,		/* IN compressed image */
+    Four length)		/* IN # of bytes of the image, 0 for none */
+{
+    BufferStoreRecord *rec;	/* header of the record */
+    char buf[sizeof(BufferStoreRecord) + PAGESIZE]; /* the record */
+
+
+    rec = (BufferStoreRecord *)buf;
+    rec->pageNo = pageNo;
+    rec->length = length;
+    rec->check = ~length;
+    if (length > 0) memcpy(buf + sizeof(BufferStoreRecord), image, length);
+
+    /* the header and the image are written at once, so a torn record is found short */
+    if (pwrite(store->fd, buf, sizeof(BufferStoreRecord) + length, store->end) != (ssize_t)(sizeof(BufferStoreRecord) + length))
+	ERR(eWRITEFAIL_RDSM);
+
+    edubfm_SetLocation(store, pageNo, (length > 0) ? store->end + (long long)sizeof(BufferStoreRecord) : -1, length);
+    store->end += sizeof(BufferStoreRecord) + length;
+
+    return(eNOERROR);
+
+} /* edubfm_AppendRecord() */
+
+
+
+/*
+ * Function: Four edubfm_ReadImage(BufferStore*, PageNo, char*)
+ *
+ * Description:
+ *  Read the image of the stored page 'pageNo' of the store 'store' and
+ *  decompress it into 'aPage'.
+ *
+ * Returns:
+ *  error code
+ *    eREADFAIL_RDSM
+ */
+static Four edubfm_ReadImage(
+    BufferStore *store,		/* IN store */
+    PageNo pageNo,		/* IN stored page */
+    char *aPage)		/* OUT page decompressed */
+{
+    BufferStored *loc = &store->pages[pageNo]; /* location of the page */
+    char image[PAGESIZE];	/* compressed image */
+
+
+    if (pread(store->fd, image, loc->length, loc->offset) != loc->length ||
+	edubfm_LZDecompress(image, loc->length, aPage, PAGESIZE) != PAGESIZE)
+	ERR(eREADFAIL_RDSM);
+
+    return(eNOERROR);
+
+} /* edubfm_ReadImage() */
+
+
+
+/*
+ * Function: Four edubfm_PutHome(BufferStore*, PageNo)
+ *
+ * Description:
+ *  Write the stored page 'pageNo' of the store 'store' to its home and
+ *  mark it so in the store.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_PutHome(
+    BufferStore *store,		/* INOUT store */
+    PageNo pageNo)		/* IN stored page */
+{
+    Four e;			/* error */
+    TrainID pid;		/* the page */
+    char *aPage;		/* page decompressed, aligned for the direct I/O */
+    char buf[2 * PAGESIZE];	/* room for 'aPage' */
+
+
+    aPage = (char *)(((size_t)buf + PAGESIZE - 1) & ~(size_t)(PAGESIZE - 1));
+
+    e = edubfm_ReadImage(store, pageNo, aPage);
+    if (e < eNOERROR) ERR(e);
+
+    MAKE_PAGEID(pid, BFM_LOAD(&store->volNo), pageNo);
+    e = RDsM_WriteTrain(aPage, &pid, PAGE_BUF_TRAIN_SIZE);
+    if (e < eNOERROR) ERR(e);
+    store->stats.nHomeWrites++;
+
+    e = edubfm_AppendRecord(store, pageNo, NULL, 0);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubfm_PutHome() */
+
+
+
+/*
+ * Function: Four edubfm_CompactStore(BufferStore*)
+ *
+ * Description:
+ *  Rewrite the store 'store' with the current images only. The new store
+ *  is written aside and renamed over the old one, so a crash leaves one
+ *  of them complete.
+ *
+ * Returns:
+ *  error code
+ *    eDEVICEOPENFAIL_RDSM
+ *    eWRITEFAIL_RDSM
+ *    some errors caused by function calls
+ */
+static Four edubfm_CompactStore(
+    BufferStore *store)		/* INOUT store */
+{
+    Four e;			/* error */
+    PageNo p;			/* page number */
+    int fd;			/* descriptor of the new store */
+    long long end;		/* end of the new store */
+    BufferStored *loc;		/* location of a page */
+    BufferStoreHeader header;	/* header of the store */
+    BufferStoreRecord *rec;	/* header of a record */
+    char name[BFM_STORE_NAME_SIZE + 8]; /* file name of the new store */
+    char buf[sizeof(BufferStoreRecord) + PAGESIZE]; /* a record */
+
+
+    sprintf(name, "%s.tmp", store->name);
+    fd = open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) ERR(eDEVICEOPENFAIL_RDSM);
+
+    e = eNOERROR;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BFM_STORE_MAGIC, sizeof(header.magic));
+    header.pageSize = PAGESIZE;
+    header.nPages = store->stats.nPages;
+    if (pwrite(fd, &header, sizeof(header), 0) != sizeof(header)) e = eWRITEFAIL_RDSM;
+
+    /* the records are copied, the pages are located in the new store once it is complete */
+    rec = (BufferStoreRecord *)buf;
+    for (p = 0, end = sizeof(header); p < store->stats.nPages && e >= eNOERROR; p++) {
+	loc = &store->pages[p];
+	if (loc->offset < 0) continue;
+	rec->pageNo = p;
+	rec->length = loc->length;
+	rec->check = ~loc->length;
+	if (pread(store->fd, buf + sizeof(BufferStoreRecord), loc->length, loc->offset) != loc->length)
+	    e = eREADFAIL_RDSM;
+	else if (pwrite(fd, buf, sizeof(BufferStoreRecord) + loc->length, end) != (ssize_t)(sizeof(BufferStoreRecord) + loc->length))
+	    e = eWRITEFAIL_RDSM;
+	end += sizeof(BufferStoreRecord) + loc->length;
+    }
+
+    if (e >= eNOERROR && (fsync(fd) < 0 || rename(name, store->name) < 0)) e = eWRITEFAIL_RDSM;
+    if (e < eNOERROR) {
+	close(fd);
+	(void) unlink(name);
+	ERR(e);
+    }
+
+    /*@ locate the pages in the new store */
+    for (p = 0, end = sizeof(header); p < store->stats.nPages; p++) {
+	loc = &store->pages[p];
+	if (loc->offset < 0) continue;
+	loc->offset = end + sizeof(BufferStoreRecord);
+	end += sizeof(BufferStoreRecord) + loc->length;
+    }
+
+    close(store->fd);
+    store->fd = fd;
+    store->end = end;
+
+    return(eNOERROR);
+
+} /* edubfm_CompactStore() */
+
+
+
+/*
+ * Function: void edubfm_PunchHome(BufferStore*, PageNo)
+ *
+ * Description:
+ *  Make the home of the page 'pageNo' of the volume of 'store' a hole of
+ *  its device, so that the page takes no room there while it is stored.
+ *  Nothing is done if the device does not support holes.
+ */
+static void edubfm_PunchHome(
+    BufferStore *store,		/* IN store of the volume */
+    PageNo pageNo)		/* IN stored page */
+{
+    Four d;			/* device of the page */
+
+
+    for (d = 0; d < store->numDevices - 1 && pageNo >= store->firstPage[d+1]; d++) ;
+    if (store->devFd[d] < 0) return;
+
+    (void) fallocate(store->devFd[d], FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+		     (off_t)(pageNo - store->firstPage[d]) * PAGESIZE, PAGESIZE);
+
+} /* edubfm_PunchHome() */
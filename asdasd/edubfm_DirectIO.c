@@ -0,0 +1,387 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_DirectIO.c
+ *
+ * Description:
+ *  Direct I/O of the volumes.
+ *  The COSMOS object opens the devices of the volumes with open64() and
+ *  reads and writes their trains with read() and write(); for the in-tree
+ *  buffer manager, the Makefile redirects these calls of cosmos_nobfm.o to
+ *  the functions below. When the parameter 'directIO' is set, the
+ *  descriptors are given O_DIRECT so that the trains are cached in the
+ *  buffer pool only, and not a second time in the page cache of the OS.
+ *
+ *  The frames are aligned to PAGESIZE, a multiple of the logical block size
+ *  of the devices, so the trains go between the device and the frames
+ *  without a copy. A request whose buffer, size or offset is not aligned
+ *  (e.g. the volume header read into a variable) is done with O_DIRECT
+ *  cleared for its duration. A descriptor on which O_DIRECT is refused,
+ *  when it is set or at the first aligned transfer, keeps using the page
+ *  cache.
+ *  While a train is located for the mmap read path or the asynchronous
+ *  writes, the reads are also reported to edubfm_ProbeRead().
+ *
+ * Exports:
+ *  int edubfm_Open(const char*, int, ...)
+ *  int edubfm_Close(int)
+ *  ssize_t edubfm_Read(int, void*, size_t)
+ *  ssize_t edubfm_Write(int, const void*, size_t)
+ *  void edubfm_SetDirectIO(Four)
+ *  void edubfm_GetDirectIOStatistics(Four*, Four*)
+ */
+
+
+#define _GNU_SOURCE
+#define _FILE_OFFSET_BITS 64
+
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* state of a descriptor */
+#define BFM_FD_UNUSED           0       /* not a device opened by the COSMOS object */
+#define BFM_FD_BUFFERED         1       /* device accessed through the page cache */
+#define BFM_FD_DIRECT           2       /* device accessed with O_DIRECT */
+#define BFM_FD_REFUSED          3       /* device on which O_DIRECT was refused */
+
+#define BFM_IS_ALIGNED(x)       (((size_t)(x) & (PAGESIZE - 1)) == 0)
+
+static One bfmFdState[BFM_MAX_FDS];     /* state of each descriptor */
+static Four bfmNumDirectIOs;            /* # of transfers done with O_DIRECT */
+static Four bfmNumBufferedIOs;          /* # of transfers of O_DIRECT descriptors done through the page cache */
+
+static Boolean edubfm_SetDirectFlag(int, Boolean);
+static Boolean edubfm_IsAlignedRequest(int, const void*, size_t);
+
+
+
+/*@================================
+ * edubfm_Open()
+ *================================*/
+/*
+ * Function: int edubfm_Open(const char*, int, ...)
+ *
+ * Description:
+ *  open64() of the COSMOS object. A regular file or block device opened is
+ *  given O_DIRECT if the parameter 'directIO' is set; it is opened without
+ *  O_DIRECT if the file system refuses it.
+ *
+ * Returns:
+ *  the descriptor, or -1 with errno set
+ */
+int edubfm_Open(
+    const char *path,		/* IN file to open */
+    int flags,			/* IN flags of open64() */
+    ...)			/* IN mode of a created file */
+{
+    int fd;			/* descriptor */
+    mode_t mode;		/* mode of a created file */
+    va_list ap;			/* variable arguments */
+    struct stat st;		/* status of the file */
+
+
+    mode = 0;
+    if (flags & O_CREAT) {
+	va_start(ap, flags);
+	mode = va_arg(ap, mode_t);
+	va_end(ap);
+    }
+
+    fd = open(path, flags, mode);
+    if (fd < 0 || fd >= BFM_MAX_FDS) return(fd);
+
+    bfmFdState[fd] = BFM_FD_UNUSED;
+    if (fstat(fd, &st) == 0 && (S_ISREG(st.st_mode) || S_ISBLK(st.st_mode))) {
+	bfmFdState[fd] = BFM_FD_BUFFERED;
+	if (edubfm_params.directIO) (void) edubfm_SetDirectFlag(fd, TRUE);
+    }
+
+    return(fd);
+
+} /* edubfm_Open() */
+
+
+
+/*@================================
+ * edubfm_Close()
+ *================================*/
+/*
+ * Function: int edubfm_Close(int)
+ *
+ * Description:
+ *  close() of the COSMOS object.
+ *
+ * Returns:
+ *  the result of close()
+ */
+int edubfm_Close(
+    int fd)			/* IN descriptor to close */
+{
+    if (fd >= 0 && fd < BFM_MAX_FDS) bfmFdState[fd] = BFM_FD_UNUSED;
+
+    return(close(fd));
+
+} /* edubfm_Close() */
+
+
+
+/*@================================
+ * edubfm_Read()
+ *================================*/
+/*
+ * Function: ssize_t edubfm_Read(int, void*, size_t)
+ *
+ * Description:
+ *  read() of the COSMOS object. On a descriptor with O_DIRECT, an aligned
+ *  request is read directly into 'buf'; an unaligned one, or one refused
+ *  with EINVAL, is read through the page cache.
+ *
+ * Returns:
+ *  the result of read()
+ */
+ssize_t edubfm_Read(
+    int fd,			/* IN descriptor */
+    void *buf,			/* OUT buffer */
+    size_t count)		/* IN # of bytes to read */
+{
+    ssize_t n;			/* # of bytes read */
+
+
+    if (edubfm_mapProbing) edubfm_ProbeRead(fd, count);
+
+    if (fd < 0 || fd >= BFM_MAX_FDS || bfmFdState[fd] != BFM_FD_DIRECT) return(read(fd, buf, count));
+
+    if (BFM_IS_ALIGNED(buf) && BFM_IS_ALIGNED(count)) {
+	n = read(fd, buf, count);
+	if (n >= 0 || errno != EINVAL) {
+	    bfmNumDirectIOs++;
+	    return(n);
+	}
+	/* refused by the file system if the offset was aligned */
+	if (edubfm_IsAlignedRequest(fd, buf, count)) {
+	    (void) edubfm_SetDirectFlag(fd, FALSE);
+	    bfmFdState[fd] = BFM_FD_REFUSED;
+	    return(read(fd, buf, count));
+	}
+    }
+
+    bfmNumBufferedIOs++;
+    (void) edubfm_SetDirectFlag(fd, FALSE);
+    n = read(fd, buf, count);
+    (void) edubfm_SetDirectFlag(fd, TRUE);
+
+    return(n);
+
+} /* edubfm_Read() */
+
+
+
+/*@================================
+ * edubfm_Write()
+ *================================*/
+/*
+ * Function: ssize_t edubfm_Write(int, const void*, size_t)
+ *
+ * Description:
+ *  write() of the COSMOS object. On a descriptor with O_DIRECT, an aligned
+ *  request is written directly from 'buf'; an unaligned one, or one
+ *  refused with EINVAL, is written through the page cache.
+ *
+ * Returns:
+ *  the result of write()
+ */
+ssize_t edubfm_Write(
+    int fd,			/* IN descriptor */
+    const void *buf,		/* IN buffer */
+    size_t count)		/* IN # of bytes to write */
+{
+    ssize_t n;			/* # of bytes written */
+
+
+    if (fd < 0 || fd >= BFM_MAX_FDS || bfmFdState[fd] != BFM_FD_DIRECT) return(write(fd, buf, count));
+
+    if (BFM_IS_ALIGNED(buf) && BFM_IS_ALIGNED(count)) {
+	n = write(fd, buf, count);
+	if (n >= 0 || errno != EINVAL) {
+	    bfmNumDirectIOs++;
+	    return(n);
+	}
+	/* refused by the file system if the offset was aligned */
+	if (edubfm_IsAlignedRequest(fd, buf, count)) {
+	    (void) edubfm_SetDirectFlag(fd, FALSE);
+	    bfmFdState[fd] = BFM_FD_REFUSED;
+	    return(write(fd, buf, count));
+	}
+    }
+
+    bfmNumBufferedIOs++;
+    (void) edubfm_SetDirectFlag(fd, FALSE);
+    n = write(fd, buf, count);
+    (void) edubfm_SetDirectFlag(fd, TRUE);
+
+    return(n);
+
+} /* edubfm_Write() */
+
+
+
+/*@================================
+ * edubfm_SetDirectIO()
+ *================================*/
+/*
+ * Function: void edubfm_SetDirectIO(Four)
+ *
+ * Description:
+ *  Set (directIO == TRUE) or clear O_DIRECT on the devices already opened.
+ *  The pages of a device cached by the OS are not used by the direct
+ *  transfers; the kernel writes out the dirty ones before a direct
+ *  transfer overlapping them.
+ */
+void edubfm_SetDirectIO(
+    Four directIO)		/* IN TRUE to use O_DIRECT */
+{
+    int fd;			/* descriptor */
+
+
+    for (fd = 0; fd < BFM_MAX_FDS; fd++) {
+	if (directIO && bfmFdState[fd] == BFM_FD_BUFFERED) (void) edubfm_SetDirectFlag(fd, TRUE);
+	else if (!directIO && bfmFdState[fd] == BFM_FD_DIRECT) {
+	    (void) edubfm_SetDirectFlag(fd, FALSE);
+	    bfmFdState[fd] = BFM_FD_BUFFERED;
+	}
+    }
+
+} /* edubfm_SetDirectIO() */
+
+
+
+/*@================================
+ * edubfm_GetDirectIOStatistics()
+ *================================*/
+/*
+ * Function: void edubfm_GetDirectIOStatistics(Four*, Four*)
+ *
+ * Description:
+ *  Return the # of transfers done with O_DIRECT and the # of those of
+ *  descriptors with O_DIRECT which went through the page cache.
+ */
+void edubfm_GetDirectIOStatistics(
+    Four *nDirectIOs,		/* OUT # of transfers done with O_DIRECT */
+    Four *nBufferedIOs)		/* OUT # of unaligned transfers */
+{
+    *nDirectIOs = bfmNumDirectIOs;
+    *nBufferedIOs = bfmNumBufferedIOs;
+
+} /* edubfm_GetDirectIOStatistics() */
+
+
+
+/*
+ * Function: Boolean edubfm_SetDirectFlag(int, Boolean)
+ *
+ * Description:
+ *  Set or clear O_DIRECT on 'fd'. Setting it, the descriptor becomes
+ *  BFM_FD_DIRECT, or BFM_FD_REFUSED if the file system refuses it.
+ *
+ * Returns:
+ *  TRUE if the flag has been changed
+ */
+static Boolean edubfm_SetDirectFlag(
+    int fd,			/* IN descriptor */
+    Boolean on)			/* IN TRUE to set O_DIRECT */
+{
+    int flags;			/* status flags of the descriptor */
+
+
+    flags = fcntl(fd, F_GETFL);
+    if (flags < 0) return(FALSE);
+
+    flags = on ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+    if (fcntl(fd, F_SETFL, flags) < 0) {
+	if (on && bfmFdState[fd] == BFM_FD_BUFFERED) bfmFdState[fd] = BFM_FD_REFUSED;
+	return(FALSE);
+    }
+
+    if (on && bfmFdState[fd] == BFM_FD_BUFFERED) bfmFdState[fd] = BFM_FD_DIRECT;
+
+    return(TRUE);
+
+} /* edubfm_SetDirectFlag() */
+
+
+
+/*
+ * Function: Boolean edubfm_IsAlignedRequest(int, const void*, size_t)
+ *
+ * Description:
+ *  Check whether a transfer of 'count' bytes between 'buf' and the current
+ *  offset of 'fd' meets the alignment of O_DIRECT.
+ *
+ * Returns:
+ *  TRUE if the buffer, the size and the offset are aligned
+ */
+static Boolean edubfm_IsAlignedRequest(
+    int fd,			/* IN descriptor */
+    const void *buf,		/* IN buffer */
+    size_t count)		/* IN # of bytes */
+{
+    off_t offset;		/* current offset of the descriptor */
+
+
+    offset = lseek(fd, 0, SEEK_CUR);
+
+    return(offset >= 0 && BFM_IS_ALIGNED(buf) && BFM_IS_ALIGNED(count) && BFM_IS_ALIGNED(offset));
+
+} /* edubfm_IsAlignedRequest() */
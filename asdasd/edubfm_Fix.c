@@ -0,0 +1,156 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Fix.c
+ *
+ * Description:
+ *  Atomic updates of the fix counts of the frames.
+ *  A frame is fixed without the mutex of its partition by incrementing its
+ *  fix count unless it is claimed, and it is claimed, under the mutex, by
+ *  swapping a zero fix count to BFM_CLAIMED. Hence a frame is either
+ *  claimed by one thread, which may give it another train, or fixed by any
+ *  number of threads, which may use its train, but never both.
+ *
+ * Exports:
+ *  Boolean edubfm_TryFix(BufferTable*)
+ *  Boolean edubfm_Claim(BufferTable*)
+ *  Boolean edubfm_Unfix(BufferTable*)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * edubfm_TryFix()
+ *================================*/
+/*
+ * Function: Boolean edubfm_TryFix(BufferTable*)
+ *
+ * Description:
+ *  Increment the fix count of the frame 'entry' unless it is claimed.
+ *
+ * Returns:
+ *  TRUE if the frame is fixed
+ */
+Boolean edubfm_TryFix(
+    BufferTable *entry)		/* IN buffer table entry of the frame */
+{
+    Two fixed;			/* current fix count */
+
+
+    fixed = BFM_LOAD(&entry->fixed);
+    while (fixed >= 0) {
+	if (__atomic_compare_exchange_n(&entry->fixed, &fixed, fixed + 1, FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	    return(TRUE);
+    }
+
+    return(FALSE);
+
+} /* edubfm_TryFix() */
+
+
+
+/*@================================
+ * edubfm_Claim()
+ *================================*/
+/*
+ * Function: Boolean edubfm_Claim(BufferTable*)
+ *
+ * Description:
+ *  Claim the frame 'entry' if it is not fixed. The caller holds the mutex
+ *  of the partition of the frame and releases the claim by storing a fix
+ *  count with BFM_STORE() before it releases the mutex.
+ *
+ * Returns:
+ *  TRUE if the frame is claimed
+ */
+Boolean edubfm_Claim(
+    BufferTable *entry)		/* IN buffer table entry of the frame */
+{
+    Two fixed;			/* expected fix count */
+
+
+    fixed = 0;
+
+    return(__atomic_compare_exchange_n(&entry->fixed, &fixed, BFM_CLAIMED, FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+} /* edubfm_Claim() */
+
+
+
+/*@================================
+ * edubfm_Unfix()
+ *================================*/
+/*
+ * Function: Boolean edubfm_Unfix(BufferTable*)
+ *
+ * Description:
+ *  Decrement the fix count of the frame 'entry' if it is fixed.
+ *
+ * Returns:
+ *  FALSE if the frame was not fixed
+ */
+Boolean edubfm_Unfix(
+    BufferTable *entry)		/* IN buffer table entry of the frame */
+{
+    Two fixed;			/* current fix count */
+
+
+    fixed = BFM_LOAD(&entry->fixed);
+    while (fixed > 0) {
+	if (__atomic_compare_exchange_n(&entry->fixed, &fixed, fixed - 1, FALSE, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+	    return(TRUE);
+    }
+
+    return(FALSE);
+
+} /* edubfm_Unfix() */
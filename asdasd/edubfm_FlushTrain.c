@@ -0,0 +1,124 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_FlushTrain.c
+ *
+ * Description:
+ *  Write out a dirty train.
+ *
+ * Exports:
+ *  Four edubfm_FlushTrain(Four, Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * edubfm_FlushTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_FlushTrain(Four, Four)
+ *
+ * Description:
+ *  Write out the train held by the frame 'index' of the buffer type 'type'
+ *  and clear its dirty bit. While a transaction may be rolled back, the
+ *  train is saved by the recovery manager instead, unless it is new,
+ *  belongs to a temporary volume or is flagged to be written in place.
+ *  A train of a volume with a compressed page store is written through the
+ *  store (see edubfm_Compress.c).
+ *  The caller holds the mutex of the partition of the frame.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_FlushTrain(
+    Four type,			/* IN buffer type */
+    Four index)			/* IN frame index */
+{
+    Four e;			/* error */
+    BufferTable *entry;		/* buffer table entry of the frame */
+    char *aTrain;		/* frame holding the train */
+
+
+    entry = BI_BUFTABLE_ENTRY(type, index);
+    aTrain = BI_BUFFER(type, index);
+
+    /* the dirty bit is cleared before the write, so that it is set again if
+       the train is modified during the write by a thread which fixed it */
+    BFM_CLEAR_BITS(entry, BFM_DIRTY);
+
+    pthread_mutex_lock(&edubfm_ioMutex);
+
+    if (BFM_IS_WRITTEN_IN_PLACE(entry->key.volNo, entry->bits, aTrain)) {
+	e = edubfm_WriteStored(&entry->key, aTrain, type);
+	if (e == BFM_NOT_STORED) e = RDsM_WriteTrain(aTrain, &entry->key, BI_BUFSIZE(type));
+    }
+    else {
+	/* the recovery manager writes the train to its home */
+	e = RM_SaveTrain(&entry->key, aTrain, BI_BUFSIZE(type));
+	if (e >= eNOERROR) e = edubfm_DropStored(&entry->key, type);
+    }
+
+    pthread_mutex_unlock(&edubfm_ioMutex);
+
+    if (e < eNOERROR) {
+	BFM_SET_BITS(entry, BFM_DIRTY);
+	ERR(e);
+    }
+
+    BFM_CLEAR_BITS(entry, BFM_NEW);
+    BI_PARTITION_OF(type, &entry->key)->stats.nWrites++;
+
+    return(eNOERROR);
+
+} /* edubfm_FlushTrain() */
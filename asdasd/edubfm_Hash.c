@@ -0,0 +1,222 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Hash.c
+ *
+ * Description:
+ *  Hash tables mapping train IDs to frames.
+ *  Each partition of a buffer pool has its own hash table with chaining;
+ *  the chains are linked through the 'nextHashEntry' fields of the buffer
+ *  table entries. The chains are modified under the mutex of the partition
+ *  of the key, and the links are published with release stores so that
+ *  edubfm_LockFreeLookUp() may walk them without the mutex.
+ *
+ * Exports:
+ *  Four edubfm_LookUp(TrainID*, Four)
+ *  Four edubfm_LockFreeLookUp(TrainID*, Four)
+ *  Four edubfm_Insert(TrainID*, Four, Four)
+ *  Four edubfm_Delete(TrainID*, Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * edubfm_LookUp()
+ *================================*/
+/*
+ * Function: Four edubfm_LookUp(TrainID*, Four)
+ *
+ * Description:
+ *  Look up the frame holding the train 'key' in the buffer pool of the
+ *  buffer type 'type'.
+ *
+ * Returns:
+ *  index of the frame, or NIL if the train is not in the buffer
+ */
+Four edubfm_LookUp(
+    TrainID *key,		/* IN train to look up */
+    Four type)			/* IN buffer type */
+{
+    Four i;			/* frame index */
+    BufferPartition *part;	/* partition of the key */
+    BufferTable *entry;		/* a buffer table entry */
+
+
+    part = BI_PARTITION_OF(type, key);
+
+    for (i = part->hashTable[BFM_HASH(key) & part->hashMask]; i != NIL; i = entry->nextHashEntry) {
+	entry = BI_BUFTABLE_ENTRY(type, i);
+	if (EQUAL_PAGEID(entry->key, *key)) return(i);
+    }
+
+    return(NIL);
+
+} /* edubfm_LookUp() */
+
+
+
+/*@================================
+ * edubfm_LockFreeLookUp()
+ *================================*/
+/*
+ * Function: Four edubfm_LockFreeLookUp(TrainID*, Four)
+ *
+ * Description:
+ *  Look up the frame holding the train 'key' without the mutex of its
+ *  partition. The chains may change during the walk: a frame met may be
+ *  moved to another chain or to the free list, so the walk is bounded by
+ *  the number of frames, a train in the buffer may be missed and the
+ *  returned frame may hold another train by the time it is used. The
+ *  caller must fix the frame and check its key again, and fall back to
+ *  edubfm_LookUp() under the mutex when NIL is returned.
+ *
+ * Returns:
+ *  index of a frame whose key was 'key', or NIL
+ */
+Four edubfm_LockFreeLookUp(
+    TrainID *key,		/* IN train to look up */
+    Four type)			/* IN buffer type */
+{
+    Four i;			/* frame index */
+    Four n;			/* # of frames visited */
+    BufferPartition *part;	/* partition of the key */
+    BufferTable *entry;		/* a buffer table entry */
+
+
+    part = BI_PARTITION_OF(type, key);
+
+    i = BFM_LOAD(&part->hashTable[BFM_HASH(key) & part->hashMask]);
+    for (n = 0; i != NIL && n < part->nFrames; n++) {
+	entry = BI_BUFTABLE_ENTRY(type, i);
+	if (EQUAL_PAGEID(entry->key, *key)) return(i);
+	i = BFM_LOAD(&entry->nextHashEntry);
+    }
+
+    return(NIL);
+
+} /* edubfm_LockFreeLookUp() */
+
+
+
+/*@================================
+ * edubfm_Insert()
+ *================================*/
+/*
+ * Function: Four edubfm_Insert(TrainID*, Four, Four)
+ *
+ * Description:
+ *  Insert the frame 'index' holding the train 'key' into the hash table.
+ *
+ * Returns:
+ *  error code
+ *    eBADHASHKEY_BFM
+ */
+Four edubfm_Insert(
+    TrainID *key,		/* IN train held by the frame */
+    Four index,			/* IN frame index */
+    Four type)			/* IN buffer type */
+{
+    BufferPartition *part;	/* partition of the key */
+    Four *head;			/* head of the hash chain */
+
+
+    if (key->pageNo == NIL) ERR(eBADHASHKEY_BFM);
+
+    part = BI_PARTITION_OF(type, key);
+    head = &part->hashTable[BFM_HASH(key) & part->hashMask];
+
+    BFM_STORE(&BI_BUFTABLE_ENTRY(type, index)->nextHashEntry, *head);
+    BFM_STORE(head, index);
+
+    return(eNOERROR);
+
+} /* edubfm_Insert() */
+
+
+
+/*@================================
+ * edubfm_Delete()
+ *================================*/
+/*
+ * Function: Four edubfm_Delete(TrainID*, Four)
+ *
+ * Description:
+ *  Remove the frame holding the train 'key' from the hash table.
+ *
+ * Returns:
+ *  error code
+ *    eNOTFOUND_BFM
+ */
+Four edubfm_Delete(
+    TrainID *key,		/* IN train to remove */
+    Four type)			/* IN buffer type */
+{
+    BufferPartition *part;	/* partition of the key */
+    Four *link;			/* link pointing to the current frame */
+    BufferTable *entry;		/* a buffer table entry */
+
+
+    part = BI_PARTITION_OF(type, key);
+
+    for (link = &part->hashTable[BFM_HASH(key) & part->hashMask]; *link != NIL; link = &entry->nextHashEntry) {
+	entry = BI_BUFTABLE_ENTRY(type, *link);
+	if (EQUAL_PAGEID(entry->key, *key)) {
+	    BFM_STORE(link, entry->nextHashEntry);
+	    BFM_STORE(&entry->nextHashEntry, NIL);
+	    return(eNOERROR);
+	}
+    }
+
+    ERR(eNOTFOUND_BFM);
+
+} /* edubfm_Delete() */
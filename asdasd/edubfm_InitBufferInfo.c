@@ -0,0 +1,346 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_InitBufferInfo.c
+ *
+ * Description:
+ *  Allocation, reset and release of the buffer pool of a buffer type.
+ *
+ * Exports:
+ *  Four edubfm_InitBufferInfo(Four, Four, Four, Four)
+ *  Four edubfm_FinalBufferInfo(Four)
+ *  void edubfm_ResetPartition(Four, BufferPartition*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+
+
+static void edubfm_FreeBufferInfo(Four);
+static char *edubfm_MapPool(BufferInfo*, size_t, Four);
+
+
+
+/*@================================
+ * edubfm_InitBufferInfo()
+ *================================*/
+/*
+ * Function: Four edubfm_InitBufferInfo(Four, Four, Four, Four)
+ *
+ * Description:
+ *  Allocate the buffer pool of the buffer type 'type' with 'nBufs' frames
+ *  of 'bufSize' pages, split into 'nPartitions' partitions. Fewer
+ *  partitions are used if a partition would get less than
+ *  BFM_MIN_PARTITION_BUFS frames. The frames and the run buffer of the
+ *  write-back are aligned to PAGESIZE, for direct I/O, and the frames are
+ *  backed as requested by edubfm_params.hugePages.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ */
+Four edubfm_InitBufferInfo(
+    Four type,			/* IN buffer type */
+    Four bufSize,		/* IN # of pages of a train */
+    Four nBufs,			/* IN # of frames */
+    Four nPartitions)		/* IN # of partitions */
+{
+    Four p;			/* partition index */
+    Four nBuckets;		/* # of hash buckets of a partition */
+    Four firstFrame;		/* first frame of the next partition */
+    BufferInfo *info;		/* the buffer pool */
+    BufferPartition *part;	/* a partition */
+
+
+    info = &edubfm_bufInfo[type];
+
+    if (nPartitions > nBufs / BFM_MIN_PARTITION_BUFS) nPartitions = MAX(1, nBufs / BFM_MIN_PARTITION_BUFS);
+
+    info->bufSize = bufSize;
+    info->nBufs = nBufs;
+    info->nPartitions = nPartitions;
+    info->bufTable = (BufferTable *)malloc(sizeof(BufferTable) * nBufs);
+    info->partitions = (BufferPartition *)calloc(nPartitions, sizeof(BufferPartition));
+    info->bufferPool = edubfm_MapPool(info, (size_t)nBufs * bufSize * PAGESIZE, edubfm_params.hugePages);
+    info->dirty = (BufferDirty *)malloc(sizeof(BufferDirty) * nBufs);
+    if (posix_memalign((void **)&info->runBuffer, PAGESIZE, (size_t)BFM_MAX_RUN * bufSize * PAGESIZE) != 0)
+	info->runBuffer = NULL;
+
+    if (info->bufTable == NULL || info->partitions == NULL || info->bufferPool == NULL ||
+	info->dirty == NULL || info->runBuffer == NULL) {
+	edubfm_FreeBufferInfo(type);
+	ERR(eMEMORYALLOCERR);
+    }
+
+    for (p = 0, firstFrame = 0; p < nPartitions; p++) {
+	part = BI_PARTITION(type, p);
+
+	part->firstFrame = firstFrame;
+	part->nFrames = nBufs / nPartitions + ((p < nBufs % nPartitions) ? 1 : 0);
+	firstFrame += part->nFrames;
+
+	for (nBuckets = 1; nBuckets < 2 * part->nFrames; nBuckets <<= 1) ;
+	part->hashMask = nBuckets - 1;
+	part->nGhosts = MAX(1, part->nFrames * BFM_2Q_KOUT_PERCENT / 100);
+
+	part->hashTable = (Four *)malloc(sizeof(Four) * nBuckets);
+	part->ghostHash = (Four *)malloc(sizeof(Four) * nBuckets);
+	part->ghosts = (BufferGhost *)malloc(sizeof(BufferGhost) * part->nGhosts);
+	if (part->hashTable == NULL || part->ghostHash == NULL || part->ghosts == NULL) {
+	    edubfm_FreeBufferInfo(type);
+	    ERR(eMEMORYALLOCERR);
+	}
+
+	pthread_mutex_init(&part->mutex, NULL);
+	edubfm_ResetPartition(type, part);
+    }
+
+    return(eNOERROR);
+
+} /* edubfm_InitBufferInfo() */
+
+
+
+/*@================================
+ * edubfm_FinalBufferInfo()
+ *================================*/
+/*
+ * Function: Four edubfm_FinalBufferInfo(Four)
+ *
+ * Description:
+ *  Write out the dirty trains of the buffer type 'type' and free its
+ *  buffer pool.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_FinalBufferInfo(
+    Four type)			/* IN buffer type */
+{
+    Four e;			/* error */
+
+
+    if (edubfm_bufInfo[type].bufTable == NULL) return(eNOERROR);
+
+    e = edubfm_WriteDirtyTrains(type, BI_NBUFS(type), FALSE);
+
+    edubfm_FreeBufferInfo(type);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubfm_FinalBufferInfo() */
+
+
+
+/*@================================
+ * edubfm_ResetPartition()
+ *================================*/
+/*
+ * Function: void edubfm_ResetPartition(Four, BufferPartition*)
+ *
+ * Description:
+ *  Drop all the trains of the partition 'part' without writing them out;
+ *  all the frames become free and the replacement state is cleared.
+ */
+void edubfm_ResetPartition(
+    Four type,			/* IN buffer type */
+    BufferPartition *part)	/* IN partition to reset */
+{
+    Four i;			/* index */
+    BufferTable *entry;		/* a buffer table entry */
+
+
+    for (i = 0; i <= (Four)part->hashMask; i++) part->hashTable[i] = part->ghostHash[i] = NIL;
+
+    for (i = part->firstFrame; i < part->firstFrame + part->nFrames; i++) {
+	entry = BI_BUFTABLE_ENTRY(type, i);
+	entry->key.pageNo = NIL;
+	entry->fixed = 0;
+	entry->bits = 0;
+	entry->queue = BFM_NOQUEUE;
+	entry->prev = entry->next = NIL;
+	memset(entry->hist, 0, sizeof(entry->hist));
+	entry->nextHashEntry = (i + 1 < part->firstFrame + part->nFrames) ? i + 1 : NIL;
+    }
+    part->freeFrames = part->firstFrame;
+
+    for (i = 0; i < part->nGhosts; i++) part->ghosts[i].key.pageNo = NIL;
+    part->nextGhost = 0;
+
+    for (i = 0; i < BFM_NUM_QUEUES; i++) {
+	part->head[i] = part->tail[i] = NIL;
+	part->count[i] = 0;
+    }
+
+    part->nextVictim = part->firstFrame;
+    part->clock = 0;
+    part->lastFrame = NIL;
+    part->ringHead = part->ringCount = 0;
+
+} /* edubfm_ResetPartition() */
+
+
+
+/*
+ * Function: void edubfm_FreeBufferInfo(Four)
+ *
+ * Description:
+ *  Free the memory of the buffer pool of the buffer type 'type', which may
+ *  be allocated partially.
+ */
+static void edubfm_FreeBufferInfo(
+    Four type)			/* IN buffer type */
+{
+    Four p;			/* partition index */
+    BufferInfo *info;		/* the buffer pool */
+    BufferPartition *part;	/* a partition */
+
+
+    info = &edubfm_bufInfo[type];
+
+    if (info->partitions != NULL) {
+	for (p = 0; p < info->nPartitions; p++) {
+	    part = &info->partitions[p];
+	    if (part->hashTable != NULL && part->ghostHash != NULL && part->ghosts != NULL)
+		pthread_mutex_destroy(&part->mutex);
+	    free(part->hashTable);
+	    free(part->ghostHash);
+	    free(part->ghosts);
+	}
+    }
+
+    free(info->partitions);
+    free(info->bufTable);
+    free(info->dirty);
+    free(info->runBuffer);
+    if (info->poolBase != NULL) munmap(info->poolBase, info->poolSize);
+
+    info->partitions = NULL;
+    info->bufTable = NULL;
+    info->dirty = NULL;
+    info->runBuffer = NULL;
+    info->bufferPool = NULL;
+    info->poolBase = NULL;
+    info->poolSize = 0;
+    info->nBufs = 0;
+    info->nPartitions = 0;
+
+} /* edubfm_FreeBufferInfo() */
+
+
+
+/*
+ * Function: char *edubfm_MapPool(BufferInfo*, size_t, Four)
+ *
+ * Description:
+ *  Map 'size' bytes for the frames of the buffer pool 'info'. With
+ *  BFM_HUGEPAGE_EXPLICIT, the mapping is taken from the hugetlb pool; if
+ *  the pool is empty, or with BFM_HUGEPAGE_TRANSPARENT, a mapping aligned
+ *  to BFM_HUGEPAGE_SIZE is advised to be backed by transparent huge pages;
+ *  if this fails too, base pages are used. The backing obtained is recorded
+ *  in info->hugePages.
+ *
+ * Returns:
+ *  the frames, or NULL if no memory could be mapped
+ */
+static char *edubfm_MapPool(
+    BufferInfo *info,		/* IN/OUT buffer pool */
+    size_t size,		/* IN # of bytes of the frames */
+    Four hugePages)		/* IN backing requested */
+{
+    size_t hugeSize;		/* 'size' rounded up to huge pages */
+    char *base;			/* start of the mapping */
+    char *aligned;		/* first huge page boundary of the mapping */
+
+
+    hugeSize = (size + BFM_HUGEPAGE_SIZE - 1) & ~((size_t)BFM_HUGEPAGE_SIZE - 1);
+
+    if (hugePages == BFM_HUGEPAGE_EXPLICIT) {
+	base = mmap(NULL, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (base != MAP_FAILED) {
+	    info->poolBase = base;
+	    info->poolSize = hugeSize;
+	    info->hugePages = BFM_HUGEPAGE_EXPLICIT;
+	    return(base);
+	}
+	hugePages = BFM_HUGEPAGE_TRANSPARENT;
+    }
+
+    if (hugePages == BFM_HUGEPAGE_TRANSPARENT) {
+	/* one more huge page, to align the frames to a huge page boundary */
+	base = mmap(NULL, hugeSize + BFM_HUGEPAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base != MAP_FAILED) {
+	    aligned = (char *)(((size_t)base + BFM_HUGEPAGE_SIZE - 1) & ~((size_t)BFM_HUGEPAGE_SIZE - 1));
+	    if (madvise(aligned, hugeSize, MADV_HUGEPAGE) == 0) {
+		info->poolBase = base;
+		info->poolSize = hugeSize + BFM_HUGEPAGE_SIZE;
+		info->hugePages = BFM_HUGEPAGE_TRANSPARENT;
+		return(aligned);
+	    }
+	    munmap(base, hugeSize + BFM_HUGEPAGE_SIZE);
+	}
+    }
+
+    base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) return(NULL);
+
+    info->poolBase = base;
+    info->poolSize = size;
+    info->hugePages = BFM_HUGEPAGE_NONE;
+
+    return(base);
+
+} /* edubfm_MapPool() */
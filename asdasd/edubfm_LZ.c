@@ -0,0 +1,312 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_LZ.c
+ *
+ * Description:
+ *  LZ codec of the compressed page stores (see edubfm_Compress.c).
+ *  A compressed image is a sequence of tokens, each made of a run of
+ *  literal bytes and a match copying 'length' bytes found 'offset' bytes
+ *  before in the output, in the block format of LZ4: a token byte holds
+ *  the literal length in its high nibble and the match length - 4 in its
+ *  low nibble, each extended by bytes of 255 when the nibble is 15; the
+ *  literals and then the 2-byte little endian offset follow. The last
+ *  token has literals only.
+ *  Matches are found with a single-entry hash table of the 4-byte
+ *  sequences of the input, which is enough for the repeated prefixes and
+ *  the free area of the data pages, and keeps a page within a few
+ *  microseconds. The decoder checks every length and offset against the
+ *  bounds of its input and output, so a damaged image is reported instead
+ *  of overrunning the frame.
+ *
+ * Exports:
+ *  Four edubfm_LZCompress(const char*, Four, char*, Four)
+ *  Four edubfm_LZDecompress(const char*, Four, char*, Four)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+
+
+#define BFM_LZ_MIN_MATCH        4       /* shortest match */
+#define BFM_LZ_MAX_OFFSET       65535   /* farthest match */
+#define BFM_LZ_HASH_BITS        12      /* log2 of the # of entries of the hash table */
+#define BFM_LZ_HASH(v)          ((UFour)((v) * 2654435761U) >> (32 - BFM_LZ_HASH_BITS))
+
+static UFour edubfm_LZRead32(const UOne*);
+static Boolean edubfm_LZEmit(UOne**, UOne*, const UOne*, Four, Four, Four);
+
+
+
+/*@================================
+ * edubfm_LZCompress()
+ *================================*/
+/*
+ * Function: Four edubfm_LZCompress(const char*, Four, char*, Four)
+ *
+ * Description:
+ *  Compress the 'srcLen' bytes of 'src' into 'dst', of 'dstSize' bytes.
+ *
+ * Returns:
+ *  # of bytes of the compressed image, or 0 if it does not fit in 'dst'
+ */
+Four edubfm_LZCompress(
+    const char *src,		/* IN bytes to compress */
+    Four srcLen,		/* IN # of bytes of 'src', at most BFM_LZ_MAX_INPUT */
+    char *dst,			/* OUT compressed image */
+    Four dstSize)		/* IN # of bytes of 'dst' */
+{
+    const UOne *in = (const UOne *)src;	/* start of the input */
+    const UOne *end = in + srcLen;	/* end of the input */
+    const UOne *p;		/* current position */
+    const UOne *anchor;		/* first byte not emitted yet */
+    const UOne *match;		/* earlier occurrence of the bytes at 'p' */
+    UOne *out = (UOne *)dst;	/* next byte of the output */
+    UOne *outEnd = out + dstSize; /* end of the output */
+    Four h;			/* hash of the bytes at 'p' */
+    Four ref;			/* position of the last occurrence of the hash */
+    Four len;			/* length of the match */
+    Four table[1 << BFM_LZ_HASH_BITS]; /* last position of each hash, -1 if none */
+
+
+    if (srcLen < 0 || srcLen > BFM_LZ_MAX_INPUT) return(0);
+
+    memset(table, 0xff, sizeof(table));
+
+    for (p = anchor = in; end - p >= BFM_LZ_MIN_MATCH; ) {
+	h = BFM_LZ_HASH(edubfm_LZRead32(p));
+	ref = table[h];
+	table[h] = p - in;
+
+	match = in + ref;
+	if (ref < 0 || p - match > BFM_LZ_MAX_OFFSET || edubfm_LZRead32(match) != edubfm_LZRead32(p)) {
+	    p++;
+	    continue;
+	}
+
+	for (len = BFM_LZ_MIN_MATCH; p + len < end && match[len] == p[len]; len++) ;
+
+	if (!edubfm_LZEmit(&out, outEnd, anchor, p - anchor, p - match, len)) return(0);
+
+	p += len;
+	anchor = p;
+	/* the end of the match starts a later one more often than its middle */
+	if (end - p >= BFM_LZ_MIN_MATCH - 2)
+	    table[BFM_LZ_HASH(edubfm_LZRead32(p - 2))] = p - 2 - in;
+    }
+
+    if (!edubfm_LZEmit(&out, outEnd, anchor, end - anchor, 0, 0)) return(0);
+
+    return(out - (UOne *)dst);
+
+} /* edubfm_LZCompress() */
+
+
+
+/*@================================
+ * edubfm_LZDecompress()
+ *================================*/
+/*
+ * Function: Four edubfm_LZDecompress(const char*, Four, char*, Four)
+ *
+ * Description:
+ *  Decompress the image 'src' of 'srcLen' bytes into 'dst', of 'dstSize'
+ *  bytes.
+ *
+ * Returns:
+ *  # of bytes decompressed, or -1 if the image is damaged or does not fit
+ *  in 'dst'
+ */
+Four edubfm_LZDecompress(
+    const char *src,		/* IN compressed image */
+    Four srcLen,		/* IN # of bytes of 'src' */
+    char *dst,			/* OUT bytes decompressed */
+    Four dstSize)		/* IN # of bytes of 'dst' */
+{
+    const UOne *in = (const UOne *)src;	/* next byte of the input */
+    const UOne *inEnd = in + srcLen;	/* end of the input */
+    UOne *out = (UOne *)dst;	/* next byte of the output */
+    UOne *outEnd = out + dstSize; /* end of the output */
+    const UOne *match;		/* bytes copied by a match */
+    Four token;			/* token of the current sequence */
+    Four n;			/* length of the literals or of the match */
+    Four b;			/* a length byte */
+    Four offset;		/* offset of the match */
+
+
+    while (in < inEnd) {
+	token = *in++;
+
+	/*@ literals */
+	n = token >> 4;
+	if (n == 15)
+	    do {
+		if (in == inEnd) return(-1);
+		b = *in++;
+		n += b;
+	    } while (b == 255);
+	if (n > inEnd - in || n > outEnd - out) return(-1);
+	memcpy(out, in, n);
+	in += n;
+	out += n;
+
+	/* the last sequence has no match */
+	if (in == inEnd) break;
+
+	/*@ match */
+	if (inEnd - in < 2) return(-1);
+	offset = in[0] | (in[1] << 8);
+	in += 2;
+	if (offset == 0 || offset > out - (UOne *)dst) return(-1);
+
+	n = token & 15;
+	if (n == 15)
+	    do {
+		if (in == inEnd) return(-1);
+		b = *in++;
+		n += b;
+	    } while (b == 255);
+	n += BFM_LZ_MIN_MATCH;
+	if (n > outEnd - out) return(-1);
+
+	match = out - offset;
+	if (offset >= n) {
+	    memcpy(out, match, n);
+	    out += n;
+	}
+	else /* the match overlaps its copy, e.g. a run of one byte */
+	    while (n-- > 0) *out++ = *match++;
+    }
+
+    return(out - (UOne *)dst);
+
+} /* edubfm_LZDecompress() */
+
+
+
+/*
+ * Function: UFour edubfm_LZRead32(const UOne*)
+ *
+ * Description:
+ *  Return the 4 bytes at 'p', which need not be aligned.
+ *
+ * Returns:
+ *  the bytes as a UFour
+ */
+static UFour edubfm_LZRead32(
+    const UOne *p)		/* IN bytes to read */
+{
+    UFour v;			/* the bytes */
+
+
+    memcpy(&v, p, sizeof(v));
+
+    return(v);
+
+} /* edubfm_LZRead32() */
+
+
+
+/*
+ * Function: Boolean edubfm_LZEmit(UOne**, UOne*, const UOne*, Four, Four, Four)
+ *
+ * Description:
+ *  Append to '*out' a sequence of the 'nLit' literals 'lit' followed by a
+ *  match of 'matchLen' bytes at 'offset', or by no match if 'matchLen' is
+ *  0, and advance '*out'.
+ *
+ * Returns:
+ *  TRUE if the sequence fits before 'outEnd'
+ */
+static Boolean edubfm_LZEmit(
+    UOne **out,			/* INOUT next byte of the output */
+    UOne *outEnd,		/* IN end of the output */
+    const UOne *lit,		/* IN literals */
+    Four nLit,			/* IN # of literals */
+    Four offset,		/* IN offset of the match */
+    Four matchLen)		/* IN length of the match, 0 if none */
+{
+    UOne *o = *out;		/* next byte of the output */
+    UOne *token;		/* token of the sequence */
+    Four n;			/* length left to encode */
+
+
+    /* token, literals with their length bytes, offset and match length bytes */
+    if (outEnd - o < 1 + nLit + nLit / 255 + 1 + 2 + matchLen / 255 + 1) return(FALSE);
+
+    token = o++;
+    if (nLit >= 15) {
+	*token = 15 << 4;
+	for (n = nLit - 15; n >= 255; n -= 255) *o++ = 255;
+	*o++ = n;
+    }
+    else *token = nLit << 4;
+
+    memcpy(o, lit, nLit);
+    o += nLit;
+
+    if (matchLen > 0) {
+	*o++ = offset & 0xff;
+	*o++ = offset >> 8;
+	n = matchLen - BFM_LZ_MIN_MATCH;
+	if (n >= 15) {
+	    *token |= 15;
+	    for (n -= 15; n >= 255; n -= 255) *o++ = 255;
+	    *o++ = n;
+	}
+	else *token |= n;
+    }
+
+    *out = o;
+
+    return(TRUE);
+
+} /* edubfm_LZEmit() */
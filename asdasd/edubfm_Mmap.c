@@ -0,0 +1,768 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Mmap.c
+ *
+ * Description:
+ *  mmap read path of the volumes.
+ *  When the parameter 'mmapReads' is set, the trains of PAGE_BUF are not
+ *  copied into the buffer pool: the device of their volume is mapped and
+ *  BfM_GetTrain() returns the page in the mapping, found by its page
+ *  number without a lookup, and fixed by incrementing its fix count.
+ *
+ *  The device is located at the first fix of a page of the volume: the
+ *  page is read with RDsM while edubfm_Read() records the descriptor and
+ *  the offset used, and the volume is mapped if the page is found at that
+ *  offset and its pages lie at consecutive offsets of one regular file
+ *  (of a volume of several devices, the pages of the first device are
+ *  mapped and the others buffered); otherwise, and for a volume with a
+ *  compressed page store, the volume is marked refused and buffered as
+ *  usual. A volume with trains in the buffer pool
+ *  is never mapped, so each train is either in a mapping or in the pool.
+ *
+ *  The mapping is private: a modified page becomes a shadow copy of the
+ *  process, and the file is only changed when the page is written back
+ *  with RDsM (by BfM_FlushAll(), BfM_RemoveTrain(), BfM_Dismount() and
+ *  BfM_Final()), or saved by the recovery manager like a buffered train.
+ *  A page dropped without being written out is discarded from the mapping
+ *  with madvise() and reads the file again. The background writer and the
+ *  replacement policy do not apply to the mapped pages, which the page
+ *  cache of the OS keeps and evicts.
+ *  The caller of the functions which write out or drop pages holds
+ *  edubfm_writeMutex.
+ *
+ * Exports:
+ *  Four edubfm_FixMapped(TrainID*, char**, Boolean)
+ *  Four edubfm_UnfixMapped(TrainID*)
+ *  Four edubfm_SetDirtyMapped(TrainID*)
+ *  Four edubfm_DropMapped(TrainID*, char*, Boolean)
+ *  Four edubfm_FlushMapped(Four)
+ *  Four edubfm_DiscardMapped(Four)
+ *  Four edubfm_UnmapVolumes(Four)
+ *  Four edubfm_LocateTrain(TrainID*, char*, int*, long long*)
+ *  void edubfm_ProbeRead(int, size_t)
+ *  void edubfm_GetMapStatistics(Four*, Four*)
+ */
+
+
+#define _FILE_OFFSET_BITS 64
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+#include "RDsM.h"
+
+
+Boolean edubfm_mapProbing = FALSE;
+
+static BufferMapping bfmMappings[BFM_MAX_MAPPINGS];    /* mapped and refused volumes */
+static pthread_mutex_t bfmMapMutex = PTHREAD_MUTEX_INITIALIZER; /* serializes the mappings of the volumes */
+static int bfmProbeFd;                  /* descriptor of the last train read while probing */
+static off_t bfmProbeOffset;            /* offset of the last train read while probing */
+static Four bfmNumMappedFixes;          /* # of fixes served from the mappings */
+static Four bfmNumMappedWrites;         /* # of mapped pages written to the disk */
+
+static BufferMapping *edubfm_FindMapping(Four);
+static Four edubfm_MapVolume(TrainID*, BufferMapping**);
+static BufferMapped *edubfm_MappedPage(BufferMapping*, TrainID*, char**);
+static Four edubfm_WriteMapped(BufferMapping*, Four, Four);
+
+
+
+/*@================================
+ * edubfm_FixMapped()
+ *================================*/
+/*
+ * Function: Four edubfm_FixMapped(TrainID*, char**, Boolean)
+ *
+ * Description:
+ *  Fix the page 'trainId' in the mapping of its volume, mapping the volume
+ *  at the first fix of one of its pages, and return the page in 'retBuf'.
+ *  At the first fix of a page which is not new, the copy saved by the
+ *  recovery manager, if any, replaces the one of the disk, as in
+ *  edubfm_ReadTrain().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *  BFM_NOT_MAPPED if the page is not served from a mapping
+ */
+Four edubfm_FixMapped(
+    TrainID *trainId,		/* IN page to fix */
+    char **retBuf,		/* OUT page in the mapping */
+    Boolean isNew)		/* IN TRUE if the page has just been allocated */
+{
+    Four e;			/* error */
+    BufferMapping *m;		/* mapping of the volume */
+    BufferMapped *page;		/* state of the page */
+    char *aTrain;		/* page in the mapping */
+
+
+    m = edubfm_FindMapping(trainId->volNo);
+    if (m == NULL) {
+	e = edubfm_MapVolume(trainId, &m);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    page = edubfm_MappedPage(m, trainId, &aTrain);
+    if (page == NULL) return(BFM_NOT_MAPPED);
+
+    (void) __atomic_fetch_add(&page->fixed, 1, __ATOMIC_ACQUIRE);
+
+    if (isNew) BFM_SET_BITS(page, BFM_VALID | BFM_NEW);
+    else if (!(BFM_LOAD(&page->bits) & BFM_VALID)) {
+	pthread_mutex_lock(&edubfm_ioMutex);
+	e = eNOERROR;
+	if (!(page->bits & BFM_VALID)) {
+	    if (RM_RollbackRequiredFlag) e = RM_LoadTrain(trainId, aTrain, PAGE_BUF_TRAIN_SIZE);
+	    if (e >= eNOERROR) BFM_SET_BITS(page, BFM_VALID);
+	}
+	pthread_mutex_unlock(&edubfm_ioMutex);
+
+	if (e < eNOERROR) {
+	    (void) __atomic_fetch_sub(&page->fixed, 1, __ATOMIC_RELEASE);
+	    ERR(e);
+	}
+    }
+
+    bfmNumMappedFixes++;
+    *retBuf = aTrain;
+
+    return(eNOERROR);
+
+} /* edubfm_FixMapped() */
+
+
+
+/*@================================
+ * edubfm_UnfixMapped()
+ *================================*/
+/*
+ * Function: Four edubfm_UnfixMapped(TrainID*)
+ *
+ * Description:
+ *  Decrement the fix count of the mapped page 'trainId'.
+ *
+ * Returns:
+ *  error code
+ *  BFM_NOT_MAPPED if the page is not served from a mapping
+ */
+Four edubfm_UnfixMapped(
+    TrainID *trainId)		/* IN page to unfix */
+{
+    Two fixed;			/* current fix count */
+    BufferMapped *page;		/* state of the page */
+
+
+    page = edubfm_MappedPage(edubfm_FindMapping(trainId->volNo), trainId, NULL);
+    if (page == NULL) return(BFM_NOT_MAPPED);
+
+    fixed = BFM_LOAD(&page->fixed);
+    while (fixed > 0) {
+	if (__atomic_compare_exchange_n(&page->fixed, &fixed, fixed - 1, FALSE, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+	    return(eNOERROR);
+    }
+
+    printf("fixed counter is less than 0!!!\n");
+    printf("trainId = {%d, %d}\n", trainId->volNo, trainId->pageNo);
+
+    return(eNOERROR);
+
+} /* edubfm_UnfixMapped() */
+
+
+
+/*@================================
+ * edubfm_SetDirtyMapped()
+ *================================*/
+/*
+ * Function: Four edubfm_SetDirtyMapped(TrainID*)
+ *
+ * Description:
+ *  Mark the mapped page 'trainId' to be written back.
+ *
+ * Returns:
+ *  error code
+ *  BFM_NOT_MAPPED if the page is not served from a mapping
+ */
+Four edubfm_SetDirtyMapped(
+    TrainID *trainId)		/* IN modified page */
+{
+    BufferMapped *page;		/* state of the page */
+
+
+    page = edubfm_MappedPage(edubfm_FindMapping(trainId->volNo), trainId, NULL);
+    if (page == NULL) return(BFM_NOT_MAPPED);
+
+    BFM_SET_BITS(page, BFM_DIRTY);
+
+    return(eNOERROR);
+
+} /* edubfm_SetDirtyMapped() */
+
+
+
+/*@================================
+ * edubfm_DropMapped()
+ *================================*/
+/*
+ * Function: Four edubfm_DropMapped(TrainID*, char*, Boolean)
+ *
+ * Description:
+ *  Drop the mapped page 'trainId', fixed or not, as BfM_RemoveTrain() and
+ *  BfM_readTrain() drop a buffered train: the page is copied into 'aTrain'
+ *  unless it is NULL, written back first if 'flushFlag' is TRUE and it is
+ *  dirty, and discarded from the mapping. A page which has not been fixed
+ *  since the volume was mapped or since it was dropped is not in the
+ *  buffer, and is left to the caller as a train of the buffer pool.
+ *  The caller holds edubfm_writeMutex.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *  BFM_NOT_MAPPED if the page is not in a mapping or not fixed yet
+ */
+Four edubfm_DropMapped(
+    TrainID *trainId,		/* IN page to drop */
+    char *aTrain,		/* OUT copy of the page, or NULL */
+    Boolean flushFlag)		/* IN TRUE to write back the page if it is dirty */
+{
+    Four e;			/* error */
+    BufferMapping *m;		/* mapping of the volume */
+    BufferMapped *page;		/* state of the page */
+    char *mapped;		/* page in the mapping */
+
+
+    m = edubfm_FindMapping(trainId->volNo);
+    page = edubfm_MappedPage(m, trainId, &mapped);
+    if (page == NULL || !(BFM_LOAD(&page->bits) & BFM_VALID)) return(BFM_NOT_MAPPED);
+
+    if (aTrain != NULL) memcpy(aTrain, mapped, PAGESIZE);
+
+    if (flushFlag && (page->bits & BFM_DIRTY)) {
+	e = edubfm_WriteMapped(m, trainId->pageNo, 1);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    (void) madvise(mapped, PAGESIZE, MADV_DONTNEED);
+    BFM_STORE(&page->bits, 0);
+    BFM_STORE(&page->fixed, 0);
+
+    return(eNOERROR);
+
+} /* edubfm_DropMapped() */
+
+
+
+/*@================================
+ * edubfm_FlushMapped()
+ *================================*/
+/*
+ * Function: Four edubfm_FlushMapped(Four)
+ *
+ * Description:
+ *  Write back the dirty mapped pages of the volume 'volNo', or of all the
+ *  volumes if 'volNo' is NIL. Adjacent pages of the same extent are
+ *  written with one call of RDsM_WriteTrains() straight from the mapping,
+ *  up to BFM_MAX_RUN pages; the pages saved by the recovery manager are
+ *  saved one by one. The pages stay in the mapping.
+ *  The caller holds edubfm_writeMutex.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_FlushMapped(
+    Four volNo)			/* IN volume, NIL for all */
+{
+    Four e;			/* error */
+    Four i;			/* slot index */
+    Four p;			/* page number */
+    Four nRun;			/* # of pages of the current run */
+    Four extNo, nextExtNo;	/* extents of the first and the next page of a run */
+    BufferMapping *m;		/* a mapping */
+    PageID pid;			/* a page identifier */
+
+
+    for (i = 0; i < BFM_MAX_MAPPINGS; i++) {
+	m = &bfmMappings[i];
+	if (BFM_LOAD(&m->state) != BFM_MAP_MAPPED || (volNo != NIL && m->volNo != volNo)) continue;
+
+	for (p = 0; p < m->nPages; p += nRun) {
+	    nRun = 1;
+	    if (!(BFM_LOAD(&m->pages[p].bits) & BFM_DIRTY)) continue;
+
+	    /* extend the run with the following dirty pages written in place */
+	    e = eNOERROR;
+	    if (BFM_IS_WRITTEN_IN_PLACE(m->volNo, m->pages[p].bits, m->base + (size_t)p * PAGESIZE)) {
+		pthread_mutex_lock(&edubfm_ioMutex);
+		MAKE_PAGEID(pid, m->volNo, p);
+		e = RDsM_PageIdToExtNo(&pid, &extNo);
+		for ( ; e >= eNOERROR && p + nRun < m->nPages && nRun < BFM_MAX_RUN; nRun++) {
+		    if (!(BFM_LOAD(&m->pages[p + nRun].bits) & BFM_DIRTY)) break;
+		    if (!BFM_IS_WRITTEN_IN_PLACE(m->volNo, m->pages[p + nRun].bits, m->base + (size_t)(p + nRun) * PAGESIZE)) break;
+		    pid.pageNo = p + nRun;
+		    if (RDsM_PageIdToExtNo(&pid, &nextExtNo) < eNOERROR || nextExtNo != extNo) break;
+		}
+		pthread_mutex_unlock(&edubfm_ioMutex);
+	    }
+
+	    if (e >= eNOERROR) e = edubfm_WriteMapped(m, p, nRun);
+	    if (e < eNOERROR) ERR(e);
+	}
+    }
+
+    return(eNOERROR);
+
+} /* edubfm_FlushMapped() */
+
+
+
+/*@================================
+ * edubfm_DiscardMapped()
+ *================================*/
+/*
+ * Function: Four edubfm_DiscardMapped(Four)
+ *
+ * Description:
+ *  Drop the mapped pages of the volume 'volNo', or of all the volumes if
+ *  'volNo' is NIL, fixed or not, without writing them back.
+ *  The caller holds edubfm_writeMutex.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_DiscardMapped(
+    Four volNo)			/* IN volume, NIL for all */
+{
+    Four i;			/* slot index */
+    BufferMapping *m;		/* a mapping */
+
+
+    for (i = 0; i < BFM_MAX_MAPPINGS; i++) {
+	m = &bfmMappings[i];
+	if (BFM_LOAD(&m->state) != BFM_MAP_MAPPED || (volNo != NIL && m->volNo != volNo)) continue;
+
+	(void) madvise(m->mapBase, m->mapSize, MADV_DONTNEED);
+	memset(m->pages, 0, m->nPages * sizeof(BufferMapped));
+    }
+
+    return(eNOERROR);
+
+} /* edubfm_DiscardMapped() */
+
+
+
+/*@================================
+ * edubfm_UnmapVolumes()
+ *================================*/
+/*
+ * Function: Four edubfm_UnmapVolumes(Four)
+ *
+ * Description:
+ *  Write back the dirty pages of the volume 'volNo', or of all the volumes
+ *  if 'volNo' is NIL, unmap them and free their slots; a refused volume
+ *  may be mapped again when it is mounted again. Nothing is done if a page
+ *  of the volumes is fixed. With NIL, the statistics are reset.
+ *  The caller holds edubfm_writeMutex.
+ *
+ * Returns:
+ *  error code
+ *    eFLUSHFIXEDBUF_BFM
+ *    some errors caused by function calls
+ */
+Four edubfm_UnmapVolumes(
+    Four volNo)			/* IN volume, NIL for all */
+{
+    Four e;			/* error */
+    Four i;			/* slot index */
+    Four p;			/* page number */
+    BufferMapping *m;		/* a mapping */
+
+
+    pthread_mutex_lock(&bfmMapMutex);
+
+    /*@ check that no page is fixed */
+    for (i = 0; i < BFM_MAX_MAPPINGS; i++) {
+	m = &bfmMappings[i];
+	if (m->state != BFM_MAP_MAPPED || (volNo != NIL && m->volNo != volNo)) continue;
+	for (p = 0; p < m->nPages; p++)
+	    if (BFM_LOAD(&m->pages[p].fixed) > 0) {
+		pthread_mutex_unlock(&bfmMapMutex);
+		ERR(eFLUSHFIXEDBUF_BFM);
+	    }
+    }
+
+    e = edubfm_FlushMapped(volNo);
+    if (e < eNOERROR) {
+	pthread_mutex_unlock(&bfmMapMutex);
+	ERR(e);
+    }
+
+    /*@ free the slots */
+    for (i = 0; i < BFM_MAX_MAPPINGS; i++) {
+	m = &bfmMappings[i];
+	if (m->state == BFM_MAP_UNUSED || (volNo != NIL && m->volNo != volNo)) continue;
+	if (m->state == BFM_MAP_MAPPED) {
+	    (void) munmap(m->mapBase, m->mapSize);
+	    free(m->pages);
+	    m->pages = NULL;
+	}
+	BFM_STORE(&m->state, BFM_MAP_UNUSED);
+    }
+
+    if (volNo == NIL) bfmNumMappedFixes = bfmNumMappedWrites = 0;
+
+    pthread_mutex_unlock(&bfmMapMutex);
+
+    return(eNOERROR);
+
+} /* edubfm_UnmapVolumes() */
+
+
+
+/*@================================
+ * edubfm_LocateTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_LocateTrain(TrainID*, char*, int*, long long*)
+ *
+ * Description:
+ *  Read the train 'trainId' of PAGE_BUF into 'aTrain' with RDsM, and
+ *  return the descriptor and the offset it was read from, recorded by
+ *  edubfm_ProbeRead(). 'fd' is -1 if RDsM did not read the train with one
+ *  call of read().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_LocateTrain(
+    TrainID *trainId,		/* IN train to locate */
+    char *aTrain,		/* OUT train read */
+    int *fd,			/* OUT descriptor of the device */
+    long long *offset)		/* OUT offset of the train in the device */
+{
+    Four e;			/* error */
+
+
+    pthread_mutex_lock(&edubfm_ioMutex);
+    bfmProbeFd = -1;
+    edubfm_mapProbing = TRUE;
+    e = RDsM_ReadTrain(trainId, aTrain, PAGE_BUF_TRAIN_SIZE);
+    edubfm_mapProbing = FALSE;
+    *fd = bfmProbeFd;
+    *offset = bfmProbeOffset;
+    pthread_mutex_unlock(&edubfm_ioMutex);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubfm_LocateTrain() */
+
+
+
+/*@================================
+ * edubfm_ProbeRead()
+ *================================*/
+/*
+ * Function: void edubfm_ProbeRead(int, size_t)
+ *
+ * Description:
+ *  Record the descriptor and the offset of a read of one train issued by
+ *  RDsM while a train is being located (see edubfm_LocateTrain()).
+ */
+void edubfm_ProbeRead(
+    int fd,			/* IN descriptor read */
+    size_t count)		/* IN # of bytes read */
+{
+    if (count != PAGE_BUF_TRAIN_SIZE * PAGESIZE) return;
+
+    bfmProbeFd = fd;
+    bfmProbeOffset = lseek(fd, 0, SEEK_CUR);
+
+} /* edubfm_ProbeRead() */
+
+
+
+/*@================================
+ * edubfm_GetMapStatistics()
+ *================================*/
+/*
+ * Function: void edubfm_GetMapStatistics(Four*, Four*)
+ *
+ * Description:
+ *  Return the # of fixes served from the mappings and the # of mapped
+ *  pages written to the disk since the volumes were last all unmapped.
+ */
+void edubfm_GetMapStatistics(
+    Four *nMappedFixes,		/* OUT # of fixes served from the mappings */
+    Four *nMappedWrites)	/* OUT # of mapped pages written */
+{
+    *nMappedFixes = bfmNumMappedFixes;
+    *nMappedWrites = bfmNumMappedWrites;
+
+} /* edubfm_GetMapStatistics() */
+
+
+
+/*
+ * Function: BufferMapping *edubfm_FindMapping(Four)
+ *
+ * Description:
+ *  Find the slot of the volume 'volNo' without the mutex.
+ *
+ * Returns:
+ *  the slot, or NULL if the volume has none
+ */
+static BufferMapping *edubfm_FindMapping(
+    Four volNo)			/* IN volume */
+{
+    Four i;			/* slot index */
+
+
+    for (i = 0; i < BFM_MAX_MAPPINGS; i++)
+	if (BFM_LOAD(&bfmMappings[i].state) != BFM_MAP_UNUSED && bfmMappings[i].volNo == volNo)
+	    return(&bfmMappings[i]);
+
+    return(NULL);
+
+} /* edubfm_FindMapping() */
+
+
+
+/*
+ * Function: Four edubfm_MapVolume(TrainID*, BufferMapping**)
+ *
+ * Description:
+ *  Give a slot to the volume of the page 'trainId' and map the volume if
+ *  possible: the page is read with RDsM to find the descriptor and the
+ *  offset of the page, and the volume is mapped if the descriptor is a
+ *  regular file, the page is at the offset given by its page number and
+ *  the same page is found in the mapping. Otherwise, or if some train of
+ *  the volume is in the buffer pool, the slot is marked refused. 'm' is
+ *  NULL if no slot is free.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_MapVolume(
+    TrainID *trainId,		/* IN first page fixed */
+    BufferMapping **m)		/* OUT slot of the volume, or NULL */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    BufferMapping *slot;	/* slot of the volume */
+    BufferTable *entry;		/* a buffer table entry */
+    struct stat st;		/* status of the device */
+    int fd;			/* descriptor of the device */
+    long long offset;		/* offset of the page in the device */
+    off_t delta;		/* offset of page 0 in the device */
+    Four numDevices;		/* # of devices of the volume */
+    PageNo firstPage[RDSM_MAX_DEVICES+1]; /* first page of each device of the volume */
+    char probe[PAGESIZE];	/* page read by RDsM */
+
+
+    pthread_mutex_lock(&bfmMapMutex);
+
+    *m = edubfm_FindMapping(trainId->volNo);
+    if (*m != NULL) {
+	pthread_mutex_unlock(&bfmMapMutex);
+	return(eNOERROR);
+    }
+
+    for (i = 0; i < BFM_MAX_MAPPINGS && bfmMappings[i].state != BFM_MAP_UNUSED; i++) ;
+    if (i == BFM_MAX_MAPPINGS) {
+	pthread_mutex_unlock(&bfmMapMutex);
+	return(eNOERROR);
+    }
+    slot = &bfmMappings[i];
+    slot->volNo = trainId->volNo;
+
+    /*@ locate the page in its device; the pages of a compressed volume are not all there */
+    fd = -1;
+    if (!edubfm_HasStore(trainId->volNo)) {
+	e = edubfm_LocateTrain(trainId, probe, &fd, &offset);
+	if (e < eNOERROR) {
+	    pthread_mutex_unlock(&bfmMapMutex);
+	    ERR(e);
+	}
+    }
+
+    /*@ map the device */
+    delta = offset - (off_t)trainId->pageNo * PAGESIZE;
+    if (fd >= 0 && delta >= 0 && delta % PAGESIZE == 0 &&
+	fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= delta + PAGESIZE) {
+	slot->mapSize = st.st_size;
+	slot->mapBase = mmap(NULL, slot->mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	if (slot->mapBase != MAP_FAILED) {
+	    slot->base = slot->mapBase + delta;
+	    slot->nPages = (slot->mapSize - delta) / PAGESIZE;
+	    /* the pages after the last extent of the first device are in the next one */
+	    if (EduRDsM_GetDevices(trainId->volNo, &numDevices, NULL, firstPage) >= eNOERROR)
+		slot->nPages = MIN(slot->nPages, firstPage[1]);
+	    slot->pages = calloc(slot->nPages, sizeof(BufferMapped));
+	    if (slot->pages != NULL && trainId->pageNo < slot->nPages &&
+		memcmp(probe, slot->base + (size_t)trainId->pageNo * PAGESIZE, PAGESIZE) == 0) {
+		/* no train of the volume may be in the buffer pool */
+		for (i = 0; i < BI_NBUFS(PAGE_BUF); i++) {
+		    entry = BI_BUFTABLE_ENTRY(PAGE_BUF, i);
+		    if (entry->key.pageNo != NIL && entry->key.volNo == trainId->volNo) break;
+		}
+		if (i == BI_NBUFS(PAGE_BUF)) {
+		    BFM_STORE(&slot->state, BFM_MAP_MAPPED);
+		    *m = slot;
+		    pthread_mutex_unlock(&bfmMapMutex);
+		    return(eNOERROR);
+		}
+	    }
+	    free(slot->pages);
+	    slot->pages = NULL;
+	    (void) munmap(slot->mapBase, slot->mapSize);
+	}
+    }
+
+    BFM_STORE(&slot->state, BFM_MAP_REFUSED);
+    *m = slot;
+
+    pthread_mutex_unlock(&bfmMapMutex);
+
+    return(eNOERROR);
+
+} /* edubfm_MapVolume() */
+
+
+
+/*
+ * Function: BufferMapped *edubfm_MappedPage(BufferMapping*, TrainID*, char**)
+ *
+ * Description:
+ *  Return the state of the page 'trainId' in the slot 'm' of its volume,
+ *  and the page in the mapping in 'aTrain' unless it is NULL.
+ *
+ * Returns:
+ *  the state of the page, or NULL if the page is not in a mapping
+ */
+static BufferMapped *edubfm_MappedPage(
+    BufferMapping *m,		/* IN slot of the volume, or NULL */
+    TrainID *trainId,		/* IN page */
+    char **aTrain)		/* OUT page in the mapping */
+{
+    if (m == NULL || BFM_LOAD(&m->state) != BFM_MAP_MAPPED) return(NULL);
+
+    if (trainId->pageNo < 0 || trainId->pageNo >= m->nPages) return(NULL);
+
+    if (aTrain != NULL) *aTrain = m->base + (size_t)trainId->pageNo * PAGESIZE;
+
+    return(&m->pages[trainId->pageNo]);
+
+} /* edubfm_MappedPage() */
+
+
+
+/*
+ * Function: Four edubfm_WriteMapped(BufferMapping*, Four, Four)
+ *
+ * Description:
+ *  Write back the 'nRun' adjacent dirty pages of the mapping 'm' from the
+ *  page 'first' and clear their dirty bits. A run of more than one page is
+ *  written in place; a single page may be saved by the recovery manager
+ *  instead. As in edubfm_FlushTrain(), the dirty bits are cleared before
+ *  the write and set again if the write fails.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_WriteMapped(
+    BufferMapping *m,		/* IN mapping */
+    Four first,			/* IN first page of the run */
+    Four nRun)			/* IN # of pages */
+{
+    Four e;			/* error */
+    Four k;			/* index in the run */
+    PageID pid;			/* first page */
+    char *aTrain;		/* first page in the mapping */
+
+
+    MAKE_PAGEID(pid, m->volNo, first);
+    aTrain = m->base + (size_t)first * PAGESIZE;
+
+    for (k = 0; k < nRun; k++) BFM_CLEAR_BITS(&m->pages[first + k], BFM_DIRTY);
+
+    pthread_mutex_lock(&edubfm_ioMutex);
+
+    if (nRun > 1)
+	e = RDsM_WriteTrains(aTrain, &pid, nRun, PAGE_BUF_TRAIN_SIZE);
+    else if (BFM_IS_WRITTEN_IN_PLACE(m->volNo, m->pages[first].bits, aTrain))
+	e = RDsM_WriteTrain(aTrain, &pid, PAGE_BUF_TRAIN_SIZE);
+    else
+	e = RM_SaveTrain(&pid, aTrain, PAGE_BUF_TRAIN_SIZE);
+
+    pthread_mutex_unlock(&edubfm_ioMutex);
+
+    for (k = 0; k < nRun; k++) {
+	if (e < eNOERROR) BFM_SET_BITS(&m->pages[first + k], BFM_DIRTY);
+	else BFM_CLEAR_BITS(&m->pages[first + k], BFM_NEW);
+    }
+
+    if (e < eNOERROR) ERR(e);
+
+    bfmNumMappedWrites += nRun;
+
+    return(eNOERROR);
+
+} /* edubfm_WriteMapped() */
@@ -0,0 +1,106 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_ReadTrain.c
+ *
+ * Description:
+ *  Read a train into a frame.
+ *
+ * Exports:
+ *  Four edubfm_ReadTrain(TrainID*, char*, Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * edubfm_ReadTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_ReadTrain(TrainID*, char*, Four)
+ *
+ * Description:
+ *  Read the train 'trainId' of the buffer type 'type' into 'aTrain'.
+ *  While a transaction may be rolled back, the copy of the train saved by
+ *  the recovery manager, if any, is read instead of the one on the disk.
+ *  The pages of the train found in the compressed page store of its volume
+ *  are decompressed from there (see edubfm_Compress.c).
+ *  The caller holds the mutex of the partition of the train.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_ReadTrain(
+    TrainID *trainId,		/* IN train to read */
+    char *aTrain,		/* OUT frame receiving the train */
+    Four type)			/* IN buffer type */
+{
+    Four e;			/* error */
+
+
+    pthread_mutex_lock(&edubfm_ioMutex);
+
+    e = RM_NOT_IN_LOG;
+    if (RM_RollbackRequiredFlag) e = RM_LoadTrain(trainId, aTrain, BI_BUFSIZE(type));
+    if (e == RM_NOT_IN_LOG) e = edubfm_ReadStored(trainId, aTrain, type);
+    if (e == BFM_NOT_STORED) e = RDsM_ReadTrain(trainId, aTrain, BI_BUFSIZE(type));
+
+    pthread_mutex_unlock(&edubfm_ioMutex);
+
+    if (e < eNOERROR) ERR(e);
+
+    BI_PARTITION_OF(type, trainId)->stats.nReads++;
+
+    return(eNOERROR);
+
+} /* edubfm_ReadTrain() */
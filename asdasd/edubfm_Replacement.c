@@ -0,0 +1,549 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Replacement.c
+ *
+ * Description:
+ *  Replacement policies of the buffer manager.
+ *  The policy in edubfm_params.policy is applied to each partition on its
+ *  own:
+ *   - BFM_CLOCK: the hand sweeps the frames of the partition and gives a
+ *     second chance to the frames whose reference bit is set.
+ *   - BFM_2Q: a train loaded for the first time enters the FIFO queue A1in;
+ *     when it is evicted from A1in, its ID is remembered in the ghost queue
+ *     A1out, and a train found in A1out when it is loaded again enters the
+ *     LRU queue Am. A1in is kept to BFM_2Q_KIN_PERCENT of the frames, so
+ *     trains referenced only once (e.g. by scans) cannot flush Am.
+ *   - BFM_LRUK: the victim is the frame whose K-th last reference is the
+ *     oldest, frames with less than K references first. Re-fixes of a train
+ *     within BFM_LRUK_CRP ticks of its last reference are correlated and
+ *     count as one reference; the clock of a partition ticks when a frame
+ *     other than the last one is referenced. The history of an evicted
+ *     train is retained in the ring of ghosts and given back to the train
+ *     if it is loaded again before its ghost is reused.
+ *  Trains loaded under BFM_HINT_SEQUENTIAL are cold under every policy:
+ *  they enter the replacement state unreferenced and leave no ghost, and
+ *  their frames are also kept in the scan ring of the partition, whose
+ *  oldest frame is reused first by the next cold train once the ring is
+ *  full.
+ *  The caller holds the mutex of the partition.
+ *
+ * Exports:
+ *  void edubfm_Touch(Four, BufferPartition*, Four)
+ *  void edubfm_Admit(Four, BufferPartition*, Four)
+ *  void edubfm_Forget(Four, BufferPartition*, Four)
+ *  Four edubfm_SelectVictim(Four, BufferPartition*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+
+
+static void edubfm_LRUKReference(Four, BufferPartition*, Four);
+static void edubfm_PushQueue(Four, BufferPartition*, Four, Four);
+static void edubfm_UnlinkQueue(Four, BufferPartition*, Four);
+static Four edubfm_ClaimInQueue(Four, BufferPartition*, Four);
+static void edubfm_RememberGhost(BufferPartition*, BufferTable*);
+static Boolean edubfm_ForgetGhost(BufferPartition*, TrainID*, UFour*);
+static void edubfm_UnlinkRing(BufferPartition*, Four);
+static Four edubfm_ClaimInRing(Four, BufferPartition*);
+
+
+
+/*@================================
+ * edubfm_Touch()
+ *================================*/
+/*
+ * Function: void edubfm_Touch(Four, BufferPartition*, Four)
+ *
+ * Description:
+ *  Record a fix of the train held by the frame 'index', found in the
+ *  buffer. The caller holds the mutex of the partition; a fix done
+ *  without the mutex may skip this call (see BfM_GetTrain()).
+ */
+void edubfm_Touch(
+    Four type,			/* IN buffer type */
+    BufferPartition *part,	/* IN partition of the frame */
+    Four index)			/* IN frame index */
+{
+    switch (edubfm_params.policy) {
+      case BFM_2Q:
+	if (BI_BUFTABLE_ENTRY(type, index)->queue == BFM_AM) {
+	    edubfm_UnlinkQueue(type, part, index);
+	    edubfm_PushQueue(type, part, BFM_AM, index);
+	}
+	break;
+
+      case BFM_LRUK:
+	edubfm_LRUKReference(type, part, index);
+	break;
+    }
+
+    /* BFM_CLOCK: the reference bit is set by the caller */
+
+} /* edubfm_Touch() */
+
+
+
+/*@================================
+ * edubfm_Admit()
+ *================================*/
+/*
+ * Function: void edubfm_Admit(Four, BufferPartition*, Four)
+ *
+ * Description:
+ *  Enter the frame 'index', which has just been given a train, into the
+ *  replacement state. A cold train is not referenced: it enters A1in
+ *  whatever its ghost says under 2Q and gets an empty history under LRU-K.
+ */
+void edubfm_Admit(
+    Four type,			/* IN buffer type */
+    BufferPartition *part,	/* IN partition of the frame */
+    Four index)			/* IN frame index */
+{
+    BufferTable *entry;		/* buffer table entry of the frame */
+
+
+    entry = BI_BUFTABLE_ENTRY(type, index);
+
+    if (entry->bits & BFM_COLD) {
+	if (part->ringCount == BFM_SCAN_RING) {
+	    part->ringHead = (part->ringHead + 1) % BFM_SCAN_RING;
+	    part->ringCount--;
+	}
+	part->ring[(part->ringHead + part->ringCount) % BFM_SCAN_RING] = index;
+	part->ringCount++;
+
+	if (edubfm_params.policy == BFM_2Q) edubfm_PushQueue(type, part, BFM_A1IN, index);
+	else memset(entry->hist, 0, sizeof(entry->hist));
+
+	return;
+    }
+
+    switch (edubfm_params.policy) {
+      case BFM_2Q:
+	edubfm_PushQueue(type, part, edubfm_ForgetGhost(part, &entry->key, NULL) ? BFM_AM : BFM_A1IN, index);
+	break;
+
+      case BFM_LRUK:
+	if (!edubfm_ForgetGhost(part, &entry->key, entry->hist)) memset(entry->hist, 0, sizeof(entry->hist));
+	edubfm_LRUKReference(type, part, index);
+	break;
+    }
+
+} /* edubfm_Admit() */
+
+
+
+/*@================================
+ * edubfm_Forget()
+ *================================*/
+/*
+ * Function: void edubfm_Forget(Four, BufferPartition*, Four)
+ *
+ * Description:
+ *  Remove the frame 'index', whose train is dropped, from the replacement
+ *  state.
+ */
+void edubfm_Forget(
+    Four type,			/* IN buffer type */
+    BufferPartition *part,	/* IN partition of the frame */
+    Four index)			/* IN frame index */
+{
+    BufferTable *entry;		/* buffer table entry of the frame */
+
+
+    entry = BI_BUFTABLE_ENTRY(type, index);
+
+    if (entry->queue != BFM_NOQUEUE) edubfm_UnlinkQueue(type, part, index);
+    memset(entry->hist, 0, sizeof(entry->hist));
+    if (part->lastFrame == index) part->lastFrame = NIL;
+    edubfm_UnlinkRing(part, index);
+
+} /* edubfm_Forget() */
+
+
+
+/*@================================
+ * edubfm_SelectVictim()
+ *================================*/
+/*
+ * Function: Four edubfm_SelectVictim(Four, BufferPartition*)
+ *
+ * Description:
+ *  Select and claim an unfixed frame of the partition 'part' whose train is
+ *  to be evicted. Under BFM_HINT_SEQUENTIAL, the oldest frame of a full
+ *  scan ring is taken if it still holds an unfixed cold train. The evicted
+ *  train is remembered in the ring of ghosts if it leaves A1in under 2Q,
+ *  or with its history under LRU-K, unless it is cold.
+ *
+ * Returns:
+ *  index of the frame
+ *  error code
+ *    eNOUNFIXEDBUF_BFM
+ */
+Four edubfm_SelectVictim(
+    Four type,			/* IN buffer type */
+    BufferPartition *part)	/* IN partition */
+{
+    Four i;			/* frame index */
+    Four n;			/* # of frames visited or of attempts */
+    Four victim;		/* selected frame */
+    Four kIn;			/* target size of A1in */
+    BufferTable *entry;		/* a buffer table entry */
+    BufferTable *best;		/* buffer table entry of the victim */
+
+
+    if (edubfm_accessHint == BFM_HINT_SEQUENTIAL && part->ringCount == BFM_SCAN_RING) {
+	victim = edubfm_ClaimInRing(type, part);
+	if (victim != NIL) return(victim);
+    }
+
+    switch (edubfm_params.policy) {
+      case BFM_CLOCK:
+	for (n = 0; n < 2 * part->nFrames; n++) {
+	    i = part->nextVictim;
+	    part->nextVictim = (i + 1 < part->firstFrame + part->nFrames) ? i + 1 : part->firstFrame;
+
+	    entry = BI_BUFTABLE_ENTRY(type, i);
+	    if (BFM_LOAD(&entry->fixed) != 0) continue;
+	    if (entry->bits & BFM_REFER) {
+		BFM_CLEAR_BITS(entry, BFM_REFER);
+		continue;
+	    }
+	    if (edubfm_Claim(entry)) return(i);
+	}
+	break;
+
+      case BFM_2Q:
+	kIn = MAX(1, part->nFrames * BFM_2Q_KIN_PERCENT / 100);
+	victim = NIL;
+	if (part->count[BFM_A1IN] > kIn) victim = edubfm_ClaimInQueue(type, part, BFM_A1IN);
+	if (victim == NIL) victim = edubfm_ClaimInQueue(type, part, BFM_AM);
+	if (victim == NIL) victim = edubfm_ClaimInQueue(type, part, BFM_A1IN);
+	if (victim == NIL) break;
+
+	entry = BI_BUFTABLE_ENTRY(type, victim);
+	if (entry->queue == BFM_A1IN && !(entry->bits & BFM_COLD)) edubfm_RememberGhost(part, entry);
+	return(victim);
+
+      case BFM_LRUK:
+	/* retry if the chosen frame is fixed before it is claimed */
+	for (n = 0; n < part->nFrames; n++) {
+	    victim = NIL;
+	    best = NULL;
+	    for (i = part->firstFrame; i < part->firstFrame + part->nFrames; i++) {
+		entry = BI_BUFTABLE_ENTRY(type, i);
+		if (BFM_LOAD(&entry->fixed) != 0 || !(entry->bits & BFM_VALID)) continue;
+		if (best == NULL || entry->hist[BFM_LRUK_K-1] < best->hist[BFM_LRUK_K-1] ||
+		    (entry->hist[BFM_LRUK_K-1] == best->hist[BFM_LRUK_K-1] && entry->hist[0] < best->hist[0])) {
+		    best = entry;
+		    victim = i;
+		}
+	    }
+	    if (victim == NIL) break;
+	    if (edubfm_Claim(best)) {
+		if (!(best->bits & BFM_COLD)) edubfm_RememberGhost(part, best);
+		return(victim);
+	    }
+	}
+	break;
+    }
+
+    ERR(eNOUNFIXEDBUF_BFM);
+
+} /* edubfm_SelectVictim() */
+
+
+
+/*
+ * Function: void edubfm_LRUKReference(Four, BufferPartition*, Four)
+ *
+ * Description:
+ *  Record a reference to the frame 'index' in its LRU-K history.
+ */
+static void edubfm_LRUKReference(
+    Four type,			/* IN buffer type */
+    BufferPartition *part,	/* IN partition of the frame */
+    Four index)			/* IN frame index */
+{
+    Four k;			/* index of the history */
+    BufferTable *entry;		/* buffer table entry of the frame */
+
+
+    entry = BI_BUFTABLE_ENTRY(type, index);
+
+    if (part->lastFrame != index) {
+	part->clock++;
+	part->lastFrame = index;
+    }
+
+    /* correlated reference */
+    if (entry->hist[0] != 0 && part->clock - entry->hist[0] <= BFM_LRUK_CRP) return;
+
+    for (k = BFM_LRUK_K - 1; k > 0; k--) entry->hist[k] = entry->hist[k-1];
+    entry->hist[0] = part->clock;
+
+} /* edubfm_LRUKReference() */
+
+
+
+/*
+ * Function: void edubfm_PushQueue(Four, BufferPartition*, Four, Four)
+ *
+ * Description:
+ *  Insert the frame 'index' at the head of the 2Q queue 'queue'.
+ */
+static void edubfm_PushQueue(
+    Four type,			/* IN buffer type */
+    BufferPartition *part,	/* IN partition of the frame */
+    Four queue,			/* IN BFM_A1IN or BFM_AM */
+    Four index)			/* IN frame index */
+{
+    BufferTable *entry;		/* buffer table entry of the frame */
+
+
+    entry = BI_BUFTABLE_ENTRY(type, index);
+
+    entry->queue = queue;
+    entry->prev = NIL;
+    entry->next = part->head[queue];
+
+    if (part->head[queue] != NIL) BI_BUFTABLE_ENTRY(type, part->head[queue])->prev = index;
+    else part->tail[queue] = index;
+
+    part->head[queue] = index;
+    part->count[queue]++;
+
+} /* edubfm_PushQueue() */
+
+
+
+/*
+ * Function: void edubfm_UnlinkQueue(Four, BufferPartition*, Four)
+ *
+ * Description:
+ *  Remove the frame 'index' from its 2Q queue.
+ */
+static void edubfm_UnlinkQueue(
+    Four type,			/* IN buffer type */
+    BufferPartition *part,	/* IN partition of the frame */
+    Four index)			/* IN frame index */
+{
+    Four queue;			/* queue of the frame */
+    BufferTable *entry;		/* buffer table entry of the frame */
+
+
+    entry = BI_BUFTABLE_ENTRY(type, index);
+    queue = entry->queue;
+
+    if (entry->prev != NIL) BI_BUFTABLE_ENTRY(type, entry->prev)->next = entry->next;
+    else part->head[queue] = entry->next;
+
+    if (entry->next != NIL) BI_BUFTABLE_ENTRY(type, entry->next)->prev = entry->prev;
+    else part->tail[queue] = entry->prev;
+
+    entry->queue = BFM_NOQUEUE;
+    entry->prev = entry->next = NIL;
+    part->count[queue]--;
+
+} /* edubfm_UnlinkQueue() */
+
+
+
+/*
+ * Function: Four edubfm_ClaimInQueue(Four, BufferPartition*, Four)
+ *
+ * Description:
+ *  Claim the unfixed frame nearest to the tail of the 2Q queue 'queue'.
+ *
+ * Returns:
+ *  index of the frame, or NIL if every frame of the queue is fixed
+ */
+static Four edubfm_ClaimInQueue(
+    Four type,			/* IN buffer type */
+    BufferPartition *part,	/* IN partition */
+    Four queue)			/* IN BFM_A1IN or BFM_AM */
+{
+    Four i;			/* frame index */
+
+
+    for (i = part->tail[queue]; i != NIL; i = BI_BUFTABLE_ENTRY(type, i)->prev)
+	if (edubfm_Claim(BI_BUFTABLE_ENTRY(type, i))) return(i);
+
+    return(NIL);
+
+} /* edubfm_ClaimInQueue() */
+
+
+
+/*
+ * Function: void edubfm_RememberGhost(BufferPartition*, BufferTable*)
+ *
+ * Description:
+ *  Remember the train of the frame 'entry', which is evicted, with its
+ *  LRU-K history, forgetting the oldest ghost if the ring is full.
+ */
+static void edubfm_RememberGhost(
+    BufferPartition *part,	/* IN partition */
+    BufferTable *entry)		/* IN buffer table entry of the evicted frame */
+{
+    Four slot;			/* ghost slot */
+    Four *head;			/* head of the hash chain */
+
+
+    slot = part->nextGhost;
+    part->nextGhost = (slot + 1) % part->nGhosts;
+
+    if (part->ghosts[slot].key.pageNo != NIL) (void) edubfm_ForgetGhost(part, &part->ghosts[slot].key, NULL);
+
+    head = &part->ghostHash[BFM_HASH(&entry->key) & part->hashMask];
+    part->ghosts[slot].key = entry->key;
+    memcpy(part->ghosts[slot].hist, entry->hist, sizeof(entry->hist));
+    part->ghosts[slot].nextHashEntry = *head;
+    *head = slot;
+
+} /* edubfm_RememberGhost() */
+
+
+
+/*
+ * Function: Boolean edubfm_ForgetGhost(BufferPartition*, TrainID*, UFour*)
+ *
+ * Description:
+ *  Remove the ghost of the train 'key' if there is one, and return its
+ *  LRU-K history in 'hist' unless 'hist' is NULL.
+ *
+ * Returns:
+ *  TRUE if the train had a ghost
+ */
+static Boolean edubfm_ForgetGhost(
+    BufferPartition *part,	/* IN partition */
+    TrainID *key,		/* IN train */
+    UFour *hist)		/* OUT history of the train, BFM_LRUK_K entries */
+{
+    Four *link;			/* link pointing to the current ghost */
+    BufferGhost *ghost;		/* a ghost */
+
+
+    for (link = &part->ghostHash[BFM_HASH(key) & part->hashMask]; *link != NIL; link = &ghost->nextHashEntry) {
+	ghost = &part->ghosts[*link];
+	if (EQUAL_PAGEID(ghost->key, *key)) {
+	    *link = ghost->nextHashEntry;
+	    ghost->key.pageNo = NIL;
+	    if (hist != NULL) memcpy(hist, ghost->hist, sizeof(ghost->hist));
+	    return(TRUE);
+	}
+    }
+
+    return(FALSE);
+
+} /* edubfm_ForgetGhost() */
+
+
+
+/*
+ * Function: void edubfm_UnlinkRing(BufferPartition*, Four)
+ *
+ * Description:
+ *  Remove the frame 'index' from the scan ring if it is there.
+ */
+static void edubfm_UnlinkRing(
+    BufferPartition *part,	/* IN partition of the frame */
+    Four index)			/* IN frame index */
+{
+    Four i;			/* position in the ring */
+    Four n;			/* # of frames after the position */
+
+
+    for (i = 0; i < part->ringCount; i++)
+	if (part->ring[(part->ringHead + i) % BFM_SCAN_RING] == index) break;
+
+    if (i == part->ringCount) return;
+
+    for (n = part->ringCount - i - 1; n > 0; n--, i++)
+	part->ring[(part->ringHead + i) % BFM_SCAN_RING] = part->ring[(part->ringHead + i + 1) % BFM_SCAN_RING];
+
+    part->ringCount--;
+
+} /* edubfm_UnlinkRing() */
+
+
+
+/*
+ * Function: Four edubfm_ClaimInRing(Four, BufferPartition*)
+ *
+ * Description:
+ *  Take the oldest frame out of the scan ring and claim it if it still
+ *  holds an unfixed cold train. A frame whose train has been fixed under
+ *  BFM_HINT_NORMAL since it was loaded is left to the policy.
+ *
+ * Returns:
+ *  index of the frame, or NIL if it cannot be claimed
+ */
+static Four edubfm_ClaimInRing(
+    Four type,			/* IN buffer type */
+    BufferPartition *part)	/* IN partition */
+{
+    Four index;			/* oldest frame of the ring */
+    BufferTable *entry;		/* buffer table entry of the frame */
+
+
+    index = part->ring[part->ringHead];
+    part->ringHead = (part->ringHead + 1) % BFM_SCAN_RING;
+    part->ringCount--;
+
+    entry = BI_BUFTABLE_ENTRY(type, index);
+    if ((entry->bits & (BFM_VALID | BFM_COLD)) != (BFM_VALID | BFM_COLD)) return(NIL);
+
+    return(edubfm_Claim(entry) ? index : NIL);
+
+} /* edubfm_ClaimInRing() */
@@ -0,0 +1,935 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Writer.c
+ *
+ * Description:
+ *  Write-back of the dirty trains.
+ *  The dirty trains of a buffer pool are collected, sorted by train ID and
+ *  written out in runs: adjacent trains of the same extent are copied into
+ *  a run buffer and written with one call of RDsM_WriteTrains(). The frames
+ *  are fixed while they are written, as by BfM_GetTrain(), so they are not
+ *  evicted meanwhile; the operations dropping trains without fixing them
+ *  are excluded by edubfm_writeMutex.
+ *
+ *  A background writer thread, started when the parameter 'cleanTarget' is
+ *  not 0, keeps that many clean frames (free, or unfixed and not dirty) in
+ *  each buffer pool by writing out unfixed dirty trains, so that the
+ *  victims found by the foreground are seldom dirty. It runs every
+ *  BFM_WRITER_INTERVAL milliseconds, or when woken by a foreground
+ *  eviction which had to write its victim, and writes at most
+ *  'writeRate' trains per second if this parameter is not 0.
+ *
+ *  With the parameter 'asyncWrites', the runs written in place are not
+ *  copied into the run buffer: each run is written from the frames of its
+ *  trains, with one vectored write, through the asynchronous I/O engine of
+ *  RDsM, whose registered buffers are the frames of the buffer pools for
+ *  the single trains, and the writes of up to BFM_ASYNC_DEPTH runs are
+ *  submitted together. The frames stay fixed until their writes complete.
+ *  The devices of a volume are located once in the volume table of RDsM
+ *  (see EduRDsM_GetDevices()), and the runs of the devices are queued in
+ *  turn, one run of each device after the other, so that the writes in
+ *  flight keep all the devices of a volume busy instead of one after the
+ *  other. A device which is not a regular file, the trains of a volume
+ *  which cannot be located, and a train whose write fails, are written
+ *  with RDsM as usual. These writes bypass the I/O counters of RDsM.
+ *  The trains of a volume with a compressed page store are written one by
+ *  one through the store (see edubfm_Compress.c).
+ *
+ * Exports:
+ *  Four edubfm_WriteDirtyTrains(Four, Four, Boolean)
+ *  void edubfm_StartWriter(void)
+ *  void edubfm_StopWriter(void)
+ *  void edubfm_WakeWriter(void)
+ *  void edubfm_GetWriterStatistics(Four*, Four*, Four*)
+ *  void edubfm_ForgetLocations(Four)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "EduOM_common.h"
+#include "EduBfM_Internal.h"
+#include "RDsM.h"
+
+
+/*
+ * State of the background writer
+ */
+static struct {
+    pthread_mutex_t mutex;		/* protects 'stop' */
+    pthread_cond_t  cond;		/* signaled to wake the writer */
+    pthread_t       thread;		/* writer thread */
+    Boolean         running;		/* TRUE if the thread is started */
+    Boolean         stop;		/* TRUE to make the thread exit */
+    Four            nBgWrites;		/* # of trains written by the writer */
+    Four            nRuns;		/* # of runs written with RDsM_WriteTrains() */
+    Four            nAsyncWrites;	/* # of trains written through the I/O engine */
+    Boolean         async;		/* TRUE if 'engine' is initialized */
+    RDsM_IOEngine   engine;		/* engine of the asynchronous writes, used under edubfm_writeMutex */
+    BufferLocation  locations[BFM_MAX_LOCATIONS]; /* volumes located for the asynchronous writes */
+    BufferWrite     writes[BFM_ASYNC_DEPTH]; /* runs being written through 'engine' */
+    BufferStream    streams[BFM_MAX_STREAMS]; /* dirty trains of each device, used under edubfm_writeMutex */
+} bfmWriter = {
+    PTHREAD_MUTEX_INITIALIZER,	/* mutex */
+    PTHREAD_COND_INITIALIZER,	/* cond */
+    0,				/* thread, set when the thread is started */
+    FALSE,			/* running */
+    FALSE,			/* stop */
+    0,				/* nBgWrites */
+    0,				/* nRuns */
+    0,				/* nAsyncWrites */
+    FALSE,			/* async */
+    { 0 },			/* engine */
+    { { 0 } },			/* locations */
+    { { 0 } },			/* writes */
+    { { 0 } }			/* streams */
+};
+
+static void *edubfm_Writer(void*);
+static Four edubfm_CountCleanFrames(Four);
+static Boolean edubfm_PinDirtyTrain(Four, BufferDirty*, Boolean);
+static Four edubfm_WriteRun(Four, BufferDirty*, Four);
+static BufferLocation *edubfm_Locate(TrainID*);
+static Boolean edubfm_QueueRun(Four, BufferDirty*, Four);
+static Four edubfm_CompleteWrites(Four, Four);
+static Four edubfm_SplitByDevice(Four, Four);
+static Four edubfm_NextStream(Four*, Four);
+static Four edubfm_DeviceOf(BufferLocation*, PageNo);
+static int edubfm_CompareDirty(const void*, const void*);
+
+
+
+/*@================================
+ * edubfm_WriteDirtyTrains()
+ *================================*/
+/*
+ * Function: Four edubfm_WriteDirtyTrains(Four, Four, Boolean)
+ *
+ * Description:
+ *  Write out up to 'maxTrains' dirty trains of the buffer type 'type', in
+ *  the order of their train IDs.
+ *  Adjacent trains of the same extent are written with one call of
+ *  RDsM_WriteTrains(), up to BFM_MAX_RUN trains, or queued to the I/O
+ *  engine with the parameter 'asyncWrites', taking the runs of the
+ *  devices in turn. Trains saved by the
+ *  recovery manager instead are written one by one by edubfm_FlushTrain().
+ *  With 'background', the trains fixed by the foreground are skipped.
+ *  The caller holds no mutex of the buffer manager.
+ *
+ * Returns:
+ *  # of trains written, or an error code
+ *    some errors caused by function calls
+ */
+Four edubfm_WriteDirtyTrains(
+    Four type,			/* IN buffer type */
+    Four maxTrains,		/* IN # of trains to write */
+    Boolean background)		/* IN TRUE if called by the background writer */
+{
+    Four e;			/* error */
+    Four i;			/* frame index, then index of the collected trains */
+    Four k;			/* index in a run */
+    Four n;			/* # of dirty trains collected */
+    Four nRun;			/* # of trains of the current run */
+    Four nWritten;		/* # of trains written */
+    Four g;			/* stream of the current run */
+    Four nStreams;		/* # of streams of the collected trains */
+    Four extNo, nextExtNo;	/* extents of the first and the next train of a run */
+    Boolean stored;		/* TRUE if the volume of the run has a compressed page store */
+    BufferInfo *info;		/* the buffer pool */
+    BufferTable *entry;		/* a buffer table entry */
+    BufferDirty *run;		/* first train of the current run */
+    BufferPartition *part;	/* partition of a train */
+
+
+    info = &edubfm_bufInfo[type];
+    if (info->bufTable == NULL) return(0);
+
+    pthread_mutex_lock(&edubfm_writeMutex);
+
+    /*@ collect the dirty trains */
+    for (i = 0, n = 0; i < info->nBufs; i++) {
+	entry = BI_BUFTABLE_ENTRY(type, i);
+	if ((entry->bits & (BFM_DIRTY | BFM_VALID)) != (BFM_DIRTY | BFM_VALID)) continue;
+	if (background && BFM_LOAD(&entry->fixed) != 0) continue;
+	info->dirty[n].key = entry->key;
+	info->dirty[n].index = i;
+	n++;
+    }
+
+    qsort(info->dirty, n, sizeof(BufferDirty), edubfm_CompareDirty);
+
+    nStreams = edubfm_SplitByDevice(type, n);
+
+    /*@ write them out in runs */
+    e = eNOERROR;
+    nWritten = 0;
+    for (g = nStreams - 1; nWritten < maxTrains && (i = edubfm_NextStream(&g, nStreams)) != NIL;
+	 bfmWriter.streams[g].next = i + MAX(nRun, 1)) {
+	run = &info->dirty[i];
+	nRun = 0;
+	if (!edubfm_PinDirtyTrain(type, run, background)) continue;
+	entry = BI_BUFTABLE_ENTRY(type, run->index);
+
+	if (!BFM_IS_WRITTEN_IN_PLACE(run->key.volNo, entry->bits, BI_BUFFER(type, run->index))) {
+	    part = BI_PARTITION_OF(type, &run->key);
+	    pthread_mutex_lock(&part->mutex);
+	    e = edubfm_FlushTrain(type, run->index);
+	    pthread_mutex_unlock(&part->mutex);
+	    (void) edubfm_Unfix(entry);
+	    if (e < eNOERROR) break;
+	    nWritten++;
+	    nRun = 1;
+	    continue;
+	}
+
+	/* extend the run with the following adjacent trains; the trains of a
+	   volume with a compressed page store are written one by one */
+	stored = edubfm_HasStore(run->key.volNo);
+	pthread_mutex_lock(&edubfm_ioMutex);
+	e = RDsM_PageIdToExtNo((PageID *)&run->key, &extNo);
+	for (nRun = 1; e >= eNOERROR && !stored && i + nRun < bfmWriter.streams[g].end && nRun < BFM_MAX_RUN &&
+		       nWritten + nRun < maxTrains; nRun++) {
+	    if (run[nRun].key.volNo != run->key.volNo ||
+		run[nRun].key.pageNo != run->key.pageNo + nRun * BI_BUFSIZE(type)) break;
+	    if (RDsM_PageIdToExtNo((PageID *)&run[nRun].key, &nextExtNo) < eNOERROR || nextExtNo != extNo) break;
+	    if (!edubfm_PinDirtyTrain(type, &run[nRun], background)) break;
+	    if (!BFM_IS_WRITTEN_IN_PLACE(run[nRun].key.volNo, BI_BUFTABLE_ENTRY(type, run[nRun].index)->bits,
+					 BI_BUFFER(type, run[nRun].index))) {
+		(void) edubfm_Unfix(BI_BUFTABLE_ENTRY(type, run[nRun].index));
+		break;
+	    }
+	}
+	pthread_mutex_unlock(&edubfm_ioMutex);
+
+	/* the frames of a queued run are unfixed when its writes complete */
+	if (e >= eNOERROR && bfmWriter.async && !stored && edubfm_QueueRun(type, run, nRun)) {
+	    nWritten += nRun;
+	    continue;
+	}
+
+	if (e >= eNOERROR) e = edubfm_WriteRun(type, run, nRun);
+
+	for (k = 0; k < nRun; k++) (void) edubfm_Unfix(BI_BUFTABLE_ENTRY(type, run[k].index));
+
+	if (e < eNOERROR) break;
+	nWritten += nRun;
+    }
+
+    /*@ wait for the queued writes */
+    if (bfmWriter.async) {
+	k = edubfm_CompleteWrites(type, NIL);
+	if (e >= eNOERROR) e = k;
+    }
+
+    if (background) bfmWriter.nBgWrites += nWritten;
+
+    pthread_mutex_unlock(&edubfm_writeMutex);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(nWritten);
+
+} /* edubfm_WriteDirtyTrains() */
+
+
+
+/*@================================
+ * edubfm_StartWriter()
+ *================================*/
+/*
+ * Function: void edubfm_StartWriter(void)
+ *
+ * Description:
+ *  Reset the write-back statistics, set up the asynchronous writes if the
+ *  parameter 'asyncWrites' is set, registering the frames of the buffer
+ *  pools, and start the background writer if the parameter 'cleanTarget'
+ *  is not 0. If the engine or the thread cannot be set up, the dirty
+ *  trains are written with RDsM, or by the foreground only.
+ */
+void edubfm_StartWriter(void)
+{
+    Four type;			/* buffer type */
+    Four k;			/* slot index */
+    char *pools[NUM_BUF_TYPES];	/* frames of the buffer pools */
+    size_t sizes[NUM_BUF_TYPES]; /* sizes of 'pools' */
+
+
+    bfmWriter.nBgWrites = 0;
+    bfmWriter.nRuns = 0;
+    bfmWriter.nAsyncWrites = 0;
+
+    if (edubfm_params.asyncWrites && !bfmWriter.async &&
+	EduRDsM_InitIOEngine(&bfmWriter.engine, BFM_ASYNC_DEPTH) >= eNOERROR) {
+	for (type = 0; type < NUM_BUF_TYPES; type++) {
+	    pools[type] = edubfm_bufInfo[type].bufferPool;
+	    sizes[type] = (size_t)BI_NBUFS(type) * BI_BUFSIZE(type) * PAGESIZE;
+	}
+	(void) EduRDsM_RegisterIOBuffers(&bfmWriter.engine, NUM_BUF_TYPES, pools, sizes);
+	for (k = 0; k < BFM_ASYNC_DEPTH; k++) bfmWriter.writes[k].run = NULL;
+	edubfm_ForgetLocations(NIL);
+	bfmWriter.async = TRUE;
+    }
+
+    if (edubfm_params.cleanTarget == 0 || bfmWriter.running) return;
+
+    bfmWriter.stop = FALSE;
+    bfmWriter.running = (pthread_create(&bfmWriter.thread, NULL, edubfm_Writer, NULL) == 0);
+
+} /* edubfm_StartWriter() */
+
+
+
+/*@================================
+ * edubfm_StopWriter()
+ *================================*/
+/*
+ * Function: void edubfm_StopWriter(void)
+ *
+ * Description:
+ *  Stop the background writer, if it is running, and wait for its end,
+ *  and release the engine of the asynchronous writes, whose registered
+ *  buffers are the frames of the buffer pools about to be freed.
+ */
+void edubfm_StopWriter(void)
+{
+    if (bfmWriter.async) {
+	(void) EduRDsM_FinalIOEngine(&bfmWriter.engine);
+	bfmWriter.async = FALSE;
+	edubfm_ForgetLocations(NIL);
+    }
+
+    if (!bfmWriter.running) return;
+
+    pthread_mutex_lock(&bfmWriter.mutex);
+    bfmWriter.stop = TRUE;
+    pthread_cond_signal(&bfmWriter.cond);
+    pthread_mutex_unlock(&bfmWriter.mutex);
+
+    pthread_join(bfmWriter.thread, NULL);
+    bfmWriter.running = FALSE;
+
+} /* edubfm_StopWriter() */
+
+
+
+/*@================================
+ * edubfm_WakeWriter()
+ *================================*/
+/*
+ * Function: void edubfm_WakeWriter(void)
+ *
+ * Description:
+ *  Wake the background writer before its next pass is due.
+ */
+void edubfm_WakeWriter(void)
+{
+    if (bfmWriter.running) pthread_cond_signal(&bfmWriter.cond);
+
+} /* edubfm_WakeWriter() */
+
+
+
+/*@================================
+ * edubfm_GetWriterStatistics()
+ *================================*/
+/*
+ * Function: void edubfm_GetWriterStatistics(Four*, Four*, Four*)
+ *
+ * Description:
+ *  Return the # of trains written by the background writer, the # of runs
+ *  written at once and the # of trains written through the I/O engine
+ *  since the buffer pools were built.
+ */
+void edubfm_GetWriterStatistics(
+    Four *nBgWrites,		/* OUT # of trains written by the background writer */
+    Four *nRuns,		/* OUT # of runs written at once */
+    Four *nAsyncWrites)		/* OUT # of trains written through the I/O engine */
+{
+    *nBgWrites = bfmWriter.nBgWrites;
+    *nRuns = bfmWriter.nRuns;
+    *nAsyncWrites = bfmWriter.nAsyncWrites;
+
+} /* edubfm_GetWriterStatistics() */
+
+
+
+/*@================================
+ * edubfm_ForgetLocations()
+ *================================*/
+/*
+ * Function: void edubfm_ForgetLocations(Four)
+ *
+ * Description:
+ *  Forget the device located for the volume 'volNo', or for all volumes
+ *  if 'volNo' is NIL, because its descriptor is about to be closed.
+ *  The caller holds edubfm_writeMutex, unless the buffer manager is being
+ *  finalized.
+ */
+void edubfm_ForgetLocations(
+    Four volNo)			/* IN volume, or NIL */
+{
+    Four i;			/* slot index */
+
+
+    for (i = 0; i < BFM_MAX_LOCATIONS; i++)
+	if (volNo == NIL || bfmWriter.locations[i].volNo == volNo) bfmWriter.locations[i].volNo = NIL;
+
+} /* edubfm_ForgetLocations() */
+
+
+
+/*
+ * Function: void *edubfm_Writer(void*)
+ *
+ * Description:
+ *  Body of the background writer. Each pass writes out the dirty trains
+ *  missing to have 'cleanTarget' clean frames in each buffer pool, within
+ *  the trains allowed by 'writeRate' since the last pass (a token bucket
+ *  holding at most a tenth of a second of writes).
+ *
+ * Returns:
+ *  NULL
+ */
+static void *edubfm_Writer(
+    void *arg)			/* IN not used */
+{
+    Four type;			/* buffer type */
+    Four nWanted;		/* # of trains to write in a buffer pool */
+    Four nWritten;		/* # of trains written */
+    double tokens;		/* # of trains which may be written */
+    double now, last;		/* times of this pass and of the last one, in seconds */
+    struct timespec ts;		/* a time */
+
+
+    (void)arg;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    last = ts.tv_sec + ts.tv_nsec / 1e9;
+    tokens = 0;
+
+    pthread_mutex_lock(&bfmWriter.mutex);
+
+    while (!bfmWriter.stop) {
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_nsec += BFM_WRITER_INTERVAL * 1000000L;
+	if (ts.tv_nsec >= 1000000000L) {
+	    ts.tv_sec++;
+	    ts.tv_nsec -= 1000000000L;
+	}
+	(void) pthread_cond_timedwait(&bfmWriter.cond, &bfmWriter.mutex, &ts);
+	if (bfmWriter.stop) break;
+
+	pthread_mutex_unlock(&bfmWriter.mutex);
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	now = ts.tv_sec + ts.tv_nsec / 1e9;
+	if (edubfm_params.writeRate > 0)
+	    tokens = MIN(tokens + (now - last) * edubfm_params.writeRate, MAX(1.0, edubfm_params.writeRate / 10.0));
+	last = now;
+
+	for (type = 0; type < NUM_BUF_TYPES; type++) {
+	    nWanted = MIN(edubfm_params.cleanTarget, BI_NBUFS(type)) - edubfm_CountCleanFrames(type);
+	    if (edubfm_params.writeRate > 0) nWanted = MIN(nWanted, (Four)tokens);
+	    if (nWanted <= 0) continue;
+
+	    /* an error is met again by the foreground, which reports it */
+	    nWritten = edubfm_WriteDirtyTrains(type, nWanted, TRUE);
+	    if (nWritten > 0 && edubfm_params.writeRate > 0) tokens -= nWritten;
+	}
+
+	pthread_mutex_lock(&bfmWriter.mutex);
+    }
+
+    pthread_mutex_unlock(&bfmWriter.mutex);
+
+    return(NULL);
+
+} /* edubfm_Writer() */
+
+
+
+/*
+ * Function: Four edubfm_CountCleanFrames(Four)
+ *
+ * Description:
+ *  Count the frames of the buffer type 'type' which may be given a train
+ *  without a write: free frames and unfixed frames holding a clean train.
+ *  The count is taken without the mutexes and may be slightly off.
+ *
+ * Returns:
+ *  # of clean frames
+ */
+static Four edubfm_CountCleanFrames(
+    Four type)			/* IN buffer type */
+{
+    Four i;			/* frame index */
+    Four nClean;		/* # of clean frames */
+    BufferTable *entry;		/* a buffer table entry */
+
+
+    for (i = 0, nClean = 0; i < BI_NBUFS(type); i++) {
+	entry = BI_BUFTABLE_ENTRY(type, i);
+	if (!(entry->bits & BFM_VALID) || (!(entry->bits & BFM_DIRTY) && BFM_LOAD(&entry->fixed) == 0)) nClean++;
+    }
+
+    return(nClean);
+
+} /* edubfm_CountCleanFrames() */
+
+
+
+/*
+ * Function: Boolean edubfm_PinDirtyTrain(Four, BufferDirty*, Boolean)
+ *
+ * Description:
+ *  Fix the frame of the collected train 'dirty' if it still holds the
+ *  train and the train is still dirty. With 'background', a frame fixed by
+ *  the foreground meanwhile is not fixed.
+ *
+ * Returns:
+ *  TRUE if the frame is fixed
+ */
+static Boolean edubfm_PinDirtyTrain(
+    Four type,			/* IN buffer type */
+    BufferDirty *dirty,		/* IN collected train */
+    Boolean background)		/* IN TRUE if called by the background writer */
+{
+    BufferTable *entry;		/* buffer table entry of the frame */
+
+
+    entry = BI_BUFTABLE_ENTRY(type, dirty->index);
+
+    if (!edubfm_TryFix(entry)) return(FALSE);
+
+    if (EQUAL_PAGEID(entry->key, dirty->key) && (entry->bits & (BFM_DIRTY | BFM_VALID)) == (BFM_DIRTY | BFM_VALID) &&
+	(!background || BFM_LOAD(&entry->fixed) == 1))
+	return(TRUE);
+
+    (void) edubfm_Unfix(entry);
+
+    return(FALSE);
+
+} /* edubfm_PinDirtyTrain() */
+
+
+
+/*
+ * Function: Four edubfm_WriteRun(Four, BufferDirty*, Four)
+ *
+ * Description:
+ *  Write out the 'nRun' adjacent trains 'run', whose frames are fixed by
+ *  the caller, and clear their dirty bits. A single train is written from
+ *  its frame; a longer run is copied into the run buffer of the buffer
+ *  pool first. As in edubfm_FlushTrain(), the dirty bits are cleared
+ *  before the write and set again if the write fails.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_WriteRun(
+    Four type,			/* IN buffer type */
+    BufferDirty *run,		/* IN adjacent trains */
+    Four nRun)			/* IN # of trains */
+{
+    Four e;			/* error */
+    Four k;			/* index in the run */
+    size_t trainBytes;		/* # of bytes of a train */
+    BufferTable *entry;		/* a buffer table entry */
+
+
+    trainBytes = (size_t)BI_BUFSIZE(type) * PAGESIZE;
+
+    for (k = 0; k < nRun; k++) {
+	entry = BI_BUFTABLE_ENTRY(type, run[k].index);
+	BFM_CLEAR_BITS(entry, BFM_DIRTY);
+	if (nRun > 1) memcpy(edubfm_bufInfo[type].runBuffer + k * trainBytes, BI_BUFFER(type, run[k].index), trainBytes);
+    }
+
+    pthread_mutex_lock(&edubfm_ioMutex);
+
+    if (nRun == 1) {
+	e = edubfm_WriteStored(&run->key, BI_BUFFER(type, run->index), type);
+	if (e == BFM_NOT_STORED) e = RDsM_WriteTrain(BI_BUFFER(type, run->index), &run->key, BI_BUFSIZE(type));
+    }
+    else
+	e = RDsM_WriteTrains(edubfm_bufInfo[type].runBuffer, &run->key, nRun, BI_BUFSIZE(type));
+
+    pthread_mutex_unlock(&edubfm_ioMutex);
+
+    for (k = 0; k < nRun; k++) {
+	entry = BI_BUFTABLE_ENTRY(type, run[k].index);
+	if (e < eNOERROR) BFM_SET_BITS(entry, BFM_DIRTY);
+	else {
+	    BFM_CLEAR_BITS(entry, BFM_NEW);
+	    BFM_COUNT(BI_PARTITION_OF(type, &run[k].key), nWrites);
+	}
+    }
+
+    if (e < eNOERROR) ERR(e);
+
+    if (nRun > 1) bfmWriter.nRuns++;
+
+    return(eNOERROR);
+
+} /* edubfm_WriteRun() */
+
+
+
+/*
+ * Function: int edubfm_CompareDirty(const void*, const void*)
+ *
+ * Description:
+ *  Order two collected trains by volume and page number, for qsort().
+ *
+ * Returns:
+ *  a negative, zero or positive value
+ */
+static int edubfm_CompareDirty(
+    const void *a,		/* IN a collected train */
+    const void *b)		/* IN another collected train */
+{
+    const TrainID *x = &((const BufferDirty *)a)->key;
+    const TrainID *y = &((const BufferDirty *)b)->key;
+
+
+    if (x->volNo != y->volNo) return((x->volNo < y->volNo) ? -1 : 1);
+    if (x->pageNo != y->pageNo) return((x->pageNo < y->pageNo) ? -1 : 1);
+
+    return(0);
+
+} /* edubfm_CompareDirty() */
+
+
+
+/*
+ * Function: BufferLocation *edubfm_Locate(TrainID*)
+ *
+ * Description:
+ *  Return the devices of the volume of the train 'trainId', locating them
+ *  in the volume table of RDsM if they are not known yet. A device is
+ *  written directly only if it is a regular file. The caller holds
+ *  edubfm_writeMutex.
+ *
+ * Returns:
+ *  the location of the volume, or NULL if no slot is free or the volume
+ *  is not mounted
+ */
+static BufferLocation *edubfm_Locate(
+    TrainID *trainId)		/* IN a train of the volume */
+{
+    Four i;			/* slot index, then device index */
+    Four slot;			/* free slot */
+    Four numDevices;		/* # of devices of the volume */
+    int fds[RDSM_MAX_DEVICES];	/* descriptors of the devices */
+    PageNo firstPage[RDSM_MAX_DEVICES+1]; /* first page of each device */
+    struct stat st;		/* status of a device */
+    BufferLocation *loc;	/* location of the volume */
+
+
+    for (i = 0, slot = NIL; i < BFM_MAX_LOCATIONS; i++) {
+	if (bfmWriter.locations[i].volNo == trainId->volNo) return(&bfmWriter.locations[i]);
+	if (bfmWriter.locations[i].volNo == NIL && slot == NIL) slot = i;
+    }
+    if (slot == NIL) return(NULL);
+
+    if (EduRDsM_GetDevices(trainId->volNo, &numDevices, fds, firstPage) < eNOERROR ||
+	numDevices > BFM_MAX_DEVICES)
+	return(NULL);
+
+    loc = &bfmWriter.locations[slot];
+    loc->volNo = trainId->volNo;
+    loc->numDevices = numDevices;
+    for (i = 0; i < numDevices; i++) {
+	loc->fd[i] = (fds[i] >= 0 && fstat(fds[i], &st) == 0 && S_ISREG(st.st_mode)) ? fds[i] : -1;
+	loc->firstPage[i] = firstPage[i];
+    }
+    loc->firstPage[numDevices] = firstPage[numDevices];
+
+    return(loc);
+
+} /* edubfm_Locate() */
+
+
+
+/*
+ * Function: Boolean edubfm_QueueRun(Four, BufferDirty*, Four)
+ *
+ * Description:
+ *  Queue the write of the 'nRun' adjacent trains 'run', whose frames are
+ *  fixed by the caller, to the engine of the asynchronous writes, and
+ *  clear their dirty bits. A single train is written from its frame, a
+ *  longer run from the frames of its trains with one vectored write.
+ *  Completed writes are reaped first if the engine is full. Only the
+ *  trains of PAGE_BUF of a located volume are queued.
+ *
+ * Returns:
+ *  TRUE if the run is queued, FALSE if it is to be written with RDsM
+ */
+static Boolean edubfm_QueueRun(
+    Four type,			/* IN buffer type */
+    BufferDirty *run,		/* IN adjacent trains */
+    Four nRun)			/* IN # of trains */
+{
+    Four k;			/* index in the run */
+    Four d;			/* device of the run */
+    Four trainBytes;		/* # of bytes of a train */
+    long long offset;		/* offset of the run in the device */
+    BufferLocation *loc;	/* location of the volume */
+    BufferWrite *w;		/* slot of the run */
+    RDsM_IOEngine *engine = &bfmWriter.engine;
+
+
+    if (type != PAGE_BUF) return(FALSE);
+
+    loc = edubfm_Locate(&run->key);
+    if (loc == NULL) return(FALSE);
+
+    d = edubfm_DeviceOf(loc, run->key.pageNo);
+    if (d == NIL || loc->fd[d] < 0 || run->key.pageNo + nRun * BI_BUFSIZE(type) > loc->firstPage[d+1]) return(FALSE);
+
+    /* an error is met again by the caller, which reports it */
+    if (engine->nQueued + engine->nInFlight >= engine->depth)
+	if (edubfm_CompleteWrites(type, 1) < eNOERROR) return(FALSE);
+
+    /* a slot is free for each request the engine may take */
+    for (w = bfmWriter.writes; w->run != NULL; w++) ;
+
+    trainBytes = BI_BUFSIZE(type) * PAGESIZE;
+    offset = (long long)(run->key.pageNo - loc->firstPage[d]) * PAGESIZE;
+    for (k = 0; k < nRun; k++) {
+	w->iov[k].iov_base = BI_BUFFER(type, run[k].index);
+	w->iov[k].iov_len = trainBytes;
+    }
+
+    if (((nRun == 1) ? EduRDsM_PrepareIO(engine, RDSM_IO_WRITE, loc->fd[d], w->iov[0].iov_base, trainBytes, offset, w)
+		     : EduRDsM_PrepareIOV(engine, RDSM_IO_WRITE, loc->fd[d], w->iov, nRun, offset, w)) < eNOERROR)
+	return(FALSE);
+
+    w->run = run;
+    w->nRun = nRun;
+    for (k = 0; k < nRun; k++) BFM_CLEAR_BITS(BI_BUFTABLE_ENTRY(type, run[k].index), BFM_DIRTY);
+
+    return(TRUE);
+
+} /* edubfm_QueueRun() */
+
+
+
+/*
+ * Function: Four edubfm_CompleteWrites(Four, Four)
+ *
+ * Description:
+ *  Submit the queued writes and wait until 'minComplete' of them, or all
+ *  of them if 'minComplete' is NIL, are complete. The frames of a run
+ *  written are unfixed; a run whose write failed is written again with
+ *  RDsM first.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_CompleteWrites(
+    Four type,			/* IN buffer type */
+    Four minComplete)		/* IN # of writes to wait for, NIL for all */
+{
+    Four e;			/* error */
+    Four firstError;		/* first error met */
+    Four i, k;			/* indexes of the completions and in a run */
+    Four nDone;			/* # of writes completed */
+    BufferWrite *w;		/* run written */
+    RDsM_IOEngine *engine = &bfmWriter.engine;
+    RDsM_IOCompletion done[BFM_MAX_RUN]; /* completed writes */
+
+
+    e = EduRDsM_SubmitIO(engine);
+    if (e < eNOERROR) ERR(e);
+
+    firstError = eNOERROR;
+    do {
+	nDone = EduRDsM_WaitIO(engine, (minComplete == NIL) ? engine->nInFlight : minComplete, done, BFM_MAX_RUN);
+	if (nDone < eNOERROR) ERR(nDone);
+
+	for (i = 0; i < nDone; i++) {
+	    w = (BufferWrite *)done[i].tag;
+	    if (done[i].result == w->nRun * BI_BUFSIZE(type) * PAGESIZE) {
+		for (k = 0; k < w->nRun; k++) {
+		    BFM_CLEAR_BITS(BI_BUFTABLE_ENTRY(type, w->run[k].index), BFM_NEW);
+		    BFM_COUNT(BI_PARTITION_OF(type, &w->run[k].key), nWrites);
+		}
+		bfmWriter.nAsyncWrites += w->nRun;
+		if (w->nRun > 1) bfmWriter.nRuns++;
+	    }
+	    else {
+		e = edubfm_WriteRun(type, w->run, w->nRun);
+		if (e < eNOERROR && firstError == eNOERROR) firstError = e;
+	    }
+	    for (k = 0; k < w->nRun; k++) (void) edubfm_Unfix(BI_BUFTABLE_ENTRY(type, w->run[k].index));
+	    w->run = NULL;
+	}
+    } while (minComplete == NIL && engine->nInFlight > 0);
+
+    if (firstError < eNOERROR) ERR(firstError);
+
+    return(eNOERROR);
+
+} /* edubfm_CompleteWrites() */
+
+
+
+/*
+ * Function: Four edubfm_SplitByDevice(Four, Four)
+ *
+ * Description:
+ *  Split the 'n' dirty trains collected for the buffer type 'type', sorted
+ *  by train ID, into streams of the trains of one device, whose runs are
+ *  written in turn. With the parameter 'asyncWrites', a stream is made for
+ *  each device of a located volume of PAGE_BUF, up to BFM_MAX_STREAMS, the
+ *  last one taking the rest; otherwise, all trains are in one stream and
+ *  are written in the order of their train IDs.
+ *
+ * Returns:
+ *  # of streams
+ */
+static Four edubfm_SplitByDevice(
+    Four type,			/* IN buffer type */
+    Four n)			/* IN # of collected trains */
+{
+    Four i;			/* index of the collected trains */
+    Four d, prevD;		/* devices of a train and of the previous one */
+    Four nStreams;		/* # of streams */
+    BufferDirty *dirty = edubfm_bufInfo[type].dirty; /* collected trains */
+    BufferLocation *loc;	/* location of the volume of a train */
+    BufferStream *streams = bfmWriter.streams;
+
+
+    streams[0].next = 0;
+    streams[0].end = n;
+    if (!bfmWriter.async || type != PAGE_BUF || n == 0) return(1);
+
+    for (i = 0, nStreams = 1, loc = NULL, prevD = NIL; i < n; i++) {
+	if (loc == NULL || loc->volNo != dirty[i].key.volNo) {
+	    loc = edubfm_Locate(&dirty[i].key);
+	    prevD = NIL;
+	}
+	d = (loc == NULL) ? 0 : edubfm_DeviceOf(loc, dirty[i].key.pageNo);
+	if (i > 0 && (d != prevD || dirty[i].key.volNo != dirty[i-1].key.volNo) && nStreams < BFM_MAX_STREAMS) {
+	    streams[nStreams-1].end = i;
+	    streams[nStreams].next = i;
+	    streams[nStreams].end = n;
+	    nStreams++;
+	}
+	prevD = d;
+    }
+
+    return(nStreams);
+
+} /* edubfm_SplitByDevice() */
+
+
+
+/*
+ * Function: Four edubfm_NextStream(Four*, Four)
+ *
+ * Description:
+ *  Move 'g' to the next of the 'nStreams' streams, in turn, which has
+ *  trains left to write.
+ *
+ * Returns:
+ *  index of the next train of the stream, or NIL if all are written
+ */
+static Four edubfm_NextStream(
+    Four *g,			/* INOUT current stream */
+    Four nStreams)		/* IN # of streams */
+{
+    Four k;			/* # of streams looked at */
+    Four h;			/* a stream */
+
+
+    for (k = 1; k <= nStreams; k++) {
+	h = (*g + k) % nStreams;
+	if (bfmWriter.streams[h].next < bfmWriter.streams[h].end) {
+	    *g = h;
+	    return(bfmWriter.streams[h].next);
+	}
+    }
+
+    return(NIL);
+
+} /* edubfm_NextStream() */
+
+
+
+/*
+ * Function: Four edubfm_DeviceOf(BufferLocation*, PageNo)
+ *
+ * Description:
+ *  Return the device of the located volume 'loc' holding the page 'pageNo'.
+ *
+ * Returns:
+ *  index of the device, or NIL if no device holds the page
+ */
+static Four edubfm_DeviceOf(
+    BufferLocation *loc,	/* IN location of the volume */
+    PageNo pageNo)		/* IN page */
+{
+    Four d;			/* device index */
+
+
+    if (pageNo < 0) return(NIL);
+
+    for (d = 0; d < loc->numDevices; d++)
+	if (pageNo < loc->firstPage[d+1]) return(d);
+
+    return(NIL);
+
+} /* edubfm_DeviceOf() */
@@ -0,0 +1,152 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_AllocPage.c
+ *
+ * Description :
+ *  eduom_AllocPage() allocates a new page and links it into a data file.
+ *
+ * Exports:
+ *  Four eduom_AllocPage(ObjectID*, PageID*, PageID*, PageID*, SlottedPage**)
+ */
+
+
+#include "EduOM_common.h"
+#include "RDsM.h"		/* for the raw disk manager call */
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * eduom_AllocPage()
+ *================================*/
+/*
+ * Function: Four eduom_AllocPage(ObjectID*, PageID*, PageID*, PageID*, SlottedPage**)
+ *
+ * Description :
+ *  Allocate a new page as close as possible to 'nearPid' (to the last page
+ *  of the file if 'nearPid' is NULL), initialize it as an empty slotted
+ *  page and link it into the page list of the file after 'prevPid', or at
+ *  the end of the list if 'prevPid' is NULL. The page is returned fixed in
+ *  the buffer; it is not in any available space list.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    some errors caused by function calls
+ */
+Four eduom_AllocPage(
+    ObjectID	*catObjForFile,	/* IN file to which the page is appended */
+    PageID	*nearPid,	/* IN allocate the page near this page, may be NULL */
+    PageID	*prevPid,	/* IN link the page after this page, NULL to append */
+    PageID	*pid,		/* OUT the new page */
+    SlottedPage	**apage)	/* OUT buffer holding the new page */
+{
+    Four	e;		/* error number */
+    Four	firstExt;	/* first extent No of the file */
+    FileID	fid;		/* ID of the file */
+    Two		eff;		/* extent fill factor of the file */
+    PageID	near;		/* page to allocate near */
+    PhysicalFileID pFid;	/* physical ID of the file */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+    fid = catEntry->fid;
+    eff = catEntry->eff;
+    MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+    if (nearPid != NULL) near = *nearPid;
+    else MAKE_PAGEID(near, catEntry->fid.volNo, catEntry->lastPage);
+
+    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    /*@ allocate and initialize the page */
+    e = RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+    if (e < 0) ERR(e);
+
+    e = RDsM_AllocTrains(fid.volNo, firstExt, &near, eff, 1, PAGESIZE2, pid);
+    if (e < 0) ERR(e);
+
+    e = BfM_GetNewTrain(pid, (char **)apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    (*apage)->header.pid = *pid;
+    (*apage)->header.flags = 0;
+    SET_PAGE_TYPE(*apage, SLOTTED_PAGE_TYPE);
+    (*apage)->header.fid = fid;
+    (*apage)->header.nSlots = 1;
+    (*apage)->header.free = 0;
+    (*apage)->header.unused = 0;
+    (*apage)->header.prevPage = NIL;
+    (*apage)->header.nextPage = NIL;
+    (*apage)->header.spaceListPrev = NIL;
+    (*apage)->header.spaceListNext = NIL;
+    (*apage)->header.unique = 0;
+    (*apage)->header.uniqueLimit = 0;
+    (*apage)->slot[0].offset = EMPTYSLOT;
+
+    /*@ link the page into the page list */
+    e = om_FileMapAddPage(catObjForFile, prevPid, pid);
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+
+    e = BfM_SetDirty(pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+
+    return(eNOERROR);
+
+} /* eduom_AllocPage() */
@@ -106,18 +106,10 @@ Four eduom_CreateObject(
     Four	neededSpace;	/* space needed to put new object [+ header] */
     SlottedPage *apage;		/* pointer to the slotted page buffer */
     Four        alignedLen;	/* aligned length of initial data */
-    Boolean     needToAllocPage;/* Is there a need to alloc a new page? */
     PageID      pid;            /* PageID in which new object to be inserted */
-    PageID      nearPid;
-    Four        firstExt;	/* first Extent No of the file */
-    Object      *obj;		/* point to the newly created object */
-    Two         i;		/* index variable */
+    ObjectID    newOid;		/* ID of the new object */
     sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
     SlottedPage *catPage;	/* pointer to buffer containing the catalog */
-    FileID      fid;		/* ID of file where the new object is placed */
-    Two         eff;		/* extent fill factor of file */
-    Boolean     isTmp;
-    PhysicalFileID pFid;
     
 
     /*@ parameter checking */
@@ -128,14 +120,6 @@ Four eduom_CreateObject(
     if(ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
 	alignedLen = MAX(sizeof(ShortPageID), ALIGNED_LENGTH(length));
 	neededSpace = sizeof(ObjectHdr) + alignedLen + sizeof(SlottedPageSlot);//ũ
-	e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);//file id
-	if (e < 0) ERR(e);
-	GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
-	fid = catEntry->fid;
-	eff = catEntry->eff;
-	MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
-	e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
-	if (e < 0) ERR(e);
 	if (nearObj != NULL) {// ƮȮ
 		pid = *((PageID *)nearObj);// 
 
@@ -162,73 +146,23 @@ Four eduom_CreateObject(
 	}
 	e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
 	if (e < 0) ERR(e);
-	needToAllocPage = FALSE;
 	if (SP_FREE(apage) < neededSpace) {//   ο ޾ƿ
 		e = BfM_FreeTrain(&pid, PAGE_BUF);
 		if (e < 0) ERR(e);
-		needToAllocPage = TRUE;
+		/* the new page is linked after the near page, or appended */
+		e = eduom_AllocPage(catObjForFile, (PageID *)nearObj, (PageID *)nearObj, &pid, &apage);
+		if (e < 0) ERR(e);
 	}
 	else {//ƴ  avaialbe space list 
 		e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
 		if (e < 0) ERRB1(e, &pid, PAGE_BUF);
 	}
-	if (needToAllocPage) {
-		e = RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
-		if (e < 0) ERR(e);
-		if (nearObj != NULL) {
-			nearPid = *((PageID *)nearObj);// Ҵ
-		}
-		else {
-			MAKE_PAGEID(nearPid, catEntry->fid.volNo, catEntry->lastPage);
-		}
-		e = RDsM_AllocTrains(fid.volNo, firstExt, &nearPid, eff, 1, PAGESIZE2, &pid);
-		if (e < 0) ERR(e);
-		e = BfM_GetNewTrain(&pid, (char **)&apage, PAGE_BUF);
-		if (e < 0) ERR(e);
-		apage->header.fid = fid; //ʱȭ
-		apage->header.nSlots = 1;
-		apage->header.free = 0;
-		apage->header.unused = 0;
-		apage->header.prevPage = NIL;
-		apage->header.nextPage = NIL;
-		apage->header.spaceListPrev = NIL;
-		apage->header.spaceListNext = NIL;
-		apage->header.unique = 0;
-		apage->header.uniqueLimit = 0;
-		apage->header.pid = pid;
-
-		/* initialize */
-		apage->slot[0].offset = EMPTYSLOT;
-
-		e = om_FileMapAddPage(catObjForFile, (PageID *)nearObj, &pid);
-		if (e < 0) ERRB1(e, &pid, PAGE_BUF);
-
-	}
-	else {
-		if (SP_CFREE(apage) < neededSpace) {
-			e = OM_CompactPage(apage, NIL);
-			if (e < 0) ERRB1(e, &pid, PAGE_BUF);
-		}
-	}
-	//  Ʈ 
-	obj = (Object *)&(apage->data[apage->header.free]);
-	obj->header = *objHdr;// 庹
-	obj->header.length = length;//̰
-	memcpy(obj->data, data, length);// Ʈ 
-	for (i = 0; i < apage->header.nSlots; i++)//slot  Ʈ
-		if (apage->slot[-i].offset == EMPTYSLOT) break;
-	if (i == apage->header.nSlots)//󽽷  ο Ը
-		apage->header.nSlots++;
-	apage->slot[-i].offset = apage->header.free;
-	e = om_GetUnique(&pid, &(apage->slot[-i].unique));
+	e = eduom_PlaceObject(catObjForFile, &pid, apage, objHdr, length, data, &newOid);
 	if (e < 0) ERRB1(e, &pid, PAGE_BUF);
-	apage->header.free += sizeof(ObjectHdr) + alignedLen;//free space  
 	if (oid != NULL)
-		MAKE_OBJECTID(*oid, pid.volNo, pid.pageNo, i, apage->slot[-i].unique);//oid
+		*oid = newOid;
 	e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);//page ˸ avaiable list 
 	if (e < 0) ERRB1(e, &pid, PAGE_BUF);
-	e = BfM_SetDirty(&pid, PAGE_BUF);
-	if (e < 0) ERRB1(e, &pid, PAGE_BUF);
 	e = BfM_FreeTrain(&pid, PAGE_BUF);
 	if (e < 0) ERR(e);
     return(eNOERROR);
@@ -0,0 +1,190 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_FilterPage.c
+ *
+ * Description :
+ *  eduom_FilterPage() evaluates a header predicate on all objects of a page,
+ *  eduom_MatchPredicate() on one object header.
+ *
+ * Exports:
+ *  Two eduom_FilterPage(SlottedPage*, OM_HdrPredicate*, Two*)
+ *  Boolean eduom_MatchPredicate(ObjectHdr*, OM_HdrPredicate*)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * eduom_FilterPage()
+ *================================*/
+/*
+ * Function: Two eduom_FilterPage(SlottedPage*, OM_HdrPredicate*, Two*)
+ *
+ * Description :
+ *  Evaluate the predicate 'pred' on the headers of all objects of the page
+ *  and store the slot numbers of the qualifying objects into 'qual' in
+ *  ascending order.
+ *
+ *  The page is processed one condition at a time over all slots rather than
+ *  one object at a time over all conditions. Each pass is a branch-free
+ *  loop that ANDs its result into a per-slot flag, so the compiler can
+ *  vectorize it and the cost does not depend on how selective the
+ *  predicate is. The slot numbers are gathered from the flags at the end.
+ *  The header of an empty slot is not valid and is never dereferenced.
+ *
+ *  The header of a stub does not describe its moved object, so a stub is
+ *  stored as a candidate whatever the predicate; the caller evaluates the
+ *  predicate on the header of the forwarded record (eduom_MatchPredicate()).
+ *  The forwarded records themselves are excluded.
+ *
+ * Returns:
+ *  # of qualifying objects
+ */
+Two eduom_FilterPage(
+    SlottedPage		*apage,		/* IN page to filter */
+    OM_HdrPredicate	*pred,		/* IN predicate on the object header */
+    Two			*qual)		/* OUT qualifying slot numbers */
+{
+    Two		i;			/* slot number */
+    Four	t;			/* index of a tag */
+    Two		nSlots;			/* # of slots of the page */
+    Two		nQual;			/* # of qualifying objects */
+    Four	offset;			/* offset of an object */
+    ObjectHdr	*hdr;			/* header of an object */
+    unsigned char match;		/* TRUE if the tag matches one of the tags */
+    unsigned char ok[OM_MAX_SLOTS];	/* TRUE if the object of the slot qualifies so far */
+    unsigned char moved[OM_MAX_SLOTS];	/* TRUE if the slot holds the stub of a moved object */
+
+
+    nSlots = apage->header.nSlots;
+
+    /*@ exclude the empty slots and the forwarded records */
+    for (i = 0; i < nSlots; i++) {
+	ok[i] = OM_IS_OBJECT_SLOT(apage, i);
+	moved[i] = ok[i] && !OM_IS_DATA_SLOT(apage, i);
+    }
+
+    /*@ evaluate each condition over all slots */
+    if (pred->conditions & PRED_TAG) {
+	for (i = 0; i < nSlots; i++) {
+	    offset = ok[i] ? apage->slot[-i].offset : 0;
+	    hdr = (ObjectHdr *)&(apage->data[offset]);
+	    for (match = 0, t = 0; t < pred->nTags; t++)
+		match |= (hdr->tag == pred->tags[t]);
+	    ok[i] &= match;
+	}
+    }
+
+    if (pred->conditions & PRED_LENGTH) {
+	for (i = 0; i < nSlots; i++) {
+	    offset = ok[i] ? apage->slot[-i].offset : 0;
+	    hdr = (ObjectHdr *)&(apage->data[offset]);
+	    ok[i] &= (hdr->length >= pred->minLength) & (hdr->length <= pred->maxLength);
+	}
+    }
+
+    if (pred->conditions & PRED_PROPERTIES) {
+	for (i = 0; i < nSlots; i++) {
+	    offset = ok[i] ? apage->slot[-i].offset : 0;
+	    hdr = (ObjectHdr *)&(apage->data[offset]);
+	    ok[i] &= ((hdr->properties & pred->propMask) == pred->propValue);
+	}
+    }
+
+    /*@ gather the qualifying slot numbers */
+    for (nQual = 0, i = 0; i < nSlots; i++) {
+	qual[nQual] = i;
+	nQual += ok[i] | moved[i];
+    }
+
+    return(nQual);
+
+} /* eduom_FilterPage() */
+
+
+
+/*@================================
+ * eduom_MatchPredicate()
+ *================================*/
+/*
+ * Function: Boolean eduom_MatchPredicate(ObjectHdr*, OM_HdrPredicate*)
+ *
+ * Description :
+ *  Evaluate the predicate 'pred' on one object header, e.g. the header of
+ *  the moved object of a stub selected by eduom_FilterPage().
+ *
+ * Returns:
+ *  TRUE if the header satisfies the predicate
+ */
+Boolean eduom_MatchPredicate(
+    ObjectHdr		*hdr,		/* IN object header */
+    OM_HdrPredicate	*pred)		/* IN predicate on the object header */
+{
+    Four	t;			/* index of a tag */
+
+
+    if (pred->conditions & PRED_TAG) {
+	for (t = 0; t < pred->nTags; t++)
+	    if (hdr->tag == pred->tags[t]) break;
+	if (t == pred->nTags) return(FALSE);
+    }
+
+    if ((pred->conditions & PRED_LENGTH) &&
+	(hdr->length < pred->minLength || hdr->length > pred->maxLength)) return(FALSE);
+
+    if ((pred->conditions & PRED_PROPERTIES) &&
+	(hdr->properties & pred->propMask) != pred->propValue) return(FALSE);
+
+    return(TRUE);
+
+} /* eduom_MatchPredicate() */
@@ -0,0 +1,152 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_Forward.c
+ *
+ * Description :
+ *  Access to the forwarded record of a moved object through its stub.
+ *
+ * Exports:
+ *  Four eduom_FixForwarded(Object*, PageID*, SlottedPage**, Object**)
+ *  Four eduom_ScanHeader(Object*, ObjectHdr*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * eduom_FixForwarded()
+ *================================*/
+/*
+ * Function: Four eduom_FixForwarded(Object*, PageID*, SlottedPage**, Object**)
+ *
+ * Description :
+ *  Fix the page holding the forwarded record of the moved object whose
+ *  stub is 'stub', and return the record in that page. The caller frees
+ *  the page 'pid' when it is done with the record.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_FixForwarded(
+    Object	*stub,		/* IN stub of a moved object */
+    PageID	*pid,		/* OUT page holding the forwarded record */
+    SlottedPage	**apage,	/* OUT buffer holding 'pid' */
+    Object	**obj)		/* OUT the forwarded record */
+{
+    Four	e;		/* error number */
+    ObjectID	*fwdOid;	/* ID of the forwarded record */
+
+
+    fwdOid = (ObjectID *)stub->data;
+    MAKE_PAGEID(*pid, fwdOid->volNo, fwdOid->pageNo);
+
+    e = BfM_GetTrain(pid, (char **)apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (!IS_VALID_OBJECTID(fwdOid, (*apage))) ERRB1(eBADOBJECTID_OM, pid, PAGE_BUF);
+
+    *obj = (Object *)&((*apage)->data[(*apage)->slot[-fwdOid->slotNo].offset]);
+
+    return(eNOERROR);
+
+} /* eduom_FixForwarded() */
+
+
+
+/*@================================
+ * eduom_ScanHeader()
+ *================================*/
+/*
+ * Function: Four eduom_ScanHeader(Object*, ObjectHdr*)
+ *
+ * Description :
+ *  Get the header of the object 'obj' as a scan returns it. The header of
+ *  a stub is replaced by the one of its forwarded record without
+ *  P_FORWARDED, since a scan returns a moved object under the ID of its
+ *  stub.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_ScanHeader(
+    Object	*obj,		/* IN object in a fixed page */
+    ObjectHdr	*objHdr)	/* OUT header of the object */
+{
+    Four	e;		/* error number */
+    PageID	pid;		/* page holding the forwarded record */
+    SlottedPage	*apage;		/* buffer holding 'pid' */
+    Object	*fwdObj;	/* the forwarded record */
+
+
+    if (!(obj->header.properties & P_MOVED)) {
+	*objHdr = obj->header;
+	return(eNOERROR);
+    }
+
+    e = eduom_FixForwarded(obj, &pid, &apage, &fwdObj);
+    if (e < 0) ERR(e);
+
+    *objHdr = fwdObj->header;
+    objHdr->properties &= ~P_FORWARDED;
+
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_ScanHeader() */
@@ -0,0 +1,134 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_PlaceObject.c
+ *
+ * Description :
+ *  eduom_PlaceObject() stores an object into a page fixed by the caller.
+ *
+ * Exports:
+ *  Four eduom_PlaceObject(ObjectID*, PageID*, SlottedPage*, ObjectHdr*, Four, char*, ObjectID*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * eduom_PlaceObject()
+ *================================*/
+/*
+ * Function: Four eduom_PlaceObject(ObjectID*, PageID*, SlottedPage*, ObjectHdr*, Four, char*, ObjectID*)
+ *
+ * Description :
+ *  Store a new object with the header 'objHdr' and 'length' bytes of 'data'
+ *  into the page 'apage' of the file, which the caller keeps fixed and has
+ *  taken out of the available space lists. The page is compacted if its
+ *  contiguous free area is too small; the caller must have checked that
+ *  the total free area is large enough (OM_NEEDED_SPACE()). The page is
+ *  set dirty and the zone map of the file is updated.
+ *
+ * Returns:
+ *  error code
+ *    eBADLENGTH_OM
+ *    some errors caused by function calls
+ */
+Four eduom_PlaceObject(
+    ObjectID	*catObjForFile,	/* IN file containing the page */
+    PageID	*pid,		/* IN page to store the object into */
+    SlottedPage	*apage,		/* INOUT buffer holding the page */
+    ObjectHdr	*objHdr,	/* IN header of the object; its length is ignored */
+    Four	length,		/* IN amount of data */
+    char	*data,		/* IN data of the object */
+    ObjectID	*oid)		/* OUT the object's ObjectID */
+{
+    Four	e;		/* error number */
+    Two		i;		/* slot number */
+    Object	*obj;		/* the new object */
+
+
+    /*@ parameter checking */
+    if (SP_FREE(apage) < OM_NEEDED_SPACE(length)) ERR(eBADLENGTH_OM);
+
+    if (SP_CFREE(apage) < OM_NEEDED_SPACE(length)) {
+	e = EduOM_CompactPage(apage, NIL);
+	if (e < 0) ERR(e);
+    }
+
+    /*@ take an empty slot, or a new one */
+    for (i = 0; i < apage->header.nSlots; i++)
+	if (apage->slot[-i].offset == EMPTYSLOT) break;
+    if (i == apage->header.nSlots) apage->header.nSlots++;
+
+    obj = (Object *)&(apage->data[apage->header.free]);
+    obj->header = *objHdr;
+    obj->header.length = length;
+    memcpy(obj->data, data, length);
+
+    apage->slot[-i].offset = apage->header.free;
+    e = om_GetUnique(pid, &(apage->slot[-i].unique));
+    if (e < 0) ERR(e);
+    apage->header.free += OM_NEEDED_SPACE(length) - sizeof(SlottedPageSlot);
+
+    MAKE_OBJECTID(*oid, pid->volNo, pid->pageNo, i, apage->slot[-i].unique);
+
+    e = eduom_ZoneMapInsert(catObjForFile, apage, &obj->header);
+    if (e < 0) ERR(e);
+
+    e = BfM_SetDirty(pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_PlaceObject() */
@@ -0,0 +1,475 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_ZoneMap.c
+ *
+ * Description :
+ *  Maintenance of the zone maps of data files.
+ *  A zone map summarizes every page of a file (page list links, # of
+ *  objects, ranges of the tags and of the lengths) in main memory, so that
+ *  a filtered scan can pass over the pages which cannot hold a qualifying
+ *  object without fixing them. eduom_CreateObject() and
+ *  EduOM_DestroyObject() keep the zone map of the file up to date.
+ *  Any number of files may have a zone map: the table of the zone maps
+ *  starts with ZM_INIT_FILES entries and is doubled when they are all in
+ *  use. An entry is never freed, so that a scan keeping a pointer to it
+ *  can tell by its generation that its zone map was given up.
+ *
+ * Exports:
+ *  OM_ZoneMap *eduom_GetZoneMap(ObjectID*)
+ *  OM_ZoneMap *eduom_NewZoneMap(ObjectID*)
+ *  void eduom_FreeZoneMap(OM_ZoneMap*)
+ *  Four eduom_ZoneMapInsert(ObjectID*, SlottedPage*, ObjectHdr*)
+ *  Four eduom_ZoneMapRemove(ObjectID*, SlottedPage*, Boolean)
+ *  PageNo eduom_ZoneMapSkip(OM_ZoneMap*, UFour, PageNo, OM_HdrPredicate*, Four, Four*)
+ */
+
+
+#include <stdlib.h>
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+static OM_ZoneMap **zoneMaps = NULL;		/* zone maps of the files */
+static Four nZoneMaps = 0;			/* # of entries of 'zoneMaps' */
+static UFour zoneMapGeneration = 0;		/* generation of the zone map allocated last */
+
+static OM_PageSummary *eduom_ZoneMapLookUp(OM_ZoneMap*, PageNo);
+static OM_PageSummary *eduom_ZoneMapAdd(OM_ZoneMap*, PageNo);
+static void eduom_ZoneMapDelete(OM_ZoneMap*, OM_PageSummary*);
+
+#define ZM_HASH(map, pageNo)	((UFour)(pageNo) * 2654435761U & ((map)->size - 1))
+
+
+
+/*@================================
+ * eduom_GetZoneMap()
+ *================================*/
+/*
+ * Function: OM_ZoneMap *eduom_GetZoneMap(ObjectID*)
+ *
+ * Description :
+ *  Return the zone map of the file given by its catalog object, or NULL if
+ *  the file has no zone map.
+ */
+OM_ZoneMap *eduom_GetZoneMap(
+    ObjectID *catObjForFile)	/* IN catalog object of the file */
+{
+    Four i;			/* index */
+
+
+    for (i = 0; i < nZoneMaps; i++)
+	if (zoneMaps[i]->catObj.pageNo != NIL &&
+	    zoneMaps[i]->catObj.volNo == catObjForFile->volNo &&
+	    zoneMaps[i]->catObj.pageNo == catObjForFile->pageNo &&
+	    zoneMaps[i]->catObj.slotNo == catObjForFile->slotNo) return(zoneMaps[i]);
+
+    return(NULL);
+
+} /* eduom_GetZoneMap() */
+
+
+
+/*@================================
+ * eduom_NewZoneMap()
+ *================================*/
+/*
+ * Function: OM_ZoneMap *eduom_NewZoneMap(ObjectID*)
+ *
+ * Description :
+ *  Allocate an empty zone map for the file given by its catalog object,
+ *  with a generation no zone map allocated before has, doubling the table
+ *  of the zone maps if all its entries are in use.
+ *
+ * Returns:
+ *  the new zone map, or NULL if memory is short
+ */
+OM_ZoneMap *eduom_NewZoneMap(
+    ObjectID *catObjForFile)	/* IN catalog object of the file */
+{
+    Four i;			/* index */
+    Four newSize;		/* # of entries of the grown table */
+    OM_ZoneMap **newMaps;	/* grown table of the zone maps */
+    OM_ZoneMap *map;		/* new zone map */
+
+
+    for (map = NULL, i = 0; i < nZoneMaps; i++)
+	if (zoneMaps[i]->catObj.pageNo == NIL) { map = zoneMaps[i]; break; }
+
+    if (map == NULL) {
+	newSize = (nZoneMaps == 0) ? ZM_INIT_FILES : nZoneMaps * 2;
+	newMaps = (OM_ZoneMap **)realloc(zoneMaps, newSize * sizeof(OM_ZoneMap *));
+	if (newMaps == NULL) return(NULL);
+	zoneMaps = newMaps;
+
+	for ( ; nZoneMaps < newSize; nZoneMaps++) {
+	    zoneMaps[nZoneMaps] = (OM_ZoneMap *)malloc(sizeof(OM_ZoneMap));
+	    if (zoneMaps[nZoneMaps] == NULL) break;
+	    zoneMaps[nZoneMaps]->catObj.pageNo = NIL;
+	    zoneMaps[nZoneMaps]->generation = 0;
+	    zoneMaps[nZoneMaps]->pages = NULL;
+	}
+	if (i == nZoneMaps) return(NULL);
+	map = zoneMaps[i];
+    }
+
+    map->pages = (OM_PageSummary *)malloc(ZM_INIT_SIZE * sizeof(OM_PageSummary));
+    if (map->pages == NULL) return(NULL);
+
+    for (i = 0; i < ZM_INIT_SIZE; i++) map->pages[i].pageNo = NIL;
+    map->size = ZM_INIT_SIZE;
+    map->nPages = 0;
+    map->catObj = *catObjForFile;
+    if (++zoneMapGeneration == 0) zoneMapGeneration = 1;
+    map->generation = zoneMapGeneration;
+
+    return(map);
+
+} /* eduom_NewZoneMap() */
+
+
+
+/*@================================
+ * eduom_FreeZoneMap()
+ *================================*/
+/*
+ * Function: void eduom_FreeZoneMap(OM_ZoneMap*)
+ *
+ * Description :
+ *  Free a zone map.
+ */
+void eduom_FreeZoneMap(
+    OM_ZoneMap *map)		/* IN zone map to free */
+{
+    free(map->pages);
+    map->pages = NULL;
+    map->catObj.pageNo = NIL;
+    map->generation = 0;
+
+} /* eduom_FreeZoneMap() */
+
+
+
+/*@================================
+ * eduom_ZoneMapInsert()
+ *================================*/
+/*
+ * Function: Four eduom_ZoneMapInsert(ObjectID*, SlottedPage*, ObjectHdr*)
+ *
+ * Description :
+ *  Record in the zone map of the file that an object with the header 'hdr'
+ *  was inserted into 'apage'; if 'hdr' is NULL, only make sure that the page
+ *  is in the zone map. A page new to the zone map is linked between its
+ *  neighbors in the page list, so it must already be in the page list.
+ *  If memory is short, the zone map is dropped.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four eduom_ZoneMapInsert(
+    ObjectID *catObjForFile,	/* IN catalog object of the file */
+    SlottedPage *apage,		/* IN page holding the new object */
+    ObjectHdr *hdr)		/* IN header of the new object, or NULL */
+{
+    OM_ZoneMap *map;		/* zone map of the file */
+    OM_PageSummary *sum;	/* summary of the page */
+    OM_PageSummary *neighbor;	/* summary of a neighbor page */
+
+
+    map = eduom_GetZoneMap(catObjForFile);
+    if (map == NULL) return(eNOERROR);
+
+    sum = eduom_ZoneMapLookUp(map, apage->header.pid.pageNo);
+    if (sum == NULL) {
+	sum = eduom_ZoneMapAdd(map, apage->header.pid.pageNo);
+	if (sum == NULL) {
+	    /* a zone map missing a page would hide its objects; give it up */
+	    eduom_FreeZoneMap(map);
+	    return(eNOERROR);
+	}
+	sum->nextPage = apage->header.nextPage;
+	sum->prevPage = apage->header.prevPage;
+	if (sum->nextPage != NIL && (neighbor = eduom_ZoneMapLookUp(map, sum->nextPage)) != NULL)
+	    neighbor->prevPage = sum->pageNo;
+	if (sum->prevPage != NIL && (neighbor = eduom_ZoneMapLookUp(map, sum->prevPage)) != NULL)
+	    neighbor->nextPage = sum->pageNo;
+    }
+
+    if (hdr == NULL) return(eNOERROR);
+
+    if (sum->nLive == 0) {
+	sum->minTag = sum->maxTag = hdr->tag;
+	sum->minLength = sum->maxLength = hdr->length;
+    }
+    else {
+	if (hdr->tag < sum->minTag) sum->minTag = hdr->tag;
+	if (hdr->tag > sum->maxTag) sum->maxTag = hdr->tag;
+	if (hdr->length < sum->minLength) sum->minLength = hdr->length;
+	if (hdr->length > sum->maxLength) sum->maxLength = hdr->length;
+    }
+    sum->nLive++;
+
+    return(eNOERROR);
+
+} /* eduom_ZoneMapInsert() */
+
+
+
+/*@================================
+ * eduom_ZoneMapRemove()
+ *================================*/
+/*
+ * Function: Four eduom_ZoneMapRemove(ObjectID*, SlottedPage*, Boolean)
+ *
+ * Description :
+ *  Record in the zone map of the file that an object was removed from
+ *  'apage'. The ranges are left as they are. If 'pageRemoved' is TRUE, the
+ *  page was removed from the page list and its summary is unlinked and
+ *  deleted.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four eduom_ZoneMapRemove(
+    ObjectID *catObjForFile,	/* IN catalog object of the file */
+    SlottedPage *apage,		/* IN page which held the object */
+    Boolean pageRemoved)	/* IN TRUE if the page left the page list */
+{
+    OM_ZoneMap *map;		/* zone map of the file */
+    OM_PageSummary *sum;	/* summary of the page */
+    OM_PageSummary *neighbor;	/* summary of a neighbor page */
+
+
+    map = eduom_GetZoneMap(catObjForFile);
+    if (map == NULL) return(eNOERROR);
+
+    sum = eduom_ZoneMapLookUp(map, apage->header.pid.pageNo);
+    if (sum == NULL) return(eNOERROR);
+
+    if (sum->nLive > 0) sum->nLive--;
+
+    if (pageRemoved) {
+	if (sum->nextPage != NIL && (neighbor = eduom_ZoneMapLookUp(map, sum->nextPage)) != NULL)
+	    neighbor->prevPage = sum->prevPage;
+	if (sum->prevPage != NIL && (neighbor = eduom_ZoneMapLookUp(map, sum->prevPage)) != NULL)
+	    neighbor->nextPage = sum->nextPage;
+	eduom_ZoneMapDelete(map, sum);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_ZoneMapRemove() */
+
+
+
+/*@================================
+ * eduom_ZoneMapSkip()
+ *================================*/
+/*
+ * Function: PageNo eduom_ZoneMapSkip(OM_ZoneMap*, UFour, PageNo, OM_HdrPredicate*, Four, Four*)
+ *
+ * Description :
+ *  Starting from 'pageNo', follow the page list in the given direction
+ *  through the zone map over the pages which cannot hold an object
+ *  satisfying 'pred', and return the first page which may. Pages which are
+ *  not in the zone map are never passed over. The property bits are not
+ *  summarized and do not let a page be passed over. If 'map' is no longer
+ *  the zone map of the generation 'generation', no page is passed over.
+ *
+ * Returns:
+ *  the first page which may hold a qualifying object, or NIL
+ */
+PageNo eduom_ZoneMapSkip(
+    OM_ZoneMap *map,		/* IN zone map of the file */
+    UFour generation,		/* IN generation of the zone map of the file */
+    PageNo pageNo,		/* IN first page to consider */
+    OM_HdrPredicate *pred,	/* IN predicate of the scan */
+    Four direction,		/* IN FORWARD or BACKWARD */
+    Four *nSkipped)		/* INOUT incremented by the # of pages passed over */
+{
+    Four t;			/* index of a tag */
+    Boolean mayQualify;		/* TRUE if the page may hold a qualifying object */
+    OM_PageSummary *sum;	/* summary of the page */
+
+
+    /* the zone map may have been given up, and its entry reused, during the scan */
+    if (map->generation != generation) return(pageNo);
+
+    while (pageNo != NIL) {
+	sum = eduom_ZoneMapLookUp(map, pageNo);
+	if (sum == NULL) break;
+
+	mayQualify = (sum->nLive > 0);
+
+	if (mayQualify && (pred->conditions & PRED_LENGTH))
+	    mayQualify = (sum->maxLength >= pred->minLength && sum->minLength <= pred->maxLength);
+
+	if (mayQualify && (pred->conditions & PRED_TAG)) {
+	    for (mayQualify = FALSE, t = 0; t < pred->nTags; t++)
+		if (pred->tags[t] >= sum->minTag && pred->tags[t] <= sum->maxTag) { mayQualify = TRUE; break; }
+	}
+
+	if (mayQualify) break;
+
+	(*nSkipped)++;
+	pageNo = (direction == FORWARD) ? sum->nextPage : sum->prevPage;
+    }
+
+    return(pageNo);
+
+} /* eduom_ZoneMapSkip() */
+
+
+
+/*
+ * Function: OM_PageSummary *eduom_ZoneMapLookUp(OM_ZoneMap*, PageNo)
+ *
+ * Description :
+ *  Return the summary of a page, or NULL if the page is not in the zone map.
+ */
+static OM_PageSummary *eduom_ZoneMapLookUp(
+    OM_ZoneMap *map,		/* IN zone map */
+    PageNo pageNo)		/* IN page to look up */
+{
+    UFour h;			/* bucket */
+
+
+    for (h = ZM_HASH(map, pageNo); map->pages[h].pageNo != NIL; h = (h + 1) & (map->size - 1))
+	if (map->pages[h].pageNo == pageNo) return(&map->pages[h]);
+
+    return(NULL);
+
+} /* eduom_ZoneMapLookUp() */
+
+
+
+/*
+ * Function: OM_PageSummary *eduom_ZoneMapAdd(OM_ZoneMap*, PageNo)
+ *
+ * Description :
+ *  Add an empty summary for a page which is not in the zone map. The hash
+ *  table is doubled when it becomes half full.
+ *
+ * Returns:
+ *  the new summary, or NULL if memory is short
+ */
+static OM_PageSummary *eduom_ZoneMapAdd(
+    OM_ZoneMap *map,		/* INOUT zone map */
+    PageNo pageNo)		/* IN page to add */
+{
+    Four i;			/* index */
+    UFour h;			/* bucket */
+    OM_PageSummary *old;	/* buckets before doubling */
+    Four oldSize;		/* # of buckets before doubling */
+
+
+    if ((map->nPages + 1) * 2 > map->size) {
+	old = map->pages;
+	oldSize = map->size;
+	map->pages = (OM_PageSummary *)malloc(oldSize * 2 * sizeof(OM_PageSummary));
+	if (map->pages == NULL) {
+	    map->pages = old;
+	    return(NULL);
+	}
+	map->size = oldSize * 2;
+	for (i = 0; i < map->size; i++) map->pages[i].pageNo = NIL;
+	for (i = 0; i < oldSize; i++) {
+	    if (old[i].pageNo == NIL) continue;
+	    for (h = ZM_HASH(map, old[i].pageNo); map->pages[h].pageNo != NIL; h = (h + 1) & (map->size - 1)) ;
+	    map->pages[h] = old[i];
+	}
+	free(old);
+    }
+
+    for (h = ZM_HASH(map, pageNo); map->pages[h].pageNo != NIL; h = (h + 1) & (map->size - 1)) ;
+    map->pages[h].pageNo = pageNo;
+    map->pages[h].nextPage = map->pages[h].prevPage = NIL;
+    map->pages[h].nLive = 0;
+    map->nPages++;
+
+    return(&map->pages[h]);
+
+} /* eduom_ZoneMapAdd() */
+
+
+
+/*
+ * Function: void eduom_ZoneMapDelete(OM_ZoneMap*, OM_PageSummary*)
+ *
+ * Description :
+ *  Delete a summary from the hash table, moving back the following entries
+ *  of its probe sequence so that no tombstone is needed.
+ */
+static void eduom_ZoneMapDelete(
+    OM_ZoneMap *map,		/* INOUT zone map */
+    OM_PageSummary *sum)	/* IN summary to delete */
+{
+    UFour hole;			/* emptied bucket */
+    UFour h;			/* bucket examined */
+    UFour home;			/* home bucket of the entry in 'h' */
+    UFour mask = map->size - 1;	/* mask of the bucket numbers */
+
+
+    hole = sum - map->pages;
+    map->pages[hole].pageNo = NIL;
+    map->nPages--;
+
+    for (h = (hole + 1) & mask; map->pages[h].pageNo != NIL; h = (h + 1) & mask) {
+	home = ZM_HASH(map, map->pages[h].pageNo);
+	/* move the entry if the hole lies between its home and its bucket */
+	if (((h - home) & mask) >= ((h - hole) & mask)) {
+	    map->pages[hole] = map->pages[h];
+	    map->pages[h].pageNo = NIL;
+	    hole = h;
+	}
+    }
+
+} /* eduom_ZoneMapDelete() */
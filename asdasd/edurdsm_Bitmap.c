@@ -0,0 +1,352 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edurdsm_Bitmap.c
+ *
+ * Description:
+ *  Word-parallel bit operations on the page maps of RDsM.
+ *  A page map page holds one bit per page of the volume after a header of
+ *  RDSM_PAGEMAP_HDR_SIZE bytes, the first page of a byte in its most
+ *  significant bit; a set bit is a free page. These functions replace the
+ *  ones of the COSMOS object, which visit the bits one at a time, and are
+ *  called by its page and extent allocation (make ALLOC=intree). The bits
+ *  are read 64 at a time in the order of the pages; the runs of free pages
+ *  in a word are found by ANDing the word with shifts of itself, and the
+ *  used pages are skipped with one count of the leading zeros.
+ *
+ * Exports:
+ *  Four RDsM_find_bits(char*, Four, Four, Four)
+ *  Four RDsM_test_n_bits_set(char*, Four, Four)
+ *  void RDsM_set_bits(char*, Four, Four)
+ *  void RDsM_clear_bits(char*, Four, Four)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+
+
+#define RDSM_WORD_BITS  64      /* # of bits read at a time */
+#define RDSM_MAP_BYTES  (PAGESIZE - RDSM_PAGEMAP_HDR_SIZE) /* bytes of bits of a page map page */
+
+/*
+ * Typedef for the bits read at a time
+ */
+typedef unsigned long long rdsm_Word;
+
+/*
+ * Macros for the leading and trailing zeros of a nonzero word
+ */
+#define RDSM_CLZ(w)     __builtin_clzll(w)
+#define RDSM_CTZ(w)     __builtin_ctzll(w)
+
+
+static rdsm_Word edurdsm_LoadBits(UOne*, Four, Four);
+static void edurdsm_FillBits(UOne*, Four, Four, UOne);
+
+
+
+/*@================================
+ * RDsM_find_bits()
+ *================================*/
+/*
+ * Function: Four RDsM_find_bits(char*, Four, Four, Four)
+ *
+ * Description:
+ *  Find the first run of 'n' set bits among the 'nBits' bits starting at
+ *  the bit 'start' of the page map page 'page'.
+ *
+ * Returns:
+ *  position of the run relative to 'start', or -1 if there is none
+ */
+Four RDsM_find_bits(
+    char *page,			/* IN page map page */
+    Four start,			/* IN first bit to look at */
+    Four nBits,			/* IN # of bits to look at */
+    Four n)			/* IN # of set bits wanted */
+{
+    UOne *map;			/* bits of the page */
+    Four pos;			/* bit being looked at */
+    Four end;			/* bit after the last bit to look at */
+    Four run;			/* length of the run of set bits at 'pos' */
+    Four len;			/* length of the part of the run in 'w' */
+    Four shift;			/* shift of 'm' */
+    rdsm_Word w;		/* bits starting at 'pos' */
+    rdsm_Word m;		/* starts of the runs of 'n' set bits in 'w' */
+
+
+    if (nBits <= 0 || n <= 0) return(-1);
+
+    map = (UOne *)page + RDSM_PAGEMAP_HDR_SIZE;
+    end = start + nBits;
+
+    /* a run fitting in a word: the bit i of 'm' is set when the bits i to
+     * i + n - 1 of 'w' are; the next word starts after the last clear bit */
+    if (n <= RDSM_WORD_BITS) {
+	for (pos = start; end - pos >= n; ) {
+	    w = edurdsm_LoadBits(map, pos, end);
+	    if (w == 0) {
+		pos += RDSM_WORD_BITS;
+		continue;
+	    }
+
+	    for (m = w, len = 1; len < n && m != 0; len += shift) {
+		shift = MIN(len, n - len);
+		m &= m << shift;
+	    }
+	    if (m != 0) return(pos + RDSM_CLZ(m) - start);
+
+	    pos += RDSM_WORD_BITS - RDSM_CTZ(~w);
+	}
+
+	return(-1);
+    }
+
+    /* a longer run: skip the clear bits and measure the run of set bits */
+    for (pos = start; end - pos >= n; ) {
+	w = edurdsm_LoadBits(map, pos, end);
+	if (w == 0) {
+	    pos += RDSM_WORD_BITS;
+	    continue;
+	}
+	if (RDSM_CLZ(w) > 0) {
+	    pos += RDSM_CLZ(w);
+	    continue;
+	}
+
+	run = 0;
+	do {
+	    len = (~w == 0) ? RDSM_WORD_BITS : RDSM_CLZ(~w);
+	    run += len;
+	    if (run >= n) return(pos - start);
+	    if (len < RDSM_WORD_BITS || pos + run >= end) break;
+	    w = edurdsm_LoadBits(map, pos + run, end);
+	} while (TRUE);
+
+	pos += run;
+    }
+
+    return(-1);
+
+} /* RDsM_find_bits() */
+
+
+
+/*@================================
+ * RDsM_test_n_bits_set()
+ *================================*/
+/*
+ * Function: Four RDsM_test_n_bits_set(char*, Four, Four)
+ *
+ * Description:
+ *  Check that none of the 'n' bits starting at the bit 'start' of the page
+ *  map page 'page' is set, i.e. that the pages are not already free.
+ *
+ * Returns:
+ *  error code
+ *    eALREADYSETBIT_RDSM
+ */
+Four RDsM_test_n_bits_set(
+    char *page,			/* IN page map page */
+    Four start,			/* IN first bit to test */
+    Four n)			/* IN # of bits to test */
+{
+    UOne *map;			/* bits of the page */
+    Four pos;			/* bit being tested */
+
+
+    map = (UOne *)page + RDSM_PAGEMAP_HDR_SIZE;
+
+    for (pos = start; pos < start + n; pos += RDSM_WORD_BITS)
+	if (edurdsm_LoadBits(map, pos, start + n) != 0) ERR(eALREADYSETBIT_RDSM);
+
+    return(eNOERROR);
+
+} /* RDsM_test_n_bits_set() */
+
+
+
+/*@================================
+ * RDsM_set_bits()
+ *================================*/
+/*
+ * Function: void RDsM_set_bits(char*, Four, Four)
+ *
+ * Description:
+ *  Set the 'n' bits starting at the bit 'start' of the page map page
+ *  'page'.
+ *
+ * Returns:
+ *  None
+ */
+void RDsM_set_bits(
+    char *page,			/* INOUT page map page */
+    Four start,			/* IN first bit to set */
+    Four n)			/* IN # of bits to set */
+{
+    edurdsm_FillBits((UOne *)page + RDSM_PAGEMAP_HDR_SIZE, start, n, 0xFF);
+
+} /* RDsM_set_bits() */
+
+
+
+/*@================================
+ * RDsM_clear_bits()
+ *================================*/
+/*
+ * Function: void RDsM_clear_bits(char*, Four, Four)
+ *
+ * Description:
+ *  Clear the 'n' bits starting at the bit 'start' of the page map page
+ *  'page'.
+ *
+ * Returns:
+ *  None
+ */
+void RDsM_clear_bits(
+    char *page,			/* INOUT page map page */
+    Four start,			/* IN first bit to clear */
+    Four n)			/* IN # of bits to clear */
+{
+    edurdsm_FillBits((UOne *)page + RDSM_PAGEMAP_HDR_SIZE, start, n, 0x00);
+
+} /* RDsM_clear_bits() */
+
+
+
+/*
+ * Function: rdsm_Word edurdsm_LoadBits(UOne*, Four, Four)
+ *
+ * Description:
+ *  Return the 64 bits of the page map 'map' starting at the bit 'pos', the
+ *  bit 'pos' in the most significant bit. The bits from the bit 'end' on
+ *  are cleared. The bytes are read up to the end of the page map page.
+ *
+ * Returns:
+ *  the bits starting at 'pos'
+ */
+static rdsm_Word edurdsm_LoadBits(
+    UOne *map,			/* IN bits of a page map page */
+    Four pos,			/* IN first bit to return */
+    Four end)			/* IN bit after the last valid bit */
+{
+    Four i;			/* index */
+    Four byte;			/* byte holding the bit 'pos' */
+    Four shift;			/* position of the bit 'pos' in its byte */
+    rdsm_Word w;		/* bits starting at the byte 'byte' */
+
+
+    byte = pos >> 3;
+    shift = pos & 7;
+
+    if (byte + sizeof(rdsm_Word) <= RDSM_MAP_BYTES) {
+	memcpy(&w, &map[byte], sizeof(rdsm_Word));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	w = __builtin_bswap64(w);
+#endif
+	if (shift > 0) {
+	    w <<= shift;
+	    if (byte + sizeof(rdsm_Word) < RDSM_MAP_BYTES) w |= map[byte + sizeof(rdsm_Word)] >> (8 - shift);
+	}
+    }
+    else {
+	for (w = 0, i = 0; byte + i < RDSM_MAP_BYTES; i++)
+	    w |= (rdsm_Word)map[byte + i] << (RDSM_WORD_BITS - 8 * (i + 1));
+	w <<= shift;
+    }
+
+    if (end - pos < RDSM_WORD_BITS) w &= ~(~(rdsm_Word)0 >> (end - pos));
+
+    return(w);
+
+} /* edurdsm_LoadBits() */
+
+
+
+/*
+ * Function: void edurdsm_FillBits(UOne*, Four, Four, UOne)
+ *
+ * Description:
+ *  Set ('fill' == 0xFF) or clear ('fill' == 0x00) the 'n' bits of 'map'
+ *  starting at the bit 'start'. The whole bytes are filled by memset().
+ *
+ * Returns:
+ *  None
+ */
+static void edurdsm_FillBits(
+    UOne *map,			/* INOUT bits */
+    Four start,			/* IN first bit to fill */
+    Four n,			/* IN # of bits to fill */
+    UOne fill)			/* IN 0xFF to set, 0x00 to clear */
+{
+    Four first;			/* first byte */
+    Four last;			/* last byte */
+    UOne firstMask;		/* bits of the first byte to fill */
+    UOne lastMask;		/* bits of the last byte to fill */
+
+
+    if (n <= 0) return;
+
+    first = start >> 3;
+    last = (start + n - 1) >> 3;
+    firstMask = 0xFF >> (start & 7);
+    lastMask = 0xFF << (7 - ((start + n - 1) & 7));
+
+    if (first == last) {
+	firstMask &= lastMask;
+	map[first] = (map[first] & ~firstMask) | (fill & firstMask);
+	return;
+    }
+
+    map[first] = (map[first] & ~firstMask) | (fill & firstMask);
+    memset(&map[first + 1], fill, last - first - 1);
+    map[last] = (map[last] & ~lastMask) | (fill & lastMask);
+
+} /* edurdsm_FillBits() */
@@ -0,0 +1,165 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edurdsm_Devices.c
+ *
+ * Description:
+ *  Layout of the devices of the mounted volumes.
+ *  A volume consists of up to RDSM_MAX_DEVICES devices, each holding
+ *  whole extents: the extents of the volume are numbered across the
+ *  devices in the order they were given to LRDS_Mount(), and a page is
+ *  found in its device at the offset given by its page number less the
+ *  first page of the device. The pages of a device beyond its last whole
+ *  extent are not used. The layout is read from the volume table of RDsM,
+ *  for the read-ahead, the page allocation and the buffer manager, which
+ *  issue the I/Os of the devices by themselves. The extents of a segment
+ *  are linked in the order of their allocation, from the extent of its
+ *  first page, and can be followed for a scan by extents.
+ *
+ * Exports:
+ *  Four EduRDsM_GetDevices(Four, Four*, int*, PageNo*)
+ *  Four EduRDsM_GetNextExt(Four, Four, Four*)
+ */
+
+
+#include "EduOM_common.h"
+#include "RDsM.h"
+
+
+extern RDsM_VolTableEntry volTable[];  /* volume table of RDsM */
+
+
+
+/*@================================
+ * EduRDsM_GetDevices()
+ *================================*/
+/*
+ * Function: Four EduRDsM_GetDevices(Four, Four*, int*, PageNo*)
+ *
+ * Description:
+ *  Return the devices of the mounted volume 'volNo': their number, the
+ *  descriptors RDsM reads and writes them with, unless 'fds' is NULL, and
+ *  the first page of each of them in 'firstPage', followed by the number
+ *  of pages of the volume. 'fds' and 'firstPage' have room for
+ *  RDSM_MAX_DEVICES devices.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four EduRDsM_GetDevices(
+    Four volNo,			/* IN volume */
+    Four *numDevices,		/* OUT # of devices of the volume */
+    int *fds,			/* OUT descriptors of the devices, may be NULL */
+    PageNo *firstPage)		/* OUT first page of each device, then # of pages */
+{
+    Four i;			/* index */
+    RDsM_VolTableEntry *v;	/* entry of the volume */
+
+
+    for (i = 0; i < RDSM_MAX_VOLUMES; i++)
+	if (volTable[i].volNo == volNo) break;
+    if (volNo == NIL || i == RDSM_MAX_VOLUMES) ERR(eBADPARAMETER);
+
+    v = &volTable[i];
+    if (v->numDevices <= 0 || v->numDevices > RDSM_MAX_DEVICES || v->devInfo == NULL) ERR(eBADPARAMETER);
+
+    *numDevices = v->numDevices;
+    for (i = 0; i < v->numDevices; i++) {
+	if (fds != NULL) fds[i] = v->devInfo[i].fd;
+	firstPage[i] = v->devInfo[i].firstExtNo * v->sizeOfExt;
+    }
+    firstPage[i] = v->numOfExts * v->sizeOfExt;
+
+    return(eNOERROR);
+
+} /* EduRDsM_GetDevices() */
+
+
+
+/*@================================
+ * EduRDsM_GetNextExt()
+ *================================*/
+/*
+ * Function: Four EduRDsM_GetNextExt(Four, Four, Four*)
+ *
+ * Description:
+ *  Return the extent following the extent 'ext' in its segment, or NIL if
+ *  'ext' is the last one. The first page of the extent 'ext' is
+ *  'ext' * sizeOfExt.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    some errors caused by function calls
+ */
+Four EduRDsM_GetNextExt(
+    Four volNo,			/* IN volume */
+    Four ext,			/* IN extent of a segment */
+    Four *nextExt)		/* OUT next extent of the segment, or NIL */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four prev;			/* previous extent of 'ext' */
+    RDsM_VolTableEntry *v;	/* entry of the volume */
+
+
+    for (i = 0; i < RDSM_MAX_VOLUMES; i++)
+	if (volTable[i].volNo == volNo) break;
+    if (volNo == NIL || i == RDSM_MAX_VOLUMES) ERR(eBADPARAMETER);
+
+    v = &volTable[i];
+    if (ext < 0 || ext >= v->numOfExts) ERR(eBADPARAMETER);
+
+    e = RDsM_get_prev_next_ext(v, ext, &prev, nextExt);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduRDsM_GetNextExt() */
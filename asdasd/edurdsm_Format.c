@@ -0,0 +1,143 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edurdsm_Format.c
+ *
+ * Description:
+ *  Fast formatting of the devices of a volume.
+ *  LRDS_FormatDataVolume() writes only the volume header and the
+ *  allocation maps of the volume, and extends each device to its size with
+ *  a write of its last page; the data pages of a device reused from an
+ *  earlier volume, however, keep their old contents on the disk. Before a
+ *  volume is formatted, EduRDsM_PrepareDevices() empties each device which
+ *  is a regular file and gives it its size at once, as a sparse file or
+ *  with its space reserved with fallocate(). This gives back the disk
+ *  space of the old data, but is not faster: dropping the blocks of the
+ *  file takes about 0.4 ms per MB of old data, while formatting the file
+ *  as is takes a few ms whatever its size, and a new file gains nothing.
+ *  It is thus only called by those who want the space back. The pages of
+ *  a device which cannot be emptied, such as a block device, may be zeroed
+ *  an extent at a time at the first allocation of the extent instead (see
+ *  edurdsm_InitExt.c).
+ *
+ * Exports:
+ *  Four EduRDsM_PrepareDevices(Four, char**, Four*, Four)
+ */
+
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+
+
+
+/*@================================
+ * EduRDsM_PrepareDevices()
+ *================================*/
+/*
+ * Function: Four EduRDsM_PrepareDevices(Four, char**, Four*, Four)
+ *
+ * Description:
+ *  Prepare the devices 'devNames' of a volume to be formatted with
+ *  LRDS_FormatDataVolume() with the same arguments: each regular file,
+ *  created if it does not exist, is emptied and given the size of its
+ *  'numPagesInDevices' pages, as a sparse file for RDSM_FORMAT_SPARSE,
+ *  or with its space reserved for RDSM_FORMAT_RESERVE; a file system
+ *  which cannot reserve space leaves the file sparse. Any other device is
+ *  left as is.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eDEVICEOPENFAIL_RDSM
+ *    eWRITEFAIL_RDSM
+ */
+Four EduRDsM_PrepareDevices(
+    Four numDevices,		/* IN # of devices of the volume */
+    char **devNames,		/* IN device names */
+    Four *numPagesInDevices,	/* IN # of pages of each device */
+    Four mode)			/* IN RDSM_FORMAT_SPARSE or RDSM_FORMAT_RESERVE */
+{
+    Four i;			/* index of the devices */
+    int fd;			/* descriptor of the device */
+    int r;			/* result of the system calls */
+    off_t size;			/* size of the device */
+    struct stat st;		/* status of the device */
+
+
+    if (numDevices < 1 || numDevices > RDSM_MAX_DEVICES) ERR(eBADPARAMETER);
+    if (mode != RDSM_FORMAT_SPARSE && mode != RDSM_FORMAT_RESERVE) ERR(eBADPARAMETER);
+
+    for (i = 0; i < numDevices; i++) {
+	fd = open(devNames[i], O_RDWR | O_CREAT, 0644);
+	if (fd < 0) ERR(eDEVICEOPENFAIL_RDSM);
+
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+	    close(fd);
+	    continue;
+	}
+
+	/* dropping the blocks of the file is cheaper than overwriting them */
+	size = (off_t)numPagesInDevices[i] * PAGESIZE;
+	r = ftruncate(fd, 0);
+	if (r == 0) r = ftruncate(fd, size);
+	if (r == 0 && mode == RDSM_FORMAT_RESERVE &&
+	    fallocate(fd, 0, 0, size) != 0 && errno != EOPNOTSUPP) r = -1;
+	close(fd);
+
+	if (r != 0) ERR(eWRITEFAIL_RDSM);
+    }
+
+    return(eNOERROR);
+
+} /* EduRDsM_PrepareDevices() */
@@ -0,0 +1,651 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edurdsm_IOEngine.c
+ *
+ * Description:
+ *  Asynchronous I/O engine for the reads and writes of the volumes done
+ *  outside RDsM by the read-ahead and the buffer manager.
+ *  Requests are prepared one by one, submitted together with one system
+ *  call, and reaped as they complete, so that a single thread keeps many
+ *  I/Os in flight. The engine uses io_uring through its system calls; the
+ *  buffers registered with it are read and written without the kernel
+ *  mapping their pages on every request. When io_uring is not available,
+ *  or the synchronous engine is chosen, the requests are done with pread()
+ *  and pwrite() at submission and reaped afterwards.
+ *
+ * Exports:
+ *  Four EduRDsM_SetIOEngine(Four)
+ *  Four EduRDsM_InitIOEngine(RDsM_IOEngine*, Four)
+ *  Four EduRDsM_FinalIOEngine(RDsM_IOEngine*)
+ *  Four EduRDsM_RegisterIOBuffers(RDsM_IOEngine*, Four, char**, size_t*)
+ *  Four EduRDsM_PrepareIO(RDsM_IOEngine*, Four, int, char*, Four, long long, void*)
+ *  Four EduRDsM_PrepareIOV(RDsM_IOEngine*, Four, int, struct iovec*, Four, long long, void*)
+ *  Four EduRDsM_SubmitIO(RDsM_IOEngine*)
+ *  Four EduRDsM_WaitIO(RDsM_IOEngine*, Four, RDsM_IOCompletion*, Four)
+ */
+
+
+#define _FILE_OFFSET_BITS 64
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+
+
+#define RDSM_MAX_FIXED_SIZE     (1L << 30)  /* maximum size of a registered buffer */
+
+/*
+ * Macros for the fields shared with the kernel
+ */
+#define RDSM_LOAD_ACQUIRE(p)        __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define RDSM_STORE_RELEASE(p, v)    __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+
+static Four rdsmIOEngine = RDSM_IO_ENGINE;     /* engine of the engines initialized next */
+
+static Four edurdsm_InitUring(RDsM_IOEngine*);
+static Four edurdsm_FixedBuffer(RDsM_IOEngine*, char*, Four);
+
+
+
+/*@================================
+ * EduRDsM_SetIOEngine()
+ *================================*/
+/*
+ * Function: Four EduRDsM_SetIOEngine(Four)
+ *
+ * Description:
+ *  Choose the engine of the I/O engines initialized from now on:
+ *  RDSM_IO_URING, RDSM_IO_SYNC, or RDSM_IO_AUTO for io_uring when the
+ *  kernel provides it. The engines already initialized are not changed.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four EduRDsM_SetIOEngine(
+    Four kind)			/* IN RDSM_IO_AUTO, RDSM_IO_URING or RDSM_IO_SYNC */
+{
+    if (kind != RDSM_IO_AUTO && kind != RDSM_IO_URING && kind != RDSM_IO_SYNC) ERR(eBADPARAMETER);
+
+    rdsmIOEngine = kind;
+
+    return(eNOERROR);
+
+} /* EduRDsM_SetIOEngine() */
+
+
+
+/*@================================
+ * EduRDsM_InitIOEngine()
+ *================================*/
+/*
+ * Function: Four EduRDsM_InitIOEngine(RDsM_IOEngine*, Four)
+ *
+ * Description:
+ *  Initialize the I/O engine 'engine' for up to 'depth' requests prepared
+ *  and not reaped yet, with the engine chosen by EduRDsM_SetIOEngine().
+ *  If io_uring cannot be set up, the synchronous engine is used, unless
+ *  RDSM_IO_URING was chosen; 'engine->kind' tells the engine used.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eMEMORYALLOCERR
+ */
+Four EduRDsM_InitIOEngine(
+    RDsM_IOEngine *engine,	/* OUT engine to initialize */
+    Four depth)			/* IN maximum # of requests in the engine */
+{
+    Four e;			/* error */
+
+
+    /*@ parameter checking */
+    if (engine == NULL || depth <= 0 || depth > RDSM_IO_MAX_DEPTH) ERR(eBADPARAMETER);
+
+    memset(engine, 0, sizeof(RDsM_IOEngine));
+    engine->ringFd = -1;
+    engine->depth = depth;
+
+    if (rdsmIOEngine != RDSM_IO_SYNC) {
+	e = edurdsm_InitUring(engine);
+	if (e >= eNOERROR) return(eNOERROR);
+	if (rdsmIOEngine == RDSM_IO_URING) ERR(e);
+    }
+
+    engine->kind = RDSM_IO_SYNC;
+    engine->queued = (RDsM_IORequest *)malloc(depth * sizeof(RDsM_IORequest));
+    engine->done = (RDsM_IOCompletion *)malloc(depth * sizeof(RDsM_IOCompletion));
+    if (engine->queued == NULL || engine->done == NULL) {
+	free(engine->queued);
+	free(engine->done);
+	ERR(eMEMORYALLOCERR);
+    }
+
+    return(eNOERROR);
+
+} /* EduRDsM_InitIOEngine() */
+
+
+
+/*@================================
+ * EduRDsM_FinalIOEngine()
+ *================================*/
+/*
+ * Function: Four EduRDsM_FinalIOEngine(RDsM_IOEngine*)
+ *
+ * Description:
+ *  Wait for the requests in flight and release the engine. Requests
+ *  prepared and not submitted are dropped.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four EduRDsM_FinalIOEngine(
+    RDsM_IOEngine *engine)	/* INOUT engine to release */
+{
+    RDsM_IOCompletion c;	/* a completion, dropped */
+
+
+    while (engine->nInFlight > 0)
+	if (EduRDsM_WaitIO(engine, 1, &c, 1) < eNOERROR) break;
+
+    if (engine->kind == RDSM_IO_URING) {
+	(void) munmap(engine->sqes, engine->sqesSize);
+	(void) munmap(engine->ring, engine->ringSize);
+	close(engine->ringFd);
+    }
+    else {
+	free(engine->queued);
+	free(engine->done);
+    }
+
+    memset(engine, 0, sizeof(RDsM_IOEngine));
+    engine->ringFd = -1;
+
+    return(eNOERROR);
+
+} /* EduRDsM_FinalIOEngine() */
+
+
+
+/*@================================
+ * EduRDsM_RegisterIOBuffers()
+ *================================*/
+/*
+ * Function: Four EduRDsM_RegisterIOBuffers(RDsM_IOEngine*, Four, char**, size_t*)
+ *
+ * Description:
+ *  Register the 'nBuffers' memory areas 'bases' of sizes 'sizes' with the
+ *  engine, replacing the ones registered before; the requests on these
+ *  areas then use them without the kernel mapping their pages each time.
+ *  The registration is an optimization only: nothing is registered with
+ *  the synchronous engine, or if the kernel refuses the areas (e.g. over
+ *  the locked memory limit), and the requests are done all the same.
+ *
+ * Returns:
+ *  # of registered buffers, or an error code
+ *    eBADPARAMETER
+ */
+Four EduRDsM_RegisterIOBuffers(
+    RDsM_IOEngine *engine,	/* INOUT engine */
+    Four nBuffers,		/* IN # of areas */
+    char **bases,		/* IN areas */
+    size_t *sizes)		/* IN sizes of the areas */
+{
+    Four i;			/* index */
+    struct iovec iov[RDSM_IO_MAX_BUFFERS]; /* areas to register */
+
+
+    /*@ parameter checking */
+    if (nBuffers < 0 || nBuffers > RDSM_IO_MAX_BUFFERS) ERR(eBADPARAMETER);
+
+    if (engine->kind != RDSM_IO_URING) return(0);
+
+    if (engine->nBuffers > 0) {
+	(void) syscall(__NR_io_uring_register, engine->ringFd, IORING_UNREGISTER_BUFFERS, NULL, 0);
+	engine->nBuffers = 0;
+    }
+
+    for (i = 0; i < nBuffers; i++) {
+	if (bases[i] == NULL || sizes[i] == 0 || sizes[i] > RDSM_MAX_FIXED_SIZE) return(0);
+	iov[i].iov_base = bases[i];
+	iov[i].iov_len = sizes[i];
+    }
+
+    if (nBuffers == 0 || syscall(__NR_io_uring_register, engine->ringFd, IORING_REGISTER_BUFFERS, iov, nBuffers) < 0)
+	return(0);
+
+    for (i = 0; i < nBuffers; i++) {
+	engine->bufBase[i] = bases[i];
+	engine->bufSize[i] = sizes[i];
+    }
+    engine->nBuffers = nBuffers;
+
+    return(nBuffers);
+
+} /* EduRDsM_RegisterIOBuffers() */
+
+
+
+/*@================================
+ * EduRDsM_PrepareIO()
+ *================================*/
+/*
+ * Function: Four EduRDsM_PrepareIO(RDsM_IOEngine*, Four, int, char*, Four, long long, void*)
+ *
+ * Description:
+ *  Prepare the read (RDSM_IO_READ) or the write (RDSM_IO_WRITE) of 'len'
+ *  bytes at the offset 'offset' of the file 'fd' into or from 'buf'. The
+ *  request is started by the next EduRDsM_SubmitIO(), and its completion
+ *  is returned by EduRDsM_WaitIO() with 'tag'. At most 'depth' requests
+ *  may be prepared and not reaped.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four EduRDsM_PrepareIO(
+    RDsM_IOEngine *engine,	/* INOUT engine */
+    Four op,			/* IN RDSM_IO_READ or RDSM_IO_WRITE */
+    int fd,			/* IN file */
+    char *buf,			/* IN buffer */
+    Four len,			/* IN # of bytes */
+    long long offset,		/* IN offset in the file */
+    void *tag)			/* IN tag of the request */
+{
+    Four fixed;			/* registered buffer holding 'buf', or NIL */
+    unsigned tail;		/* tail of the submission ring */
+    unsigned idx;		/* entry of the request */
+    struct io_uring_sqe *sqe;	/* submission queue entry */
+    RDsM_IORequest *req;	/* request of the synchronous engine */
+
+
+    /*@ parameter checking */
+    if ((op != RDSM_IO_READ && op != RDSM_IO_WRITE) || fd < 0 || buf == NULL || len <= 0 || offset < 0)
+	ERR(eBADPARAMETER);
+
+    if (engine->nQueued + engine->nInFlight >= engine->depth) ERR(eBADPARAMETER);
+
+    if (engine->kind == RDSM_IO_SYNC) {
+	req = &engine->queued[engine->nQueued];
+	req->op = op;
+	req->fd = fd;
+	req->buf = buf;
+	req->len = len;
+	req->iov = NULL;
+	req->offset = offset;
+	req->tag = tag;
+	engine->nQueued++;
+	return(eNOERROR);
+    }
+
+    /* only this thread moves the tail */
+    tail = *engine->sqTail;
+    idx = tail & *engine->sqMask;
+    sqe = &((struct io_uring_sqe *)engine->sqes)[idx];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+    fixed = edurdsm_FixedBuffer(engine, buf, len);
+    if (fixed != NIL) {
+	sqe->opcode = (op == RDSM_IO_READ) ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+	sqe->buf_index = fixed;
+    }
+    else
+	sqe->opcode = (op == RDSM_IO_READ) ? IORING_OP_READ : IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long)buf;
+    sqe->len = len;
+    sqe->off = offset;
+    sqe->user_data = (unsigned long)tag;
+
+    engine->sqArray[idx] = idx;
+    RDSM_STORE_RELEASE(engine->sqTail, tail + 1);
+    engine->nQueued++;
+
+    return(eNOERROR);
+
+} /* EduRDsM_PrepareIO() */
+
+
+
+/*@================================
+ * EduRDsM_PrepareIOV()
+ *================================*/
+/*
+ * Function: Four EduRDsM_PrepareIOV(RDsM_IOEngine*, Four, int, struct iovec*, Four, long long, void*)
+ *
+ * Description:
+ *  Prepare the vectored read (RDSM_IO_READ) or write (RDSM_IO_WRITE) of
+ *  the 'iovcnt' buffers 'iov' at the offset 'offset' of the file 'fd', as
+ *  EduRDsM_PrepareIO() does for one buffer. 'iov' is used until the
+ *  completion of the request. The registered buffers are not used.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four EduRDsM_PrepareIOV(
+    RDsM_IOEngine *engine,	/* INOUT engine */
+    Four op,			/* IN RDSM_IO_READ or RDSM_IO_WRITE */
+    int fd,			/* IN file */
+    struct iovec *iov,		/* IN buffers */
+    Four iovcnt,		/* IN # of buffers */
+    long long offset,		/* IN offset in the file */
+    void *tag)			/* IN tag of the request */
+{
+    unsigned tail;		/* tail of the submission ring */
+    unsigned idx;		/* entry of the request */
+    struct io_uring_sqe *sqe;	/* submission queue entry */
+    RDsM_IORequest *req;	/* request of the synchronous engine */
+
+
+    /*@ parameter checking */
+    if ((op != RDSM_IO_READ && op != RDSM_IO_WRITE) || fd < 0 || iov == NULL || iovcnt <= 0 || offset < 0)
+	ERR(eBADPARAMETER);
+
+    if (engine->nQueued + engine->nInFlight >= engine->depth) ERR(eBADPARAMETER);
+
+    if (engine->kind == RDSM_IO_SYNC) {
+	req = &engine->queued[engine->nQueued];
+	req->op = op;
+	req->fd = fd;
+	req->iov = iov;
+	req->iovcnt = iovcnt;
+	req->offset = offset;
+	req->tag = tag;
+	engine->nQueued++;
+	return(eNOERROR);
+    }
+
+    /* only this thread moves the tail */
+    tail = *engine->sqTail;
+    idx = tail & *engine->sqMask;
+    sqe = &((struct io_uring_sqe *)engine->sqes)[idx];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+    sqe->opcode = (op == RDSM_IO_READ) ? IORING_OP_READV : IORING_OP_WRITEV;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long)iov;
+    sqe->len = iovcnt;
+    sqe->off = offset;
+    sqe->user_data = (unsigned long)tag;
+
+    engine->sqArray[idx] = idx;
+    RDSM_STORE_RELEASE(engine->sqTail, tail + 1);
+    engine->nQueued++;
+
+    return(eNOERROR);
+
+} /* EduRDsM_PrepareIOV() */
+
+
+
+/*@================================
+ * EduRDsM_SubmitIO()
+ *================================*/
+/*
+ * Function: Four EduRDsM_SubmitIO(RDsM_IOEngine*)
+ *
+ * Description:
+ *  Start the requests prepared since the last submission, with one system
+ *  call. The synchronous engine does them here.
+ *
+ * Returns:
+ *  # of requests submitted, or an error code
+ *    some errors caused by function calls
+ */
+Four EduRDsM_SubmitIO(
+    RDsM_IOEngine *engine)	/* INOUT engine */
+{
+    Four i;			/* index */
+    Four n;			/* # of requests submitted */
+    long ret;			/* result of a system call */
+    RDsM_IORequest *req;	/* request of the synchronous engine */
+
+
+    if (engine->nQueued == 0) return(0);
+
+    if (engine->kind == RDSM_IO_SYNC) {
+	for (i = 0; i < engine->nQueued; i++) {
+	    req = &engine->queued[i];
+	    if (req->iov != NULL)
+		ret = (req->op == RDSM_IO_READ) ? preadv(req->fd, req->iov, req->iovcnt, req->offset)
+						 : pwritev(req->fd, req->iov, req->iovcnt, req->offset);
+	    else
+		ret = (req->op == RDSM_IO_READ) ? pread(req->fd, req->buf, req->len, req->offset)
+						 : pwrite(req->fd, req->buf, req->len, req->offset);
+	    engine->done[engine->nDone].tag = req->tag;
+	    engine->done[engine->nDone].result = (ret < 0) ? -errno : ret;
+	    engine->nDone++;
+	}
+	n = engine->nQueued;
+    }
+    else {
+	for (n = 0; n < engine->nQueued; n += ret) {
+	    ret = syscall(__NR_io_uring_enter, engine->ringFd, engine->nQueued - n, 0, 0, NULL, 0);
+	    if (ret < 0 && errno != EINTR && errno != EAGAIN) break;
+	    if (ret < 0) ret = 0;
+	}
+	if (n < engine->nQueued) {
+	    /* the requests stay in the ring and are submitted with the next ones */
+	    engine->nQueued -= n;
+	    engine->nInFlight += n;
+	    ERR(eBADPARAMETER);
+	}
+    }
+
+    engine->nQueued = 0;
+    engine->nInFlight += n;
+    engine->nSubmits++;
+    engine->nRequests += n;
+
+    return(n);
+
+} /* EduRDsM_SubmitIO() */
+
+
+
+/*@================================
+ * EduRDsM_WaitIO()
+ *================================*/
+/*
+ * Function: Four EduRDsM_WaitIO(RDsM_IOEngine*, Four, RDsM_IOCompletion*, Four)
+ *
+ * Description:
+ *  Reap up to 'maxComplete' completed requests into 'completions', waiting
+ *  until at least 'minComplete' of them have completed or none is left in
+ *  flight.
+ *
+ * Returns:
+ *  # of requests reaped, or an error code
+ *    eBADPARAMETER
+ */
+Four EduRDsM_WaitIO(
+    RDsM_IOEngine *engine,	/* INOUT engine */
+    Four minComplete,		/* IN # of requests to wait for */
+    RDsM_IOCompletion *completions, /* OUT completed requests */
+    Four maxComplete)		/* IN size of 'completions' */
+{
+    Four n;			/* # of requests reaped */
+    unsigned head, tail;	/* head and tail of the completion ring */
+    struct io_uring_cqe *cqe;	/* completion queue entry */
+
+
+    /*@ parameter checking */
+    if (completions == NULL || maxComplete <= 0) ERR(eBADPARAMETER);
+
+    minComplete = MIN(minComplete, maxComplete);
+
+    if (engine->kind == RDSM_IO_SYNC) {
+	n = MIN(engine->nDone, maxComplete);
+	memcpy(completions, engine->done, n * sizeof(RDsM_IOCompletion));
+	memmove(engine->done, engine->done + n, (engine->nDone - n) * sizeof(RDsM_IOCompletion));
+	engine->nDone -= n;
+	engine->nInFlight -= n;
+	return(n);
+    }
+
+    for (n = 0; ; ) {
+	head = *engine->cqHead;
+	tail = RDSM_LOAD_ACQUIRE(engine->cqTail);
+	for ( ; head != tail && n < maxComplete; head++, n++) {
+	    cqe = &((struct io_uring_cqe *)engine->cqes)[head & *engine->cqMask];
+	    completions[n].tag = (void *)(unsigned long)cqe->user_data;
+	    completions[n].result = cqe->res;
+	    engine->nInFlight--;
+	}
+	RDSM_STORE_RELEASE(engine->cqHead, head);
+
+	if (n >= minComplete || engine->nInFlight == 0) break;
+
+	if (syscall(__NR_io_uring_enter, engine->ringFd, 0, minComplete - n, IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+	    errno != EINTR && errno != EAGAIN)
+	    ERR(eBADPARAMETER);
+    }
+
+    return(n);
+
+} /* EduRDsM_WaitIO() */
+
+
+
+/*
+ * Function: Four edurdsm_InitUring(RDsM_IOEngine*)
+ *
+ * Description:
+ *  Set up an io_uring of 'engine->depth' entries and map its rings. The
+ *  kernel must map both rings at once and read and write at the offsets
+ *  given (Linux 5.6 on), which is where IORING_OP_READ and IORING_OP_WRITE
+ *  appeared.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+static Four edurdsm_InitUring(
+    RDsM_IOEngine *engine)	/* INOUT engine */
+{
+    struct io_uring_params p;	/* parameters of the ring */
+    size_t sqSize, cqSize;	/* sizes of the rings */
+
+
+    memset(&p, 0, sizeof(p));
+    engine->ringFd = syscall(__NR_io_uring_setup, engine->depth, &p);
+    if (engine->ringFd < 0) ERR(eBADPARAMETER);
+
+    if (!(p.features & IORING_FEAT_SINGLE_MMAP) || !(p.features & IORING_FEAT_RW_CUR_POS)) {
+	close(engine->ringFd);
+	engine->ringFd = -1;
+	ERR(eBADPARAMETER);
+    }
+
+    sqSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cqSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    engine->ringSize = MAX(sqSize, cqSize);
+    engine->ring = mmap(NULL, engine->ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			engine->ringFd, IORING_OFF_SQ_RING);
+    engine->sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+    engine->sqes = mmap(NULL, engine->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			engine->ringFd, IORING_OFF_SQES);
+    if (engine->ring == MAP_FAILED || engine->sqes == MAP_FAILED) {
+	if (engine->ring != MAP_FAILED) (void) munmap(engine->ring, engine->ringSize);
+	if (engine->sqes != MAP_FAILED) (void) munmap(engine->sqes, engine->sqesSize);
+	close(engine->ringFd);
+	engine->ringFd = -1;
+	ERR(eBADPARAMETER);
+    }
+
+    engine->sqTail = (unsigned *)(engine->ring + p.sq_off.tail);
+    engine->sqMask = (unsigned *)(engine->ring + p.sq_off.ring_mask);
+    engine->sqArray = (unsigned *)(engine->ring + p.sq_off.array);
+    engine->cqHead = (unsigned *)(engine->ring + p.cq_off.head);
+    engine->cqTail = (unsigned *)(engine->ring + p.cq_off.tail);
+    engine->cqMask = (unsigned *)(engine->ring + p.cq_off.ring_mask);
+    engine->cqes = engine->ring + p.cq_off.cqes;
+    engine->kind = RDSM_IO_URING;
+
+    return(eNOERROR);
+
+} /* edurdsm_InitUring() */
+
+
+
+/*
+ * Function: Four edurdsm_FixedBuffer(RDsM_IOEngine*, char*, Four)
+ *
+ * Description:
+ *  Find the registered buffer holding the 'len' bytes at 'buf'.
+ *
+ * Returns:
+ *  index of the registered buffer, or NIL
+ */
+static Four edurdsm_FixedBuffer(
+    RDsM_IOEngine *engine,	/* IN engine */
+    char *buf,			/* IN start of the bytes */
+    Four len)			/* IN # of bytes */
+{
+    Four i;			/* index */
+
+
+    for (i = 0; i < engine->nBuffers; i++)
+	if (buf >= engine->bufBase[i] && buf + len <= engine->bufBase[i] + engine->bufSize[i]) return(i);
+
+    return(NIL);
+
+} /* edurdsm_FixedBuffer() */
@@ -0,0 +1,346 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edurdsm_InitExt.c
+ *
+ * Description:
+ *  Lazy initialization of the extents of a volume.
+ *  Formatting does not touch the data pages of a volume, so a device
+ *  which is not a fresh sparse file, such as a block device or a file
+ *  formatted again without EduRDsM_PrepareDevices(), holds old data in the
+ *  extents never allocated since. When EduRDsM_SetInitExt() turns it on,
+ *  such an extent is zeroed when it is allocated for the first time: a
+ *  file has the blocks of the extent punched out if it has any, a block
+ *  device has the extent zeroed with BLKZEROOUT, and any other device has
+ *  it overwritten with zeros. It is off by default: RDsM never reads a
+ *  page it has not written, so the zeroing only keeps old data from
+ *  showing through the device, at the cost of a system call or more per
+ *  extent and a walk of the free extents at the first allocation.
+ *
+ *  RDsM takes the free extents from the head of their list and puts the
+ *  freed ones back at its head, and the list is in the order of the
+ *  extent numbers after formatting; striping keeps that order on each
+ *  device. On each device, the extents never allocated are thus the ones
+ *  after the last extent ever allocated, and an extent is initialized
+ *  when it is allocated after the mark of its device, which is moved past
+ *  it. The marks are found at the first allocation of each mount of the
+ *  volume from the extents which are not free, and forgotten when the
+ *  volume is dismounted; an extent freed after the last allocated one is
+ *  thus zeroed again when it is reused, which is harmless. The RDsM_alloc_ext()
+ *  of edurdsm_Stripe.c initializes the extents it allocates (make
+ *  ALLOC=intree); this RDsM_Dismount() replaces the one of the COSMOS
+ *  object, which it calls as cosmos_RDsM_Dismount().
+ *
+ * Exports:
+ *  Four EduRDsM_SetInitExt(Boolean)
+ *  Four EduRDsM_InitExt(RDsM_VolTableEntry*, Four)
+ *  Four RDsM_Dismount(Four)
+ */
+
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+
+
+extern RDsM_VolTableEntry volTable[];  /* volume table of RDsM */
+
+/* RDsM_Dismount() of the COSMOS object */
+Four cosmos_RDsM_Dismount(Four);
+
+/*
+ * Marks of the volumes, by entry of the volume table
+ */
+static struct {
+    Boolean loaded;		/* TRUE if the marks of 'volNo' are found */
+    VolNo   volNo;		/* volume of the entry when its marks were found */
+    Four    mark[RDSM_MAX_DEVICES]; /* extents of each device from this one on are not initialized */
+} rdsmInits[RDSM_MAX_VOLUMES];
+
+static char rdsmZeroPage[PAGESIZE];	/* page of zeros */
+static Boolean rdsmInitExtOn = FALSE;	/* TRUE if the extents are zeroed */
+
+static Four edurdsm_LoadMarks(RDsM_VolTableEntry*, Four, Four*);
+static Four edurdsm_ZeroExt(RDsM_VolTableEntry*, Four, Four);
+
+
+
+/*@================================
+ * EduRDsM_SetInitExt()
+ *================================*/
+/*
+ * Function: Four EduRDsM_SetInitExt(Boolean)
+ *
+ * Description:
+ *  Turn on or off the zeroing of the extents allocated for the first time
+ *  since the volume was formatted. The extents allocated while it is off
+ *  are not zeroed later.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ */
+Four EduRDsM_SetInitExt(
+    Boolean on)			/* IN TRUE to zero the extents */
+{
+    rdsmInitExtOn = on;
+
+    return(eNOERROR);
+
+} /* EduRDsM_SetInitExt() */
+
+
+
+/*@================================
+ * EduRDsM_InitExt()
+ *================================*/
+/*
+ * Function: Four EduRDsM_InitExt(RDsM_VolTableEntry*, Four)
+ *
+ * Description:
+ *  Zero the extent 'ext' of the volume 'v', just allocated, if it is
+ *  allocated for the first time since the volume was formatted and the
+ *  zeroing is on.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four EduRDsM_InitExt(
+    RDsM_VolTableEntry *v,	/* IN entry of the volume */
+    Four ext)			/* IN extent just allocated */
+{
+    Four e;			/* error */
+    Four i;			/* index of the volume in the volume table */
+    Four d;			/* device of the extent */
+
+
+    if (!rdsmInitExtOn) return(eNOERROR);
+
+    i = v - volTable;
+    if (i < 0 || i >= RDSM_MAX_VOLUMES) return(eNOERROR);
+
+    if (!rdsmInits[i].loaded || rdsmInits[i].volNo != v->volNo) {
+	e = edurdsm_LoadMarks(v, ext, rdsmInits[i].mark);
+	if (e < eNOERROR) ERR(e);
+	rdsmInits[i].loaded = TRUE;
+	rdsmInits[i].volNo = v->volNo;
+    }
+
+    for (d = v->numDevices - 1; d > 0 && ext < v->devInfo[d].firstExtNo; d--) ;
+    if (ext < rdsmInits[i].mark[d]) return(eNOERROR);
+
+    e = edurdsm_ZeroExt(v, d, ext);
+    if (e < eNOERROR) ERR(e);
+    rdsmInits[i].mark[d] = ext + 1;
+
+    return(eNOERROR);
+
+} /* EduRDsM_InitExt() */
+
+
+
+/*@================================
+ * RDsM_Dismount()
+ *================================*/
+/*
+ * Function: Four RDsM_Dismount(Four)
+ *
+ * Description:
+ *  Dismount the volume 'volNo' as RDsM does, forgetting its marks, so
+ *  that they are found again if it is formatted and mounted again.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four RDsM_Dismount(
+    Four volNo)			/* IN volume to dismount */
+{
+    Four e;			/* error */
+    Four i;			/* index of the volume table */
+
+
+    for (i = 0; i < RDSM_MAX_VOLUMES; i++)
+	if (rdsmInits[i].loaded && rdsmInits[i].volNo == volNo) rdsmInits[i].loaded = FALSE;
+
+    e = cosmos_RDsM_Dismount(volNo);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* RDsM_Dismount() */
+
+
+
+/*
+ * Function: Four edurdsm_LoadMarks(RDsM_VolTableEntry*, Four, Four*)
+ *
+ * Description:
+ *  Find the mark of each device of the volume 'v', past the last extent
+ *  of the device which is neither free nor 'newExt', the extent just
+ *  allocated. If the list of the free extents does not hold
+ *  'numOfFreeExts' extents, every extent is initialized when allocated.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four edurdsm_LoadMarks(
+    RDsM_VolTableEntry *v,	/* IN entry of the volume */
+    Four newExt,		/* IN extent just allocated */
+    Four *mark)			/* OUT mark of each device */
+{
+    Four e;			/* error */
+    Four k;			/* index of the free extents */
+    Four d;			/* device index */
+    Four ext;			/* an extent */
+    Four prev, next;		/* neighbors of 'ext' in the list */
+    Four last;			/* first extent after the device */
+    char *isFree;		/* TRUE for each free extent */
+
+
+    for (d = 0; d < v->numDevices; d++) mark[d] = v->devInfo[d].firstExtNo;
+
+    isFree = (char *)calloc(v->numOfExts, 1);
+    if (isFree == NULL) ERR(eMEMORYALLOCERR);
+
+    for (k = 0, ext = v->firstFreeExt; ext != NIL && k < v->numOfFreeExts; k++, ext = next) {
+	e = RDsM_get_prev_next_ext(v, ext, &prev, &next);
+	if (e < eNOERROR) {
+	    free(isFree);
+	    ERR(e);
+	}
+	if (ext >= 0 && ext < v->numOfExts) isFree[ext] = TRUE;
+    }
+    if (k != v->numOfFreeExts || ext != NIL) {
+	free(isFree);
+	return(eNOERROR);
+    }
+    if (newExt >= 0 && newExt < v->numOfExts) isFree[newExt] = TRUE;
+
+    for (d = 0; d < v->numDevices; d++) {
+	last = (d + 1 < v->numDevices) ? v->devInfo[d+1].firstExtNo : v->numOfExts;
+	for (ext = last - 1; ext >= v->devInfo[d].firstExtNo && isFree[ext]; ext--) ;
+	mark[d] = ext + 1;
+    }
+
+    free(isFree);
+
+    return(eNOERROR);
+
+} /* edurdsm_LoadMarks() */
+
+
+
+/*
+ * Function: Four edurdsm_ZeroExt(RDsM_VolTableEntry*, Four, Four)
+ *
+ * Description:
+ *  Zero the extent 'ext' of the device 'd' of the volume 'v', through a
+ *  descriptor of its own, so that the offset of the descriptor of RDsM is
+ *  not moved.
+ *
+ * Returns:
+ *  error code
+ *    eDEVICEOPENFAIL_RDSM
+ *    eWRITEFAIL_RDSM
+ */
+static Four edurdsm_ZeroExt(
+    RDsM_VolTableEntry *v,	/* IN entry of the volume */
+    Four d,			/* IN device of the extent */
+    Four ext)			/* IN extent to zero */
+{
+    int fd;			/* descriptor of the device */
+    int r;			/* result of the system calls */
+    off_t offset;		/* offset of the extent in the device */
+    off_t length;		/* # of bytes of the extent */
+    off_t data;			/* first data of the file from 'offset' */
+    off_t done;			/* # of bytes zeroed */
+    uint64_t range[2];		/* range zeroed by BLKZEROOUT */
+    struct stat st;		/* status of the device */
+
+
+    offset = (off_t)(ext - v->devInfo[d].firstExtNo) * v->sizeOfExt * PAGESIZE;
+    length = (off_t)v->sizeOfExt * PAGESIZE;
+
+    fd = open(v->devInfo[d].devName, O_RDWR);
+    if (fd < 0) ERR(eDEVICEOPENFAIL_RDSM);
+
+    r = -1;
+    if (fstat(fd, &st) != 0) st.st_mode = 0;
+    if (S_ISREG(st.st_mode)) {
+	/* a hole, or space reserved and never written, reads as zeros */
+	data = lseek(fd, offset, SEEK_DATA);
+	if (data < 0 || data >= offset + length) r = 0;
+	else r = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, length);
+    }
+    else if (S_ISBLK(st.st_mode)) {
+	range[0] = offset;
+	range[1] = length;
+	r = ioctl(fd, BLKZEROOUT, range);
+    }
+
+    for (done = 0; r != 0 && done < length; done += PAGESIZE)
+	if (pwrite(fd, rdsmZeroPage, PAGESIZE, offset + done) != PAGESIZE) break;
+    close(fd);
+
+    if (r != 0 && done < length) ERR(eWRITEFAIL_RDSM);
+
+    return(eNOERROR);
+
+} /* edurdsm_ZeroExt() */
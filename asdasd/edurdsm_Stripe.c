@@ -0,0 +1,230 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edurdsm_Stripe.c
+ *
+ * Description:
+ *  Striping of the extent allocation across the devices of a volume.
+ *  RDsM allocates the extents of the segments from the head of the list
+ *  of the free extents of the volume, which is in the order of the extent
+ *  numbers after formatting: the extents of a file fill the first device
+ *  before the others, and a scan of the file reads one device at a time.
+ *  This RDsM_alloc_ext() replaces the one of the COSMOS object (make
+ *  ALLOC=intree), which it calls as cosmos_RDsM_alloc_ext(), and, at the
+ *  first allocation of a volume of several devices, relinks the free
+ *  extents so that they alternate between the devices, in their order on
+ *  each device. The following extents of a file are then on successive
+ *  devices, and the read-ahead and the writes of the buffer manager, which
+ *  serve each device on its own, keep all of them busy. The new order is
+ *  written to the volume like any change of the list; extents freed later
+ *  are put at the head of the list by RDsM as usual.
+ *
+ * Exports:
+ *  Four RDsM_alloc_ext(RDsM_VolTableEntry*, Four, Four*)
+ */
+
+
+#include <stdlib.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+
+
+extern RDsM_VolTableEntry volTable[];  /* volume table of RDsM */
+
+/* RDsM_alloc_ext() of the COSMOS object */
+Four cosmos_RDsM_alloc_ext(RDsM_VolTableEntry*, Four, Four*);
+
+/*
+ * Volumes whose free extents are striped, by entry of the volume table
+ */
+static struct {
+    Boolean striped;		/* TRUE if the free extents of 'volNo' are striped */
+    VolNo   volNo;		/* volume of the entry when it was striped */
+} rdsmStripes[RDSM_MAX_VOLUMES];
+
+static Four edurdsm_StripeFreeExts(RDsM_VolTableEntry*);
+
+
+
+/*@================================
+ * RDsM_alloc_ext()
+ *================================*/
+/*
+ * Function: Four RDsM_alloc_ext(RDsM_VolTableEntry*, Four, Four*)
+ *
+ * Description:
+ *  Allocate the extent at the head of the free extents of the volume 'v'
+ *  and link it after the extent 'prevExt' of its segment (NIL for a new
+ *  segment), as RDsM does, zeroing it if it was never allocated (see
+ *  edurdsm_InitExt.c), and striping the free extents across the devices
+ *  at the first allocation of the volume.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four RDsM_alloc_ext(
+    RDsM_VolTableEntry *v,	/* INOUT entry of the volume */
+    Four prevExt,		/* IN last extent of the segment, or NIL */
+    Four *newExt)		/* OUT extent allocated */
+{
+    Four e;			/* error */
+    Four i;			/* index of the volume in the volume table */
+
+
+    /* the count and the head of the free extents are loaded from now on */
+    e = cosmos_RDsM_alloc_ext(v, prevExt, newExt);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduRDsM_InitExt(v, *newExt);
+    if (e < eNOERROR) ERR(e);
+
+    i = v - volTable;
+    if (i < 0 || i >= RDSM_MAX_VOLUMES) return(eNOERROR);
+    if (rdsmStripes[i].striped && rdsmStripes[i].volNo == v->volNo) return(eNOERROR);
+
+    rdsmStripes[i].striped = TRUE;
+    rdsmStripes[i].volNo = v->volNo;
+
+    if (v->numDevices > 1) {
+	e = edurdsm_StripeFreeExts(v);
+	if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* RDsM_alloc_ext() */
+
+
+
+/*
+ * Function: Four edurdsm_StripeFreeExts(RDsM_VolTableEntry*)
+ *
+ * Description:
+ *  Relink the free extents of the volume 'v' so that they are taken from
+ *  its devices in turn, each device in the order of the current list. The
+ *  list is left as is if it does not hold 'numOfFreeExts' extents.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four edurdsm_StripeFreeExts(
+    RDsM_VolTableEntry *v)	/* INOUT entry of the volume */
+{
+    Four e;			/* error */
+    Four k;			/* index of the free extents */
+    Four d;			/* device index */
+    Four n;			/* # of free extents */
+    Four ext;			/* a free extent */
+    Four prev, next;		/* neighbors of 'ext' in the list */
+    Four *exts;			/* free extents in the order of the list */
+    Four *order;		/* free extents in the striped order */
+    Four *dev;			/* device of each extent of 'exts' */
+    Four start[RDSM_MAX_DEVICES+1]; /* first index of each device in 'order' */
+    Four cursor[RDSM_MAX_DEVICES]; /* next index of each device in 'order' */
+
+
+    n = v->numOfFreeExts;
+    if (n <= 1) return(eNOERROR);
+
+    exts = (Four *)malloc(3 * n * sizeof(Four));
+    if (exts == NULL) ERR(eMEMORYALLOCERR);
+    order = exts + n;
+    dev = order + n;
+
+    /*@ collect the free extents by device */
+    for (d = 0; d <= v->numDevices; d++) start[d] = 0;
+    for (k = 0, ext = v->firstFreeExt; ext != NIL && k < n; k++, ext = next) {
+	e = RDsM_get_prev_next_ext(v, ext, &prev, &next);
+	if (e < eNOERROR) {
+	    free(exts);
+	    ERR(e);
+	}
+	for (d = v->numDevices - 1; d > 0 && ext < v->devInfo[d].firstExtNo; d--) ;
+	exts[k] = ext;
+	dev[k] = d;
+	start[d+1]++;
+    }
+    if (k != n || ext != NIL) {
+	free(exts);
+	return(eNOERROR);
+    }
+
+    for (d = 0; d < v->numDevices; d++) {
+	start[d+1] += start[d];
+	cursor[d] = start[d];
+    }
+    for (k = 0; k < n; k++) order[cursor[dev[k]]++] = exts[k];
+
+    /*@ take them from the devices in turn */
+    for (d = 0; d < v->numDevices; d++) cursor[d] = start[d];
+    for (k = 0; k < n; )
+	for (d = 0; d < v->numDevices; d++)
+	    if (cursor[d] < start[d+1]) exts[k++] = order[cursor[d]++];
+
+    /*@ relink them */
+    for (k = 0; k < n; k++) {
+	e = RDsM_set_prev_next_ext(v, exts[k], NIL, (k + 1 < n) ? exts[k+1] : NIL);
+	if (e < eNOERROR) {
+	    free(exts);
+	    ERR(e);
+	}
+    }
+
+    v->firstFreeExt = exts[0];
+    free(exts);
+
+    e = RDsM_change_NumOfFreeExts_FirstFreeExt(v);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edurdsm_StripeFreeExts() */